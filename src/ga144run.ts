@@ -0,0 +1,780 @@
+/**
+ * ga144run — headless GA144 emulator runner
+ *
+ * Usage:
+ *   ./node_modules/.bin/esbuild --bundle ga144run.ts --platform=node --format=esm | node --input-type=module - <file>
+ *   # or use the ga144run wrapper script
+ *
+ * Options:
+ *   --steps=N      Node-step budget (default 50M)
+ *   --boot         Deliver the program as a serial boot stream to node 708
+ *                  (as the web UI does) instead of loading RAM directly
+ *   --livelock=NS  Stop when nodes spin for NS guest ns without IO
+ *   --serial       Print bytes decoded from node 708's serial TX pin
+ *   --serial-pty=PATH  Bridge node 708's serial RX/TX to a pseudo-terminal
+ *                  linked at PATH (needs socat), like the EVB002 COM port
+ *   --serial-stdio Bridge the serial port to stdin/stdout instead; the
+ *                  report goes to stderr
+ *   --baud=N       Serial bridge baud rate (default 921600)
+ *   --realtime[=X] Pace guest time to X times wall-clock time (default 1)
+ *   --mesh=RxC     Simulate an R-row, C-column mesh of F18A nodes instead of
+ *                  the 8x18 GA144 (no I/O ring, so no pin or device options)
+ *   --coverage     Print per-node word and branch coverage
+ *   --lcov=FILE    Write CUBE line/branch coverage as an lcov tracefile
+ *   --vga-frames=N Capture VGA frames, stopping after N (0 = no limit)
+ *   --vga-out=PATH Write captured frames: a directory for ppm/png, a file for raw
+ *   --vga-format=F ppm (default), png or raw (concatenated RGB24)
+ *   --vga-size=WxH Capture resolution (default 640x480)
+ *   --vcd=FILE     Stream pin, DAC and port handshake waveforms as VCD
+ *   --vcd-nodes=L  Comma-separated nodes to probe (default: GPIO and analog nodes)
+ *   --vcd-in=FILE  Replay a VCD signal as pin17 input (with --vcd-pin)
+ *   --vcd-pin=S@N  Signal name or scope path S drives node N's pin17 (default 708)
+ *   --sram=MODE    Attach the external SRAM: cluster (node 107 protocol for
+ *                  masters 106/207/108) or pins (decode the 007/008/009 bus)
+ *   --sram-load=F  Load SRAM from a file of little-endian 16-bit words
+ *   --sram-dump=F  Write the SRAM contents to a file after the run
+ *   --eth-in=FILE  Send the frames of a pcap file to the 10BASE-T Rx pin (217)
+ *   --eth-out=FILE Write frames decoded from the Tx pin (317) as pcap
+ *   --eth-loopback Loop the Tx pin back to the Rx pin
+ *   --i2c=LIST     Put slaves on the 708.17 (SCL) / 708.1 (SDA) I2C bus, e.g.
+ *                  sensor@40:FE=54:FF=49,eeprom@50:4096 (hex address/registers)
+ *   --i2c-mode=M   Check bus timing against standard or fast (default) mode
+ *   --stimulus=L   Drive GPIO pins of any node from stimulus files, comma-
+ *                  separated; lines are TIME NODE.PIN LEVEL, e.g. 5us 200.17 1
+ *   --analog=LIST  Stream WAV or CSV files into analog nodes' ADCs, e.g.
+ *                  709:in.wav,713:probe.csv (files are read in chunks)
+ *   --analog-rate=HZ  Sample rate of CSV inputs (default 1000000)
+ *   --analog-loop  Repeat analog inputs instead of holding the last sample
+ *   --audio=FILE   Resample DAC output to a WAV file (16-bit PCM)
+ *   --audio-nodes=L  DAC nodes to capture, one channel each (default 117)
+ *   --audio-rate=HZ  WAV sample rate (default 48000)
+ *   --host-profile Report the emulator's own host time per subsystem and
+ *                  its throughput (MIPS, events/s, IO writes/s, queue depth)
+ *   --json         Output the run result as JSON
+ *
+ * Exit status: 0 finished, 1 error, 2 deadlock, 3 livelock.
+ */
+import { readFileSync, writeFileSync, mkdirSync, openSync, readSync, writeSync, closeSync } from 'fs';
+import { join } from 'path';
+import { spawn } from 'child_process';
+import type { Readable, Writable } from 'stream';
+import { deflateSync } from 'zlib';
+import { compileCube } from './src/core/cube/compiler';
+import { compile } from './src/core/assembler';
+import { buildBootStream } from './src/core/bootstream';
+import { GA144 } from './src/core/ga144';
+import { Mesh, GA144_MESH } from './src/core/mesh';
+import { ROM_DATA } from './src/core/rom-data';
+import { SerialBits, SerialDecoder } from './src/core/serial';
+import type { CompiledProgram } from './src/core/types';
+import type { StallReport } from './src/core/deadlock';
+import type { SourceMapEntry } from './src/core/cube/emitter';
+import { summarizeCoverage, coverageToLcov } from './src/core/coverage';
+import { VgaFrameCapture, encodePpm, encodePng } from './src/ui/emulator/vgaCapture';
+import type { VgaFrame } from './src/ui/emulator/vgaCapture';
+import { VcdWriter, parseVcd, findVcdSignal, vcdToPinBits } from './src/core/vcd';
+import { VcdProbe } from './src/core/vcd-probe';
+import { DacAudioCapture } from './src/core/dac-audio';
+import { WavWriter } from './src/core/wav';
+import { SramDevice } from './src/core/devices/sram';
+import { EthernetPhyDevice } from './src/core/devices/ethernet';
+import { I2cBusDevice, I2cRegisterDevice, I2cEepromDevice } from './src/core/devices/i2c';
+import type { I2cSlave } from './src/core/devices/i2c';
+import { AnalogInputDevice, wavStream, csvStream } from './src/core/devices/analog-input';
+import { StimulusDevice, stimulusFile } from './src/core/devices/stimulus';
+import type { AnalogChannel } from './src/core/devices/analog-input';
+import type { ByteReader } from './src/core/wav';
+import { PcapWriter, parsePcap } from './src/core/pcap';
+import { NODE_GPIO_PINS, ANALOG_NODES } from './src/core/constants';
+import { HostProfiler, calibrateHostCosts, HOST_SECTIONS } from './src/core/host-profile';
+
+// ---- Argument parsing ----
+
+const args = process.argv.slice(2);
+const options = new Map<string, string>();
+for (const a of args) {
+  if (!a.startsWith('--')) continue;
+  const eq = a.indexOf('=');
+  if (eq < 0) options.set(a, '');
+  else options.set(a.slice(0, eq), a.slice(eq + 1));
+}
+const files = args.filter(a => !a.startsWith('--'));
+
+if (files.length === 0) {
+  console.error('ga144run — headless GA144 emulator');
+  console.error('');
+  console.error('Usage: ./ga144run <file.cube|file.aforth> [options]');
+  console.error('');
+  console.error('Options:');
+  console.error('  --steps=N      Node-step budget (default 50000000)');
+  console.error('  --boot         Boot via serial stream to node 708 instead of direct load');
+  console.error('  --livelock=NS  Stop when nodes spin for NS guest ns without IO');
+  console.error('  --mesh=RxC     Mesh of R rows and C columns, e.g. 32x32 (default 8x18)');
+  console.error('  --serial       Print bytes decoded from node 708 serial output');
+  console.error('  --serial-pty=PATH  Bridge the 708 serial port to a PTY at PATH (needs socat)');
+  console.error('  --serial-stdio Bridge the 708 serial port to stdin/stdout');
+  console.error('  --baud=N       Serial bridge baud rate (default 921600)');
+  console.error('  --realtime[=X] Pace guest time to X times wall clock (default 1)');
+  console.error('  --coverage     Print per-node word and branch coverage');
+  console.error('  --lcov=FILE    Write CUBE line/branch coverage as lcov');
+  console.error('  --vga-frames=N Capture VGA frames, stop after N (0 = no limit)');
+  console.error('  --vga-out=PATH Write frames (directory for ppm/png, file for raw)');
+  console.error('  --vga-format=F ppm (default), png or raw RGB24 stream');
+  console.error('  --vga-size=WxH Capture resolution (default 640x480)');
+  console.error('  --vcd=FILE     Stream pin/DAC/handshake waveforms as VCD');
+  console.error('  --vcd-nodes=L  Nodes to probe, e.g. 708,217 (default: GPIO and analog)');
+  console.error('  --vcd-in=FILE  Replay a VCD signal as pin17 input');
+  console.error('  --vcd-pin=S@N  Signal S drives node N pin17 (default node 708)');
+  console.error('  --sram=MODE    External SRAM: cluster (107 protocol) or pins (007/008/009 bus)');
+  console.error('  --sram-load=F  Load SRAM from little-endian 16-bit words');
+  console.error('  --sram-dump=F  Write SRAM contents after the run');
+  console.error('  --eth-in=FILE  Send pcap frames to the 10BASE-T Rx pin');
+  console.error('  --eth-out=FILE Write frames from the Tx pin as pcap');
+  console.error('  --eth-loopback Loop the Tx pin back to the Rx pin');
+  console.error('  --i2c=LIST     I2C slaves on 708.17/708.1: sensor@40[:REG=VAL...],eeprom@50[:SIZE]');
+  console.error('  --i2c-mode=M   I2C timing checks: standard or fast (default)');
+  console.error('  --stimulus=L   Pin stimulus files (TIME NODE.PIN LEVEL lines), comma-separated');
+  console.error('  --analog=LIST  Stream WAV/CSV files into ADCs: NODE:FILE[,NODE:FILE...]');
+  console.error('  --analog-rate=HZ  Sample rate of CSV inputs (default 1000000)');
+  console.error('  --analog-loop  Repeat analog inputs instead of holding the last sample');
+  console.error('  --audio=FILE   Resample DAC output to a WAV file');
+  console.error('  --audio-nodes=L  DAC nodes to capture, e.g. 117,617 (default 117)');
+  console.error('  --audio-rate=HZ  WAV sample rate (default 48000)');
+  console.error('  --host-profile Report host time per emulator subsystem and throughput');
+  console.error('  --json         Output run result as JSON');
+  process.exit(1);
+}
+
+function numberOption(name: string, fallback: number): number {
+  const raw = options.get(name);
+  if (raw === undefined) return fallback;
+  const value = Number(raw);
+  if (!Number.isFinite(value) || value < 0) {
+    console.error(`Error: ${name} expects a non-negative number, got '${raw}'`);
+    process.exit(1);
+  }
+  return value;
+}
+
+const maxSteps = numberOption('--steps', options.has('--serial-pty') || options.has('--serial-stdio') ? Infinity : 50_000_000);
+const analogRate = numberOption('--analog-rate', 1_000_000);
+const audioPath = options.get('--audio');
+const audioRate = numberOption('--audio-rate', 48_000);
+const audioNodes = (options.get('--audio-nodes') ?? '117').split(',').map(Number);
+if (audioRate <= 0) {
+  console.error('Error: --audio-rate must be positive');
+  process.exit(1);
+}
+const livelockNS = numberOption('--livelock', 0);
+const boot = options.has('--boot');
+const serialOut = options.has('--serial');
+const serialPty = options.get('--serial-pty');
+const serialStdio = options.has('--serial-stdio');
+const serialBridge = serialPty !== undefined || serialStdio;
+const baud = numberOption('--baud', GA144.BOOT_BAUD);
+const realtime = options.has('--realtime') ? (options.get('--realtime') === '' ? 1 : numberOption('--realtime', 1)) : 0;
+if (serialPty !== undefined && serialStdio) {
+  console.error('Error: --serial-pty and --serial-stdio are two ends for one port');
+  process.exit(1);
+}
+if (serialBridge && (serialOut || boot)) {
+  console.error('Error: the serial bridge cannot be combined with --serial or --boot');
+  process.exit(1);
+}
+if (serialPty === '' || (serialBridge && baud <= 0)) {
+  console.error('Error: --serial-pty needs a PATH and --baud must be positive');
+  process.exit(1);
+}
+const coverageOut = options.has('--coverage');
+const lcovPath = options.get('--lcov');
+const jsonOut = options.has('--json');
+const hostProfile = options.has('--host-profile');
+const vgaOut = options.get('--vga-out');
+const vgaFormat = options.get('--vga-format') ?? 'ppm';
+const vgaCapture = vgaOut !== undefined || options.has('--vga-frames') || options.has('--vga-format') || options.has('--vga-size');
+const vgaFrameLimit = numberOption('--vga-frames', 0);
+const vgaSizeMatch = /^(\d+)x(\d+)$/.exec(options.get('--vga-size') ?? '640x480');
+if (!vgaSizeMatch || Number(vgaSizeMatch[1]) === 0 || Number(vgaSizeMatch[2]) === 0) {
+  console.error(`Error: --vga-size expects WxH, got '${options.get('--vga-size')}'`);
+  process.exit(1);
+}
+if (vgaFormat !== 'ppm' && vgaFormat !== 'png' && vgaFormat !== 'raw') {
+  console.error(`Error: --vga-format expects ppm, png or raw, got '${vgaFormat}'`);
+  process.exit(1);
+}
+let mesh = GA144_MESH;
+if (options.has('--mesh')) {
+  try {
+    mesh = Mesh.parse(options.get('--mesh')!);
+  } catch (e) {
+    console.error(`Error: --mesh: ${(e as Error).message}`);
+    process.exit(1);
+  }
+}
+const vcdPath = options.get('--vcd');
+if (vcdPath !== undefined && !mesh.standard && !options.has('--vcd-nodes')) {
+  console.error('Error: --vcd on a non-standard mesh needs --vcd-nodes');
+  process.exit(1);
+}
+const vcdNodes = options.has('--vcd-nodes')
+  ? options.get('--vcd-nodes')!.split(',').map(Number)
+  : [...Object.keys(NODE_GPIO_PINS).map(Number), ...ANALOG_NODES].sort((a, b) => a - b);
+for (const c of vcdNodes) {
+  if (!mesh.validCoord(c)) {
+    console.error(`Error: --vcd-nodes has an invalid node '${options.get('--vcd-nodes')}'`);
+    process.exit(1);
+  }
+}
+const vcdIn = options.get('--vcd-in');
+const vcdPinMatch = /^(.+?)(?:@(\d+))?$/.exec(options.get('--vcd-pin') ?? '');
+if (vcdIn !== undefined && !vcdPinMatch) {
+  console.error('Error: --vcd-in needs --vcd-pin=SIGNAL[@NODE]');
+  process.exit(1);
+}
+if (vcdIn !== undefined && boot) {
+  console.error('Error: --vcd-in and --boot both drive the serial pin stream');
+  process.exit(1);
+}
+const sramLoad = options.get('--sram-load');
+const sramDump = options.get('--sram-dump');
+const sramMode = options.get('--sram') ?? (sramLoad !== undefined || sramDump !== undefined ? 'cluster' : undefined);
+if (sramMode !== undefined && sramMode !== 'cluster' && sramMode !== 'pins') {
+  console.error(`Error: --sram expects cluster or pins, got '${sramMode}'`);
+  process.exit(1);
+}
+const ethIn = options.get('--eth-in');
+const ethOut = options.get('--eth-out');
+const ethLoopback = options.has('--eth-loopback');
+if (ethIn !== undefined && ethLoopback) {
+  console.error('Error: --eth-in and --eth-loopback both drive the Rx pin');
+  process.exit(1);
+}
+const i2cMode = options.get('--i2c-mode') ?? 'fast';
+if (i2cMode !== 'standard' && i2cMode !== 'fast') {
+  console.error(`Error: --i2c-mode expects standard or fast, got '${i2cMode}'`);
+  process.exit(1);
+}
+const i2cSlaves: I2cSlave[] = [];
+for (const spec of options.get('--i2c')?.split(',') ?? []) {
+  const m = /^(sensor|eeprom)@([0-9a-f]{1,2})((?::[0-9a-f=]+)*)$/i.exec(spec);
+  const address = m ? parseInt(m[2], 16) : NaN;
+  const params = m?.[3] ? m[3].slice(1).split(':') : [];
+  const paramOk = (p: string) => (m![1] === 'eeprom' ? /^\d+$/.test(p) : /^[0-9a-f]{1,2}=[0-9a-f]{1,2}$/i.test(p));
+  if (!m || address > 0x7F || (m[1] === 'eeprom' && params.length > 1) || !params.every(paramOk)) {
+    console.error(`Error: bad --i2c device '${spec}' (expected sensor@ADDR[:REG=VAL...] or eeprom@ADDR[:SIZE])`);
+    process.exit(1);
+  }
+  if (m[1] === 'eeprom') {
+    i2cSlaves.push(new I2cEepromDevice(address, { size: params.length > 0 ? parseInt(params[0], 10) : undefined }));
+  } else {
+    const registers: Record<number, number> = {};
+    for (const p of params) {
+      const [reg, value] = p.split('=').map(x => parseInt(x, 16));
+      registers[reg] = value;
+    }
+    i2cSlaves.push(new I2cRegisterDevice(address, { registers }));
+  }
+}
+
+// ---- Compile ----
+
+const filePath = files[0];
+let source: string;
+try {
+  source = readFileSync(filePath, 'utf-8');
+} catch {
+  console.error(`Error: cannot read file '${filePath}'`);
+  process.exit(1);
+}
+
+let compiled: CompiledProgram;
+let sourceMap: SourceMapEntry[] | undefined;
+if (filePath.endsWith('.cube')) {
+  const result = compileCube(source);
+  compiled = result;
+  sourceMap = result.sourceMap;
+} else {
+  compiled = compile(source);
+}
+if (compiled.errors.length > 0) {
+  console.error(`\x1b[31m✗ ${filePath}: ${compiled.errors.length} error(s)\x1b[0m`);
+  for (const err of compiled.errors) {
+    const loc = err.line ? `:${err.line}${err.col ? ':' + err.col : ''}` : '';
+    console.error(`  ${filePath}${loc}: ${err.message}`);
+  }
+  process.exit(1);
+}
+if (!mesh.standard) {
+  const io = ['--boot', '--serial', '--serial-pty', '--serial-stdio', '--vcd-in', '--sram', '--sram-load', '--eth-in', '--eth-out',
+    '--eth-loopback', '--i2c', '--analog', '--audio', '--stimulus'].filter(f => options.has(f));
+  if ([...options.keys()].some(f => f.startsWith('--vga-'))) io.push('--vga-*');
+  if (io.length > 0) {
+    console.error(`Error: ${io.join(', ')}: only the 8x18 mesh has the GA144's I/O ring`);
+    process.exit(1);
+  }
+}
+const outside = compiled.nodes.filter(n => !mesh.validCoord(n.coord)).map(n => n.coord);
+if (outside.length > 0) {
+  console.error(`Error: nodes ${outside.join(', ')} are outside the ${mesh} mesh`);
+  process.exit(1);
+}
+if (lcovPath !== undefined && !sourceMap) {
+  console.error('Error: --lcov needs a CUBE source file (arrayForth has no source map)');
+  process.exit(1);
+}
+
+// ---- Run ----
+
+const CHUNK_STEPS = 100_000;
+
+const ga = new GA144('headless', mesh);
+ga.setRomData(ROM_DATA);
+ga.reset();
+ga.setLivelockWindow(livelockNS);
+ga.setCoverageEnabled(coverageOut || lcovPath !== undefined);
+// Nothing here reads the snapshot ring, so only node 708's pin writes are kept
+ga.setIoRingEnabled(false);
+const serialTap = serialOut ? ga.traceIoWrites([708]).trace : null;
+
+// VGA frames are written as they complete so long captures stay small in memory
+const vgaFrames: { index: number; timeNS: number; crc: string }[] = [];
+let vgaRawFd: number | null = null;
+if (vgaOut !== undefined) {
+  if (vgaFormat === 'raw') vgaRawFd = openSync(vgaOut, 'w');
+  else mkdirSync(vgaOut, { recursive: true });
+}
+const onVgaFrame = (frame: VgaFrame) => {
+  if (vgaFrameLimit > 0 && frame.index >= vgaFrameLimit) return;
+  vgaFrames.push({ index: frame.index, timeNS: frame.timeNS, crc: frame.crc.toString(16).padStart(8, '0') });
+  if (vgaOut === undefined) return;
+  const name = `frame-${frame.index.toString().padStart(5, '0')}`;
+  if (vgaRawFd !== null) writeSync(vgaRawFd, frame.rgb);
+  else if (vgaFormat === 'png') writeFileSync(join(vgaOut, `${name}.png`), encodePng(frame, deflateSync));
+  else writeFileSync(join(vgaOut, `${name}.ppm`), encodePpm(frame));
+};
+const vga = vgaCapture
+  ? new VgaFrameCapture(ga.ioBus, onVgaFrame, Number(vgaSizeMatch[1]), Number(vgaSizeMatch[2]))
+  : null;
+
+// The VCD is streamed to disk as the run goes; memory stays bounded
+let vcdFd: number | null = null;
+let vcd: VcdProbe | null = null;
+if (vcdPath !== undefined) {
+  const fd = openSync(vcdPath, 'w');
+  vcdFd = fd;
+  vcd = new VcdProbe(ga, new VcdWriter(text => writeSync(fd, text)), vcdNodes);
+}
+
+// Audio is streamed to disk; the WAV header gets its sizes at the end
+let audioFd: number | null = null;
+let audioWav: WavWriter | null = null;
+let audio: DacAudioCapture | null = null;
+if (audioPath !== undefined) {
+  try {
+    const fd = openSync(audioPath, 'w');
+    audioFd = fd;
+    const wav = new WavWriter(bytes => writeSync(fd, bytes), audioRate, audioNodes.length);
+    audioWav = wav;
+    audio = new DacAudioCapture(ga, { coords: audioNodes, sampleRate: audioRate, onFrames: s => wav.write(s) });
+  } catch (e) {
+    console.error(`Error: --audio: ${(e as Error).message}`);
+    process.exit(1);
+  }
+}
+
+// SRAM contents are not touched by chip reset, so load them once up front
+const sram = sramMode !== undefined ? new SramDevice({ mode: sramMode }) : null;
+if (sram) {
+  if (sramLoad !== undefined) {
+    try {
+      sram.load(readFileSync(sramLoad));
+    } catch {
+      console.error(`Error: cannot read file '${sramLoad}'`);
+      process.exit(1);
+    }
+  }
+  ga.attachDevice(sram);
+}
+
+// Tx frames are written as they are decoded
+let ethFd: number | null = null;
+let eth: EthernetPhyDevice | null = null;
+if (ethIn !== undefined || ethOut !== undefined || ethLoopback) {
+  const fd = ethOut !== undefined ? openSync(ethOut, 'w') : null;
+  ethFd = fd;
+  const pcap = fd !== null ? new PcapWriter(bytes => writeSync(fd, bytes)) : null;
+  eth = new EthernetPhyDevice({ loopback: ethLoopback, onFrame: f => pcap?.write(f.timeNS, f.data) });
+  ga.attachDevice(eth);
+  if (ethIn !== undefined) {
+    try {
+      const packets = parsePcap(readFileSync(ethIn));
+      const t0 = packets[0]?.timeNS ?? 0;
+      for (const p of packets) eth.enqueueFrame(p.data, p.timeNS - t0);
+    } catch (e) {
+      console.error(`Error: ${ethIn}: ${(e as Error).message}`);
+      process.exit(1);
+    }
+  }
+}
+
+// Stimulus files are merged into one schedule and read a chunk at a time
+const stimulusFds: number[] = [];
+let stimulus: StimulusDevice | null = null;
+for (const file of options.get('--stimulus')?.split(',') ?? []) {
+  let fd: number;
+  try {
+    fd = openSync(file, 'r');
+  } catch (e) {
+    console.error(`Error: ${file}: ${(e as Error).message}`);
+    process.exit(1);
+  }
+  stimulusFds.push(fd);
+  const events = stimulusFile((offset, length) => {
+    const buf = new Uint8Array(length);
+    return buf.subarray(0, readSync(fd, buf, 0, length, offset));
+  });
+  stimulus ??= new StimulusDevice();
+  // Errors surface mid-run, so name the file in them
+  stimulus.add({
+    *[Symbol.iterator]() {
+      try {
+        yield* events;
+      } catch (e) {
+        throw new Error(`${file}: ${(e as Error).message}`);
+      }
+    },
+  });
+}
+
+// Analog inputs are read through the file descriptor a chunk at a time
+const analogChannels: AnalogChannel[] = [];
+const analogFds: number[] = [];
+for (const spec of options.get('--analog')?.split(',') ?? []) {
+  const m = /^(\d+):(.+)$/.exec(spec);
+  if (!m) {
+    console.error(`Error: bad --analog input '${spec}' (expected NODE:FILE)`);
+    process.exit(1);
+  }
+  try {
+    const fd = openSync(m[2], 'r');
+    analogFds.push(fd);
+    const read: ByteReader = (offset, length) => {
+      const buf = new Uint8Array(length);
+      return buf.subarray(0, readSync(fd, buf, 0, length, offset));
+    };
+    const stream = /\.wav$/i.test(m[2]) ? wavStream(read) : csvStream(read, analogRate);
+    analogChannels.push({ coord: Number(m[1]), stream, loop: options.has('--analog-loop') });
+  } catch (e) {
+    console.error(`Error: ${m[2]}: ${(e as Error).message}`);
+    process.exit(1);
+  }
+}
+let analog: AnalogInputDevice | null = null;
+if (analogChannels.length > 0) {
+  try {
+    analog = new AnalogInputDevice({ channels: analogChannels });
+  } catch (e) {
+    console.error(`Error: ${(e as Error).message}`);
+    process.exit(1);
+  }
+  ga.attachDevice(analog);
+}
+
+let i2c: I2cBusDevice | null = null;
+if (i2cSlaves.length > 0) {
+  i2c = new I2cBusDevice({ mode: i2cMode });
+  try {
+    for (const slave of i2cSlaves) i2c.addSlave(slave);
+  } catch (e) {
+    console.error(`Error: ${(e as Error).message}`);
+    process.exit(1);
+  }
+  ga.attachDevice(i2c);
+}
+
+if (stimulus) {
+  try {
+    ga.attachDevice(stimulus);
+  } catch (e) {
+    console.error(`Error: ${(e as Error).message}`);
+    process.exit(1);
+  }
+}
+
+if (boot) {
+  const bytes = Array.from(buildBootStream(compiled.nodes).bytes);
+  ga.enqueueSerialBits(708, SerialBits.bootStreamBits(bytes, GA144.BOOT_BAUD));
+} else {
+  ga.load(compiled);
+}
+if (vcdIn !== undefined) {
+  const node = vcdPinMatch![2] !== undefined ? Number(vcdPinMatch![2]) : 708;
+  try {
+    const signal = findVcdSignal(parseVcd(readFileSync(vcdIn, 'utf-8')), vcdPinMatch![1]);
+    const { startNS, bits } = vcdToPinBits(signal);
+    ga.enqueueSerialBits(node, bits, startNS);
+  } catch (e) {
+    console.error(`Error: ${vcdIn}: ${(e as Error).message}`);
+    process.exit(1);
+  }
+}
+
+type StopReason = 'steps' | 'idle' | 'breakpoint' | 'deadlock' | 'livelock' | 'frames';
+let reason: StopReason = 'steps';
+let stall: StallReport | null = null;
+
+// Capture flushes count as output delivery ('post'), as postMessage does in the worker
+const profiler = hostProfile ? new HostProfiler(calibrateHostCosts()) : null;
+ga.setHostProfiler(profiler);
+profiler?.start(ga.getHostCounters());
+
+/** Run one chunk of steps; returns why the run stops, or null to go on. */
+function runChunk(): StopReason | null {
+  const before = ga.getTotalSteps();
+  try {
+    const t0 = performance.now();
+    const hit = ga.stepProgramN(Math.min(CHUNK_STEPS, maxSteps - before));
+    if (profiler) {
+      profiler.add('step', performance.now() - t0);
+      profiler.sampleQueueDepth(ga.getHostCounters().queueDepth);
+    }
+    if (hit) return 'breakpoint';
+  } catch (e) {
+    // A malformed stimulus line is only reached when its time comes
+    console.error(`Error: ${(e as Error).message}`);
+    process.exit(1);
+  }
+  const t1 = performance.now();
+  vcd?.flush();
+  vga?.flush();
+  profiler?.add('post', performance.now() - t1);
+  if (vga && vgaFrameLimit > 0 && vga.frames >= vgaFrameLimit) return 'frames';
+  const t2 = performance.now();
+  stall = ga.detectStall();
+  profiler?.add('stall', performance.now() - t2);
+  if (stall) return stall.kind;
+  // A chunk can end on device events alone; the chip is idle only once
+  // no device has input left to deliver
+  if (ga.getTotalSteps() === before && ga.getDevicePending() === 0) return 'idle';
+  return null;
+}
+
+if (serialBridge) {
+  reason = await runSerialBridge();
+} else {
+  while (ga.getTotalSteps() < maxSteps) {
+    const r = runChunk();
+    if (r !== null) {
+      reason = r;
+      break;
+    }
+  }
+}
+
+/**
+ * Serve node 708's serial port to a terminal: host bytes go to the RX pin
+ * at `baud`, and TX pin activity is decoded as it happens. The chip runs
+ * flat out (or paced with --realtime), and when every node is idle the run
+ * waits for input instead of ending. Once the input side closes (or on
+ * Ctrl-C) it ends when the last input byte has been delivered and TX has
+ * been quiet for 100 character times.
+ */
+async function runSerialBridge(): Promise<StopReason> {
+  let input: Readable;
+  let output: Writable;
+  if (serialPty !== undefined) {
+    const socat = spawn('socat', [`PTY,link=${serialPty},raw,echo=0`, 'STDIO'], { stdio: ['pipe', 'pipe', 'inherit'] });
+    socat.on('error', e => {
+      console.error(`Error: cannot start socat for --serial-pty: ${e.message}`);
+      process.exit(1);
+    });
+    socat.on('spawn', () => console.error(`serial: ${serialPty} at ${baud} baud`));
+    process.on('exit', () => socat.kill());
+    input = socat.stdout;
+    output = socat.stdin;
+  } else {
+    input = process.stdin;
+    output = process.stdout;
+  }
+
+  let closed = false;
+  let wake: (() => void) | null = null;
+  const arrival = () => new Promise<void>(resolve => { wake = resolve; });
+  const notify = () => { wake?.(); wake = null; };
+  input.on('data', (chunk: Buffer) => {
+    ga.sendSerialInput(Array.from(chunk), baud);
+    notify();
+  });
+  input.on('end', () => { closed = true; notify(); });
+  process.on('SIGINT', () => { closed = true; notify(); });
+
+  const decoder = new SerialDecoder(baud, byte => output.write(Uint8Array.of(byte)));
+  let lastTxNS = 0;
+  const unsubscribe = ga.ioBus.subscribe({ coords: [708] }, (_coord, value, timeNS) => {
+    if (value > 3) return;
+    decoder.write((value & 1) !== 0, timeNS);
+    lastTxNS = timeNS;
+  });
+  const quietNS = (1000 * 1e9) / baud;
+
+  // Guest time at wall-clock `startMs`, rebased after idle waits
+  let startMs = performance.now();
+  let startNS = ga.getGuestTimeNS();
+  let result: StopReason = 'steps';
+  while (ga.getTotalSteps() < maxSteps) {
+    const r = runChunk();
+    decoder.advance(ga.getGuestTimeNS());
+    if (closed && ga.getSerialInputPending() === 0 && ga.getGuestTimeNS() - lastTxNS > quietNS) {
+      result = 'idle';
+      break;
+    }
+    if (r === 'idle') {
+      if (closed) {
+        result = 'idle';
+        break;
+      }
+      await arrival();
+      startMs = performance.now();
+      startNS = ga.getGuestTimeNS();
+      continue;
+    }
+    if (r !== null) {
+      result = r;
+      break;
+    }
+    const aheadMs = realtime > 0 ? (ga.getGuestTimeNS() - startNS) / 1e6 / realtime - (performance.now() - startMs) : 0;
+    // Yield to let input in; sleep off any lead over the wall clock
+    await new Promise(resolve => (aheadMs >= 1 ? setTimeout(resolve, aheadMs) : setImmediate(resolve)));
+  }
+  unsubscribe();
+  input.destroy();
+  if (output !== process.stdout) output.end();
+  return result;
+}
+
+vga?.close();
+eth?.flush();
+if (ethFd !== null) closeSync(ethFd);
+for (const fd of analogFds) closeSync(fd);
+for (const fd of stimulusFds) closeSync(fd);
+if (vgaRawFd !== null) closeSync(vgaRawFd);
+
+const hostReport = profiler?.report(ga.getHostCounters());
+const snapshot = ga.getSnapshot();
+vcd?.close(snapshot.totalSimTimeNS);
+if (vcdFd !== null) closeSync(vcdFd);
+audio?.close(snapshot.totalSimTimeNS);
+if (audioFd !== null) {
+  writeSync(audioFd, audioWav!.header(), 0, 44, 0);
+  closeSync(audioFd);
+}
+const debug = ga.getDebugLogDelta(0);
+const serial = serialTap
+  ? SerialBits.decodeBits(
+    GA144.ioWritesToBitsFromBuffer(serialTap.writes, serialTap.timestamps, 0, serialTap.count, 708),
+    GA144.BOOT_BAUD,
+  )
+  : [];
+const exitCode = reason === 'deadlock' ? 2 : reason === 'livelock' ? 3 : 0;
+const coverage = ga.getCoverage();
+const coverageSummary = coverageOut ? summarizeCoverage(compiled.nodes, coverage) : undefined;
+
+if (sram && sramDump !== undefined) writeFileSync(sramDump, sram.dump());
+if (lcovPath !== undefined) {
+  writeFileSync(lcovPath, coverageToLcov(filePath, compiled.nodes, sourceMap!, coverage), 'utf-8');
+}
+
+// ---- JSON output mode ----
+
+// With the serial port on stdout, the report goes to stderr
+const report = serialStdio ? console.error : console.log;
+
+if (jsonOut) {
+  const out = {
+    file: filePath,
+    reason,
+    steps: snapshot.totalSteps,
+    simTimeNS: snapshot.totalSimTimeNS,
+    activeCount: snapshot.activeCount,
+    stall,
+    debug: debug.values.map((value, i) => ({ coord: debug.coords[i], value, timeNS: debug.timestamps[i] })),
+    serial: serialOut ? serial : undefined,
+    coverage: coverageSummary,
+    vgaFrames: vga ? vgaFrames : undefined,
+    sram: sram ? sram.snapshot() : undefined,
+    eth: eth ? eth.snapshot() : undefined,
+    i2c: i2c ? i2c.snapshot() : undefined,
+    stimulus: stimulus ? stimulus.snapshot() : undefined,
+    analog: analog ? analog.snapshot() : undefined,
+    audio: audio ? audio.snapshot() : undefined,
+    hostProfile: hostReport,
+  };
+  report(JSON.stringify(out, null, 2));
+  process.exit(exitCode);
+}
+
+// ---- Summary ----
+
+const pad = (c: number) => c.toString().padStart(3, '0');
+
+for (let i = 0; i < debug.values.length; i++) {
+  const v = debug.values[i];
+  report(`  [${(debug.timestamps[i] / 1e3).toFixed(3).padStart(12)} µs] ${pad(debug.coords[i])}: 0x${v.toString(16).padStart(5, '0')} ${v}`);
+}
+if (serialOut) {
+  process.stdout.write(String.fromCharCode(...serial));
+  if (serial.length > 0) process.stdout.write('\n');
+}
+
+if (coverageSummary) {
+  const pct = (hit: number, total: number) => (total === 0 ? '-' : `${Math.round((100 * hit) / total)}%`);
+  report('  \x1b[1mCoverage:\x1b[0m');
+  for (const c of coverageSummary) {
+    report(`    Node ${pad(c.coord)}: words ${c.wordsHit}/${c.words} (${pct(c.wordsHit, c.words)}), branches ${c.branchesHit}/${c.branches} (${pct(c.branchesHit, c.branches)})`);
+  }
+}
+if (lcovPath !== undefined) {
+  report(`  lcov written to ${lcovPath}`);
+}
+for (const f of vgaFrames) {
+  report(`  frame ${f.index.toString().padStart(5, '0')} @ ${(f.timeNS / 1e6).toFixed(3)} ms  crc32=${f.crc}`);
+}
+if (eth) {
+  const s = eth.snapshot() as { rxFrames: number; txFrames: number; txBytes: number; fcsErrors: number; firstTxNS: number | null; lastTxNS: number | null };
+  const spanNS = s.firstTxNS !== null && s.lastTxNS! > s.firstTxNS ? s.lastTxNS! - s.firstTxNS : 0;
+  const rate = spanNS > 0 ? `, ${((s.txBytes * 8 * 1e3) / spanNS).toFixed(2)} Mb/s` : '';
+  report(`  eth: ${s.rxFrames} frames in, ${s.txFrames} out (${s.txBytes} bytes${rate}), ${s.fcsErrors} FCS errors`);
+}
+if (audio) {
+  const s = audio.snapshot();
+  const peaks = s.peak.map(p => p.toFixed(3)).join('/');
+  report(`  audio: ${s.frames} frames (${(s.frames / s.sampleRate).toFixed(3)} s) at ${s.sampleRate} Hz from ${s.channels.join(',')}, ${s.writes} DAC writes, peak ${peaks}`);
+}
+if (stimulus) {
+  const s = stimulus.snapshot() as { sources: number; pending: number; applied: number };
+  report(`  stimulus: ${s.applied} pin events from ${s.sources} file(s), ${s.pending} with events left`);
+}
+if (i2c) {
+  const s = i2c.snapshot() as { mode: string; transfers: number; bytes: number; nacks: number; stretches: number; violations: Record<string, number> };
+  const bad = Object.entries(s.violations).filter(([, n]) => n > 0).map(([k, n]) => `${k}×${n}`);
+  report(`  i2c: ${s.transfers} transfers, ${s.bytes} bytes, ${s.nacks} NACKs, ${s.stretches} stretches, ${s.mode}-mode violations: ${bad.length > 0 ? bad.join(' ') : 'none'}`);
+}
+if (hostReport) {
+  const ms = (section: (typeof HOST_SECTIONS)[number]) => hostReport.sections[section];
+  report(`  host: ${hostReport.mips.toFixed(2)} MIPS, ${(hostReport.eventsPerSec / 1e6).toFixed(2)}M events/s, ${Math.round(hostReport.ioWritesPerSec)} IO writes/s, queue depth ${hostReport.queueDepth.toFixed(1)}, ${hostReport.guestSpeed.toFixed(4)}× real time`);
+  report(`  host ms: ${HOST_SECTIONS.map(s => `${s} ${ms(s).toFixed(1)}`).join(', ')} of ${hostReport.windowMS.toFixed(1)}`);
+}
+
+const summary = `${snapshot.totalSteps} steps, ${(snapshot.totalSimTimeNS / 1e3).toFixed(3)} µs simulated`;
+if (stall?.kind === 'deadlock') {
+  const chain = stall.cycle.map(pad).join(' → ') + (stall.cycleClosed ? ` → ${pad(stall.cycle[0])}` : ' → (unconnected port)');
+  console.error(`\x1b[31m✗ ${filePath}: deadlock after ${summary}\x1b[0m`);
+  console.error(`  wait cycle: ${chain}`);
+  console.error(`  stuck nodes: ${stall.coords.map(pad).join(', ')}`);
+} else if (stall?.kind === 'livelock') {
+  console.error(`\x1b[31m✗ ${filePath}: livelock after ${summary}\x1b[0m`);
+  console.error(`  spinning nodes: ${stall.coords.map(pad).join(', ')}`);
+} else {
+  report(`\x1b[32m✓ ${filePath}\x1b[0m — ${reason} after ${summary}`);
+}
+process.exit(exitCode);
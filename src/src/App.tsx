@@ -9,16 +9,20 @@ import { WysiwygEditor } from './ui/cube3d/WysiwygEditor';
 import { EmulatorPanel } from './ui/emulator/EmulatorPanel';
 import { CompileOutputPanel } from './ui/output/CompileOutputPanel';
 import { IoPanel } from './ui/output/IoPanel';
+import { WatchPanel } from './ui/watch/WatchPanel';
 import { useEmulator } from './hooks/useEmulator';
 import { readUrlSource, updateUrlSource } from './ui/urlSource';
 import { RecursePanel } from './ui/recurse/RecursePanel';
 import { ArrayForthViewer } from './ui/arrayforth/ArrayForthViewer';
 import { decompile } from './core/decompiler';
 import { useEditorStore } from './stores/editorStore';
+import { useEmulatorStore } from './stores/emulatorStore';
+import type { WatchSymbol } from './core/cube';
+
+const NO_WATCH_SYMBOLS: WatchSymbol[] = [];
 
 function App() {
   const {
-    snapshot,
     selectedCoord,
     isRunning,
     compileErrors,
@@ -35,10 +39,20 @@ function App() {
     selectNode,
     bootStreamBytes,
     emulatorError,
+    stall,
+    activity,
     sendSerialInput,
+    setDebugChannel,
+    setClockCounter,
+    setLivelockWindow,
+    setHostProfiling,
+    setWatches,
+    resetDebugLog,
     setLanguage,
   } = useEmulator();
 
+  // Chip output lives in the emulator store; panels select their own slices
+  const ready = useEmulatorStore(s => s.ready);
   const [activeTab, setActiveTab] = useState(1); // Default to Editor tab (index 1 now)
   const [urlSource, setUrlSource] = useState<string | null>(null);
   const editorSourceRef = useRef<string>('');
@@ -116,7 +130,7 @@ function App() {
     [compiledProgram]
   );
 
-  if (!snapshot) return null;
+  if (!ready) return null;
 
   return (
     <ThemeProvider theme={theme}>
@@ -126,11 +140,6 @@ function App() {
         onTabChange={setActiveTab}
         toolbar={
           <DebugToolbar
-            activeCount={snapshot.activeCount}
-            totalSteps={snapshot.totalSteps}
-            totalEnergyPJ={snapshot.totalEnergyPJ}
-            chipPowerMW={snapshot.chipPowerMW}
-            totalSimTimeNS={snapshot.totalSimTimeNS}
             language={language}
             isRunning={isRunning}
             onCompile={handleCompileButton}
@@ -143,6 +152,7 @@ function App() {
             onRun={run}
             onStop={stop}
             onReset={reset}
+            onSetHostProfiling={setHostProfiling}
           />
         }
         wysiwygTab={
@@ -182,12 +192,18 @@ function App() {
         }
         emulatorTab={
           <EmulatorPanel
-            nodeStates={snapshot.nodeStates}
-            nodeCoords={snapshot.nodeCoords}
+            activity={activity}
             selectedCoord={selectedCoord}
-            selectedNode={snapshot.selectedNode}
             sourceMap={sourceMap}
+            stall={stall}
             onNodeClick={selectNode}
+            onSetLivelockWindow={setLivelockWindow}
+            watchPanel={
+              <WatchPanel
+                symbols={cubeCompileResult?.watchSymbols ?? NO_WATCH_SYMBOLS}
+                onSetWatches={setWatches}
+              />
+            }
             compileOutput={
               <CompileOutputPanel
                 cubeResult={cubeCompileResult}
@@ -199,12 +215,10 @@ function App() {
         }
         ioTab={
           <IoPanel
-            ioWrites={snapshot.ioWrites}
-            ioWriteTimestamps={snapshot.ioWriteTimestamps}
-            ioWriteCount={snapshot.ioWriteCount}
-            ioWriteStart={snapshot.ioWriteStart}
-            ioWriteSeq={snapshot.ioWriteSeq}
             onSendSerialInput={sendSerialInput}
+            onSetDebugChannel={setDebugChannel}
+            onSetClockCounter={setClockCounter}
+            onClearDebugLog={resetDebugLog}
           />
         }
       />
@@ -8,7 +8,7 @@ import { SerialBits } from './serial';
 import { ROM_DATA } from './rom-data';
 import { buildBootStream } from './bootstream';
 
-import { ResolutionTracker } from '../ui/emulator/vgaResolution';
+import { VgaDecoder } from '../ui/emulator/vgaDecoder';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = dirname(__filename);
@@ -23,13 +23,13 @@ function bootAndDetect(ga: GA144, compiled: ReturnType<typeof compileCube>) {
   ga.enqueueSerialBits(708, SerialBits.bootStreamBits(
     Array.from(buildBootStream(compiled.nodes).bytes), GA144.BOOT_BAUD));
 
-  const tracker = new ResolutionTracker();
+  const tracker = new VgaDecoder();
   const CHUNK = 500_000;
   const MAX_STEPS = 50_000_000;
   for (let stepped = 0; stepped < MAX_STEPS; stepped += CHUNK) {
     ga.stepUntilDone(CHUNK);
     const s = ga.getSnapshot();
-    tracker.process(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
+    tracker.decode(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
     if (tracker.complete) break;
   }
   return tracker.getResolution();
@@ -83,7 +83,7 @@ describe('CH.cube Swiss flag sample', () => {
 
     // Mimic the worker run loop: step in 50K chunks, check active count,
     // advance idle time when all nodes suspended (like the worker does)
-    const tracker = new ResolutionTracker();
+    const tracker = new VgaDecoder();
     const CHUNK = 500_000;
     const MAX_CHUNKS = 100; // 50M steps max
     let totalIdleAdvances = 0;
@@ -91,7 +91,7 @@ describe('CH.cube Swiss flag sample', () => {
     for (let c = 0; c < MAX_CHUNKS; c++) {
       ga.stepProgramN(CHUNK);
       const s = ga.getSnapshot();
-      tracker.process(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
+      tracker.decode(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
       if (ga.getActiveCount() === 0) {
         ga.advanceIdleTime(50 * 1e6); // 50ms in ns, like the worker
         totalIdleAdvances++;
@@ -130,13 +130,13 @@ describe('CH.cube Swiss flag sample', () => {
       Array.from(buildBootStream(compiled.nodes).bytes), GA144.BOOT_BAUD));
 
     // Process incrementally after the double-load
-    const tracker = new ResolutionTracker();
+    const tracker = new VgaDecoder();
     const CHUNK = 500_000;
     const MAX_STEPS = 50_000_000;
     for (let stepped = 0; stepped < MAX_STEPS; stepped += CHUNK) {
       ga.stepUntilDone(CHUNK);
       const s = ga.getSnapshot();
-      tracker.process(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
+      tracker.decode(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
       if (tracker.complete) break;
     }
 
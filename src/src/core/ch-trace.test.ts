@@ -12,10 +12,7 @@ import {
   readIoWrite, readIoTimestamp, taggedCoord,
   isHsync, isVsync,
 } from '../ui/emulator/vgaResolution';
-import {
-  renderIoWrites, createRenderState,
-} from '../ui/emulator/vgaRenderer';
-import { ResolutionTracker } from '../ui/emulator/vgaResolution';
+import { VgaDecoder } from '../ui/emulator/vgaDecoder';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = dirname(__filename);
@@ -35,13 +32,13 @@ function bootGA() {
 
 /** Run until first complete frame, collecting all IO writes incrementally. */
 function collectFirstFrame(ga: GA144) {
-  const tracker = new ResolutionTracker();
+  const tracker = new VgaDecoder();
   const CHUNK = 500_000;
   const MAX_STEPS = 80_000_000;
   for (let stepped = 0; stepped < MAX_STEPS; stepped += CHUNK) {
     ga.stepUntilDone(CHUNK);
     const s = ga.getSnapshot();
-    tracker.process(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
+    tracker.decode(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
     if (tracker.complete) break;
   }
   return { tracker, snapshot: ga.getSnapshot() };
@@ -135,13 +132,9 @@ describe('Node 217 sync timing investigation', () => {
 
     const texW = 640, texH = 480;
     const texData = new Uint8Array(texW * texH * 4);
-    const state = createRenderState();
+    const decoder = new VgaDecoder({ data: texData, width: texW, height: texH });
 
-    renderIoWrites(
-      state, texData, texW, texH,
-      s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq,
-      true, s.ioWriteTimestamps
-    );
+    decoder.decode(s.ioWrites, s.ioWriteCount, s.ioWriteStart, s.ioWriteSeq, s.ioWriteTimestamps);
 
     // Measure R, G, B left/right edges per row
     type Edge = { left: number; right: number };
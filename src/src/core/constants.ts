@@ -38,6 +38,15 @@ export const PORT = {
   DATA:  0x141,
 } as const;
 
+// Emulator-only extension ports. These addresses decode to nothing on a
+// real F18A (reads return the unmapped default, writes are dropped), so
+// guest code can use them for instrumentation without affecting hardware
+// builds beyond the cost of the store itself.
+export const EMU_PORT = {
+  DEBUG: 0x1FF,   // write-only: append T to the debug log
+  CLOCK: 0x1FE,   // read-only: node time counter (see ClockCounterMode)
+} as const;
+
 // Named addresses for the assembler
 export const NAMED_ADDRESSES: Record<string, number> = {
   right:  0x1D5,
@@ -117,7 +126,8 @@ export const NODE_GPIO_PINS: Record<number, number> = {
   300: 2, 500: 1, 600: 1,
 };
 
-// Convert node coordinate (YXX) to linear index (0-143)
+// Convert node coordinate (YXX) to linear index (0-143) on the standard
+// 8x18 layout; chips with other geometries use their Mesh (mesh.ts)
 export function coordToIndex(coord: number): number {
   return Math.floor(coord / 100) * 18 + (coord % 100);
 }
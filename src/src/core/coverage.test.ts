@@ -0,0 +1,87 @@
+/**
+ * Tests for guest code coverage bitmaps and lcov export.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { NodeCoverage, summarizeCoverage, coverageToLcov } from './coverage';
+
+// Line 4 loops twice around line 5; line 8 blocks forever, so line 10
+// never runs.
+const SOURCE = `#include std
+node 404
+/\\
+std.loop{n=2}
+/\\ std.send{port=0x1FF, value=1}
+/\\ std.again{}
+/\\
+std.recv{port=0x1D5, value=x}
+/\\
+std.send{port=0x1FF, value=x}
+`;
+
+function run(enable: boolean) {
+  const compiled = compileCube(SOURCE);
+  expect(compiled.errors).toHaveLength(0);
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  ga.setCoverageEnabled(enable);
+  ga.load(compiled);
+  ga.stepProgramN(5000);
+  return { ga, compiled };
+}
+
+describe('NodeCoverage', () => {
+  it('folds RAM mirrors and ignores port execution', () => {
+    const cov = new NodeCoverage();
+    cov.markSlot(0x45, 2);
+    cov.markSlot(0x15D, 0);
+    cov.markBranch(0x05, 1, false);
+    expect(cov.slots[0x05]).toBe(0b100);
+    expect(cov.slots.reduce((a, b) => a + b, 0)).toBe(4);
+    expect(cov.branches[0x05]).toBe(0b1000);
+  });
+});
+
+describe('GA144 coverage', () => {
+  it('is off by default', () => {
+    expect(run(false).ga.getCoverage().size).toBe(0);
+  });
+
+  it('records executed words and both outcomes of a counted loop', () => {
+    const { ga, compiled } = run(true);
+    const [summary] = summarizeCoverage(compiled.nodes, ga.getCoverage());
+    expect(summary.coord).toBe(404);
+    expect(summary.wordsHit).toBeGreaterThan(0);
+    expect(summary.wordsHit).toBeLessThan(summary.words);
+    expect(summary.branches).toBeGreaterThanOrEqual(2);
+    expect(summary.branchesHit).toBeGreaterThanOrEqual(2);
+  });
+
+  it('reset clears bitmaps but keeps coverage enabled', () => {
+    const { ga } = run(true);
+    ga.reset();
+    const cov = ga.getCoverage().get(404)!;
+    expect(cov).toBeDefined();
+    expect(cov.slots.every(b => b === 0)).toBe(true);
+  });
+
+  it('exports lcov line and branch records through the source map', () => {
+    const { ga, compiled } = run(true);
+    const lcov = coverageToLcov('test.cube', compiled.nodes, compiled.sourceMap!, ga.getCoverage());
+    const lines = lcov.trim().split('\n');
+    expect(lines[0]).toBe('TN:');
+    expect(lines[1]).toBe('SF:test.cube');
+    expect(lines).toContain('DA:4,1');
+    expect(lines).toContain('DA:5,1');
+    expect(lines).toContain('DA:8,1');
+    expect(lines).toContain('DA:10,0');
+    // The loop's `next` both jumped back and fell through
+    const brda = lines.filter(l => l.startsWith('BRDA:'));
+    expect(brda.some(l => l.endsWith(',0,1'))).toBe(true);
+    expect(brda.some(l => l.endsWith(',1,1'))).toBe(true);
+    expect(lines[lines.length - 1]).toBe('end_of_record');
+  });
+});
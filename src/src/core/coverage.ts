@@ -0,0 +1,174 @@
+/**
+ * Guest code coverage.
+ *
+ * Each node can carry a NodeCoverage: one byte per instruction word with a
+ * bit per executed slot, and one byte per word recording taken/not-taken
+ * outcomes of `if`, `-if` and `next`. F18ANode only touches it behind a
+ * null check, so coverage costs nothing when it is off.
+ *
+ * Words are indexed with regionIndex(), so RAM (0x00–0x3F) and ROM
+ * (0x80–0xBF) mirrors collapse onto their physical word. Code executed
+ * from a port is not tracked.
+ */
+import { isPortAddr, regionIndex } from './constants';
+import { disassembleWord } from './disassembler';
+import type { CompiledNode } from './types';
+import type { SourceMapEntry } from './cube/emitter';
+
+/** Size of the per-node bitmaps (covers regionIndex() of RAM and ROM). */
+export const COVERAGE_WORDS = 0xC0;
+
+const BRANCH_OPCODES = new Set(['if', '-if', 'next']);
+
+export class NodeCoverage {
+  /** Bit s set: slot s of the word executed. */
+  readonly slots = new Uint8Array(COVERAGE_WORDS);
+  /** Bit 2s: branch in slot s taken; bit 2s+1: not taken. */
+  readonly branches = new Uint8Array(COVERAGE_WORDS);
+
+  markSlot(addr: number, slot: number): void {
+    if (isPortAddr(addr)) return;
+    this.slots[regionIndex(addr)] |= 1 << slot;
+  }
+
+  markBranch(addr: number, slot: number, taken: boolean): void {
+    if (isPortAddr(addr)) return;
+    this.branches[regionIndex(addr)] |= 1 << (2 * slot + (taken ? 0 : 1));
+  }
+
+  reset(): void {
+    this.slots.fill(0);
+    this.branches.fill(0);
+  }
+}
+
+/** Per-node counts for a quick textual summary. */
+export interface CoverageSummary {
+  coord: number;
+  wordsHit: number;
+  words: number;
+  branchesHit: number;
+  branches: number;
+}
+
+/** A static branch site: the slot of a word holding if/-if/next. */
+interface BranchSite {
+  addr: number;
+  slot: number;
+}
+
+function branchSites(node: CompiledNode): BranchSite[] {
+  const sites: BranchSite[] = [];
+  for (let addr = 0; addr < node.len; addr++) {
+    const word = node.mem[addr];
+    if (word === null || word === undefined) continue;
+    const { slots } = disassembleWord(word);
+    for (let slot = 0; slot < 4; slot++) {
+      const s = slots[slot];
+      if (s && BRANCH_OPCODES.has(s.opcode)) sites.push({ addr, slot });
+    }
+  }
+  return sites;
+}
+
+function branchOutcomes(cov: NodeCoverage, site: BranchSite): [boolean, boolean] {
+  const bits = cov.branches[site.addr];
+  return [(bits & (1 << (2 * site.slot))) !== 0, (bits & (1 << (2 * site.slot + 1))) !== 0];
+}
+
+/** Summarize coverage of each compiled node's RAM image. */
+export function summarizeCoverage(
+  nodes: CompiledNode[],
+  coverage: Map<number, NodeCoverage>,
+): CoverageSummary[] {
+  const out: CoverageSummary[] = [];
+  for (const node of nodes) {
+    const cov = coverage.get(node.coord);
+    if (!cov) continue;
+    let wordsHit = 0;
+    for (let addr = 0; addr < node.len; addr++) {
+      if (cov.slots[addr] !== 0) wordsHit++;
+    }
+    const sites = branchSites(node);
+    let branchesHit = 0;
+    for (const site of sites) {
+      const [taken, notTaken] = branchOutcomes(cov, site);
+      if (taken) branchesHit++;
+      if (notTaken) branchesHit++;
+    }
+    out.push({ coord: node.coord, wordsHit, words: node.len, branchesHit, branches: sites.length * 2 });
+  }
+  return out;
+}
+
+/**
+ * Render coverage as an lcov tracefile for one CUBE source file.
+ *
+ * Every source map entry owns the words from its address up to the next
+ * entry of the same node; entries that emitted no code are skipped. A line
+ * counts as hit when any slot in any word it owns executed. Branch sites
+ * inside a line's words become BRDA records: branch 0 is taken, branch 1
+ * falls through, and `-` marks a site whose word never executed.
+ */
+export function coverageToLcov(
+  sourcePath: string,
+  nodes: CompiledNode[],
+  sourceMap: SourceMapEntry[],
+  coverage: Map<number, NodeCoverage>,
+): string {
+  const lineHits = new Map<number, number>();
+  const lineBranches = new Map<number, { taken: boolean; notTaken: boolean; executed: boolean }[]>();
+
+  for (const node of nodes) {
+    const cov = coverage.get(node.coord);
+    if (!cov) continue;
+    const entries = sourceMap
+      .filter(e => e.coord === node.coord)
+      .sort((a, b) => a.addr - b.addr);
+    const sites = branchSites(node);
+
+    for (let i = 0; i < entries.length; i++) {
+      const entry = entries[i];
+      const end = i + 1 < entries.length ? entries[i + 1].addr : Math.max(entry.addr + 1, node.len);
+      if (end <= entry.addr) continue; // emitted no code (e.g. #include)
+      let hit = false;
+      for (let addr = entry.addr; addr < end && addr < COVERAGE_WORDS; addr++) {
+        if (cov.slots[addr] !== 0) hit = true;
+      }
+      lineHits.set(entry.line, Math.max(lineHits.get(entry.line) ?? 0, hit ? 1 : 0));
+
+      for (const site of sites) {
+        if (site.addr < entry.addr || site.addr >= end) continue;
+        const [taken, notTaken] = branchOutcomes(cov, site);
+        const executed = (cov.slots[site.addr] & (1 << site.slot)) !== 0;
+        const list = lineBranches.get(entry.line) ?? [];
+        list.push({ taken, notTaken, executed });
+        lineBranches.set(entry.line, list);
+      }
+    }
+  }
+
+  const out: string[] = ['TN:', `SF:${sourcePath}`];
+  const lines = [...lineHits.keys()].sort((a, b) => a - b);
+  let branchesFound = 0;
+  let branchesHit = 0;
+  for (const line of lines) {
+    const branches = lineBranches.get(line) ?? [];
+    branches.forEach((b, block) => {
+      const fmt = (v: boolean) => (b.executed ? (v ? '1' : '0') : '-');
+      out.push(`BRDA:${line},${block},0,${fmt(b.taken)}`);
+      out.push(`BRDA:${line},${block},1,${fmt(b.notTaken)}`);
+      branchesFound += 2;
+      branchesHit += (b.taken ? 1 : 0) + (b.notTaken ? 1 : 0);
+    });
+  }
+  if (branchesFound > 0) {
+    out.push(`BRF:${branchesFound}`);
+    out.push(`BRH:${branchesHit}`);
+  }
+  for (const line of lines) out.push(`DA:${line},${lineHits.get(line)}`);
+  out.push(`LF:${lines.length}`);
+  out.push(`LH:${lines.filter(l => lineHits.get(l)! > 0).length}`);
+  out.push('end_of_record');
+  return out.join('\n') + '\n';
+}
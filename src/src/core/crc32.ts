@@ -0,0 +1,18 @@
+/**
+ * CRC-32 (IEEE 802.3) — the checksum of Ethernet frames, PNG chunks and
+ * zlib streams.
+ */
+
+const CRC_TABLE = new Uint32Array(256);
+for (let n = 0; n < 256; n++) {
+  let c = n;
+  for (let k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320 ^ (c >>> 1) : c >>> 1;
+  CRC_TABLE[n] = c >>> 0;
+}
+
+/** CRC-32 of `data`; pass a previous result as `crc` to continue it. */
+export function crc32(data: Uint8Array, crc: number = 0): number {
+  let c = ~crc >>> 0;
+  for (let i = 0; i < data.length; i++) c = CRC_TABLE[(c ^ data[i]) & 0xFF] ^ (c >>> 8);
+  return ~c >>> 0;
+}
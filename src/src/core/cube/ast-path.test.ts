@@ -1,7 +1,7 @@
 import { describe, it, expect } from 'vitest';
 import { tokenizeCube } from './tokenizer';
 import { parseCube } from './parser';
-import { indexAst, getItemAtPath, getParentPath, getItemIndex, itemPath, clausePath, argPath, termPath } from './ast-path';
+import { indexAst, getItemAtPath, getParentPath, getItemIndex, itemPath, clausePath, argPath, termPath, hashSubtree } from './ast-path';
 import type { CubeProgram, Application } from './ast';
 
 function parse(source: string): CubeProgram {
@@ -131,3 +131,14 @@ describe('getItemIndex', () => {
     expect(getItemIndex('i2.c1.i3')).toBe(3);
   });
 });
+
+describe('hashSubtree', () => {
+  it('ignores source locations but not structure', () => {
+    const a = parse('plus{a=1, b=2, c=x}');
+    const moved = parse('\n\n  plus{a=1, b=2, c=x}');
+    const changed = parse('plus{a=1, b=3, c=x}');
+    expect(hashSubtree(moved.conjunction.items[0])).toBe(hashSubtree(a.conjunction.items[0]));
+    expect(hashSubtree(changed.conjunction.items[0])).not.toBe(hashSubtree(a.conjunction.items[0]));
+    expect(hashSubtree({ name: 'x' })).not.toBe(hashSubtree({ name: 'y' }));
+  });
+});
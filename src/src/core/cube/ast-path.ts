@@ -33,6 +33,54 @@ export function variantPath(parent: string, index: number): string {
   return `${parent}.t${index}`;
 }
 
+/** Encode a parameter index within a predicate definition. */
+export function paramPath(parent: string, index: number): string {
+  return `${parent}.p${index}`;
+}
+
+/** Encode a field index within a type definition variant. */
+export function fieldPath(parent: string, index: number): string {
+  return `${parent}.f${index}`;
+}
+
+/**
+ * Structural hash of an AST subtree. Source locations are ignored, so a
+ * subtree keeps its hash when text edits elsewhere shift its lines. Two
+ * 32-bit FNV-1a lanes keep accidental collisions out of cache keys.
+ */
+export function hashSubtree(node: unknown): string {
+  let h1 = 0x811c9dc5;
+  let h2 = 0x01000193;
+  const mix = (text: string) => {
+    for (let i = 0; i < text.length; i++) {
+      const c = text.charCodeAt(i);
+      h1 = Math.imul(h1 ^ c, 0x01000193);
+      h2 = Math.imul(h2 ^ c, 0x5bd1e995);
+    }
+  };
+  const walk = (value: unknown) => {
+    if (Array.isArray(value)) {
+      mix('[');
+      for (const v of value) walk(v);
+      mix(']');
+    } else if (value !== null && typeof value === 'object') {
+      mix('{');
+      for (const [key, v] of Object.entries(value)) {
+        if (key === 'loc') continue;
+        mix(key);
+        mix(':');
+        walk(v);
+      }
+      mix('}');
+    } else {
+      mix(typeof value === 'string' ? `"${value}"` : String(value));
+      mix(',');
+    }
+  };
+  walk(node);
+  return (h1 >>> 0).toString(36) + '.' + (h2 >>> 0).toString(36);
+}
+
 /** Type for any AST node we might want to reference. */
 export type AstNode = ConjunctionItem | Term | ArgBinding | Conjunction;
 
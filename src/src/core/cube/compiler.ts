@@ -8,8 +8,8 @@ import { resolve } from './resolver';
 import type { ResolvedSymbol } from './resolver';
 import { typeCheck } from './typechecker';
 import { allocateNodes } from './allocator';
-import { mapVariables } from './varmapper';
-import type { VariableMap } from './varmapper';
+import { mapVariables, listWatchSymbols } from './varmapper';
+import type { VariableMap, WatchSymbol } from './varmapper';
 import { emitCode } from './emitter';
 import type { SourceMapEntry } from './emitter';
 import type { CubeProgram, ConjunctionItem } from './ast';
@@ -18,6 +18,8 @@ import type { CompiledProgram, CompiledNode, CompileError } from '../types';
 export interface CubeCompileResult extends CompiledProgram {
   symbols?: Map<string, ResolvedSymbol>;
   variables?: VariableMap;
+  /** RAM variables and constructor fields of every node, for the watch panel */
+  watchSymbols?: WatchSymbol[];
   sourceMap?: SourceMapEntry[];
   nodeCoord?: number;
   warnings: CompileError[];
@@ -87,6 +89,7 @@ export function compileCube(source: string): CubeCompileResult {
   const allErrors: CompileError[] = [];
   const allWarnings: CompileError[] = [];
   const allSourceMap: SourceMapEntry[] = [];
+  const allWatchSymbols: WatchSymbol[] = [];
   let lastSymbols: Map<string, ResolvedSymbol> | undefined;
   let lastVarMap: VariableMap | undefined;
 
@@ -118,6 +121,7 @@ export function compileCube(source: string): CubeCompileResult {
     allErrors.push(...emitErrors);
     if (warnings) allWarnings.push(...warnings);
     if (sourceMap) allSourceMap.push(...sourceMap);
+    allWatchSymbols.push(...listWatchSymbols(varMap, plan.nodeCoord));
     lastSymbols = resolved.symbols;
     lastVarMap = varMap;
   }
@@ -128,6 +132,7 @@ export function compileCube(source: string): CubeCompileResult {
     warnings: allWarnings,
     symbols: lastSymbols,
     variables: lastVarMap,
+    watchSymbols: allErrors.length > 0 ? undefined : allWatchSymbols,
     sourceMap: allSourceMap.length > 0 ? allSourceMap : undefined,
     nodeCoord: nodeGroups.length === 1 ? nodeGroups[0].coord : undefined,
   };
@@ -19,6 +19,8 @@ import { analyzeClauses } from './clause-analysis';
 // ---- Source map entry: maps F18A address to CUBE source location ----
 
 export interface SourceMapEntry {
+  /** Node the code was emitted for; addr is a word address in its RAM. */
+  coord: number;
   addr: number;
   line: number;
   col: number;
@@ -35,6 +37,7 @@ interface EmitContext {
   errors: CompileError[];
   warnings: CompileError[];
   sourceMap: SourceMapEntry[];
+  nodeCoord: number;
   /** Label to jump to when the current clause/guard fails */
   failLabel?: string;
   /** Counter for generating unique labels */
@@ -70,6 +73,7 @@ export function emitCode(
     errors: [],
     warnings: [],
     sourceMap: [],
+    nodeCoord: plan.nodeCoord,
     labelCounter: 0,
   };
 
@@ -159,6 +163,7 @@ function emitItem(ctx: EmitContext, item: ConjunctionItem): void {
     case 'application':
       if (item.functor !== '__node') {
         ctx.sourceMap.push({
+          coord: ctx.nodeCoord,
           addr: ctx.builder.getLocationCounter(),
           line: item.loc.line,
           col: item.loc.col,
@@ -169,6 +174,7 @@ function emitItem(ctx: EmitContext, item: ConjunctionItem): void {
       break;
     case 'unification':
       ctx.sourceMap.push({
+        coord: ctx.nodeCoord,
         addr: ctx.builder.getLocationCounter(),
         line: item.loc.line,
         col: item.loc.col,
@@ -528,7 +534,7 @@ function emitConstructorApp(ctx: EmitContext, app: Application, sym: ResolvedSym
   }
 
   // Allocate a contiguous block for fields (compile-time allocation)
-  const baseAddr = allocateFields(ctx.varMap, fields.length);
+  const baseAddr = allocateFields(ctx.varMap, fields.map(f => `${app.functor}.${f}`));
 
   // Store each field value at base+i using explicit address per field
   for (let i = 0; i < fields.length; i++) {
@@ -5,4 +5,4 @@ export { parseCube } from './parser';
 export type { CubeProgram } from './ast';
 export type { SourceMapEntry } from './emitter';
 export type { ResolvedSymbol } from './resolver';
-export type { VariableMap } from './varmapper';
+export type { VariableMap, WatchSymbol } from './varmapper';
@@ -26,6 +26,16 @@ export interface VariableMap {
   nextRamAddr: number;
   /** Next available field storage address (allocated upward from 0x20) */
   nextFieldAddr: number;
+  /** Field words allocated so far, named `constructor.field` */
+  fields: { name: string; addr: number }[];
+}
+
+/** A RAM word the debugger can watch: a variable or constructor field. */
+export interface WatchSymbol {
+  coord: number;
+  name: string;
+  addr: number;
+  kind: 'var' | 'field';
 }
 
 export function mapVariables(variableNames: Set<string>): VariableMap {
@@ -45,12 +55,26 @@ export function mapVariables(variableNames: Set<string>): VariableMap {
     nextRamAddr--;
   }
 
-  return { vars, nextRamAddr, nextFieldAddr: 0x20 };
+  return { vars, nextRamAddr, nextFieldAddr: 0x20, fields: [] };
 }
 
-/** Allocate a contiguous block of RAM for constructor fields. Returns the base address. */
-export function allocateFields(varMap: VariableMap, count: number): number {
+/** Allocate a contiguous block of RAM for constructor fields, one word per
+ *  name. Returns the base address. */
+export function allocateFields(varMap: VariableMap, names: string[]): number {
   const base = varMap.nextFieldAddr;
-  varMap.nextFieldAddr += count;
+  names.forEach((name, i) => varMap.fields.push({ name, addr: base + i }));
+  varMap.nextFieldAddr += names.length;
   return base;
 }
+
+/** RAM-resident variables and fields of one node's program, by address. */
+export function listWatchSymbols(varMap: VariableMap, coord: number): WatchSymbol[] {
+  const symbols: WatchSymbol[] = [];
+  for (const [name, m] of varMap.vars) {
+    if (m.location === VarLocation.RAM && m.ramAddr !== undefined) {
+      symbols.push({ coord, name, addr: m.ramAddr, kind: 'var' });
+    }
+  }
+  for (const f of varMap.fields) symbols.push({ coord, name: f.name, addr: f.addr, kind: 'field' });
+  return symbols.sort((a, b) => a.addr - b.addr);
+}
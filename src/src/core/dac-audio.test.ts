@@ -0,0 +1,70 @@
+/**
+ * Tests for DAC audio capture: level reconstruction, channel interleaving
+ * and band-limited resampling.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { coordToIndex } from './constants';
+import { DacAudioCapture } from './dac-audio';
+
+/** io value that sets the DAC to `level` in [-1, 1). */
+function dac(level: number): number {
+  return (Math.round(level * 256) + 256) ^ 0x155;
+}
+
+function capture(coords?: number[]) {
+  const ga = new GA144('test');
+  const out: number[] = [];
+  const audio = new DacAudioCapture(ga, { coords, onFrames: (s, frames) => { for (let i = 0; i < frames * (coords?.length ?? 1); i++) out.push(s[i]); } });
+  const write = (coord: number, level: number, timeNS: number) => ga.ioBus.publish(coordToIndex(coord), dac(level), timeNS, timeNS);
+  return { audio, out, write };
+}
+
+describe('DacAudioCapture', () => {
+  it('holds DAC levels between writes at the output rate', () => {
+    const { audio, out, write } = capture();
+    write(117, 0.5, 0);
+    write(117, -0.25, 5_000_000);
+    audio.close(10_000_000);
+
+    expect(out).toHaveLength(480);
+    // Half the filter still sees the silence before the first write
+    expect(out[0]).toBeGreaterThan(0.2);
+    expect(out[0]).toBeLessThan(0.4);
+    expect(out[100]).toBeCloseTo(0.5, 3);
+    expect(out[300]).toBeCloseTo(-0.25, 3);
+    expect(out[479]).toBeCloseTo(-0.25, 3);
+    expect(audio.snapshot()).toMatchObject({ frames: 480, writes: 2, channels: [117] });
+  });
+
+  it('interleaves channels and keeps sub-sample edge timing', () => {
+    const { audio, out, write } = capture([617, 717]);
+    write(617, 0.5, 0);
+    write(717, -0.5, 0);
+    // A 1 kHz square on 717 whose edges fall between output samples
+    for (let i = 1; i < 20; i++) write(717, i % 2 === 0 ? -0.5 : 0.5, i * 500_000 + 7_000);
+    audio.close(10_000_000);
+
+    expect(out).toHaveLength(2 * 480);
+    const left = out.filter((_, i) => i % 2 === 0);
+    const right = out.filter((_, i) => i % 2 === 1);
+    expect(left[200]).toBeCloseTo(0.5, 3);
+    // The edge at 1.007 ms lies between samples 48 (1.000 ms) and 49
+    expect(right[48 - 8]).toBeCloseTo(0.5, 2);
+    expect(right[48 + 8]).toBeCloseTo(-0.5, 2);
+    expect(Math.abs(right[48] + right[49])).toBeLessThan(0.6);
+    const mean = right.slice(48, 432).reduce((a, b) => a + b, 0) / 384;
+    expect(Math.abs(mean)).toBeLessThan(0.02);
+  });
+
+  it('rejects tones above the output Nyquist rate instead of aliasing them', () => {
+    const { audio, out, write } = capture();
+    // 30 kHz square, which point sampling at 48 kHz would fold to 18 kHz
+    const half = 1e9 / 60_000;
+    for (let i = 0; i < 600; i++) write(117, i % 2 === 0 ? 0.5 : -0.5, i * half);
+    audio.close(10_000_000);
+    const rms = Math.sqrt(out.slice(40, 440).reduce((a, b) => a + b * b, 0) / 400);
+    expect(rms).toBeLessThan(0.03);
+    expect(() => new DacAudioCapture(new GA144('test'), { coords: [708], onFrames: () => {} })).toThrow('has no DAC');
+  });
+});
@@ -0,0 +1,182 @@
+/**
+ * DAC audio capture — reconstructs the analog output of DAC nodes from
+ * their io writes and resamples it to an audio rate.
+ *
+ * Each write sets the node's 9-bit DAC (XOR encoding removed) at the
+ * write's jittered time, and the output holds until the next write. The
+ * held waveform is integrated exactly into bins at `oversample` times the
+ * output rate, so edges between output samples keep their timing; a
+ * Blackman-windowed sinc low-pass then decimates to the output rate.
+ * Mid-scale (code 256) is silence and full scale is ±1.
+ *
+ * Each node is one output channel. Frames are handed to `onFrames` in
+ * blocks, interleaved, as soon as every channel has them — to a WavWriter
+ * headless, or to an audio worklet's queue in the browser.
+ */
+import type { GA144 } from './ga144';
+import { ANALOG_NODES } from './constants';
+
+const DAC_XOR = 0x155;
+/** Filter half-width in output samples. */
+const HALF_TAPS = 16;
+/** Nodes that fall this far behind the one writing are advanced (holding). */
+const SLACK_NS = 10_000;
+const BLOCK_FRAMES = 1024;
+
+export interface DacAudioOptions {
+  /** Analog nodes to capture, one channel each (default [117]). */
+  coords?: readonly number[];
+  /** Output rate (default 48000). */
+  sampleRate?: number;
+  /** Integration bins per output sample (default 4). */
+  oversample?: number;
+  /** Receives `frames` interleaved frames, `frames × channels` samples. */
+  onFrames: (samples: Float32Array, frames: number) => void;
+}
+
+/** Low-pass taps at the oversampled rate, cut off at 0.45 of the output rate. */
+function lowPass(oversample: number): Float64Array {
+  const n = 2 * HALF_TAPS * oversample + 1;
+  const fc = 0.45 / oversample;
+  const taps = new Float64Array(n);
+  let sum = 0;
+  for (let i = 0; i < n; i++) {
+    const x = i - (n - 1) / 2;
+    const sinc = x === 0 ? 2 * fc : Math.sin(2 * Math.PI * fc * x) / (Math.PI * x);
+    const w = 0.42 - 0.5 * Math.cos((2 * Math.PI * i) / (n - 1)) + 0.08 * Math.cos((4 * Math.PI * i) / (n - 1));
+    taps[i] = sinc * w;
+    sum += taps[i];
+  }
+  for (let i = 0; i < n; i++) taps[i] /= sum;
+  return taps;
+}
+
+class DacChannel {
+  readonly coord: number;
+  level = 0;
+  peak = 0;
+  private timeNS = 0;
+  private bin = 0;
+  private area = 0;
+  private readonly history: Float64Array;
+  private historyPos = 0;
+  /** Output samples not yet emitted. */
+  readonly pending: number[] = [];
+
+  constructor(coord: number, taps: number) {
+    this.coord = coord;
+    this.history = new Float64Array(taps);
+  }
+
+  get time(): number {
+    return this.timeNS;
+  }
+
+  /** Hold the current level up to `timeNS`, producing output samples. */
+  advance(timeNS: number, binNS: number, taps: Float64Array, oversample: number): void {
+    if (timeNS <= this.timeNS) return;
+    let binEnd = (this.bin + 1) * binNS;
+    while (timeNS >= binEnd) {
+      this.area += this.level * (binEnd - this.timeNS);
+      this.timeNS = binEnd;
+      this.push(this.area / binNS, taps, oversample);
+      this.area = 0;
+      this.bin++;
+      binEnd = (this.bin + 1) * binNS;
+    }
+    this.area += this.level * (timeNS - this.timeNS);
+    this.timeNS = timeNS;
+  }
+
+  private push(value: number, taps: Float64Array, oversample: number): void {
+    const n = this.history.length;
+    this.history[this.historyPos] = value;
+    this.historyPos = (this.historyPos + 1) % n;
+    // Bin j completes output sample (j - HALF_TAPS * oversample) / oversample
+    const centre = this.bin - HALF_TAPS * oversample;
+    if (centre < 0 || centre % oversample !== 0) return;
+    let acc = 0;
+    for (let i = 0, k = this.historyPos; i < n; i++, k = k + 1 === n ? 0 : k + 1) acc += taps[i] * this.history[k];
+    this.pending.push(acc);
+  }
+}
+
+export class DacAudioCapture {
+  readonly sampleRate: number;
+  readonly channels: number;
+  private readonly oversample: number;
+  private readonly binNS: number;
+  private readonly taps: Float64Array;
+  private readonly nodes: DacChannel[];
+  private readonly byCoord = new Map<number, DacChannel>();
+  private readonly onFrames: (samples: Float32Array, count: number) => void;
+  private unsubscribe: (() => void) | null;
+  private frames = 0;
+  private writes = 0;
+
+  constructor(ga: GA144, options: DacAudioOptions) {
+    const coords = options.coords ?? [117];
+    for (const c of coords) {
+      if (!ANALOG_NODES.includes(c)) throw new Error(`Node ${c} has no DAC (analog nodes: ${ANALOG_NODES.join(', ')})`);
+    }
+    this.sampleRate = options.sampleRate ?? 48_000;
+    this.oversample = options.oversample ?? 4;
+    this.binNS = 1e9 / (this.sampleRate * this.oversample);
+    this.taps = lowPass(this.oversample);
+    this.nodes = coords.map(c => new DacChannel(c, this.taps.length));
+    for (const ch of this.nodes) this.byCoord.set(ch.coord, ch);
+    this.channels = this.nodes.length;
+    this.onFrames = options.onFrames;
+    this.unsubscribe = ga.ioBus.subscribe({ coords }, (coord, value, _timeNS, jitteredNS) => this.write(coord, value, jitteredNS));
+  }
+
+  private write(coord: number, value: number, timeNS: number): void {
+    const ch = this.byCoord.get(coord)!;
+    ch.advance(timeNS, this.binNS, this.taps, this.oversample);
+    ch.level = (((value & 0x1FF) ^ DAC_XOR) - 256) / 256;
+    ch.peak = Math.max(ch.peak, Math.abs(ch.level));
+    this.writes++;
+    for (const other of this.nodes) {
+      if (other.time < ch.time - SLACK_NS) other.advance(ch.time - SLACK_NS, this.binNS, this.taps, this.oversample);
+    }
+    if (this.ready() >= BLOCK_FRAMES) this.emit(this.ready());
+  }
+
+  private ready(): number {
+    let n = Infinity;
+    for (const ch of this.nodes) n = Math.min(n, ch.pending.length);
+    return n;
+  }
+
+  private emit(count: number): void {
+    if (count <= 0) return;
+    const samples = new Float32Array(count * this.channels);
+    this.nodes.forEach((ch, c) => {
+      for (let i = 0; i < count; i++) samples[i * this.channels + c] = ch.pending[i];
+      ch.pending.splice(0, count);
+    });
+    this.frames += count;
+    this.onFrames(samples, count);
+  }
+
+  /** Stop capturing and emit the output up to `endNS`. */
+  close(endNS: number): void {
+    this.unsubscribe?.();
+    this.unsubscribe = null;
+    // Run the filter past the end so its last outputs are complete
+    const flushNS = endNS + ((HALF_TAPS + 1) * 1e9) / this.sampleRate;
+    for (const ch of this.nodes) ch.advance(flushNS, this.binNS, this.taps, this.oversample);
+    const total = Math.floor((endNS * this.sampleRate) / 1e9);
+    this.emit(Math.min(this.ready(), total - this.frames));
+  }
+
+  snapshot(): { sampleRate: number; channels: number[]; frames: number; writes: number; peak: number[] } {
+    return {
+      sampleRate: this.sampleRate,
+      channels: this.nodes.map(ch => ch.coord),
+      frames: this.frames,
+      writes: this.writes,
+      peak: this.nodes.map(ch => ch.peak),
+    };
+  }
+}
@@ -0,0 +1,146 @@
+/**
+ * Tests for wait-for graph stall detection (deadlock.ts, GA144.detectStall).
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { findStuckNodes, findWaitCycle } from './deadlock';
+import { buildBootStream } from './bootstream';
+import { SerialBits } from './serial';
+
+function runCube(source: string, steps: number, configure?: (ga: GA144) => void): GA144 {
+  const compiled = compileCube(source);
+  expect(compiled.errors).toHaveLength(0);
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  configure?.(ga);
+  ga.load(compiled);
+  ga.stepProgramN(steps);
+  return ga;
+}
+
+describe('findStuckNodes', () => {
+  it('marks a closed wait cycle as stuck', () => {
+    expect(findStuckNodes([[1], [2], [0]])).toEqual([true, true, true]);
+  });
+
+  it('frees every node that transitively waits on a running node', () => {
+    // 0 → 1 → 2 (running); 3 waits on an unconnected port
+    expect(findStuckNodes([[1], [2], null, []])).toEqual([false, false, false, true]);
+  });
+
+  it('a multiport read is freed by any non-stuck neighbour', () => {
+    expect(findStuckNodes([[1, 2], [0], null])).toEqual([false, false, false]);
+  });
+});
+
+describe('findWaitCycle', () => {
+  it('returns the cycle reached from a tail node', () => {
+    const waits = [[1], [2], [3], [1]];
+    const stuck = findStuckNodes(waits);
+    expect(findWaitCycle(0, waits, stuck)).toEqual({ nodes: [1, 2, 3], closed: true });
+  });
+
+  it('returns the chain when it ends at an unconnected port', () => {
+    const waits = [[1], []];
+    expect(findWaitCycle(0, waits, findStuckNodes(waits))).toEqual({ nodes: [0, 1], closed: false });
+  });
+});
+
+describe('GA144.detectStall', () => {
+  it('reports two nodes reading from each other as a deadlock', () => {
+    // 404 and 405 share their RIGHT port (0x1D5); both read, nobody writes
+    const ga = runCube(`#include std
+node 404
+/\\
+std.recv{port=0x1D5, value=x}
+/\\
+node 405
+/\\
+std.recv{port=0x1D5, value=y}
+`, 5000);
+    const report = ga.detectStall();
+    expect(report).not.toBeNull();
+    expect(report!.kind).toBe('deadlock');
+    expect(report!.coords).toEqual([404, 405]);
+    expect([...report!.cycle].sort()).toEqual([404, 405]);
+    expect(report!.cycleClosed).toBe(true);
+  });
+
+  it('does not flag a completed exchange or idle ROM nodes', () => {
+    const ga = runCube(`#include std
+node 404
+/\\
+std.send{port=0x1D5, value=7}
+/\\
+node 405
+/\\
+std.recv{port=0x1D5, value=y}
+`, 5000);
+    expect(ga.detectStall()).toBeNull();
+  });
+
+  it('does not flag a writer whose reader is still running', () => {
+    const ga = runCube(`#include std
+node 404
+/\\
+std.send{port=0x1D5, value=7}
+/\\
+node 405
+/\\
+std.loop{n=100000}
+/\\ std.again{}
+`, 5000);
+    expect(ga.getNodeByCoord(404).getPortWaitTargets()).toEqual([ga.getNodeByCoord(405).index]);
+    expect(ga.detectStall()).toBeNull();
+  });
+
+  it('reports a livelock only when enabled', () => {
+    const spin = `#include std
+node 404
+/\\
+std.loop{n=100000}
+/\\ std.again{}
+`;
+    expect(runCube(spin, 20000).detectStall()).toBeNull();
+    const report = runCube(spin, 20000, ga => ga.setLivelockWindow(10_000)).detectStall();
+    expect(report).not.toBeNull();
+    expect(report!.kind).toBe('livelock');
+    expect(report!.coords).toEqual([404]);
+  });
+
+  it('reports a livelock after a serial boot stream has been delivered', () => {
+    const compiled = compileCube(`#include std
+node 708
+/\\
+std.loop{n=100000}
+/\\ std.again{}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    ga.setLivelockWindow(10_000);
+    const bytes = Array.from(buildBootStream(compiled.nodes).bytes);
+    ga.enqueueSerialBits(708, SerialBits.bootStreamBits(bytes, GA144.BOOT_BAUD));
+    for (let i = 0; i < 100 && ga.getSerialInputPending() > 0; i++) ga.stepProgramN(5_000);
+    expect(ga.getSerialInputPending()).toBe(0);
+    ga.stepProgramN(20_000);
+    const report = ga.detectStall();
+    expect(report).not.toBeNull();
+    expect(report!.kind).toBe('livelock');
+    expect(report!.coords).toEqual([708]);
+  });
+
+  it('does not count CUBE halt loops as livelock', () => {
+    const ga = runCube(`#include std
+node 404
+/\\
+std.send{port=0x1FF, value=1}
+`, 20000, g => g.setLivelockWindow(1_000));
+    expect(ga.getActiveCount()).toBeGreaterThan(0);
+    expect(ga.detectStall()).toBeNull();
+  });
+});
@@ -0,0 +1,75 @@
+/**
+ * Deadlock and livelock detection over the port wait-for graph.
+ *
+ * Each blocked node waits on the neighbours behind the port(s) it is
+ * reading or writing. A node is *stuck* when every neighbour it waits on
+ * is itself stuck — computed as a greatest fixed point, so a node waiting
+ * on anything that is running, or on its wake pin, is never stuck.
+ *
+ * A stuck set alone is not an error: after a program finishes, idle ROM
+ * nodes sit in multiport reads waiting for a boot stream. Only stuck nodes
+ * that are executing RAM code are reported as a deadlock.
+ */
+
+export type StallKind = 'deadlock' | 'livelock';
+
+export interface StallReport {
+  kind: StallKind;
+  /** Deadlock: stuck nodes running RAM code. Livelock: spinning nodes. */
+  coords: number[];
+  /** Deadlock only: one wait-for cycle to highlight, in wait order. When the
+   *  wait chain ends at a port with no neighbour it is returned instead. */
+  cycle: number[];
+  /** True when `cycle` loops back to its first node. */
+  cycleClosed: boolean;
+}
+
+export interface WaitCycle {
+  nodes: number[];
+  closed: boolean;
+}
+
+/**
+ * Compute the stuck set. `waits[i]` lists the node indices node i is blocked
+ * on, or null when node i can still make progress on its own.
+ */
+export function findStuckNodes(waits: (number[] | null)[]): boolean[] {
+  const n = waits.length;
+  const stuck: boolean[] = new Array(n);
+  for (let i = 0; i < n; i++) stuck[i] = waits[i] !== null;
+
+  let changed = true;
+  while (changed) {
+    changed = false;
+    for (let i = 0; i < n; i++) {
+      if (!stuck[i]) continue;
+      for (const j of waits[i]!) {
+        if (!stuck[j]) {
+          stuck[i] = false;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  return stuck;
+}
+
+/**
+ * Follow wait edges from `start` through stuck nodes until a node repeats
+ * (returning the cycle) or the chain dead-ends (returning the chain).
+ */
+export function findWaitCycle(start: number, waits: (number[] | null)[], stuck: boolean[]): WaitCycle {
+  const path: number[] = [];
+  const seenAt = new Map<number, number>();
+  let cur = start;
+  for (;;) {
+    const prev = seenAt.get(cur);
+    if (prev !== undefined) return { nodes: path.slice(prev), closed: true };
+    seenAt.set(cur, path.length);
+    path.push(cur);
+    const next = waits[cur]?.find(j => stuck[j]);
+    if (next === undefined) return { nodes: path, closed: false };
+    cur = next;
+  }
+}
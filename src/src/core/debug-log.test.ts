@@ -0,0 +1,76 @@
+/**
+ * Tests for the emulator debug-print channel (EMU_PORT.DEBUG).
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { DebugLog } from './debug-log';
+import { EMU_PORT } from './constants';
+
+const PRINT_SOURCE = `#include std
+node 404
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=42}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=0x3FFFF}
+`;
+
+function runPrint(configure?: (ga: GA144) => void): GA144 {
+  const compiled = compileCube(PRINT_SOURCE);
+  expect(compiled.errors).toHaveLength(0);
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  configure?.(ga);
+  ga.load(compiled);
+  ga.stepProgramN(2000);
+  return ga;
+}
+
+describe('DebugLog', () => {
+  it('keeps the newest entries when the ring wraps', () => {
+    const log = new DebugLog(4);
+    for (let i = 0; i < 6; i++) log.push(100, i, i * 10);
+    expect(log.totalSeq).toBe(6);
+    expect(log.count).toBe(4);
+    expect(log.entry(0)).toEqual({ coord: 100, value: 2, timeNS: 20 });
+    const delta = log.getDelta(0);
+    expect(delta.startSeq).toBe(2);
+    expect(delta.values).toEqual([2, 3, 4, 5]);
+    expect(log.getDelta(5).values).toEqual([5]);
+  });
+});
+
+describe('debug channel', () => {
+  it('captures guest writes with the source coordinate', () => {
+    const ga = runPrint();
+    const delta = ga.getDebugLogDelta(0);
+    expect(delta.values).toEqual([42, 0x3FFFF]);
+    expect(delta.coords).toEqual([404, 404]);
+    expect(delta.timestamps[1]).toBeGreaterThan(delta.timestamps[0]);
+  });
+
+  it('does not touch the IO write ring', () => {
+    const ga = runPrint();
+    expect(ga.getIoWritesDelta(0).writes).toHaveLength(0);
+  });
+
+  it('drops writes when disabled', () => {
+    const ga = runPrint(g => g.setDebugChannel({ enabled: false }));
+    expect(ga.getDebugLogDelta(0).totalSeq).toBe(0);
+  });
+
+  it('zero-time mode refunds the store time', () => {
+    const normal = runPrint().getDebugLogDelta(0);
+    const zero = runPrint(g => g.setDebugChannel({ zeroTime: true })).getDebugLogDelta(0);
+    expect(zero.values).toEqual(normal.values);
+    expect(zero.timestamps[1]).toBeLessThan(normal.timestamps[1]);
+  });
+
+  it('is cleared by reset', () => {
+    const ga = runPrint();
+    ga.reset();
+    expect(ga.getDebugLogDelta(0).totalSeq).toBe(0);
+  });
+});
@@ -0,0 +1,97 @@
+/**
+ * Debug-print log for the emulator-only debug channel (EMU_PORT.DEBUG).
+ *
+ * Guest writes to the debug port land here instead of the IO register ring,
+ * so instrumentation neither evicts VGA data nor shows up as pin activity.
+ * Entries are kept in a fixed-size ring of typed arrays with a monotonic
+ * sequence counter, mirroring the IO write ring's delta-transfer scheme.
+ */
+
+/** One captured debug write. */
+export interface DebugLogEntry {
+  coord: number;
+  value: number;
+  /** Node-local simulated time (ns) at the write. */
+  timeNS: number;
+}
+
+/** Delta of debug entries since a given sequence number. */
+export interface DebugLogDelta {
+  coords: number[];
+  values: number[];
+  timestamps: number[];
+  startSeq: number;
+  totalSeq: number;
+}
+
+export class DebugLog {
+  static readonly DEFAULT_CAPACITY = 65_536;
+
+  readonly capacity: number;
+  private coords: Uint16Array;
+  private values: Uint32Array;
+  private timestamps: Float64Array;
+  private start = 0;     // ring start index
+  private startSeq = 0;  // sequence number at ring start
+  private seq = 0;       // next sequence number to write
+
+  constructor(capacity: number = DebugLog.DEFAULT_CAPACITY) {
+    this.capacity = capacity;
+    this.coords = new Uint16Array(capacity);
+    this.values = new Uint32Array(capacity);
+    this.timestamps = new Float64Array(capacity);
+  }
+
+  push(coord: number, value: number, timeNS: number): void {
+    const cap = this.capacity;
+    if (this.seq - this.startSeq >= cap) {
+      this.start = (this.start + 1) % cap;
+      this.startSeq++;
+    }
+    const idx = (this.start + (this.seq - this.startSeq)) % cap;
+    this.coords[idx] = coord;
+    this.values[idx] = value;
+    this.timestamps[idx] = timeNS;
+    this.seq++;
+  }
+
+  /** Total entries ever written (monotonic). */
+  get totalSeq(): number {
+    return this.seq;
+  }
+
+  /** Number of entries currently retained. */
+  get count(): number {
+    return this.seq - this.startSeq;
+  }
+
+  /** Read a retained entry by offset from the oldest one. */
+  entry(offset: number): DebugLogEntry {
+    const idx = (this.start + offset) % this.capacity;
+    return { coord: this.coords[idx], value: this.values[idx], timeNS: this.timestamps[idx] };
+  }
+
+  getDelta(sinceSeq: number): DebugLogDelta {
+    const from = Math.max(sinceSeq, this.startSeq);
+    const count = this.seq - from;
+    if (count <= 0) {
+      return { coords: [], values: [], timestamps: [], startSeq: from, totalSeq: this.seq };
+    }
+    const coords = new Array<number>(count);
+    const values = new Array<number>(count);
+    const timestamps = new Array<number>(count);
+    for (let i = 0; i < count; i++) {
+      const idx = (this.start + (from - this.startSeq) + i) % this.capacity;
+      coords[i] = this.coords[idx];
+      values[i] = this.values[idx];
+      timestamps[i] = this.timestamps[idx];
+    }
+    return { coords, values, timestamps, startSeq: from, totalSeq: this.seq };
+  }
+
+  reset(): void {
+    this.start = 0;
+    this.startSeq = 0;
+    this.seq = 0;
+  }
+}
@@ -0,0 +1,144 @@
+/**
+ * Tests for the analog input device: VCO counter integration, WAV and
+ * CSV streaming, and ADC reads on a real chip.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from '../ga144';
+import { ROM_DATA } from '../rom-data';
+import { compileCube } from '../cube';
+import { IoBus } from '../io-bus';
+import { EMU_PORT, PORT } from '../constants';
+import { AnalogInputDevice, arrayStream, functionStream, wavStream, csvStream } from './analog-input';
+import type { AnalogSource, DeviceHost } from './device';
+import type { ByteReader } from '../wav';
+
+/** 1 GHz + 1 GHz/V from 0 V, so counts are easy to predict. */
+const VCO = { centerHz: 1e9, centerV: 0, hzPerVolt: 1e9 };
+
+function attach(device: AnalogInputDevice): Map<number, AnalogSource> {
+  const sources = new Map<number, AnalogSource>();
+  const host = {
+    now: () => 0,
+    schedule: () => {},
+    setPin: () => {},
+    getPin: () => false,
+    setAnalogSource: (coord: number, source: AnalogSource | null) => {
+      if (source) sources.set(coord, source);
+      else sources.delete(coord);
+    },
+    setDataBus: () => {},
+    setExternalPort: () => {},
+    deliverPortValue: () => {},
+    ioBus: new IoBus(),
+  } satisfies DeviceHost;
+  device.attach(host);
+  return sources;
+}
+
+/** A ByteReader over `bytes` that records the size of each read. */
+function reader(bytes: Uint8Array, reads: number[] = []): ByteReader {
+  return (offset, length) => {
+    reads.push(length);
+    return bytes.subarray(offset, offset + length);
+  };
+}
+
+function wav16(samples: number[], rate: number, channels = 1): Uint8Array {
+  const bytes = new Uint8Array(44 + samples.length * 2);
+  const view = new DataView(bytes.buffer);
+  const ascii = (off: number, s: string) => { for (let i = 0; i < 4; i++) bytes[off + i] = s.charCodeAt(i); };
+  ascii(0, 'RIFF');
+  view.setUint32(4, bytes.length - 8, true);
+  ascii(8, 'WAVE');
+  ascii(12, 'fmt ');
+  view.setUint32(16, 16, true);
+  view.setUint16(20, 1, true);
+  view.setUint16(22, channels, true);
+  view.setUint32(24, rate, true);
+  view.setUint32(28, rate * channels * 2, true);
+  view.setUint16(32, channels * 2, true);
+  view.setUint16(34, 16, true);
+  ascii(36, 'data');
+  view.setUint32(40, samples.length * 2, true);
+  samples.forEach((s, i) => view.setInt16(44 + i * 2, s, true));
+  return bytes;
+}
+
+describe('AnalogInputDevice', () => {
+  it('integrates VCO frequency over linearly interpolated samples', () => {
+    // 0 V, 1 V, 1 V at 1 MHz: 1 GHz rising to 2 GHz over the first µs
+    const device = new AnalogInputDevice({ channels: [{ coord: 709, stream: arrayStream([0, 1, 1], 1e6) }], vco: VCO });
+    const adc = attach(device).get(709)!;
+    expect(adc(709, 500)).toBe(500 + 125);
+    expect(adc(709, 1000)).toBe(1500);
+    expect(adc(709, 3000)).toBe(1500 + 4000);  // holds the last sample
+    expect(adc(709, 200_000)).toBe((1500 + 2 * 199_000) & 0x3FFFF);
+    expect(device.snapshot()).toMatchObject({ channels: [{ coord: 709, samples: 3, volts: 1, ended: true }] });
+
+    // Chip reset: time starts over
+    expect(adc(709, 500)).toBe(625);
+  });
+
+  it('loops and generates signals, and rejects nodes without an ADC', () => {
+    const device = new AnalogInputDevice({
+      channels: [
+        { coord: 717, stream: arrayStream([1, 0], 1e6), loop: true },
+        { coord: 117, stream: functionStream(t => (t < 2e-6 ? 0 : 1), 1e6) },
+      ],
+      vco: VCO,
+    });
+    const sources = attach(device);
+    expect(sources.get(717)!(717, 4000)).toBe(4 * 1500);
+    expect(sources.get(117)!(117, 3000)).toBe(1000 + 1500 + 2000);
+    device.detach();
+    expect(sources.size).toBe(0);
+    expect(() => new AnalogInputDevice({ channels: [{ coord: 708, stream: arrayStream([0], 1) }] })).toThrow('has no ADC');
+  });
+
+  it('streams a WAV file in chunks, mapping full scale to the voltage range', () => {
+    const samples = Array.from({ length: 10_000 }, (_, i) => (i % 2 === 0 ? -0x8000 : 0));
+    const reads: number[] = [];
+    const stream = wavStream(reader(wav16(samples, 1e6), reads), { minV: 0, maxV: 2 });
+    const device = new AnalogInputDevice({ channels: [{ coord: 713, stream }], vco: VCO });
+    const adc = attach(device).get(713)!;
+    // Alternating 0 V and 1 V: 1.5 GHz on average
+    expect(adc(713, 10_000)).toBe(15_000);
+    expect(Math.max(...reads)).toBeLessThanOrEqual(4096 * 2);
+  });
+
+  it('streams CSV values across chunk boundaries, skipping a header', () => {
+    const lines = ['t,volts', ...Array.from({ length: 20_000 }, (_, i) => `${i},${i < 10_000 ? 0 : 1}`)];
+    const reads: number[] = [];
+    const stream = csvStream(reader(new TextEncoder().encode(lines.join('\r\n')), reads), 1e6, 1);
+    const out = new Float64Array(30_000);
+    expect(stream.read(out)).toBe(20_000);
+    expect(out[9_999]).toBe(0);
+    expect(out[10_000]).toBe(1);
+    expect(reads.length).toBeGreaterThan(2);
+    stream.rewind();
+    expect(stream.read(new Float64Array(5))).toBe(5);
+  });
+
+  it('feeds DATA reads on an analog node', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    // 1 GHz: the counter is the read time in ns
+    ga.attachDevice(new AnalogInputDevice({ channels: [{ coord: 709, stream: arrayStream([0], 1e6) }], vco: VCO }));
+    const compiled = compileCube(`#include std
+node 709
+/\\
+std.recv{port=${PORT.DATA}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    ga.stepProgramN(200);
+
+    const log = ga.getDebugLogDelta(0);
+    expect(log.values).toHaveLength(1);
+    expect(log.values[0]).toBeGreaterThan(0);
+    expect(log.values[0]).toBeLessThanOrEqual(log.timestamps[0]);
+  });
+});
@@ -0,0 +1,304 @@
+/**
+ * Analog input — streams a waveform into an analog node's ADC.
+ *
+ * The GA144's ADC is a voltage-controlled oscillator feeding a counter:
+ * reading DATA returns the 18-bit count, and software measures voltage as
+ * the count difference over a known time. This device replaces the
+ * thermal VCO model of the chosen nodes with one driven by a sample
+ * stream. The VCO frequency is linear in the input voltage, and the
+ * counter is the integral of that frequency over guest time, with the
+ * voltage interpolated linearly between samples.
+ *
+ * Streams deliver samples a buffer at a time and are only read forward as
+ * guest time advances, so a recording never has to fit in memory. Nothing
+ * is scheduled: the counter is brought up to date when the node reads it.
+ */
+import { ANALOG_NODES } from '../constants';
+import { parseWavHeader, decodeWavSamples } from '../wav';
+import type { ByteReader } from '../wav';
+import type { Device, DeviceHost } from './device';
+
+/** A forward-only source of voltage samples. */
+export interface AnalogStream {
+  /** Samples per second. */
+  readonly rate: number;
+  /** Fill `out` with the next samples (volts); returns how many, 0 at the end. */
+  read(out: Float64Array): number;
+  /** Back to the first sample. */
+  rewind(): void;
+}
+
+/** VCO transfer function: frequency = centerHz + (volts - centerV) * hzPerVolt. */
+export interface VcoResponse {
+  centerHz: number;
+  centerV: number;
+  hzPerVolt: number;
+}
+
+/** ~3 GHz at mid-rail, the same nominal rate as the thermal VCO model. */
+export const DEFAULT_VCO: VcoResponse = { centerHz: 3e9, centerV: 0.9, hzPerVolt: 2e9 };
+
+export interface AnalogChannel {
+  /** One of ANALOG_NODES. */
+  coord: number;
+  stream: AnalogStream;
+  /** Start again from the first sample at the end instead of holding the last. */
+  loop?: boolean;
+}
+
+export interface AnalogInputOptions {
+  channels: AnalogChannel[];
+  vco?: VcoResponse;
+}
+
+const BUFFER_SAMPLES = 4096;
+const COUNTER_WRAP = 0x40000;
+
+/** Counter state of one node's VCO. */
+class VcoIntegrator {
+  readonly coord: number;
+  private readonly stream: AnalogStream;
+  private readonly loop: boolean;
+  private readonly vco: VcoResponse;
+  private readonly periodNS: number;
+  private readonly buffer = new Float64Array(BUFFER_SAMPLES);
+  private bufferLength = 0;
+  private bufferPos = 0;
+
+  // Interval [index, index + 1) between samples a and b
+  private index = 0;
+  private a = 0;
+  private b = 0;
+  private timeNS = 0;
+  private cycles = 0;  // kept modulo the counter wrap
+  samples = 0;
+  ended = false;
+
+  constructor(channel: AnalogChannel, vco: VcoResponse) {
+    this.coord = channel.coord;
+    this.stream = channel.stream;
+    this.loop = channel.loop ?? false;
+    this.vco = vco;
+    this.periodNS = 1e9 / channel.stream.rate;
+    this.rewind();
+  }
+
+  rewind(): void {
+    this.stream.rewind();
+    this.bufferLength = this.bufferPos = 0;
+    this.samples = 0;
+    this.ended = false;
+    this.index = 0;
+    this.timeNS = 0;
+    this.cycles = 0;
+    this.a = this.next(0);
+    this.b = this.next(this.a);
+  }
+
+  /** The next sample, or `last` once the stream has ended. */
+  private next(last: number): number {
+    if (this.bufferPos === this.bufferLength) {
+      if (this.ended) return last;
+      this.bufferLength = this.stream.read(this.buffer);
+      if (this.bufferLength === 0 && this.loop && this.samples > 0) {
+        this.stream.rewind();
+        this.bufferLength = this.stream.read(this.buffer);
+      }
+      this.bufferPos = 0;
+      if (this.bufferLength === 0) {
+        this.ended = true;
+        return last;
+      }
+    }
+    this.samples++;
+    return this.buffer[this.bufferPos++];
+  }
+
+  private hz(volts: number): number {
+    return Math.max(0, this.vco.centerHz + (volts - this.vco.centerV) * this.vco.hzPerVolt);
+  }
+
+  /** Input voltage at the current time. */
+  volts(): number {
+    return this.a + (this.b - this.a) * ((this.timeNS - this.index * this.periodNS) / this.periodNS);
+  }
+
+  /** The counter at `timeNS`. Earlier times (a chip reset) start over. */
+  counter(timeNS: number): number {
+    if (timeNS < this.timeNS) this.rewind();
+    while (this.timeNS < timeNS) {
+      const endNS = (this.index + 1) * this.periodNS;
+      const toNS = Math.min(timeNS, endNS);
+      const v0 = this.volts();
+      const dtNS = toNS - this.timeNS;
+      this.timeNS = toNS;
+      const v1 = toNS === endNS ? this.b : this.volts();
+      // Frequency is linear in voltage, so the trapezoid is exact
+      this.cycles = (this.cycles + ((this.hz(v0) + this.hz(v1)) / 2) * (dtNS / 1e9)) % COUNTER_WRAP;
+      if (toNS === endNS) {
+        this.index++;
+        this.a = this.b;
+        this.b = this.next(this.b);
+      }
+    }
+    return Math.floor(this.cycles) & (COUNTER_WRAP - 1);
+  }
+}
+
+export class AnalogInputDevice implements Device {
+  readonly name = 'analog-input';
+  private readonly channels: VcoIntegrator[];
+  private host: DeviceHost | null = null;
+
+  constructor(options: AnalogInputOptions) {
+    const vco = options.vco ?? DEFAULT_VCO;
+    for (const c of options.channels) {
+      if (!ANALOG_NODES.includes(c.coord)) {
+        throw new Error(`Node ${c.coord} has no ADC (analog nodes: ${ANALOG_NODES.join(', ')})`);
+      }
+      if (!(c.stream.rate > 0)) throw new Error(`Node ${c.coord}: sample rate must be positive`);
+    }
+    this.channels = options.channels.map(c => new VcoIntegrator(c, vco));
+  }
+
+  attach(host: DeviceHost): void {
+    this.host = host;
+    for (const ch of this.channels) host.setAnalogSource(ch.coord, (_coord, timeNS) => ch.counter(timeNS));
+  }
+
+  detach(): void {
+    for (const ch of this.channels) this.host?.setAnalogSource(ch.coord, null);
+    this.host = null;
+  }
+
+  onEvent(): void {}
+
+  reset(): void {
+    for (const ch of this.channels) ch.rewind();
+  }
+
+  snapshot(): unknown {
+    return {
+      channels: this.channels.map(ch => ({ coord: ch.coord, samples: ch.samples, volts: ch.volts(), ended: ch.ended })),
+    };
+  }
+}
+
+// ---- Streams ----
+
+/** Samples held in memory. */
+export function arrayStream(samples: ArrayLike<number>, rate: number): AnalogStream {
+  let pos = 0;
+  return {
+    rate,
+    read(out) {
+      const n = Math.min(out.length, samples.length - pos);
+      for (let i = 0; i < n; i++) out[i] = samples[pos + i];
+      pos += n;
+      return n;
+    },
+    rewind() { pos = 0; },
+  };
+}
+
+/** An endless generated signal: `fn(seconds)` gives volts. */
+export function functionStream(fn: (timeS: number) => number, rate: number): AnalogStream {
+  let index = 0;
+  return {
+    rate,
+    read(out) {
+      for (let i = 0; i < out.length; i++) out[i] = fn((index + i) / rate);
+      index += out.length;
+      return out.length;
+    },
+    rewind() { index = 0; },
+  };
+}
+
+export interface WavStreamOptions {
+  /** Channel to take (default 0). */
+  channel?: number;
+  /** Voltages of sample values -1 and +1 (default 0 to 1.8 V). */
+  minV?: number;
+  maxV?: number;
+}
+
+/** A WAV file read in chunks; full scale maps onto [minV, maxV]. */
+export function wavStream(read: ByteReader, options: WavStreamOptions = {}): AnalogStream {
+  const format = parseWavHeader(read);
+  const channel = options.channel ?? 0;
+  if (channel >= format.channels) throw new Error(`wav: no channel ${channel} (${format.channels} channels)`);
+  const minV = options.minV ?? 0;
+  const maxV = options.maxV ?? 1.8;
+  const frame = (format.bitsPerSample >> 3) * format.channels;
+  let pos = 0;
+  return {
+    rate: format.sampleRate,
+    read(out) {
+      const want = Math.min(out.length * frame, format.dataLength - pos);
+      const bytes = read(format.dataOffset + pos, want - (want % frame));
+      const n = decodeWavSamples(format, bytes, channel, out);
+      pos += n * frame;
+      for (let i = 0; i < n; i++) out[i] = minV + ((out[i] + 1) / 2) * (maxV - minV);
+      return n;
+    },
+    rewind() { pos = 0; },
+  };
+}
+
+const CSV_CHUNK = 1 << 16;
+
+/**
+ * A CSV file of voltages, read in chunks. Values come from column
+ * `column` (default 0); lines where it is not a number, such as a
+ * header, are skipped.
+ */
+export function csvStream(read: ByteReader, rate: number, column = 0): AnalogStream {
+  let pos = 0;
+  let partial = '';
+  let pending: number[] = [];
+  let pendingPos = 0;
+  let eof = false;
+  let decoder = new TextDecoder();
+
+  const parse = (line: string) => {
+    const v = Number(line.split(',')[column]);
+    if (line.trim() !== '' && Number.isFinite(v)) pending.push(v);
+  };
+  const fill = () => {
+    pending = [];
+    pendingPos = 0;
+    while (pending.length === 0 && !eof) {
+      const bytes = read(pos, CSV_CHUNK);
+      pos += bytes.length;
+      eof = bytes.length < CSV_CHUNK;
+      const lines = (partial + decoder.decode(bytes, { stream: !eof })).split(/\r?\n/);
+      partial = eof ? '' : lines.pop()!;
+      for (const line of lines) parse(line);
+    }
+  };
+
+  return {
+    rate,
+    read(out) {
+      let n = 0;
+      while (n < out.length) {
+        if (pendingPos === pending.length) {
+          if (eof) break;
+          fill();
+          continue;
+        }
+        out[n++] = pending[pendingPos++];
+      }
+      return n;
+    },
+    rewind() {
+      pos = 0;
+      partial = '';
+      pending = [];
+      pendingPos = 0;
+      eof = false;
+      decoder = new TextDecoder();
+    },
+  };
+}
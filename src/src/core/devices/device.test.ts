@@ -0,0 +1,168 @@
+/**
+ * Tests for the peripheral device API (GA144.attachDevice) and the
+ * built-in serial input device.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from '../ga144';
+import { ROM_DATA } from '../rom-data';
+import { compileCube } from '../cube';
+import { EMU_PORT, PORT } from '../constants';
+import type { Device, DeviceHost } from './device';
+
+function makeGa(source?: string): GA144 {
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  if (source !== undefined) {
+    const compiled = compileCube(source);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+  }
+  return ga;
+}
+
+/** Runs `actions` at the given guest times. */
+class ScriptDevice implements Device {
+  readonly name = 'script';
+  host!: DeviceHost;
+  fired: number[] = [];
+  resets = 0;
+  private actions: [number, (host: DeviceHost) => void][];
+  constructor(actions: [number, (host: DeviceHost) => void][]) {
+    this.actions = actions;
+  }
+  attach(host: DeviceHost): void {
+    this.host = host;
+    for (const [t] of this.actions) host.schedule(t);
+  }
+  onEvent(timeNS: number): void {
+    this.fired.push(timeNS);
+    this.actions[this.fired.length - 1]?.[1](this.host);
+  }
+  reset(): void {
+    this.resets++;
+  }
+  snapshot(): unknown {
+    return { fired: this.fired.length };
+  }
+}
+
+/** Ticks every 10 ns forever, with input it never gets to deliver. */
+class ClockDevice implements Device {
+  readonly name = 'clock';
+  readonly pending = 1;
+  private host!: DeviceHost;
+  attach(host: DeviceHost): void {
+    this.host = host;
+    host.schedule(10);
+  }
+  onEvent(timeNS: number): void {
+    this.host.schedule(timeNS + 10);
+  }
+  reset(): void {}
+  snapshot(): unknown {
+    return null;
+  }
+}
+
+const WAKE_THEN_READ_IO = `#include std
+node 708
+/\\
+std.recv{port=${PORT.UP}, value=w}
+/\\
+std.recv{port=${PORT.IO}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+`;
+
+describe('GA144 devices', () => {
+  it('runs device events in time order without using the step budget', () => {
+    const ga = makeGa();
+    const dev = new ScriptDevice([[300, () => {}], [100, () => {}], [200, () => {}]]);
+    ga.attachDevice(dev);
+    ga.stepProgramN(5000);
+    expect(dev.fired).toEqual([100, 200, 300]);
+    expect(ga.getTotalSteps()).toBe(5000);
+  });
+
+  it('wakes a node blocked on its wake pin and exposes pin1 input', () => {
+    const ga = makeGa(WAKE_THEN_READ_IO);
+    ga.attachDevice(new ScriptDevice([[5000, host => {
+      host.setPin(708, 1, true);
+      host.setPin(708, 17, true);
+    }]]));
+    ga.stepProgramN(2000);
+
+    const log = ga.getDebugLogDelta(0);
+    expect(log.values).toHaveLength(1);
+    expect(log.timestamps[0]).toBeGreaterThanOrEqual(5000);
+    expect(log.values[0] & 0x20002).toBe(0x20002);
+  });
+
+  it('feeds analog reads from a device source', () => {
+    const ga = makeGa(`#include std
+node 117
+/\\
+std.recv{port=${PORT.DATA}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+`);
+    ga.attachDevice(new ScriptDevice([[0, host => host.setAnalogSource(117, () => 0x1234)]]));
+    ga.stepProgramN(2000);
+    expect(ga.getDebugLogDelta(0).values).toEqual([0x1234]);
+  });
+
+  it('resets devices with the chip and drops events on detach', () => {
+    const ga = makeGa();
+    const dev = new ScriptDevice([[100, () => {}], [200, () => {}]]);
+    const detach = ga.attachDevice(dev);
+    ga.reset();
+    expect(dev.resets).toBe(1);
+
+    const late = new ScriptDevice([[1e9, () => {}]]);
+    const detachLate = ga.attachDevice(late);
+    detachLate();
+    detach();
+    ga.stepProgramN(1000);
+    expect(late.fired).toEqual([]);
+    expect(ga.getDeviceSnapshots().map(d => d.name)).toEqual(['serial-in']);
+  });
+
+  it('returns from a free-running clock with its input still pending', () => {
+    const ga = makeGa(WAKE_THEN_READ_IO);
+    ga.stepProgramN(2000);
+    const before = ga.getTotalSteps();
+    ga.attachDevice(new ClockDevice());
+    ga.stepProgramN(1000);
+    expect(ga.getTotalSteps()).toBe(before);
+    expect(ga.getDevicePending()).toBe(1);
+  });
+
+  it('drains device events until a node steps when single-stepping', () => {
+    const ga = makeGa(WAKE_THEN_READ_IO);
+    ga.stepProgramN(2000);
+    const before = ga.getTotalSteps();
+    ga.enqueueSerialBits(708, [
+      { value: false, durationNS: 100 },
+      { value: false, durationNS: 100 },
+      { value: false, durationNS: 100 },
+      { value: true, durationNS: 100 },
+    ]);
+    ga.stepProgram();
+    expect(ga.getTotalSteps()).toBe(before + 1);
+  });
+});
+
+describe('SerialInputDevice', () => {
+  it('keeps a stream queued before load()', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    ga.enqueueSerialBits(708, [{ value: true, durationNS: 100 }], 0);
+    ga.load(compileCube(WAKE_THEN_READ_IO));
+    ga.stepProgramN(2000);
+
+    expect(ga.getDebugLogDelta(0).values).toHaveLength(1);
+    expect(ga.getDeviceSnapshots()[0]).toEqual({ name: 'serial-in', state: { node: 708, pending: 0, endTimeNS: 100 } });
+  });
+});
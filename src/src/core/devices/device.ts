@@ -0,0 +1,87 @@
+/**
+ * Peripheral device API — models of what is wired to the chip's pins and
+ * analog inputs.
+ *
+ * A device is attached to a GA144 and gets a DeviceHost. Through it, it
+ * schedules its own timed events on the chip's event queue, drives pin
+ * inputs with the same wake semantics as real pins, feeds analog nodes'
+ * ADC reads, and subscribes to the IO bus to react to the nodes' writes.
+ * Device events are interleaved with node steps in guest-time order but do
+ * not consume the step budget, and nothing is checked per instruction,
+ * so attached devices cost the node hot path nothing.
+ */
+import type { IoBus } from '../io-bus';
+import type { PortIndex } from '../types';
+
+/** GPIO pins by the io register bit they are read at. */
+export type GpioPin = 17 | 5 | 3 | 1;
+
+/** Returns the 18-bit ADC counter value an analog node reads at `timeNS`. */
+export type AnalogSource = (coord: number, timeNS: number) => number;
+
+/** Off-chip logic behind a node's DATA port (the parallel bus of nodes
+ *  007/008/009). Writes still latch, so reads fall back sensibly. */
+export interface DataBus {
+  read(coord: number, timeNS: number): number;
+  write(coord: number, value: number, timeNS: number): void;
+}
+
+/**
+ * Stands in for the neighbour on one of a node's comm ports, so a device
+ * can model a whole cluster at the protocol level. Handshakes complete at
+ * the returned times; the node idles until then without being suspended.
+ */
+export interface ExternalPort {
+  /** The node writes `value`; returns when the write handshake completes. */
+  write(value: number, timeNS: number): number;
+  /** The node reads: the value and when it is available, or null to block
+   *  until DeviceHost.deliverPortValue. */
+  read(timeNS: number): { value: number; readyNS: number } | null;
+}
+
+export interface DeviceHost {
+  /** Guest wall-clock time (ns) of the event being processed. */
+  now(): number;
+  /** Call the device's onEvent at absolute guest time `timeNS`.
+   *  Each call queues one event; times in the past run next. */
+  schedule(timeNS: number): void;
+  /** Drive a pin input. A node blocked reading its wake pin resumes when
+   *  pin17 reaches the level it waits for. */
+  setPin(coord: number, pin: GpioPin, level: boolean): void;
+  getPin(coord: number, pin: GpioPin): boolean;
+  /** Take over an analog node's ADC (DATA port) reads; null releases it. */
+  setAnalogSource(coord: number, source: AnalogSource | null): void;
+  /** Attach logic behind a node's DATA port; null restores the plain latch. */
+  setDataBus(coord: number, bus: DataBus | null): void;
+  /** Replace the neighbour on a node's single port `port` (PortIndex). */
+  setExternalPort(coord: number, port: PortIndex, endpoint: ExternalPort | null): void;
+  /** Complete a read that an ExternalPort blocked, at the current time. */
+  deliverPortValue(coord: number, value: number): void;
+  /** The chip's IO write bus. Subscriptions are the device's to remove. */
+  readonly ioBus: IoBus;
+}
+
+export interface Device {
+  /** Name used in snapshots and error messages. */
+  readonly name: string;
+  /** Called once by GA144.attachDevice. */
+  attach(host: DeviceHost): void;
+  /** A scheduled event is due. */
+  onEvent(timeNS: number): void;
+  /** The chip was reset and its event queue cleared. */
+  reset(): void;
+  /** JSON-safe state for inspection and UI display. */
+  snapshot(): unknown;
+  /** Input still to deliver (bits, frames, stimulus events). A run that
+   *  stops stepping nodes is not idle while a device has some. Leave it
+   *  out for free-running outputs such as clocks. */
+  readonly pending?: number;
+  /** Called when the device is removed from the chip. */
+  detach?(): void;
+}
+
+/** Named device state, as returned by GA144.getDeviceSnapshots. */
+export interface DeviceSnapshot {
+  name: string;
+  state: unknown;
+}
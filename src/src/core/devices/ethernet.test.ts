@@ -0,0 +1,146 @@
+/**
+ * Tests for the 10BASE-T line model: Manchester coding, Tx decode,
+ * loopback and Rx delivery to a node's pin.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from '../ga144';
+import { ROM_DATA } from '../rom-data';
+import { compileCube } from '../cube';
+import { IoBus } from '../io-bus';
+import { EMU_PORT, PORT, coordToIndex } from '../constants';
+import {
+  EthernetPhyDevice, encodeEthernetFrame, manchesterEdges, decodeManchester,
+} from './ethernet';
+import type { EthernetFrame } from './ethernet';
+import type { DeviceHost, GpioPin } from './device';
+
+const FRAME = Uint8Array.from({ length: 64 }, (_, i) => (i * 37 + 5) & 0xFF);
+
+/** Host whose events are run by `run()` in time order. */
+function fakeHost() {
+  const ioBus = new IoBus();
+  const queue: number[] = [];
+  const pins: { coord: number; level: boolean; timeNS: number }[] = [];
+  let now = 0;
+  const host = {
+    now: () => now,
+    schedule: (t: number) => { queue.push(t); },
+    setPin: (coord: number, _pin: GpioPin, level: boolean) => { pins.push({ coord, level, timeNS: now }); },
+    getPin: () => false,
+    setAnalogSource: () => {},
+    setDataBus: () => {},
+    setExternalPort: () => {},
+    deliverPortValue: () => {},
+    ioBus,
+  } satisfies DeviceHost;
+  const run = (device: EthernetPhyDevice, untilNS: number) => {
+    for (;;) {
+      queue.sort((a, b) => a - b);
+      if (queue.length === 0 || queue[0] > untilNS) return;
+      now = queue.shift()!;
+      device.onEvent(now);
+    }
+  };
+  /** Drive the Tx node's pin17 like node 317's io writes. */
+  const transmit = (coord: number, times: number[], levels: boolean[]) => {
+    for (let i = 0; i < times.length; i++) {
+      ioBus.publish(coordToIndex(coord), levels[i] ? 0x30000 : 0x20000, times[i], 0);
+    }
+  };
+  return { host, pins, run, transmit };
+}
+
+describe('Manchester coding', () => {
+  it('round-trips a frame with preamble, padding and FCS', () => {
+    const short = FRAME.subarray(0, 20);
+    const { times, levels, endNS } = manchesterEdges(encodeEthernetFrame(short), 1000);
+    expect(times[0]).toBe(1050);  // first preamble 1: low, then high at mid-cell
+    expect(endNS).toBe(1000 + (8 + 64) * 8 * 100 + 300);
+
+    const octets = decodeManchester(times, levels)!;
+    expect(octets).toHaveLength(64);
+    expect(Array.from(octets.subarray(0, 20))).toEqual(Array.from(short));
+    expect(Array.from(octets.subarray(20, 60)).every(b => b === 0)).toBe(true);
+  });
+
+  it('tracks edge jitter and rejects bursts without an SFD', () => {
+    const { times, levels } = manchesterEdges(encodeEthernetFrame(FRAME), 0);
+    const jittered = times.map((t, i) => t + ((i * 7) % 21) - 10);
+    expect(Array.from(decodeManchester(jittered, levels)!.subarray(0, 64))).toEqual(Array.from(FRAME));
+    expect(decodeManchester([0, 100], [true, false])).toBeNull();
+  });
+});
+
+describe('EthernetPhyDevice', () => {
+  it('decodes transmitted frames and mirrors them onto Rx in loopback', () => {
+    const frames: EthernetFrame[] = [];
+    const phy = new EthernetPhyDevice({ loopback: true, clockNode: null, onFrame: f => frames.push(f) });
+    const { host, pins, run, transmit } = fakeHost();
+    phy.attach(host);
+
+    const { times, levels, endNS } = manchesterEdges(encodeEthernetFrame(FRAME), 2000);
+    transmit(317, times, levels);
+    transmit(317, [endNS + 1_000_000, endNS + 1_000_100], [true, false]);  // link pulse
+    run(phy, Infinity);
+    phy.flush();
+
+    expect(frames).toHaveLength(1);
+    expect(frames[0].fcsOk).toBe(true);
+    expect(frames[0].timeNS).toBe(2050);
+    expect(Array.from(frames[0].data)).toEqual(Array.from(FRAME));
+    expect(phy.snapshot()).toMatchObject({ txFrames: 1, txBytes: 68, linkPulses: 1, fcsErrors: 0 });
+    expect(pins.filter(p => p.coord === 217).map(p => p.timeNS).slice(0, 3)).toEqual(times.slice(0, 3).map(t => t + 50));
+  });
+
+  it('flags a corrupted FCS', () => {
+    const frames: EthernetFrame[] = [];
+    const phy = new EthernetPhyDevice({ clockNode: null, linkPulses: false, onFrame: f => frames.push(f) });
+    const { host, transmit } = fakeHost();
+    phy.attach(host);
+    const octets = encodeEthernetFrame(FRAME);
+    octets[20] ^= 1;
+    const { times, levels } = manchesterEdges(octets, 0);
+    transmit(317, times, levels);
+    phy.flush();
+    expect(frames[0].fcsOk).toBe(false);
+  });
+
+  it('puts queued frames on the Rx pin after the interframe gap', () => {
+    const phy = new EthernetPhyDevice({ clockNode: null, linkPulses: false });
+    const { host, pins, run } = fakeHost();
+    phy.attach(host);
+    phy.enqueueFrame(FRAME, 1000);
+    phy.enqueueFrame(FRAME, 1000);
+    run(phy, Infinity);
+
+    const rises = pins.filter(p => p.level);
+    const frameNS = (8 + 68) * 8 * 100 + 300;
+    expect(rises[0].timeNS).toBe(1050);
+    expect(pins.find(p => p.timeNS > 1000 + frameNS)!.timeNS).toBe(1000 + frameNS + 9600 + 50);
+    expect(phy.snapshot()).toMatchObject({ rxFrames: 2, rxPending: 0 });
+  });
+
+  it('wakes the Rx node at the first edge on a real chip', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    const phy = new EthernetPhyDevice({ clockNode: null, linkPulses: false });
+    ga.attachDevice(phy);
+    // Node 217 waits on its pin through the left port
+    const compiled = compileCube(`#include std
+node 217
+/\\
+std.recv{port=${PORT.LEFT}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    phy.enqueueFrame(FRAME, 5000);
+    ga.stepProgramN(2000);
+
+    const log = ga.getDebugLogDelta(0);
+    expect(log.values).toHaveLength(1);
+    expect(log.timestamps[0]).toBeGreaterThanOrEqual(5050);
+  });
+});
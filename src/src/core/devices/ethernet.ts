@@ -0,0 +1,350 @@
+/**
+ * 10BASE-T line — the far end of the AN007 NIC's twisted pairs.
+ *
+ * Receive: frames (from enqueueFrame or a pcap file) get preamble, SFD,
+ * padding and FCS, and are Manchester coded onto the Rx node's pin17 as
+ * level changes only, one device event per edge. Frames are expanded
+ * just before they go on the line, so long captures cost no memory up
+ * front. Normal link pulses are sent every 16 ms while the line is idle.
+ *
+ * Transmit: the Tx node's pin17 drive (io bits 17:16; high-Z counts as
+ * low) is collected into bursts separated by idle line. Each burst is
+ * decoded by locking onto mid-cell edges; bursts carrying an SFD become
+ * frames with their FCS checked, short ones count as link pulses.
+ *
+ * Loopback mirrors the Tx pin onto the Rx pin after a cable delay, so a
+ * NIC can talk to itself with no pcap input.
+ *
+ * The 10 MHz reference the Tx pin node times itself by is a square wave
+ * on the clock node's pin17.
+ */
+import type { Device, DeviceHost } from './device';
+import { crc32 } from '../crc32';
+
+export interface EthernetFrame {
+  /** Guest time (ns) of the frame's first edge. */
+  timeNS: number;
+  /** Destination MAC through payload, without FCS. */
+  data: Uint8Array;
+  fcsOk: boolean;
+}
+
+export interface EthernetPhyOptions {
+  /** Node whose pin17 receives the line (default 217). */
+  rxNode?: number;
+  /** Node whose pin17 drives the line (default 317). */
+  txNode?: number;
+  /** Node given the 10 MHz reference on pin17, or null for none (default 417). */
+  clockNode?: number | null;
+  /** Mirror Tx onto Rx instead of sending queued frames. */
+  loopback?: boolean;
+  loopbackDelayNS?: number;
+  /** Send normal link pulses while idle (default on unless loopback). */
+  linkPulses?: boolean;
+  /** Called for every frame decoded from the Tx pin. */
+  onFrame?: (frame: EthernetFrame) => void;
+}
+
+/** Bit time at 10 Mb/s (ns). */
+export const ETH_BIT_NS = 100;
+const HALF_NS = ETH_BIT_NS / 2;
+const IFG_NS = 96 * ETH_BIT_NS;
+const NLP_INTERVAL_NS = 16_000_000;
+/** Quiet line that ends a Tx burst; longer than the 3-bit TP_IDL. */
+const IDLE_GAP_NS = 5 * ETH_BIT_NS;
+const MIN_FRAME = 60;
+
+/** Preamble, SFD, frame padded to the minimum size, and FCS. */
+export function encodeEthernetFrame(data: Uint8Array): Uint8Array {
+  const len = Math.max(data.length, MIN_FRAME);
+  const out = new Uint8Array(8 + len + 4);
+  out.fill(0x55, 0, 7);
+  out[7] = 0xD5;
+  out.set(data, 8);
+  const fcs = crc32(out.subarray(8, 8 + len));
+  for (let i = 0; i < 4; i++) out[8 + len + i] = (fcs >>> (8 * i)) & 0xFF;
+  return out;
+}
+
+/**
+ * Manchester line levels for `octets` (LSB first) starting at `startNS`:
+ * a 1 is low then high, a 0 high then low. Only changes are returned,
+ * from and back to an idle low line, ending with the 3-bit TP_IDL high.
+ */
+export function manchesterEdges(octets: Uint8Array, startNS: number): { times: number[]; levels: boolean[]; endNS: number } {
+  const times: number[] = [];
+  const levels: boolean[] = [];
+  let level = false;
+  const set = (v: boolean, t: number) => {
+    if (v === level) return;
+    times.push(t);
+    levels.push(v);
+    level = v;
+  };
+  let t = startNS;
+  for (const byte of octets) {
+    for (let i = 0; i < 8; i++) {
+      const bit = ((byte >> i) & 1) === 1;
+      set(!bit, t);
+      set(bit, t + HALF_NS);
+      t += ETH_BIT_NS;
+    }
+  }
+  set(true, t);
+  set(false, t + 3 * ETH_BIT_NS);
+  return { times, levels, endNS: t + 3 * ETH_BIT_NS };
+}
+
+/**
+ * Decode one burst of line edges into the octets after the SFD (FCS
+ * included), or null if there is no SFD. Bits are the levels after
+ * mid-cell edges; each next mid-cell edge is the first one 3/4 to 5/4 of
+ * a bit time on, which skips cell-boundary edges and tracks drift.
+ */
+export function decodeManchester(times: number[], levels: boolean[]): Uint8Array | null {
+  const n = times.length;
+  if (n === 0) return null;
+  const bits: number[] = [levels[0] ? 1 : 0];
+  let mid = times[0];
+  let j = 1;
+  for (;;) {
+    while (j < n && times[j] < mid + 0.75 * ETH_BIT_NS) j++;
+    if (j >= n || times[j] > mid + 1.25 * ETH_BIT_NS) break;
+    bits.push(levels[j] ? 1 : 0);
+    mid = times[j];
+    j++;
+  }
+  // The preamble alternates; the SFD ends with the first pair of 1s
+  let k = 1;
+  while (k < bits.length && !(bits[k - 1] === 1 && bits[k] === 1)) k++;
+  if (k >= bits.length) return null;
+  const first = k + 1;
+  const out = new Uint8Array((bits.length - first) >> 3);
+  for (let i = 0; i < out.length; i++) {
+    let byte = 0;
+    for (let b = 0; b < 8; b++) byte |= bits[first + 8 * i + b] << b;
+    out[i] = byte;
+  }
+  return out;
+}
+
+export class EthernetPhyDevice implements Device {
+  readonly name = 'eth-phy';
+  readonly rxNode: number;
+  readonly txNode: number;
+  readonly clockNode: number | null;
+  readonly loopback: boolean;
+  private readonly loopbackDelayNS: number;
+  private readonly linkPulses: boolean;
+  private readonly onFrame: ((frame: EthernetFrame) => void) | null;
+  private host: DeviceHost | null = null;
+  private unsubscribe: (() => void) | null = null;
+  private scheduledNS = Infinity;
+
+  // Rx line: queued frames, then the edges of the one on the line
+  private frames: { data: Uint8Array; atNS: number }[] = [];
+  private nextFrame = 0;
+  private rxTimes: number[] = [];
+  private rxLevels: boolean[] = [];
+  private rxIdx = 0;
+  private rxEndNS = -Infinity;
+  private nlpDueNS = NLP_INTERVAL_NS;
+  private clockNS = HALF_NS;
+  private clockLevel = false;
+
+  // Tx line: edges of the current burst
+  private txLevel = false;
+  private txTimes: number[] = [];
+  private txLevels: boolean[] = [];
+
+  // Statistics
+  private rxSent = 0;
+  private txFrames = 0;
+  private txBytes = 0;
+  private fcsErrors = 0;
+  private linkPulseCount = 0;
+  private fragments = 0;
+  private firstTxNS: number | null = null;
+  private lastTxNS: number | null = null;
+
+  constructor(options: EthernetPhyOptions = {}) {
+    this.rxNode = options.rxNode ?? 217;
+    this.txNode = options.txNode ?? 317;
+    this.clockNode = options.clockNode === undefined ? 417 : options.clockNode;
+    this.loopback = options.loopback ?? false;
+    this.loopbackDelayNS = options.loopbackDelayNS ?? 50;
+    this.linkPulses = options.linkPulses ?? !this.loopback;
+    this.onFrame = options.onFrame ?? null;
+  }
+
+  attach(host: DeviceHost): void {
+    this.host = host;
+    this.unsubscribe = host.ioBus.subscribe({ coords: [this.txNode] }, (_coord, value, timeNS) => {
+      this.txEdge(((value >> 16) & 3) === 3, timeNS);
+    });
+    this.reschedule();
+  }
+
+  detach(): void {
+    this.unsubscribe?.();
+    this.unsubscribe = null;
+    this.host = null;
+  }
+
+  /** Queue a frame (no preamble or FCS) to arrive at `atNS`, or as soon as
+   *  the line is free after the previous one plus the interframe gap. */
+  enqueueFrame(data: Uint8Array, atNS = 0): void {
+    this.frames.push({ data, atNS });
+    this.reschedule();
+  }
+
+  /** Frames queued but not yet on the line. */
+  get pending(): number {
+    return this.frames.length - this.nextFrame;
+  }
+
+  /** Decode the Tx burst in progress, if any (call at the end of a run). */
+  flush(): void {
+    this.finishBurst();
+  }
+
+  // ---- Receive ----
+
+  private nextFrameNS(): number {
+    if (this.nextFrame >= this.frames.length) return Infinity;
+    return Math.max(this.frames[this.nextFrame].atNS, this.rxEndNS + IFG_NS);
+  }
+
+  private pushRx(level: boolean, timeNS: number): void {
+    const last = this.rxTimes.length > this.rxIdx ? this.rxTimes[this.rxTimes.length - 1] : -Infinity;
+    this.rxTimes.push(Math.max(timeNS, last));
+    this.rxLevels.push(level);
+  }
+
+  private reschedule(): void {
+    const host = this.host;
+    if (host === null) return;
+    let next = this.rxIdx < this.rxTimes.length ? this.rxTimes[this.rxIdx] : Math.min(
+      this.nextFrameNS(),
+      this.linkPulses ? this.nlpDueNS : Infinity,
+    );
+    if (this.clockNode !== null) next = Math.min(next, this.clockNS);
+    if (next < this.scheduledNS) {
+      this.scheduledNS = next;
+      host.schedule(next);
+    }
+  }
+
+  onEvent(timeNS: number): void {
+    const host = this.host!;
+    if (timeNS >= this.scheduledNS) this.scheduledNS = Infinity;
+
+    if (this.clockNode !== null && timeNS >= this.clockNS) {
+      this.clockLevel = !this.clockLevel;
+      host.setPin(this.clockNode, 17, this.clockLevel);
+      this.clockNS += HALF_NS;
+    }
+
+    // An idle line takes the next frame or link pulse that is due
+    if (this.rxIdx >= this.rxTimes.length) {
+      this.rxTimes = [];
+      this.rxLevels = [];
+      this.rxIdx = 0;
+      if (this.nextFrameNS() <= timeNS) {
+        const frame = this.frames[this.nextFrame++];
+        const edges = manchesterEdges(encodeEthernetFrame(frame.data), timeNS);
+        this.rxTimes = edges.times;
+        this.rxLevels = edges.levels;
+        this.rxEndNS = edges.endNS;
+        this.nlpDueNS = edges.endNS + NLP_INTERVAL_NS;
+        this.rxSent++;
+        if (this.nextFrame === this.frames.length) {
+          this.frames = [];
+          this.nextFrame = 0;
+        }
+      } else if (this.linkPulses && this.nlpDueNS <= timeNS) {
+        this.pushRx(true, timeNS);
+        this.pushRx(false, timeNS + ETH_BIT_NS);
+        this.rxEndNS = timeNS + ETH_BIT_NS;
+        this.nlpDueNS = timeNS + NLP_INTERVAL_NS;
+      }
+    }
+    while (this.rxIdx < this.rxTimes.length && this.rxTimes[this.rxIdx] <= timeNS) {
+      host.setPin(this.rxNode, 17, this.rxLevels[this.rxIdx++]);
+    }
+    this.reschedule();
+  }
+
+  // ---- Transmit ----
+
+  private txEdge(level: boolean, timeNS: number): void {
+    if (level === this.txLevel) return;
+    this.txLevel = level;
+    const n = this.txTimes.length;
+    if (n > 0 && timeNS - this.txTimes[n - 1] > IDLE_GAP_NS) this.finishBurst();
+    this.txTimes.push(timeNS);
+    this.txLevels.push(level);
+    if (this.loopback) {
+      this.pushRx(level, timeNS + this.loopbackDelayNS);
+      this.reschedule();
+    }
+  }
+
+  private finishBurst(): void {
+    const times = this.txTimes;
+    if (times.length === 0) return;
+    const octets = decodeManchester(times, this.txLevels);
+    const startNS = times[0];
+    this.txTimes = [];
+    this.txLevels = [];
+    if (octets === null || octets.length < 4) {
+      if (times[times.length - 1] - startNS <= 2 * ETH_BIT_NS) this.linkPulseCount++;
+      else this.fragments++;
+      return;
+    }
+    const data = octets.slice(0, octets.length - 4);
+    const fcs = (octets[octets.length - 4] | octets[octets.length - 3] << 8
+      | octets[octets.length - 2] << 16 | octets[octets.length - 1] << 24) >>> 0;
+    const fcsOk = crc32(data) === fcs;
+    if (!fcsOk) this.fcsErrors++;
+    this.txFrames++;
+    this.txBytes += octets.length;
+    this.firstTxNS ??= startNS;
+    this.lastTxNS = times[times.length - 1];
+    this.onFrame?.({ timeNS: startNS, data, fcsOk });
+  }
+
+  reset(): void {
+    this.scheduledNS = Infinity;
+    this.frames = [];
+    this.nextFrame = 0;
+    this.rxTimes = [];
+    this.rxLevels = [];
+    this.rxIdx = 0;
+    this.rxEndNS = -Infinity;
+    this.nlpDueNS = NLP_INTERVAL_NS;
+    this.clockNS = HALF_NS;
+    this.clockLevel = false;
+    this.txLevel = false;
+    this.txTimes = [];
+    this.txLevels = [];
+    this.rxSent = this.txFrames = this.txBytes = this.fcsErrors = this.linkPulseCount = this.fragments = 0;
+    this.firstTxNS = this.lastTxNS = null;
+    this.reschedule();
+  }
+
+  snapshot(): unknown {
+    return {
+      loopback: this.loopback,
+      rxFrames: this.rxSent,
+      rxPending: this.pending,
+      txFrames: this.txFrames,
+      txBytes: this.txBytes,
+      fcsErrors: this.fcsErrors,
+      linkPulses: this.linkPulseCount,
+      fragments: this.fragments,
+      firstTxNS: this.firstTxNS,
+      lastTxNS: this.lastTxNS,
+    };
+  }
+}
@@ -0,0 +1,196 @@
+/**
+ * Tests for the I2C bus model: protocol decode, register and EEPROM
+ * slaves, clock stretching and timing checks, driven by a bit-banged
+ * master on node 708's io register.
+ */
+import { describe, it, expect } from 'vitest';
+import { IoBus } from '../io-bus';
+import { coordToIndex } from '../constants';
+import { I2cBusDevice, I2cRegisterDevice, I2cEepromDevice } from './i2c';
+import type { I2cBusOptions } from './i2c';
+import type { DeviceHost, GpioPin } from './device';
+
+/** A 400 kHz master (1.4 µs low, 1.1 µs high) on 708.17/708.1. */
+function busMaster(options: I2cBusOptions = {}, lowNS = 1400, highNS = 1100) {
+  const ioBus = new IoBus();
+  const queue: number[] = [];
+  const level = new Map<GpioPin, boolean>();
+  let now = 0;
+  const host = {
+    now: () => now,
+    schedule: (t: number) => { queue.push(t); },
+    setPin: (_coord: number, pin: GpioPin, l: boolean) => { level.set(pin, l); },
+    getPin: () => false,
+    setAnalogSource: () => {},
+    setDataBus: () => {},
+    setExternalPort: () => {},
+    deliverPortValue: () => {},
+    ioBus,
+  } satisfies DeviceHost;
+  const bus = new I2cBusDevice(options);
+  bus.attach(host);
+
+  let sclLow = false;
+  let sdaLow = false;
+  const drive = () => ioBus.publish(coordToIndex(708), (sclLow ? 0x20000 : 0) | (sdaLow ? 2 : 0), now, 0);
+  /** SCL is low and SDA set up: one clock pulse, returning SDA. */
+  const clock = (): boolean => {
+    now += lowNS;
+    sclLow = false;
+    drive();
+    while (!level.get(17)) {
+      queue.sort((a, b) => a - b);
+      now = queue.shift()!;
+      bus.onEvent(now);
+    }
+    const bit = level.get(1)!;
+    now += highNS;
+    sclLow = true;
+    drive();
+    return bit;
+  };
+  const start = () => {
+    if (sclLow) {
+      sdaLow = false;
+      drive();
+      now += lowNS;
+      sclLow = false;
+      drive();
+      now += highNS;
+    }
+    sdaLow = true;
+    drive();
+    now += highNS;
+    sclLow = true;
+    drive();
+  };
+  const stop = () => {
+    sdaLow = true;
+    drive();
+    now += lowNS;
+    sclLow = false;
+    drive();
+    now += highNS;
+    sdaLow = false;
+    drive();
+    now += lowNS;
+  };
+  /** Returns true when the byte was acknowledged. */
+  const write = (byte: number): boolean => {
+    for (let i = 7; i >= 0; i--) {
+      sdaLow = ((byte >> i) & 1) === 0;
+      drive();
+      clock();
+    }
+    sdaLow = false;
+    drive();
+    return !clock();
+  };
+  const read = (ack: boolean): number => {
+    sdaLow = false;
+    drive();
+    let v = 0;
+    for (let i = 0; i < 8; i++) v = (v << 1) | (clock() ? 1 : 0);
+    sdaLow = ack;
+    drive();
+    clock();
+    return v;
+  };
+  return { bus, queue, start, stop, write, read, now: () => now, wait: (ns: number) => { now += ns; } };
+}
+
+describe('I2cBusDevice', () => {
+  it('reads registers with a repeated start and no scheduled events', () => {
+    const m = busMaster();
+    const sensor = new I2cRegisterDevice(0x40, {
+      registers: { 0xFE: 0x54, 0xFF: 0x49 },
+      sample: (reg, timeNS) => (reg === 0x01 ? timeNS & 0xFF : undefined),
+    });
+    m.bus.addSlave(sensor);
+
+    m.start();
+    expect(m.write(0x40 << 1)).toBe(true);
+    expect(m.write(0xFE)).toBe(true);
+    m.start();
+    expect(m.write((0x40 << 1) | 1)).toBe(true);
+    expect([m.read(true), m.read(false)]).toEqual([0x54, 0x49]);
+    m.stop();
+
+    m.start();
+    m.write(0x40 << 1);
+    m.write(0x02);
+    m.write(0xA5);
+    m.stop();
+    expect(sensor.registers[2]).toBe(0xA5);
+
+    expect(m.queue).toHaveLength(0);
+    expect(m.bus.snapshot()).toMatchObject({
+      transfers: 3, bytes: 5, nacks: 0,
+      violations: { tLOW: 0, tHIGH: 0, tHD_STA: 0, tSU_STA: 0, tSU_STO: 0, tBUF: 0, tSU_DAT: 0 },
+    });
+  });
+
+  it('NACKs unknown addresses and rejects duplicates', () => {
+    const m = busMaster();
+    m.bus.addSlave(new I2cRegisterDevice(0x40));
+    expect(() => m.bus.addSlave(new I2cEepromDevice(0x40))).toThrow('already in use');
+    m.start();
+    expect(m.write(0x41 << 1)).toBe(false);
+    m.stop();
+    expect(m.bus.snapshot()).toMatchObject({ transfers: 0, nacks: 1 });
+  });
+
+  it('stretches the clock after each acknowledged byte', () => {
+    const m = busMaster();
+    m.bus.addSlave(new I2cRegisterDevice(0x44, { stretchNS: 10_000, registers: { 0: 0x12 } }));
+    m.start();
+    m.write((0x44 << 1) | 1);
+    const before = m.now();
+    expect(m.read(false)).toBe(0x12);
+    expect(m.now() - before).toBe(9 * 2500 + 10_000 - 1400);
+    m.stop();
+    expect(m.bus.snapshot()).toMatchObject({ stretches: 1 });
+  });
+
+  it('counts timing violations for the selected mode', () => {
+    const m = busMaster({ mode: 'standard' });
+    m.bus.addSlave(new I2cRegisterDevice(0x40));
+    m.start();
+    m.write(0x40 << 1);
+    m.stop();
+    const { violations } = m.bus.snapshot() as { violations: Record<string, number> };
+    expect(violations.tLOW).toBe(10);
+    expect(violations.tHIGH).toBe(9);
+    expect(violations.tSU_DAT).toBe(0);
+  });
+});
+
+describe('I2cEepromDevice', () => {
+  it('wraps page writes and NACKs during the write cycle', () => {
+    const m = busMaster();
+    const eeprom = new I2cEepromDevice(0x50, { pageSize: 8, writeCycleNS: 100_000 });
+    m.bus.addSlave(eeprom);
+
+    m.start();
+    m.write(0x50 << 1);
+    m.write(0x06);
+    for (const b of [1, 2, 3, 4]) m.write(b);
+    m.stop();
+    expect(Array.from(eeprom.data.subarray(0, 8))).toEqual([3, 4, 0xFF, 0xFF, 0xFF, 0xFF, 1, 2]);
+
+    m.start();
+    expect(m.write(0x50 << 1)).toBe(false);
+    m.stop();
+    m.wait(100_000);
+    m.start();
+    expect(m.write(0x50 << 1)).toBe(true);
+    m.write(0x06);
+    m.start();
+    m.write((0x50 << 1) | 1);
+    expect([m.read(true), m.read(true), m.read(false)]).toEqual([1, 2, 0xFF]);
+    m.stop();
+
+    m.bus.reset();
+    expect(eeprom.data[6]).toBe(1);
+  });
+});
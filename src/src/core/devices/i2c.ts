@@ -0,0 +1,458 @@
+/**
+ * I2C bus — open-drain SCL and SDA lines with pull-ups, wired to GPIO pins,
+ * with slave devices answering at byte level.
+ *
+ * A line is low while the master's pin drives low (control field 10) or
+ * a slave holds it; released (00/01) or driven-high (11) pins leave it to
+ * the pull-up. Line levels are fed back to the pins' inputs, so the master
+ * reads the bus and a pin17 line can wake it. The master's io writes are
+ * the only input: START/STOP, bits and ACKs are decoded from them as they
+ * happen, and slaves answer on the same SCL edge. The only scheduled
+ * events are the ends of clock stretches, so a 400 kHz bus costs nothing
+ * between edges.
+ *
+ * Every edge is checked against the standard- or fast-mode minimum times
+ * (tLOW, tHIGH, tHD;STA, tSU;STA, tSU;STO, tBUF, tSU;DAT); violations are
+ * counted per parameter.
+ */
+import type { Device, DeviceHost, GpioPin } from './device';
+
+export interface I2cSlave {
+  /** 7-bit address. */
+  readonly address: number;
+  /** Hold SCL low this long after each acknowledged byte (ns); 0 for none. */
+  readonly stretchNS?: number;
+  /** Addressed for a read or write; return false to NACK. */
+  start(read: boolean, timeNS: number): boolean;
+  /** A byte from the master; return false to NACK it. */
+  write(byte: number, timeNS: number): boolean;
+  /** The next byte for the master. */
+  read(timeNS: number): number;
+  /** STOP or a repeated START ended the transfer. */
+  stop(timeNS: number): void;
+  reset?(): void;
+}
+
+export type I2cMode = 'standard' | 'fast';
+
+/** Minimum times per mode (ns), I2C-bus specification UM10204 table 10. */
+export const I2C_TIMING: Record<I2cMode, Record<I2cTimingParam, number>> = {
+  standard: { tLOW: 4700, tHIGH: 4000, tHD_STA: 4000, tSU_STA: 4700, tSU_STO: 4000, tBUF: 4700, tSU_DAT: 250 },
+  fast: { tLOW: 1300, tHIGH: 600, tHD_STA: 600, tSU_STA: 600, tSU_STO: 600, tBUF: 1300, tSU_DAT: 100 },
+};
+
+export type I2cTimingParam = 'tLOW' | 'tHIGH' | 'tHD_STA' | 'tSU_STA' | 'tSU_STO' | 'tBUF' | 'tSU_DAT';
+
+export interface I2cLine {
+  node: number;
+  pin: GpioPin;
+}
+
+export interface I2cBusOptions {
+  /** Default 708.17 (AN012 sensor bus). */
+  scl?: I2cLine;
+  /** Default 708.1. */
+  sda?: I2cLine;
+  /** Timing checked against (default fast). */
+  mode?: I2cMode;
+}
+
+/** Shift of a pin's 2-bit control field in the io register. */
+const FIELD_SHIFT: Record<GpioPin, number> = { 17: 16, 5: 4, 3: 2, 1: 0 };
+
+type BusState = 'idle' | 'addr' | 'write' | 'read' | 'ignore';
+
+export class I2cBusDevice implements Device {
+  readonly name = 'i2c';
+  readonly scl: I2cLine;
+  readonly sda: I2cLine;
+  readonly mode: I2cMode;
+  private readonly timing: Record<I2cTimingParam, number>;
+  private readonly slaves: I2cSlave[] = [];
+  private host: DeviceHost | null = null;
+  private unsubscribe: (() => void) | null = null;
+
+  // Line drivers and levels
+  private masterScl = false;  // master pulls low
+  private masterSda = false;
+  private slaveSda = false;
+  private stretchUntil = -Infinity;
+  private sclLevel = true;
+  private sdaLevel = true;
+
+  // Protocol
+  private state: BusState = 'idle';
+  private active: I2cSlave | null = null;
+  private bit = 0;           // clock within the byte: 0-7 data, 8 the ACK
+  private shift = 0;
+  private outByte = 0;
+
+  // Edge times for the timing checks
+  private sclRiseNS = -Infinity;
+  private sclFallNS = -Infinity;
+  private sdaChangeNS = -Infinity;
+  private startNS = -Infinity;
+  private stopNS = -Infinity;
+  private startPending = false;
+
+  // Statistics
+  private transfers = 0;
+  private bytes = 0;
+  private nacks = 0;
+  private stretches = 0;
+  private violations: Record<I2cTimingParam, number> = I2cBusDevice.noViolations();
+
+  constructor(options: I2cBusOptions = {}) {
+    this.scl = options.scl ?? { node: 708, pin: 17 };
+    this.sda = options.sda ?? { node: 708, pin: 1 };
+    this.mode = options.mode ?? 'fast';
+    this.timing = I2C_TIMING[this.mode];
+  }
+
+  private static noViolations(): Record<I2cTimingParam, number> {
+    return { tLOW: 0, tHIGH: 0, tHD_STA: 0, tSU_STA: 0, tSU_STO: 0, tBUF: 0, tSU_DAT: 0 };
+  }
+
+  /** Put a slave on the bus. Addresses must be unique. */
+  addSlave(slave: I2cSlave): void {
+    if (this.slaves.some(s => s.address === slave.address)) {
+      throw new Error(`I2C address 0x${slave.address.toString(16)} is already in use`);
+    }
+    this.slaves.push(slave);
+  }
+
+  attach(host: DeviceHost): void {
+    this.host = host;
+    const coords = this.scl.node === this.sda.node ? [this.scl.node] : [this.scl.node, this.sda.node];
+    this.unsubscribe = host.ioBus.subscribe({ coords }, (coord, value, timeNS) => {
+      if (coord === this.scl.node) this.masterScl = ((value >> FIELD_SHIFT[this.scl.pin]) & 3) === 2;
+      if (coord === this.sda.node) this.masterSda = ((value >> FIELD_SHIFT[this.sda.pin]) & 3) === 2;
+      this.update(timeNS);
+    });
+    this.driveInputs();
+  }
+
+  detach(): void {
+    this.unsubscribe?.();
+    this.unsubscribe = null;
+    this.host = null;
+  }
+
+  private driveInputs(): void {
+    this.host!.setPin(this.scl.node, this.scl.pin, this.sclLevel);
+    this.host!.setPin(this.sda.node, this.sda.pin, this.sdaLevel);
+  }
+
+  // ---- Lines ----
+
+  private update(timeNS: number): void {
+    const scl = !this.masterScl && timeNS >= this.stretchUntil;
+    const sda = !this.masterSda && !this.slaveSda;
+    // A write that moves both lines changes SDA inside the SCL low time
+    if (scl && !this.sclLevel) {
+      this.setSda(sda, timeNS);
+      this.setScl(scl, timeNS);
+    } else {
+      this.setScl(scl, timeNS);
+      this.setSda(!this.masterSda && !this.slaveSda, timeNS);
+    }
+  }
+
+  private setScl(level: boolean, timeNS: number): void {
+    if (level === this.sclLevel) return;
+    this.sclLevel = level;
+    this.host!.setPin(this.scl.node, this.scl.pin, level);
+    if (level) this.sclRise(timeNS);
+    else this.sclFall(timeNS);
+  }
+
+  private setSda(level: boolean, timeNS: number): void {
+    if (level === this.sdaLevel) return;
+    this.sdaLevel = level;
+    this.host!.setPin(this.sda.node, this.sda.pin, level);
+    this.sdaChangeNS = timeNS;
+    if (!this.sclLevel) return;
+    if (!level) this.start(timeNS);
+    else this.stop(timeNS);
+  }
+
+  private driveSda(low: boolean, timeNS: number): void {
+    this.slaveSda = low;
+    this.setSda(!this.masterSda && !low, timeNS);
+  }
+
+  private check(param: I2cTimingParam, elapsedNS: number): void {
+    if (elapsedNS < this.timing[param]) this.violations[param]++;
+  }
+
+  // ---- Protocol ----
+
+  private start(timeNS: number): void {
+    if (this.state !== 'idle') {
+      this.check('tSU_STA', timeNS - this.sclRiseNS);
+      this.endTransfer(timeNS);
+    } else {
+      this.check('tBUF', timeNS - this.stopNS);
+    }
+    this.state = 'addr';
+    this.bit = -1;  // the fall that ends the START is not a data clock
+    this.shift = 0;
+    this.startNS = timeNS;
+    this.startPending = true;
+  }
+
+  private stop(timeNS: number): void {
+    this.check('tSU_STO', timeNS - this.sclRiseNS);
+    this.endTransfer(timeNS);
+    this.state = 'idle';
+    this.stopNS = timeNS;
+  }
+
+  private endTransfer(timeNS: number): void {
+    this.active?.stop(timeNS);
+    this.active = null;
+    if (this.slaveSda) this.driveSda(false, timeNS);
+  }
+
+  private sclRise(timeNS: number): void {
+    this.check('tLOW', timeNS - this.sclFallNS);
+    if (this.sdaChangeNS > this.sclFallNS) this.check('tSU_DAT', timeNS - this.sdaChangeNS);
+    this.sclRiseNS = timeNS;
+    if (this.bit < 8) {
+      if (this.state === 'addr' || this.state === 'write') this.shift = (this.shift << 1 | (this.sdaLevel ? 1 : 0)) & 0xFF;
+    } else if (this.state === 'read' && this.sdaLevel) {
+      // Master NACK: the read is over
+      this.state = 'ignore';
+    }
+  }
+
+  private sclFall(timeNS: number): void {
+    this.check('tHIGH', timeNS - this.sclRiseNS);
+    if (this.startPending) {
+      this.check('tHD_STA', timeNS - this.startNS);
+      this.startPending = false;
+    }
+    this.sclFallNS = timeNS;
+    if (this.state === 'idle') return;
+    this.bit++;
+
+    if (this.bit === 8) {
+      // Byte complete: the receiver acknowledges in the 9th clock
+      if (this.state === 'addr') this.addressed(timeNS);
+      else if (this.state === 'write') this.received(timeNS);
+      else if (this.state === 'read') this.driveSda(false, timeNS);
+      return;
+    }
+    if (this.bit === 9) {
+      this.bit = 0;
+      if (this.slaveSda) this.driveSda(false, timeNS);
+      const stretch = this.active?.stretchNS ?? 0;
+      if (stretch > 0 && this.state !== 'ignore') {
+        this.stretchUntil = timeNS + stretch;
+        this.stretches++;
+        this.host!.schedule(this.stretchUntil);
+      }
+      if (this.state === 'read') {
+        this.outByte = this.active!.read(timeNS) & 0xFF;
+        this.bytes++;
+      }
+    }
+    if (this.state === 'read') this.driveSda(((this.outByte >> (7 - this.bit)) & 1) === 0, timeNS);
+  }
+
+  private addressed(timeNS: number): void {
+    const address = this.shift >> 1;
+    const read = (this.shift & 1) === 1;
+    const slave = this.slaves.find(s => s.address === address) ?? null;
+    if (slave === null || !slave.start(read, timeNS)) {
+      this.nacks++;
+      this.state = 'ignore';
+      return;
+    }
+    this.active = slave;
+    this.transfers++;
+    this.state = read ? 'read' : 'write';
+    this.driveSda(true, timeNS);
+  }
+
+  private received(timeNS: number): void {
+    this.bytes++;
+    if (this.active!.write(this.shift, timeNS)) {
+      this.driveSda(true, timeNS);
+    } else {
+      this.nacks++;
+      this.state = 'ignore';
+    }
+    this.shift = 0;
+  }
+
+  /** End of a clock stretch. */
+  onEvent(timeNS: number): void {
+    if (timeNS >= this.stretchUntil) this.update(timeNS);
+  }
+
+  reset(): void {
+    this.masterScl = this.masterSda = this.slaveSda = false;
+    this.stretchUntil = -Infinity;
+    this.sclLevel = this.sdaLevel = true;
+    this.state = 'idle';
+    this.active = null;
+    this.bit = this.shift = this.outByte = 0;
+    this.sclRiseNS = this.sclFallNS = this.sdaChangeNS = this.startNS = this.stopNS = -Infinity;
+    this.startPending = false;
+    this.transfers = this.bytes = this.nacks = this.stretches = 0;
+    this.violations = I2cBusDevice.noViolations();
+    for (const s of this.slaves) s.reset?.();
+    if (this.host) this.driveInputs();
+  }
+
+  snapshot(): unknown {
+    return {
+      mode: this.mode,
+      transfers: this.transfers,
+      bytes: this.bytes,
+      nacks: this.nacks,
+      stretches: this.stretches,
+      violations: { ...this.violations },
+      slaves: this.slaves.map(s => s.address),
+    };
+  }
+}
+
+// ---- Slaves ----
+
+export interface I2cRegisterOptions {
+  /** Register file size in bytes (default 256). */
+  size?: number;
+  /** Initial register values. */
+  registers?: Record<number, number>;
+  /** Live value of a register at read time; undefined reads the file. */
+  sample?: (reg: number, timeNS: number) => number | undefined;
+  stretchNS?: number;
+}
+
+/**
+ * A register-file sensor: the first byte of a write sets the register
+ * pointer, further bytes are stored with auto-increment, and reads
+ * continue from the pointer.
+ */
+export class I2cRegisterDevice implements I2cSlave {
+  readonly address: number;
+  readonly stretchNS: number;
+  readonly registers: Uint8Array;
+  private readonly initial: Uint8Array;
+  private readonly sample: ((reg: number, timeNS: number) => number | undefined) | null;
+  private pointer = 0;
+  private pointerNext = false;
+
+  constructor(address: number, options: I2cRegisterOptions = {}) {
+    this.address = address;
+    this.stretchNS = options.stretchNS ?? 0;
+    this.registers = new Uint8Array(options.size ?? 256);
+    for (const [reg, value] of Object.entries(options.registers ?? {})) this.registers[Number(reg)] = value;
+    this.initial = this.registers.slice();
+    this.sample = options.sample ?? null;
+  }
+
+  start(read: boolean): boolean {
+    this.pointerNext = !read;
+    return true;
+  }
+
+  write(byte: number): boolean {
+    if (this.pointerNext) {
+      this.pointer = byte % this.registers.length;
+      this.pointerNext = false;
+    } else {
+      this.registers[this.pointer] = byte;
+      this.pointer = (this.pointer + 1) % this.registers.length;
+    }
+    return true;
+  }
+
+  read(timeNS: number): number {
+    const value = this.sample?.(this.pointer, timeNS) ?? this.registers[this.pointer];
+    this.pointer = (this.pointer + 1) % this.registers.length;
+    return value;
+  }
+
+  stop(): void {}
+
+  reset(): void {
+    this.registers.set(this.initial);
+    this.pointer = 0;
+  }
+}
+
+export interface I2cEepromOptions {
+  /** Size in bytes (default 256, a 24C02). */
+  size?: number;
+  /** Page size for writes (default 16). */
+  pageSize?: number;
+  /** Internal write cycle after STOP, NACKing its address meanwhile (default 5 ms). */
+  writeCycleNS?: number;
+}
+
+/**
+ * 24Cxx-style EEPROM: one address byte up to 256 bytes, two above.
+ * Writes wrap within a page and are committed at STOP, after which the
+ * device NACKs its address for the write cycle (acknowledge polling).
+ * Contents survive chip reset.
+ */
+export class I2cEepromDevice implements I2cSlave {
+  readonly address: number;
+  readonly data: Uint8Array;
+  private readonly pageSize: number;
+  private readonly writeCycleNS: number;
+  private readonly addressBytes: number;
+  private pointer = 0;
+  private addressLeft = 0;
+  private page: Map<number, number> = new Map();
+  private busyUntil = -Infinity;
+
+  constructor(address: number, options: I2cEepromOptions = {}) {
+    this.address = address;
+    this.data = new Uint8Array(options.size ?? 256).fill(0xFF);
+    this.pageSize = options.pageSize ?? 16;
+    this.writeCycleNS = options.writeCycleNS ?? 5_000_000;
+    this.addressBytes = this.data.length > 256 ? 2 : 1;
+  }
+
+  start(read: boolean, timeNS: number): boolean {
+    if (timeNS < this.busyUntil) return false;
+    this.addressLeft = read ? 0 : this.addressBytes;
+    if (!read) this.pointer = 0;
+    this.page.clear();
+    return true;
+  }
+
+  write(byte: number): boolean {
+    if (this.addressLeft > 0) {
+      this.pointer = ((this.pointer << 8) | byte) % this.data.length;
+      this.addressLeft--;
+      return true;
+    }
+    this.page.set(this.pointer, byte);
+    const base = this.pointer - (this.pointer % this.pageSize);
+    this.pointer = base + ((this.pointer + 1) % this.pageSize);
+    return true;
+  }
+
+  read(): number {
+    const value = this.data[this.pointer];
+    this.pointer = (this.pointer + 1) % this.data.length;
+    return value;
+  }
+
+  stop(timeNS: number): void {
+    if (this.page.size === 0) return;
+    for (const [addr, byte] of this.page) this.data[addr] = byte;
+    this.page.clear();
+    this.busyUntil = timeNS + this.writeCycleNS;
+  }
+
+  reset(): void {
+    this.busyUntil = -Infinity;
+    this.page.clear();
+  }
+}
@@ -0,0 +1,12 @@
+export type { Device, DeviceHost, DeviceSnapshot, GpioPin, AnalogSource, DataBus, ExternalPort } from './device';
+export { SerialInputDevice } from './serial-input';
+export { SramDevice, SRAM_CTRL_STOP } from './sram';
+export type { SramMode, SramOptions } from './sram';
+export { EthernetPhyDevice, encodeEthernetFrame, manchesterEdges, decodeManchester, ETH_BIT_NS } from './ethernet';
+export type { EthernetFrame, EthernetPhyOptions } from './ethernet';
+export { I2cBusDevice, I2cRegisterDevice, I2cEepromDevice, I2C_TIMING } from './i2c';
+export type { I2cSlave, I2cMode, I2cLine, I2cBusOptions, I2cTimingParam, I2cRegisterOptions, I2cEepromOptions } from './i2c';
+export { AnalogInputDevice, DEFAULT_VCO, arrayStream, functionStream, wavStream, csvStream } from './analog-input';
+export type { AnalogStream, AnalogChannel, AnalogInputOptions, VcoResponse, WavStreamOptions } from './analog-input';
+export { StimulusDevice, hasGpioPin, clockStimulus, bitsStimulus, serialStimulus, parseStimulusLine, stimulusFile } from './stimulus';
+export type { PinEvent } from './stimulus';
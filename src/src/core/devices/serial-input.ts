@@ -0,0 +1,92 @@
+/**
+ * Serial input device — drives a node's pin17 through a stream of timed
+ * levels. This is the EVB002 COM port path used for boot streams and
+ * terminal input, and the replay path for recorded pin traces.
+ *
+ * Only one event is in the queue at a time; each edge schedules the next.
+ * Appended bits continue an in-flight stream.
+ */
+import type { Device, DeviceHost } from './device';
+import type { SerialBit } from '../serial';
+
+export class SerialInputDevice implements Device {
+  readonly name = 'serial-in';
+
+  /** Gap (ns) inserted before a stream appended without a start time. */
+  static readonly GAP_NS = 1_000_000; // 1 ms between streams for clear separation
+
+  private host: DeviceHost | null = null;
+  private values: boolean[] = [];
+  private times: number[] = [];  // absolute start time of each bit
+  private endTime = 0;            // absolute end time of the last bit
+  private nextBit = 0;            // next bit to fire
+  private inFlight = false;
+  private coord: number | null = null;
+
+  attach(host: DeviceHost): void {
+    this.host = host;
+  }
+
+  /** Target node of the most recent stream, or null if none since reset. */
+  get node(): number | null {
+    return this.coord;
+  }
+
+  /** Bits not yet delivered. */
+  get pending(): number {
+    return this.values.length - this.nextBit;
+  }
+
+  /**
+   * Append bits for node `coord`. Durations are relative hold times. The
+   * stream starts after the previous one plus GAP_NS, or at `startNS` if
+   * given (still clamped to after the previous stream and now).
+   */
+  enqueue(coord: number, bits: SerialBit[], startNS?: number): void {
+    if (bits.length === 0) return;
+    const host = this.host!;
+    this.coord = coord;
+    const baseIdx = this.values.length;
+    let absTime = startNS !== undefined
+      ? Math.max(startNS, this.endTime, host.now())
+      : Math.max(this.endTime, host.now()) + SerialInputDevice.GAP_NS;
+    for (const bit of bits) {
+      this.values.push(bit.value);
+      this.times.push(absTime);
+      absTime += bit.durationNS;
+    }
+    this.endTime = absTime;
+    // A running chain reaches the appended bits on its own
+    if (!this.inFlight) {
+      this.nextBit = baseIdx;
+      this.inFlight = true;
+      host.schedule(this.times[baseIdx]);
+    }
+  }
+
+  onEvent(): void {
+    const host = this.host!;
+    if (this.coord !== null && this.nextBit < this.values.length) {
+      host.setPin(this.coord, 17, this.values[this.nextBit]);
+    }
+    this.nextBit++;
+    if (this.nextBit < this.values.length) {
+      host.schedule(this.times[this.nextBit]);
+    } else {
+      this.inFlight = false;
+    }
+  }
+
+  reset(): void {
+    this.values = [];
+    this.times = [];
+    this.endTime = 0;
+    this.nextBit = 0;
+    this.inFlight = false;
+    this.coord = null;
+  }
+
+  snapshot(): unknown {
+    return { node: this.coord, pending: this.pending, endTimeNS: this.endTime };
+  }
+}
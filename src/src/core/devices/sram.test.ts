@@ -0,0 +1,120 @@
+/**
+ * Tests for the external SRAM device: AN003 bus decode (pins mode) and
+ * the node 107 interface fast path (cluster mode).
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from '../ga144';
+import { ROM_DATA } from '../rom-data';
+import { compileCube } from '../cube';
+import { IoBus } from '../io-bus';
+import { EMU_PORT, PORT, coordToIndex } from '../constants';
+import { SramDevice, SRAM_CTRL_STOP } from './sram';
+import type { DataBus, DeviceHost } from './device';
+
+const inv = (w: number): number => ~w & 0x3FFFF;
+
+function makeGa(source: string, sram: SramDevice): GA144 {
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  ga.attachDevice(sram);
+  const compiled = compileCube(source);
+  expect(compiled.errors).toHaveLength(0);
+  ga.load(compiled);
+  return ga;
+}
+
+const send = (port: number, value: number) => `/\\\nstd.send{port=${port}, value=${value}}\n`;
+const recv = (port: number) => `/\\\nstd.recv{port=${port}, value=x}\n`;
+const debugX = `/\\\nstd.send{port=${EMU_PORT.DEBUG}, value=x}\n`;
+
+describe('SramDevice cluster mode', () => {
+  // Node 207 reaches 107 through its up port
+  it('serves ex! and ex@ from master 207 at the cluster cycle time', () => {
+    const sram = new SramDevice();
+    const ga = makeGa('#include std\nnode 207\n'
+      + send(PORT.UP, inv(1)) + send(PORT.UP, inv(0x1234)) + send(PORT.UP, 0xBEEF)
+      + send(PORT.UP, 1) + send(PORT.UP, 0x1234) + recv(PORT.UP) + debugX, sram);
+    ga.stepProgramN(2000);
+
+    const log = ga.getDebugLogDelta(0);
+    expect(log.values).toEqual([0xBEEF]);
+    expect(log.timestamps[0]).toBeGreaterThanOrEqual(450);  // write cycle + read cycle
+    expect(sram.mem[0x11234]).toBe(0xBEEF);
+    expect(sram.snapshot()).toMatchObject({ reads: 1, writes: 1 });
+  });
+
+  it('compare-and-exchanges only on a match', () => {
+    const sram = new SramDevice();
+    sram.mem[0x00042] = 7;
+    const cx = (port: number, n: number, w: number) =>
+      send(port, inv(n)) + send(port, 0) + send(port, 0x42) + send(port, w) + recv(port) + debugX;
+    // Master 108 reaches 107 through its left port
+    const ga = makeGa('#include std\nnode 207\n' + cx(PORT.UP, 5, 9) + 'node 108\n' + cx(PORT.LEFT, 7, 9), sram);
+    ga.stepProgramN(4000);
+
+    expect(ga.getDebugLogDelta(0).values.sort()).toEqual([0, 0xFFFF]);
+    expect(sram.mem[0x42]).toBe(9);
+  });
+
+  it('wakes a master blocked on its port when another posts a stimulus', () => {
+    const sram = new SramDevice();
+    // 106 reaches 107 through its right port; mk! [+x -1 m] posts to 106
+    const ga = makeGa('#include std\nnode 106\n' + recv(PORT.RIGHT) + send(EMU_PORT.DEBUG, 1)
+      + 'node 207\n' + send(PORT.UP, 0) + send(PORT.UP, inv(1)) + send(PORT.UP, 0x8000), sram);
+    ga.stepProgramN(2000);
+    expect(ga.getDebugLogDelta(0).values).toEqual([1]);
+  });
+
+  it('loads and dumps little-endian words and keeps them across reset', () => {
+    const sram = new SramDevice({ words: 1024 });
+    const source = '#include std\nnode 207\n' + send(PORT.UP, 0) + send(PORT.UP, 1) + recv(PORT.UP) + debugX;
+    const ga = makeGa(source, sram);
+    sram.load(new Uint8Array([0x34, 0x12, 0x78, 0x56]));
+    ga.reset();
+    ga.load(compileCube(source));
+    ga.stepProgramN(2000);
+
+    expect(ga.getDebugLogDelta(0).values).toEqual([0x5678]);
+    expect(Array.from(sram.dump(0, 2))).toEqual([0x34, 0x12, 0x78, 0x56]);
+  });
+});
+
+describe('SramDevice pins mode', () => {
+  function attachPins(sram: SramDevice) {
+    const ioBus = new IoBus();
+    const buses = new Map<number, DataBus>();
+    const host = {
+      now: () => 0,
+      schedule: () => {},
+      setPin: () => {},
+      getPin: () => false,
+      setAnalogSource: () => {},
+      setDataBus: (coord: number, bus: DataBus | null) => { if (bus) buses.set(coord, bus); },
+      setExternalPort: () => {},
+      deliverPortValue: () => {},
+      ioBus,
+    } satisfies DeviceHost;
+    sram.attach(host);
+    const io = (coord: number, value: number, t: number) => ioBus.publish(coordToIndex(coord), value, t, 0);
+    return { io, addr: buses.get(9)!, data: buses.get(7)! };
+  }
+
+  it('decodes AN003 write and read cycles with A18 from node 008', () => {
+    const sram = new SramDevice({ mode: 'pins' });
+    const { io, addr, data } = attachPins(sram);
+    io(8, SRAM_CTRL_STOP, 0);
+    addr.write(9, 0x123, 10);
+    io(7, 0x15555, 20);            // data pins out
+    data.write(7, 0xABCD, 30);
+    io(8, 0x2557A, 100);           // CE- WE- low, A18 high
+    io(8, SRAM_CTRL_STOP, 150);
+    expect(sram.mem[1 << 18 | 0x123]).toBe(0xABCD);
+
+    io(7, 0x14555, 160);           // data pins in
+    io(8, 0x2557E, 200);           // CE- low, WE- high
+    expect(data.read(7, 230)).toBe(0xABCD);  // before tAA
+    expect(data.read(7, 300)).toBe(0xABCD);
+    expect(sram.snapshot()).toMatchObject({ reads: 2, writes: 1, violations: 1 });
+  });
+});
@@ -0,0 +1,365 @@
+/**
+ * External SRAM — the EVB002's 1M x 16 CY62167 on the parallel bus of
+ * nodes 007/008/009, wired as in AN003.
+ *
+ * Two ways to drive it:
+ *
+ *   'pins'     the SRAM cluster's own code runs on 007/008/009 and the
+ *              device decodes the bus as it is written: node 009's DATA
+ *              writes are the low 18 address lines, node 008's io writes
+ *              the control pins (pin17 A19, pin5 A18, pin3 WE-, pin1 CE-),
+ *              node 007's DATA the 16-bit data bus, driven while its io has
+ *              bit 12 set. Reads closer than tAA to the address or CE-
+ *              edge, and WE- pulses shorter than tPWE, are counted as
+ *              timing violations.
+ *
+ *   'cluster'  the whole cluster (107, 007, 008, 009) is replaced by the
+ *              interface protocol of node 107. Masters 106, 207 and 108
+ *              talk to it through their ports toward 107 with the AN003
+ *              primitives ex@ [+p +a]→w, ex! [-p -a w], cx? [-n +p a w]→f
+ *              and mk! [+x -f m]. Each request completes at the end of its
+ *              last word with the cluster's cycle time and no instructions
+ *              are simulated on the four cluster nodes — the fast path for
+ *              frame buffers and tables kept in SRAM.
+ *
+ * Memory contents survive chip reset, as on the board.
+ */
+import type { Device, DeviceHost, ExternalPort } from './device';
+import { convertDirection } from '../constants';
+
+export type SramMode = 'pins' | 'cluster';
+
+export interface SramOptions {
+  mode?: SramMode;
+  /** Size in 16-bit words (default 1M, a power of two). */
+  words?: number;
+  /** Cluster ex@ and cx? latency from the last request word (ns). */
+  readCycleNS?: number;
+  /** Cluster ex! memory cycle; the next request waits for it (ns). */
+  writeCycleNS?: number;
+  /** Pins address access time (ns). */
+  tAA?: number;
+  /** Pins minimum WE- pulse width (ns). */
+  tPWE?: number;
+}
+
+// Bus nodes (pins mode)
+const DATA_NODE = 7;
+const CTRL_NODE = 8;
+const ADDR_NODE = 9;
+
+/** Node 007 io value bit that turns the data pins into outputs. */
+const DATA_DRIVE = 0x1000;
+
+/** Control word that de-asserts CE- and WE-. */
+export const SRAM_CTRL_STOP = 0x3557F;
+
+/** Masters of node 107 and their port write bits in its io register (AN003 §4). */
+const MASTERS: { coord: number; bit: number; toward: string }[] = [
+  { coord: 106, bit: 0x8000, toward: 'east' },
+  { coord: 207, bit: 0x0200, toward: 'south' },
+  { coord: 108, bit: 0x0800, toward: 'west' },
+];
+const ALL_MASTERS = 0x8A00;
+
+const isNeg = (w: number): boolean => (w & 0x20000) !== 0;
+const inv = (w: number): number => ~w & 0x3FFFF;
+
+interface MasterState {
+  coord: number;
+  bit: number;
+  words: number[];
+  reply: { value: number; readyNS: number } | null;
+  blocked: boolean;
+  stimulus: boolean;
+}
+
+export class SramDevice implements Device {
+  readonly name = 'sram';
+  readonly mode: SramMode;
+  readonly mem: Uint16Array;
+  private readonly addrMask: number;
+  private readonly readCycleNS: number;
+  private readonly writeCycleNS: number;
+  private readonly tAA: number;
+  private readonly tPWE: number;
+  private host: DeviceHost | null = null;
+  private unsubscribe: (() => void) | null = null;
+
+  // Statistics
+  private reads = 0;
+  private writes = 0;
+  private exchanges = 0;
+  private violations = 0;
+  private rejected = 0;
+
+  // Pins state
+  private addrLatch = 0;
+  private addrNS = 0;
+  private ctrl = SRAM_CTRL_STOP;
+  private ceNS = 0;
+  private weNS = 0;
+  private dataLatch = 0;
+  private driving = false;
+
+  // Cluster state
+  private masters: MasterState[] = [];
+  private enabled = ALL_MASTERS;
+  private busyUntil = 0;
+
+  constructor(options: SramOptions = {}) {
+    this.mode = options.mode ?? 'cluster';
+    const words = options.words ?? 1 << 20;
+    if (words <= 0 || (words & (words - 1)) !== 0) throw new Error(`SRAM size must be a power of two, got ${words}`);
+    this.mem = new Uint16Array(words);
+    this.addrMask = words - 1;
+    this.readCycleNS = options.readCycleNS ?? 250;
+    this.writeCycleNS = options.writeCycleNS ?? 200;
+    this.tAA = options.tAA ?? 55;
+    this.tPWE = options.tPWE ?? 40;
+    this.masters = MASTERS.map(m => ({
+      coord: m.coord, bit: m.bit, words: [], reply: null, blocked: false, stimulus: false,
+    }));
+  }
+
+  attach(host: DeviceHost): void {
+    this.host = host;
+    if (this.mode === 'pins') {
+      host.setDataBus(ADDR_NODE, {
+        read: () => this.addrLatch,
+        write: (_coord, value, timeNS) => {
+          this.addrLatch = value & 0x3FFFF;
+          this.addrNS = timeNS;
+          this.commitWrite();
+        },
+      });
+      host.setDataBus(DATA_NODE, {
+        read: (_coord, timeNS) => this.readDataBus(timeNS),
+        write: (_coord, value) => {
+          this.dataLatch = value;
+          this.commitWrite();
+        },
+      });
+      this.unsubscribe = host.ioBus.subscribe({ coords: [DATA_NODE, CTRL_NODE] }, (coord, value, timeNS) => {
+        if (coord === CTRL_NODE) {
+          this.setControl(value, timeNS);
+        } else {
+          this.driving = (value & DATA_DRIVE) !== 0;
+          this.commitWrite();
+        }
+      });
+    } else {
+      for (let i = 0; i < MASTERS.length; i++) {
+        const m = MASTERS[i];
+        host.setExternalPort(m.coord, convertDirection(m.coord, m.toward), this.masterPort(this.masters[i]));
+      }
+    }
+  }
+
+  detach(): void {
+    const host = this.host;
+    if (host === null) return;
+    if (this.mode === 'pins') {
+      host.setDataBus(ADDR_NODE, null);
+      host.setDataBus(DATA_NODE, null);
+      this.unsubscribe?.();
+      this.unsubscribe = null;
+    } else {
+      for (const m of MASTERS) host.setExternalPort(m.coord, convertDirection(m.coord, m.toward), null);
+    }
+    this.host = null;
+  }
+
+  // ---- Contents ----
+
+  /** Copy little-endian 16-bit words from `bytes` into memory at `wordAddr`. */
+  load(bytes: Uint8Array, wordAddr = 0): void {
+    const n = Math.min(bytes.length >> 1, this.mem.length - wordAddr);
+    for (let i = 0; i < n; i++) this.mem[wordAddr + i] = bytes[2 * i] | bytes[2 * i + 1] << 8;
+  }
+
+  /** `count` words from `wordAddr` as little-endian bytes. */
+  dump(wordAddr = 0, count = this.mem.length - wordAddr): Uint8Array {
+    const words = this.mem.subarray(wordAddr, wordAddr + count);
+    const out = new Uint8Array(words.length * 2);
+    for (let i = 0; i < words.length; i++) {
+      out[2 * i] = words[i] & 0xFF;
+      out[2 * i + 1] = words[i] >> 8;
+    }
+    return out;
+  }
+
+  // ---- Pins mode ----
+
+  private get address(): number {
+    const c = this.ctrl;
+    const a18 = ((c >> 4) & 3) === 3 ? 1 << 18 : 0;
+    const a19 = ((c >> 16) & 3) === 3 ? 1 << 19 : 0;
+    return (a19 | a18 | this.addrLatch) & this.addrMask;
+  }
+
+  /** Active-low control field driven low. */
+  private static asserted(ctrl: number, shift: number): boolean {
+    return ((ctrl >> shift) & 3) === 2;
+  }
+
+  private setControl(value: number, timeNS: number): void {
+    const prev = this.ctrl;
+    const wasCE = SramDevice.asserted(prev, 0);
+    const wasWE = wasCE && SramDevice.asserted(prev, 2);
+    this.ctrl = value;
+    const ce = SramDevice.asserted(value, 0);
+    const we = ce && SramDevice.asserted(value, 2);
+    if (ce && !wasCE) this.ceNS = timeNS;
+    if (we && !wasWE) this.weNS = timeNS;
+    if (wasWE && !we) {
+      this.writes++;
+      if (timeNS - this.weNS < this.tPWE) this.violations++;
+    }
+    // A18/A19 moving is an address change too
+    if (((value ^ prev) & 0x30030) !== 0) this.addrNS = timeNS;
+    this.commitWrite();
+  }
+
+  /** While CE- and WE- are low the driven data bus is written through. */
+  private commitWrite(): void {
+    if (this.driving && SramDevice.asserted(this.ctrl, 0) && SramDevice.asserted(this.ctrl, 2)) {
+      this.mem[this.address] = this.dataLatch & 0xFFFF;
+    }
+  }
+
+  private readDataBus(timeNS: number): number {
+    const c = this.ctrl;
+    if (this.driving || !SramDevice.asserted(c, 0) || SramDevice.asserted(c, 2)) return this.dataLatch;
+    this.reads++;
+    if (timeNS - Math.max(this.addrNS, this.ceNS) < this.tAA) this.violations++;
+    return this.mem[this.address];
+  }
+
+  // ---- Cluster mode ----
+
+  private masterPort(m: MasterState): ExternalPort {
+    return {
+      write: (value, timeNS) => {
+        // Node 107 takes the word once the previous memory cycle is done
+        const t = Math.max(timeNS, this.busyUntil);
+        if ((this.enabled & m.bit) === 0) {
+          this.rejected++;
+          return t;
+        }
+        m.words.push(value & 0x3FFFF);
+        this.execute(m, t);
+        return t;
+      },
+      read: (timeNS) => {
+        if (m.reply !== null) {
+          const r = m.reply;
+          m.reply = null;
+          return { value: r.value, readyNS: Math.max(timeNS, r.readyNS) };
+        }
+        if (m.stimulus) {
+          m.stimulus = false;
+          return { value: 0, readyNS: Math.max(timeNS, this.busyUntil) };
+        }
+        m.blocked = true;
+        return null;
+      },
+    };
+  }
+
+  /** Run `m`'s request once all its words have arrived; `t` is the last word's time. */
+  private execute(m: MasterState, t: number): void {
+    const w = m.words;
+    if (w.length < 2) return;
+    const [w0, w1] = w;
+    if (!isNeg(w0) && !isNeg(w1)) {
+      // ex@ [+p +a]
+      const readyNS = t + this.readCycleNS;
+      m.reply = { value: this.mem[this.clusterAddr(w0, w1)], readyNS };
+      this.busyUntil = readyNS;
+      this.reads++;
+    } else if (!isNeg(w0)) {
+      // mk! [+x -f m]
+      if (w.length < 3) return;
+      this.setMasks(inv(w1), w[2] & ALL_MASTERS, t);
+    } else if (isNeg(w1)) {
+      // ex! [-p -a w]
+      if (w.length < 3) return;
+      this.mem[this.clusterAddr(inv(w0), inv(w1))] = w[2] & 0xFFFF;
+      this.busyUntil = t + this.writeCycleNS;
+      this.writes++;
+    } else {
+      // cx? [-n +p a w]
+      if (w.length < 4) return;
+      const addr = this.clusterAddr(w1, w[2]);
+      const stored = this.mem[addr] === (inv(w0) & 0xFFFF);
+      if (stored) this.mem[addr] = w[3] & 0xFFFF;
+      const readyNS = t + this.readCycleNS + (stored ? this.writeCycleNS : 0);
+      m.reply = { value: stored ? 0xFFFF : 0, readyNS };
+      this.busyUntil = readyNS;
+      this.exchanges++;
+    }
+    w.length = 0;
+  }
+
+  private clusterAddr(p: number, a: number): number {
+    return ((p & 0xF) << 16 | (a & 0xFFFF)) & this.addrMask;
+  }
+
+  private setMasks(f: number, mask: number, t: number): void {
+    if (f === 0) {
+      this.enabled = mask;
+      for (const m of this.masters) if ((mask & m.bit) === 0) m.stimulus = false;
+      return;
+    }
+    let wake = false;
+    for (const m of this.masters) {
+      if ((mask & m.bit) === 0) continue;
+      m.stimulus = true;
+      wake ||= m.blocked;
+    }
+    // Blocked masters are woken from the event queue at the posting time
+    if (wake) this.host!.schedule(t);
+  }
+
+  onEvent(): void {
+    for (const m of this.masters) {
+      if (!m.blocked || !m.stimulus) continue;
+      m.blocked = false;
+      m.stimulus = false;
+      this.host!.deliverPortValue(m.coord, 0);
+    }
+  }
+
+  reset(): void {
+    this.addrLatch = 0;
+    this.addrNS = 0;
+    this.ctrl = SRAM_CTRL_STOP;
+    this.ceNS = 0;
+    this.weNS = 0;
+    this.dataLatch = 0;
+    this.driving = false;
+    for (const m of this.masters) {
+      m.words = [];
+      m.reply = null;
+      m.blocked = false;
+      m.stimulus = false;
+    }
+    this.enabled = ALL_MASTERS;
+    this.busyUntil = 0;
+    this.reads = this.writes = this.exchanges = this.violations = this.rejected = 0;
+  }
+
+  snapshot(): unknown {
+    return {
+      mode: this.mode,
+      words: this.mem.length,
+      reads: this.reads,
+      writes: this.writes,
+      exchanges: this.exchanges,
+      violations: this.violations,
+      rejected: this.rejected,
+      busyUntilNS: this.busyUntil,
+    };
+  }
+}
@@ -0,0 +1,169 @@
+/**
+ * Tests for the stimulus scheduler: merging sources into one event chain,
+ * pin validation, stimulus files, and waking nodes on a real chip.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from '../ga144';
+import { ROM_DATA } from '../rom-data';
+import { compileCube } from '../cube';
+import { IoBus } from '../io-bus';
+import { EMU_PORT, PORT } from '../constants';
+import {
+  StimulusDevice, clockStimulus, serialStimulus, parseStimulusLine, stimulusFile,
+} from './stimulus';
+import type { PinEvent } from './stimulus';
+import type { DeviceHost, GpioPin } from './device';
+
+/** Host whose events are run by `run()` in time order. `nudgeNS` delays
+ *  each event, as the chip's event queue does on a time collision. */
+function fakeHost(nudgeNS = 0) {
+  const queue: number[] = [];
+  const pins: string[] = [];
+  let now = 0;
+  let maxQueued = 0;
+  const host = {
+    now: () => now,
+    schedule: (t: number) => {
+      queue.push(t + nudgeNS);
+      maxQueued = Math.max(maxQueued, queue.length);
+    },
+    setPin: (coord: number, pin: GpioPin, level: boolean) => { pins.push(`${now} ${coord}.${pin}=${+level}`); },
+    getPin: () => false,
+    setAnalogSource: () => {},
+    setDataBus: () => {},
+    setExternalPort: () => {},
+    deliverPortValue: () => {},
+    ioBus: new IoBus(),
+  } satisfies DeviceHost;
+  const run = (device: StimulusDevice, untilNS: number) => {
+    for (;;) {
+      queue.sort((a, b) => a - b);
+      if (queue.length === 0 || queue[0] > untilNS) return;
+      now = queue.shift()!;
+      device.onEvent(now);
+    }
+  };
+  return { host, pins, run, maxQueued: () => maxQueued };
+}
+
+const ev = (timeNS: number, coord: number, pin: GpioPin, level: boolean): PinEvent => ({ timeNS, coord, pin, level });
+
+describe('StimulusDevice', () => {
+  it('merges sources in time order, ties in source order, with one queued event', () => {
+    const { host, pins, run, maxQueued } = fakeHost();
+    const stim = new StimulusDevice();
+    stim.add([ev(100, 200, 17, true), ev(300, 200, 17, false)]);
+    stim.add(clockStimulus(300, 1, 100, { startNS: 50, count: 2 }));
+    stim.attach(host);
+    stim.add([ev(100, 8, 5, true)]);
+    run(stim, 1000);
+
+    expect(pins).toEqual([
+      '50 300.1=1',
+      '100 200.17=1', '100 300.1=0', '100 8.5=1',
+      '150 300.1=1', '200 300.1=0',
+      '300 200.17=0',
+    ]);
+    expect(maxQueued()).toBe(1);
+    expect(stim.snapshot()).toMatchObject({ sources: 3, pending: 0, applied: 7 });
+
+    // Chip reset replays every source
+    stim.reset();
+    run(stim, 60);
+    expect(pins.slice(7)).toEqual(['50 300.1=1']);
+  });
+
+  it('streams endless generators lazily and rejects bad events', () => {
+    const { host, pins, run } = fakeHost();
+    const stim = new StimulusDevice();
+    stim.add(clockStimulus(1, 1, 10));
+    stim.attach(host);
+    run(stim, 995);
+    expect(pins).toHaveLength(200);
+    expect(stim.pending).toBe(1);
+
+    const bad = new StimulusDevice();
+    bad.attach(host);
+    expect(() => bad.add([ev(0, 100, 1, true)])).toThrow('Node 100 has no pin 1');
+    bad.add([ev(2000, 708, 1, true), ev(1500, 708, 1, false)]);
+    expect(() => run(bad, 3000)).toThrow('not sorted');
+  });
+
+  it('keeps one queued event when the queue nudges event times', () => {
+    const { host, pins, run, maxQueued } = fakeHost(0.001);
+    const stim = new StimulusDevice();
+    stim.add(clockStimulus(300, 1, 100, { count: 50 }));
+    stim.add(clockStimulus(200, 17, 100, { count: 50 }));
+    stim.attach(host);
+    run(stim, 10_000);
+    expect(pins).toHaveLength(200);
+    expect(maxQueued()).toBe(1);
+    expect(stim.snapshot()).toMatchObject({ pending: 0, nextNS: null });
+  });
+
+  it('serialises bytes with boot-stream polarity', () => {
+    const { host, pins, run } = fakeHost();
+    const stim = new StimulusDevice();
+    stim.add(serialStimulus(708, 17, [0x01], 1e6, 1000));
+    stim.attach(host);
+    run(stim, 20_000);
+    // Start bit high, then bit 0 (set, so low) and bit 1 (clear, so high)
+    expect(pins.slice(0, 3)).toEqual(['1000 708.17=1', '2000 708.17=0', '3000 708.17=1']);
+  });
+
+  it('parses stimulus files in chunks', () => {
+    expect(parseStimulusLine('  # comment')).toBeNull();
+    expect(parseStimulusLine('12.5us 200.17 hi # dq')).toEqual(ev(12_500, 200, 17, true));
+    expect(parseStimulusLine('3ms 8.5 0')).toEqual(ev(3e6, 8, 5, false));
+    expect(() => parseStimulusLine('10 8.7 1')).toThrow('node 8 has no pin 7');
+    expect(() => parseStimulusLine('10 8.5')).toThrow('expected TIME NODE.PIN LEVEL');
+
+    const lines = ['# time node.pin level', ...Array.from({ length: 10_000 }, (_, i) => `${i}us 300.${i % 2 ? 1 : 17} ${i % 3 ? 1 : 0}`)];
+    const bytes = new TextEncoder().encode(lines.join('\n'));
+    const reads: number[] = [];
+    const source = stimulusFile((offset, length) => {
+      reads.push(offset);
+      return bytes.subarray(offset, offset + length);
+    });
+    const events = [...source];
+    expect(events).toHaveLength(10_000);
+    expect(events[9_999]).toEqual(ev(9_999_000, 300, 1, false));
+    expect(reads.length).toBeGreaterThan(1);
+
+    const broken = new TextEncoder().encode('0 708.17 1\n5 708.17 x\n');
+    expect(() => [...stimulusFile((o, n) => broken.subarray(o, o + n))]).toThrow('line 2:');
+  });
+
+  it('wakes nodes on different pins of a real chip', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    const stim = new StimulusDevice();
+    stim.add([ev(5000, 708, 1, true), ev(5000, 708, 17, true)]);
+    stim.add([ev(8000, 200, 17, true)]);
+    ga.attachDevice(stim);
+    const compiled = compileCube(`#include std
+node 708
+/\\
+std.recv{port=${PORT.UP}, value=w}
+/\\
+std.recv{port=${PORT.IO}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+node 200
+/\\
+std.recv{port=${PORT.LEFT}, value=w}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=w}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    ga.stepProgramN(4000);
+
+    const log = ga.getDebugLogDelta(0);
+    expect(log.values).toHaveLength(2);
+    expect(log.timestamps[0]).toBeGreaterThanOrEqual(5000);
+    expect(log.values[0] & 0x20002).toBe(0x20002);
+    expect(log.timestamps[1]).toBeGreaterThanOrEqual(8000);
+  });
+});
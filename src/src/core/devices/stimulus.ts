@@ -0,0 +1,266 @@
+/**
+ * Stimulus scheduler — drives any GPIO pin of any node from timed level
+ * schedules, for board-level scenarios with several inputs at once (a
+ * 1-wire pin on 200, sync pins on 300 and the 708 UART together).
+ *
+ * A source is a time-sorted sequence of pin events, possibly covering
+ * several pins. Sources are pulled lazily, one event ahead, and merged
+ * through a min-heap of their next events, so a schedule file or
+ * generator of any length costs one pending event per source and a single
+ * chain of chip events.
+ *
+ * Sources are iterables and are iterated afresh on chip reset, so a
+ * scenario replays from the start; pass re-iterable objects (arrays, or
+ * `{ [Symbol.iterator]: generator }`) rather than one-shot generators.
+ */
+import { NODE_GPIO_PINS } from '../constants';
+import { SerialBits } from '../serial';
+import type { SerialBit } from '../serial';
+import type { ByteReader } from '../wav';
+import type { Device, DeviceHost, GpioPin } from './device';
+
+export interface PinEvent {
+  /** Absolute guest time (ns). */
+  timeNS: number;
+  coord: number;
+  pin: GpioPin;
+  level: boolean;
+}
+
+/** Pins in the order NODE_GPIO_PINS counts them. */
+const PIN_ORDER: GpioPin[] = [17, 1, 3, 5];
+
+/** True if `coord` has GPIO pin `pin`. */
+export function hasGpioPin(coord: number, pin: number): pin is GpioPin {
+  return PIN_ORDER.slice(0, NODE_GPIO_PINS[coord] ?? 0).includes(pin as GpioPin);
+}
+
+interface Cursor {
+  /** Source index; equal times apply in the order sources were added. */
+  order: number;
+  iterator: Iterator<PinEvent>;
+  head: PinEvent;
+}
+
+export class StimulusDevice implements Device {
+  readonly name = 'stimulus';
+  private host: DeviceHost | null = null;
+  private readonly sources: Iterable<PinEvent>[] = [];
+  /** Min-heap of sources by the time of their next event. */
+  private heap: Cursor[] = [];
+  /** Time of the earliest queued chip event (Infinity when none). The
+   *  queue may nudge it later on a collision, so it is not matched exactly. */
+  private scheduledNS = Infinity;
+  private applied = 0;
+
+  attach(host: DeviceHost): void {
+    this.host = host;
+    this.start();
+  }
+
+  detach(): void {
+    this.host = null;
+  }
+
+  /** Add a time-sorted source; its events before now apply at once. */
+  add(source: Iterable<PinEvent>): void {
+    this.sources.push(source);
+    if (!this.host) return;
+    this.open(source, this.sources.length - 1);
+    this.scheduleNext();
+  }
+
+  /** Sources with events still to come. */
+  get pending(): number {
+    return this.heap.length;
+  }
+
+  private start(): void {
+    this.heap = [];
+    this.scheduledNS = Infinity;
+    this.sources.forEach((source, order) => this.open(source, order));
+    this.scheduleNext();
+  }
+
+  private open(source: Iterable<PinEvent>, order: number): void {
+    const iterator = source[Symbol.iterator]();
+    const first = iterator.next();
+    if (first.done) return;
+    this.push({ order, iterator, head: StimulusDevice.check(first.value, -Infinity) });
+  }
+
+  private static check(e: PinEvent, previousNS: number): PinEvent {
+    if (!hasGpioPin(e.coord, e.pin)) throw new Error(`Node ${e.coord} has no pin ${e.pin}`);
+    if (e.timeNS < previousNS) throw new Error(`Stimulus not sorted: ${e.timeNS} ns after ${previousNS} ns`);
+    return e;
+  }
+
+  private scheduleNext(): void {
+    if (this.heap.length === 0) return;
+    const t = this.heap[0].head.timeNS;
+    if (t >= this.scheduledNS) return;
+    this.scheduledNS = t;
+    this.host!.schedule(t);
+  }
+
+  onEvent(timeNS: number): void {
+    const host = this.host!;
+    if (timeNS >= this.scheduledNS) this.scheduledNS = Infinity;
+    while (this.heap.length > 0 && this.heap[0].head.timeNS <= timeNS) {
+      const cursor = this.heap[0];
+      const e = cursor.head;
+      host.setPin(e.coord, e.pin, e.level);
+      this.applied++;
+      const next = cursor.iterator.next();
+      if (next.done) {
+        this.pop();
+      } else {
+        cursor.head = StimulusDevice.check(next.value, e.timeNS);
+        this.siftDown(0);
+      }
+    }
+    this.scheduleNext();
+  }
+
+  reset(): void {
+    this.applied = 0;
+    if (this.host) this.start();
+  }
+
+  snapshot(): unknown {
+    return {
+      sources: this.sources.length,
+      pending: this.heap.length,
+      applied: this.applied,
+      nextNS: this.heap.length > 0 ? this.heap[0].head.timeNS : null,
+    };
+  }
+
+  // ---- Heap ----
+
+  private static before(a: Cursor, b: Cursor): boolean {
+    return a.head.timeNS < b.head.timeNS || (a.head.timeNS === b.head.timeNS && a.order < b.order);
+  }
+
+  private push(cursor: Cursor): void {
+    const h = this.heap;
+    h.push(cursor);
+    let i = h.length - 1;
+    while (i > 0) {
+      const parent = (i - 1) >> 1;
+      if (!StimulusDevice.before(h[i], h[parent])) break;
+      [h[parent], h[i]] = [h[i], h[parent]];
+      i = parent;
+    }
+  }
+
+  private pop(): void {
+    const last = this.heap.pop()!;
+    if (this.heap.length === 0) return;
+    this.heap[0] = last;
+    this.siftDown(0);
+  }
+
+  private siftDown(i: number): void {
+    const h = this.heap;
+    for (;;) {
+      const l = 2 * i + 1;
+      const r = l + 1;
+      let min = i;
+      if (l < h.length && StimulusDevice.before(h[l], h[min])) min = l;
+      if (r < h.length && StimulusDevice.before(h[r], h[min])) min = r;
+      if (min === i) return;
+      [h[min], h[i]] = [h[i], h[min]];
+      i = min;
+    }
+  }
+}
+
+// ---- Sources ----
+
+/** A square wave starting high at `startNS`; `count` periods, or endless. */
+export function clockStimulus(
+  coord: number, pin: GpioPin, periodNS: number,
+  options: { startNS?: number; duty?: number; count?: number } = {},
+): Iterable<PinEvent> {
+  const startNS = options.startNS ?? 0;
+  const highNS = periodNS * (options.duty ?? 0.5);
+  const count = options.count ?? Infinity;
+  return {
+    *[Symbol.iterator]() {
+      for (let i = 0; i < count; i++) {
+        const t = startNS + i * periodNS;
+        yield { timeNS: t, coord, pin, level: true };
+        yield { timeNS: t + highNS, coord, pin, level: false };
+      }
+    },
+  };
+}
+
+/** Timed levels (relative hold times, as in SerialBit streams) from `startNS`. */
+export function bitsStimulus(coord: number, pin: GpioPin, bits: readonly SerialBit[], startNS = 0): Iterable<PinEvent> {
+  return {
+    *[Symbol.iterator]() {
+      let t = startNS;
+      for (const bit of bits) {
+        yield { timeNS: t, coord, pin, level: bit.value };
+        t += bit.durationNS;
+      }
+    },
+  };
+}
+
+/** Bytes as async serial, with the polarity of SerialBits.buildBits. */
+export function serialStimulus(coord: number, pin: GpioPin, bytes: number[], baud: number, startNS = 0): Iterable<PinEvent> {
+  return bitsStimulus(coord, pin, SerialBits.buildBits(bytes, baud), startNS);
+}
+
+const TIME_UNITS: Record<string, number> = { ns: 1, us: 1e3, 'µs': 1e3, ms: 1e6, s: 1e9 };
+
+/**
+ * One line of a stimulus file: `TIME NODE.PIN LEVEL`, e.g. `12.5us 200.17 1`.
+ * TIME takes an ns (default), us, ms or s suffix; LEVEL is 0/1 or lo/hi.
+ * Blank lines and `#` comments give null.
+ */
+export function parseStimulusLine(line: string): PinEvent | null {
+  const text = line.replace(/#.*/, '').trim();
+  if (text === '') return null;
+  const m = /^([\d.]+(?:e[+-]?\d+)?)\s*(ns|us|µs|ms|s)?\s+(\d+)\.(\d+)\s+(0|1|lo|hi)$/i.exec(text);
+  if (!m) throw new Error(`expected TIME NODE.PIN LEVEL, got '${text}'`);
+  const coord = Number(m[3]);
+  const pin = Number(m[4]);
+  if (!hasGpioPin(coord, pin)) throw new Error(`node ${coord} has no pin ${pin}`);
+  const level = m[5] === '1' || m[5].toLowerCase() === 'hi';
+  return { timeNS: Number(m[1]) * TIME_UNITS[(m[2] ?? 'ns').toLowerCase()], coord, pin, level };
+}
+
+const FILE_CHUNK = 1 << 16;
+
+/** A stimulus file read in chunks, so schedules need not fit in memory. */
+export function stimulusFile(read: ByteReader): Iterable<PinEvent> {
+  return {
+    *[Symbol.iterator]() {
+      const decoder = new TextDecoder();
+      let pos = 0;
+      let lineNo = 0;
+      let partial = '';
+      for (let eof = false; !eof;) {
+        const bytes = read(pos, FILE_CHUNK);
+        pos += bytes.length;
+        eof = bytes.length < FILE_CHUNK;
+        const lines = (partial + decoder.decode(bytes, { stream: !eof })).split(/\r?\n/);
+        partial = eof ? '' : lines.pop()!;
+        for (const line of lines) {
+          lineNo++;
+          let e: PinEvent | null;
+          try {
+            e = parseStimulusLine(line);
+          } catch (err) {
+            throw new Error(`line ${lineNo}: ${(err as Error).message}`);
+          }
+          if (e) yield e;
+        }
+      }
+    },
+  };
+}
@@ -0,0 +1,72 @@
+/**
+ * Tests for the emulator clock port (EMU_PORT.CLOCK). Samples are
+ * reported through the debug channel so the test reads them back
+ * without touching the IO ring.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { EMU_PORT } from './constants';
+import type { ClockCounterMode } from './types';
+
+const SAMPLE_SOURCE = `#include std
+node 404
+/\\
+std.recv{port=${EMU_PORT.CLOCK}, value=t0}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=t0}
+/\\
+std.recv{port=${EMU_PORT.CLOCK}, value=t1}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=t1}
+`;
+
+function sample(mode: ClockCounterMode, coords?: number[]): number[] {
+  const compiled = compileCube(SAMPLE_SOURCE);
+  expect(compiled.errors).toHaveLength(0);
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  ga.setClockCounter(mode, coords);
+  ga.load(compiled);
+  ga.stepProgramN(2000);
+  return ga.getDebugLogDelta(0).values;
+}
+
+describe('emulator clock port', () => {
+  it('steps mode counts executed instructions', () => {
+    const [t0, t1] = sample('steps');
+    expect(t0).toBeGreaterThan(0);
+    // Only the store, debug send and reload (plus nop padding) sit between samples
+    expect(t1 - t0).toBeGreaterThan(0);
+    expect(t1 - t0).toBeLessThan(64);
+  });
+
+  it('ns mode tracks the node simulated time', () => {
+    const steps = sample('steps');
+    const ns = sample('ns');
+    const dSteps = steps[1] - steps[0];
+    const dNs = ns[1] - ns[0];
+    // Each instruction costs between ~1.5 ns and ~5 ns
+    expect(dNs).toBeGreaterThanOrEqual(Math.floor(dSteps * 1.2));
+    expect(dNs).toBeLessThanOrEqual(Math.ceil(dSteps * 6));
+  });
+
+  it('reads as an unmapped port when off', () => {
+    expect(sample('off')).toEqual([0x134A9, 0x134A9]);
+  });
+
+  it('is enabled per node', () => {
+    expect(sample('steps', [405])).toEqual([0x134A9, 0x134A9]);
+    expect(sample('steps', [404])[0]).not.toBe(0x134A9);
+  });
+
+  it('mode survives reset', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.setClockCounter('ns');
+    ga.reset();
+    expect(ga.getNodeByCoord(404).clockMode).toBe('ns');
+  });
+});
@@ -1,16 +1,17 @@
 /**
  * Sorted event queue backed by a pool-allocated linked list.
  *
- * Fixed pool of 1024 nodes. Events are sorted by time (ascending).
+ * Fixed pool of nodes (1024 by default; a chip sizes it to its mesh).
+ * Events are sorted by time (ascending).
  * O(1) dequeue from head, O(n) insertion scan but no array shifting.
  * On time collision the new arrival is nudged forward by EPSILON.
  */
 
 export const EVT_NODE = 0;
-export const EVT_SERIAL = 1;
+export const EVT_DEVICE = 1;  // payload = device slot (see GA144.attachDevice)
 
 const EPSILON = 0.001; // ns nudge for collision resolution
-const POOL_SIZE = 1024;
+const DEFAULT_POOL_SIZE = 1024;
 const NIL = -1; // sentinel for "no node"
 
 export interface EventQueue {
@@ -18,22 +19,22 @@ export interface EventQueue {
   times: Float64Array;
   types: Uint8Array;
   payloads: Uint16Array;
-  next: Int16Array;     // next pointer (-1 = end)
+  next: Int32Array;     // next pointer (-1 = end)
 
   head: number;         // index of first (soonest) event, or NIL
   freeHead: number;     // head of free list, or NIL
 }
 
-export function createEventQueue(): EventQueue {
-  const next = new Int16Array(POOL_SIZE);
-  // Build free list: 0 → 1 → 2 → ... → POOL_SIZE-1 → NIL
-  for (let i = 0; i < POOL_SIZE - 1; i++) next[i] = i + 1;
-  next[POOL_SIZE - 1] = NIL;
+export function createEventQueue(size: number = DEFAULT_POOL_SIZE): EventQueue {
+  const next = new Int32Array(size);
+  // Build free list: 0 → 1 → 2 → ... → size-1 → NIL
+  for (let i = 0; i < size - 1; i++) next[i] = i + 1;
+  next[size - 1] = NIL;
 
   return {
-    times: new Float64Array(POOL_SIZE),
-    types: new Uint8Array(POOL_SIZE),
-    payloads: new Uint16Array(POOL_SIZE),
+    times: new Float64Array(size),
+    types: new Uint8Array(size),
+    payloads: new Uint16Array(size),
     next,
     head: NIL,
     freeHead: 0,
@@ -43,7 +44,7 @@ export function createEventQueue(): EventQueue {
 /** Allocate a node from the free list. Throws on overflow. */
 function alloc(q: EventQueue): number {
   const idx = q.freeHead;
-  if (idx === NIL) throw new Error('EventQueue overflow (1024 limit)');
+  if (idx === NIL) throw new Error(`EventQueue overflow (${q.next.length} limit)`);
   q.freeHead = q.next[idx];
   return idx;
 }
@@ -102,6 +103,13 @@ export function isEmpty(q: EventQueue): boolean {
   return q.head === NIL;
 }
 
+/** Number of queued events (walks the list; for sampling, not hot paths). */
+export function queueLength(q: EventQueue): number {
+  let n = 0;
+  for (let i = q.head; i !== NIL; i = q.next[i]) n++;
+  return n;
+}
+
 /**
  * Peek at the head event time. Returns Infinity if empty.
  */
@@ -155,10 +163,34 @@ export function removeByTypeAndPayload(q: EventQueue, type: number, payload: num
   }
 }
 
+/** Remove all events of a given type (e.g. every EVT_NODE on load). */
+export function removeByType(q: EventQueue, type: number): void {
+  while (q.head !== NIL && q.types[q.head] === type) {
+    const old = q.head;
+    q.head = q.next[old];
+    free(q, old);
+  }
+  if (q.head === NIL) return;
+
+  let prev = q.head;
+  let cur = q.next[prev];
+  while (cur !== NIL) {
+    if (q.types[cur] === type) {
+      q.next[prev] = q.next[cur];
+      free(q, cur);
+      cur = q.next[prev];
+    } else {
+      prev = cur;
+      cur = q.next[cur];
+    }
+  }
+}
+
 /** Clear all events and reset the free list. */
 export function clearQueue(q: EventQueue): void {
-  for (let i = 0; i < POOL_SIZE - 1; i++) q.next[i] = i + 1;
-  q.next[POOL_SIZE - 1] = NIL;
+  const size = q.next.length;
+  for (let i = 0; i < size - 1; i++) q.next[i] = i + 1;
+  q.next[size - 1] = NIL;
   q.head = NIL;
   q.freeHead = 0;
 }
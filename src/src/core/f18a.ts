@@ -4,18 +4,37 @@
  */
 import { CircularStack } from './stack';
 import {
-  MEM_SIZE, coordToIndex, indexToCoord,
+  MEM_SIZE,
   isPortAddr, regionIndex, PORT, IO_BITS, NODE_GPIO_PINS, ANALOG_NODES,
-  BOOT_NODES, PortIndex,
+  BOOT_NODES, EMU_PORT, PortIndex,
 } from './constants';
 import { WORD_MASK, XOR_ENCODING, NodeState } from './types';
-import type { NodeSnapshot, PortHandler } from './types';
+import type { ClockCounterMode, NodeSnapshot, PortHandler } from './types';
 import type { GA144 } from './ga144';
 import {
   createThermalState, resetThermalState, recordInstruction,
   recordIdle, mixThermalSeed,
 } from './thermal';
 import type { ThermalState } from './thermal';
+import type { NodeCoverage } from './coverage';
+import type { NodeRamWatch } from './ram-watch';
+import type { DataBus, ExternalPort } from './devices/device';
+import { NO_LINK } from './links';
+import { NODE_INTS, NODE_FLOATS, nodeStateCode, unpackNode } from './node-pack';
+import type { LinkTable } from './links';
+
+/** Single-port address by PortIndex (LEFT, UP, DOWN, RIGHT). */
+const SINGLE_PORT_ADDR = [PORT.LEFT, PORT.UP, PORT.DOWN, PORT.RIGHT];
+
+/** Order a multiport read or write visits its ports (as in `rdlu`). */
+const MULTIPORT_ORDER: readonly PortIndex[] = [PortIndex.RIGHT, PortIndex.DOWN, PortIndex.LEFT, PortIndex.UP];
+
+/** io register handshake bits by PortIndex. */
+const PORT_READ_MASK = [IO_BITS.Lr_MASK, IO_BITS.Ur_MASK, IO_BITS.Dr_MASK, IO_BITS.Rr_MASK];
+const PORT_WRITE_BIT = [IO_BITS.Lw_BIT, IO_BITS.Uw_BIT, IO_BITS.Dw_BIT, IO_BITS.Rw_BIT];
+
+/** Port bits (bit = PortIndex) of a multiport address's port list. */
+const portBits = (...ports: PortIndex[]): number => ports.reduce((mask, p) => mask | (1 << p), 0);
 
 const mask18 = (n: number): number => n & WORD_MASK;
 
@@ -51,26 +70,31 @@ export class F18ANode {
   // Memory
   private memory: (number | PortHandler | null)[];
 
-  // Port communication
-  private writingNodes: (F18ANode | null)[] = [null, null, null, null];
-  private portVals: (number | null)[] = [null, null, null, null];
-  private readingNodes: (F18ANode | null)[] = [null, null, null, null];
-  private ludrPortNodes: (number | null)[] = [null, null, null, null]; // stores indices
+  // Port communication — handshakes live in the chip's link table; these
+  // are this node's four entries of its per-port maps (by PortIndex)
+  private readonly links: LinkTable;
+  private readonly peers: Int32Array;
+  private readonly inChan: Int32Array;
+  private readonly outChan: Int32Array;
 
   // Fetch state
   private fetchingInProgress: false | 'stack' | 'inst' = false;
   private fetchedData: number | null = null;
   private fetchNext = false;
 
-  // Multiport state
-  private multiportReadPorts: PortIndex[] | null = null;
-  private currentReadingPort: PortIndex | PortIndex[] | null = null;
+  // Pending read: requested ports and those registered as a channel's
+  // reader (bit = PortIndex, 0 = none)
+  private readPorts = 0;
+  private readIsMulti = false;
+  private readWaitMask = 0;
   private currentWritingPort: PortIndex | null = null;
 
   // GPIO
   private numGpioPins: number;
+  private readonly ioRing: boolean;
   private wakePinPort: PortIndex | null = null;
   private pin17 = false;
+  private pinInputs = 0;  // externally driven pin1/3/5 levels, as io read bits
   private WD = false;
   private notWD = true;
   private waitingOnWakePin = false;
@@ -86,6 +110,28 @@ export class F18ANode {
   // Step counter
   stepCount = 0;
 
+  // Emulator clock port mode (configuration — survives reset)
+  clockMode: ClockCounterMode = 'off';
+
+  // Device-driven ADC input (configuration — survives reset); overrides the VCO counter
+  analogSource: ((coord: number, timeNS: number) => number) | null = null;
+
+  // Device logic behind the DATA port of non-analog nodes (configuration)
+  dataBus: DataBus | null = null;
+
+  // Device endpoints replacing neighbours on single ports (configuration)
+  private externalPorts: (ExternalPort | null)[] = [null, null, null, null];
+
+  // Coverage bitmaps (null = coverage off)
+  coverage: NodeCoverage | null = null;
+
+  // RAM write watch (null = no watched words on this node)
+  ramWatch: NodeRamWatch | null = null;
+
+  // Port-wait tracer: called with the pending read/write port masks
+  // (bit = PortIndex) on every suspend and with zeros on wakeup
+  onPortWait: ((readMask: number, writeMask: number, pinWait: boolean, timeNS: number) => void) | null = null;
+
   // Callback fired once on the first instruction fetched from RAM (addr < 0x40)
   onFirstRamInstruction: (() => void) | null = null;
 
@@ -100,8 +146,14 @@ export class F18ANode {
     this.index = index;
     this.activeIndex = index;
     this.ga144 = ga144;
-    this.coord = indexToCoord(index);
-    this.numGpioPins = NODE_GPIO_PINS[this.coord] || 0;
+    this.coord = ga144.mesh.indexToCoord(index);
+    this.links = ga144.links;
+    this.peers = this.links.peer.subarray(index * 4, index * 4 + 4);
+    this.inChan = this.links.inChan.subarray(index * 4, index * 4 + 4);
+    this.outChan = this.links.outChan.subarray(index * 4, index * 4 + 4);
+    // Pins, the ADC and boot ROM entries belong to the GA144's I/O ring
+    this.ioRing = ga144.mesh.standard;
+    this.numGpioPins = this.ioRing ? NODE_GPIO_PINS[this.coord] || 0 : 0;
     this.dstack = new CircularStack(8, 0x15555);
     this.rstack = new CircularStack(8, 0x15555);
     this.memory = new Array(MEM_SIZE).fill(0x134A9); // call warm
@@ -114,45 +166,13 @@ export class F18ANode {
   // ========================================================================
 
   init(): void {
-    this.initLudrPortNodes();
+    this.initWakePinPort();
     this.initIoMask();
   }
 
-  private initLudrPortNodes(): void {
-    const coord = this.coord;
-    const x = coord % 100;
-    const y = Math.floor(coord / 100);
-
-    const convert = (dir: string): PortIndex => {
-      switch (dir) {
-        case 'north': return y % 2 === 0 ? PortIndex.DOWN : PortIndex.UP;
-        case 'south': return y % 2 === 0 ? PortIndex.UP : PortIndex.DOWN;
-        case 'east':  return x % 2 === 0 ? PortIndex.RIGHT : PortIndex.LEFT;
-        case 'west':  return x % 2 === 0 ? PortIndex.LEFT : PortIndex.RIGHT;
-        default: throw new Error(`Invalid direction: ${dir}`);
-      }
-    };
-
-    this.ludrPortNodes = [null, null, null, null];
-
-    // North neighbor
-    if (y < 7) {
-      this.ludrPortNodes[convert('north')] = coordToIndex(coord + 100);
-    }
-    // East neighbor
-    if (x < 17) {
-      this.ludrPortNodes[convert('east')] = coordToIndex(coord + 1);
-    }
-    // South neighbor
-    if (y > 0) {
-      this.ludrPortNodes[convert('south')] = coordToIndex(coord - 100);
-    }
-    // West neighbor
-    if (x > 0) {
-      this.ludrPortNodes[convert('west')] = coordToIndex(coord - 1);
-    }
-
-    // Wake pin port
+  private initWakePinPort(): void {
+    // Neighbours are wired by the link table; the wake pin takes the
+    // off-chip port of an edge node
     if (this.numGpioPins > 0) {
       if (this.coord > 700 || this.coord < 17) {
         this.wakePinPort = PortIndex.UP;
@@ -169,10 +189,10 @@ export class F18ANode {
       mask = pinMasks[this.numGpioPins] || 0;
     }
     // Add status bits for existing ports
-    if (this.ludrPortNodes[PortIndex.LEFT] !== null) mask |= 0x1800;
-    if (this.ludrPortNodes[PortIndex.UP] !== null) mask |= 0x600;
-    if (this.ludrPortNodes[PortIndex.DOWN] !== null) mask |= 0x6000;
-    if (this.ludrPortNodes[PortIndex.RIGHT] !== null) mask |= 0x18000;
+    if (this.peers[PortIndex.LEFT] !== NO_LINK) mask |= 0x1800;
+    if (this.peers[PortIndex.UP] !== NO_LINK) mask |= 0x600;
+    if (this.peers[PortIndex.DOWN] !== NO_LINK) mask |= 0x6000;
+    if (this.peers[PortIndex.RIGHT] !== NO_LINK) mask |= 0x18000;
 
     this.notIoReadMask = mask18(~mask);
     this.ioReadDefault = 0x15555 & mask;
@@ -230,24 +250,27 @@ export class F18ANode {
     this.ga144.removeFromActiveList(this);
     this.ga144.deactivateNode(this);
     this.suspended = true;
+    if (this.onPortWait !== null) this.reportPortWait();
   }
 
   private wakeup(): void {
     this.ga144.addToActiveList(this);
     this.ga144.enqueueNode(this);
     this.suspended = false;
+    if (this.onPortWait !== null) this.onPortWait(0, 0, false, this.thermal.simulatedTime);
+  }
+
+  private reportPortWait(): void {
+    const pinBit = this.wakePinPort !== null ? 1 << this.wakePinPort : 0;
+    const readMask = this.readPorts & ~pinBit;
+    const writeMask = this.currentWritingPort !== null ? 1 << this.currentWritingPort : 0;
+    this.onPortWait!(readMask, writeMask, this.waitingOnWakePin, this.thermal.simulatedTime);
   }
 
   // ========================================================================
   // Port communication
   // ========================================================================
 
-  private getPortNode(port: PortIndex): F18ANode | null {
-    const idx = this.ludrPortNodes[port];
-    if (idx === null) return null;
-    return this.ga144.getNodeByIndex(idx);
-  }
-
   private doPortRead(port: PortIndex): boolean {
     if (port === this.wakePinPort && this.wakePinPort !== null) {
       // Reading from wake pin
@@ -262,46 +285,32 @@ export class F18ANode {
       }
     }
 
-    const writingNode = this.writingNodes[port];
-    if (writingNode) {
-      // Value was ready — synchronize simulated time on handshake
-      const maxTime = Math.max(this.thermal.simulatedTime, writingNode.thermal.simulatedTime);
-      this.thermal.simulatedTime = maxTime;
-      writingNode.thermal.simulatedTime = maxTime;
-      this.fetchedData = this.portVals[port]!;
-      this.writingNodes[port] = null;
-      writingNode.finishPortWrite();
+    const c = this.inChan[port];
+    if (c !== NO_LINK && this.links.writer[c] !== NO_LINK) {
+      this.takeWrite(c);
       return true;
-    } else {
-      // Suspend while waiting
-      const other = this.getPortNode(port);
-      if (other) {
-        other.receivePortRead(port, this);
-      }
-      this.currentReadingPort = port;
-      this.suspend();
-      return false;
     }
+    // Suspend while waiting; a port without a neighbour waits forever
+    this.readPorts = 1 << port;
+    this.readIsMulti = false;
+    this.readWaitMask = c !== NO_LINK ? this.waitToRead(c, port) : 0;
+    this.suspend();
+    return false;
   }
 
-  private doMultiportRead(ports: PortIndex[]): boolean {
+  private doMultiportRead(ports: number): boolean {
     let done = false;
-    for (const port of ports) {
+    for (const port of MULTIPORT_ORDER) {
+      if ((ports & (1 << port)) === 0) continue;
       if (port === this.wakePinPort && this.wakePinPort !== null) {
         if (this.pin17 === this.notWD) {
           this.fetchedData = this.pin17 ? 1 : 0;
           done = true;
         }
-      } else {
-        const writingNode = this.writingNodes[port];
-        if (writingNode && !done) {
-          // Synchronize simulated time on handshake
-          const maxTime = Math.max(this.thermal.simulatedTime, writingNode.thermal.simulatedTime);
-          this.thermal.simulatedTime = maxTime;
-          writingNode.thermal.simulatedTime = maxTime;
-          this.fetchedData = this.portVals[port]!;
-          this.writingNodes[port] = null;
-          writingNode.finishPortWrite();
+      } else if (!done) {
+        const c = this.inChan[port];
+        if (c !== NO_LINK && this.links.writer[c] !== NO_LINK) {
+          this.takeWrite(c);
           done = true;
         }
       }
@@ -313,55 +322,75 @@ export class F18ANode {
     }
 
     // Suspend waiting for any port
-    this.multiportReadPorts = [];
-    let hasWakePin = false;
-    for (const port of ports) {
-      if (port === this.wakePinPort && this.wakePinPort !== null) {
-        hasWakePin = true;
-      }
-      const other = this.getPortNode(port);
-      if (other) {
-        other.receivePortRead(port, this);
-        this.multiportReadPorts.push(port);
-      }
+    let waitMask = 0;
+    for (const port of MULTIPORT_ORDER) {
+      const c = this.inChan[port];
+      if ((ports & (1 << port)) !== 0 && c !== NO_LINK) waitMask |= this.waitToRead(c, port);
     }
-    this.waitingOnWakePin = hasWakePin;
-    this.currentReadingPort = ports;
+    this.waitingOnWakePin = this.wakePinPort !== null && (ports & (1 << this.wakePinPort)) !== 0;
+    this.readPorts = ports;
+    this.readIsMulti = true;
+    this.readWaitMask = waitMask;
     this.suspend();
     return false;
   }
 
+  /** Register as channel c's reader; returns the port's bit. */
+  private waitToRead(c: number, port: PortIndex): number {
+    this.links.reader[c] = this.index;
+    this.links.readNS[c] = this.thermal.simulatedTime;
+    return 1 << port;
+  }
+
+  /** Complete a rendezvous with the writer blocked on inbound channel c. */
+  private takeWrite(c: number): void {
+    const links = this.links;
+    const writingNode = this.ga144.getNodeByIndex(links.writer[c]);
+    // Synchronize simulated time on handshake
+    const maxTime = Math.max(this.thermal.simulatedTime, writingNode.thermal.simulatedTime);
+    this.thermal.simulatedTime = maxTime;
+    writingNode.thermal.simulatedTime = maxTime;
+    this.fetchedData = links.value[c];
+    links.writer[c] = NO_LINK;
+    links.transfers[c]++;
+    writingNode.finishPortWrite();
+  }
+
+  /** Complete a rendezvous with the reader blocked on outbound channel c. */
+  private giveRead(c: number, value: number): void {
+    const links = this.links;
+    const readingNode = this.ga144.getNodeByIndex(links.reader[c]);
+    // Synchronize simulated time on handshake
+    const maxTime = Math.max(this.thermal.simulatedTime, readingNode.thermal.simulatedTime);
+    this.thermal.simulatedTime = maxTime;
+    readingNode.thermal.simulatedTime = maxTime;
+    links.reader[c] = NO_LINK;
+    links.transfers[c]++;
+    readingNode.finishPortRead(value);
+  }
+
   private portWrite(port: PortIndex, value: number): boolean {
-    const readingNode = this.readingNodes[port];
-    if (readingNode) {
-      // Synchronize simulated time on handshake
-      const maxTime = Math.max(this.thermal.simulatedTime, readingNode.thermal.simulatedTime);
-      this.thermal.simulatedTime = maxTime;
-      readingNode.thermal.simulatedTime = maxTime;
-      this.readingNodes[port] = null;
-      readingNode.finishPortRead(value);
+    const links = this.links;
+    const c = this.outChan[port];
+    if (c !== NO_LINK && links.reader[c] !== NO_LINK) {
+      this.giveRead(c, value);
       return true;
-    } else {
-      const other = this.getPortNode(port);
-      if (other) {
-        other.receivePortWrite(port, value, this);
-      }
-      this.currentWritingPort = port;
-      this.suspend();
-      return false;
     }
+    if (c !== NO_LINK) {
+      links.writer[c] = this.index;
+      links.value[c] = value;
+      links.writeNS[c] = this.thermal.simulatedTime;
+    }
+    this.currentWritingPort = port;
+    this.suspend();
+    return false;
   }
 
-  private multiportWrite(ports: PortIndex[], value: number): boolean {
-    for (const port of ports) {
-      const readingNode = this.readingNodes[port];
-      if (readingNode) {
-        // Synchronize simulated time on handshake
-        const maxTime = Math.max(this.thermal.simulatedTime, readingNode.thermal.simulatedTime);
-        this.thermal.simulatedTime = maxTime;
-        readingNode.thermal.simulatedTime = maxTime;
-        this.readingNodes[port] = null;
-        readingNode.finishPortRead(value);
+  private multiportWrite(ports: number, value: number): boolean {
+    for (const port of MULTIPORT_ORDER) {
+      const c = this.outChan[port];
+      if ((ports & (1 << port)) !== 0 && c !== NO_LINK && this.links.reader[c] !== NO_LINK) {
+        this.giveRead(c, value);
       }
     }
     return true;
@@ -374,15 +403,21 @@ export class F18ANode {
     if (this.fetchingInProgress) {
       this.finishFetch();
     }
-    // Cancel any other multiport reads
-    if (this.multiportReadPorts) {
-      for (const port of this.multiportReadPorts) {
-        const other = this.getPortNode(port);
-        if (other) other.receivePortRead(port, null);
+    this.cancelReads();
+  }
+
+  /** Withdraw from every channel of the pending read (other multiport
+   *  ports stop offering this node as their reader). */
+  private cancelReads(): void {
+    const mask = this.readWaitMask;
+    if (mask !== 0) {
+      for (let port = 0; port < 4; port++) {
+        if ((mask & (1 << port)) !== 0) this.links.reader[this.inChan[port]] = NO_LINK;
       }
-      this.multiportReadPorts = null;
+      this.readWaitMask = 0;
     }
-    this.currentReadingPort = null;
+    this.readPorts = 0;
+    this.readIsMulti = false;
   }
 
   finishPortWrite(): void {
@@ -390,15 +425,6 @@ export class F18ANode {
     this.wakeup();
   }
 
-  receivePortRead(port: PortIndex, node: F18ANode | null): void {
-    this.readingNodes[port] = node;
-  }
-
-  receivePortWrite(port: PortIndex, value: number, node: F18ANode): void {
-    this.writingNodes[port] = node;
-    this.portVals[port] = value;
-  }
-
   // ========================================================================
   // IO register
   // ========================================================================
@@ -406,20 +432,18 @@ export class F18ANode {
   private readIoReg(): number {
     let io = (mask18(~this.IO) & this.notIoReadMask) | this.ioReadDefault;
 
-    // Handshake read bits
-    if (this.readingNodes[PortIndex.LEFT]) io &= IO_BITS.Lr_MASK;
-    if (this.readingNodes[PortIndex.UP]) io &= IO_BITS.Ur_MASK;
-    if (this.readingNodes[PortIndex.DOWN]) io &= IO_BITS.Dr_MASK;
-    if (this.readingNodes[PortIndex.RIGHT]) io &= IO_BITS.Rr_MASK;
-
-    // Handshake write bits
-    if (this.writingNodes[PortIndex.LEFT]) io |= IO_BITS.Lw_BIT;
-    if (this.writingNodes[PortIndex.UP]) io |= IO_BITS.Uw_BIT;
-    if (this.writingNodes[PortIndex.DOWN]) io |= IO_BITS.Dw_BIT;
-    if (this.writingNodes[PortIndex.RIGHT]) io |= IO_BITS.Rw_BIT;
+    // Handshake bits: a neighbour waiting to read from us, or to write to us
+    const links = this.links;
+    for (let port = 0; port < 4; port++) {
+      const out = this.outChan[port];
+      if (out === NO_LINK) continue;
+      if (links.reader[out] !== NO_LINK) io &= PORT_READ_MASK[port];
+      if (links.writer[this.inChan[port]] !== NO_LINK) io |= PORT_WRITE_BIT[port];
+    }
 
     // GPIO pin bits
     if (this.numGpioPins > 0 && this.pin17) io |= IO_BITS.PIN17_BIT;
+    io |= this.pinInputs;
 
     return io;
   }
@@ -473,7 +497,9 @@ export class F18ANode {
       }
       return;
     }
-    (this.memory as number[])[regionIndex(addr)] = value;
+    const index = regionIndex(addr);
+    (this.memory as number[])[index] = value;
+    if (this.ramWatch !== null && index < 0x40) this.ramWatch.written(index, value, this.thermal.simulatedTime);
   }
 
   // ========================================================================
@@ -483,6 +509,7 @@ export class F18ANode {
   private executeInstruction(opcode: number, jumpAddrPos: number, addrMask: number): boolean {
     this.stepCount++;
     recordInstruction(this.thermal, opcode);
+    if (this.coverage !== null) this.coverage.markSlot(this.IIndex, this.iI);
 
     if (opcode < 8) {
       // Control flow instructions - address from RAW word (not XOR-decoded)
@@ -529,6 +556,7 @@ export class F18ANode {
         }
 
       case 5: // next
+        if (this.coverage !== null) this.coverage.markBranch(this.IIndex, this.iI, this.R !== 0);
         if (this.R === 0) {
           this.rPop();
           return false;
@@ -539,6 +567,7 @@ export class F18ANode {
         }
 
       case 6: // if (jump if T=0)
+        if (this.coverage !== null) this.coverage.markBranch(this.IIndex, this.iI, this.T === 0);
         if (this.T === 0) {
           this.P = addr | (this.P & mask);
         }
@@ -548,6 +577,7 @@ export class F18ANode {
         return false;
 
       case 7: // -if (jump if T>=0, bit 17 = 0)
+        if (this.coverage !== null) this.coverage.markBranch(this.IIndex, this.iI, ((this.T >> 17) & 1) === 0);
         if (((this.T >> 17) & 1) === 0) {
           this.P = addr | (this.P & mask);
         }
@@ -814,15 +844,15 @@ export class F18ANode {
     this.fetchNext = false;
     this.dstack = new CircularStack(8, 0x15555);
     this.rstack = new CircularStack(8, 0x15555);
-    this.writingNodes = [null, null, null, null];
-    this.readingNodes = [null, null, null, null];
-    this.portVals = [null, null, null, null];
-    this.multiportReadPorts = null;
-    this.currentReadingPort = null;
+    // Link channels are cleared by the chip (LinkTable.reset)
+    this.readPorts = 0;
+    this.readIsMulti = false;
+    this.readWaitMask = 0;
     this.currentWritingPort = null;
     this.WD = false;
     this.notWD = true;
     this.pin17 = false;
+    this.pinInputs = 0;
     this.waitingOnWakePin = false;
     this.unextJumpP = false;
     this.suspended = false;
@@ -854,7 +884,7 @@ export class F18ANode {
     // Boot nodes (708, 705, 300, 200, 1, 701) have a "cold" entry at 0xAA.
     // All other nodes only have "warm" at 0xA9 (0xAA is the "poly" function).
     // Matches reference: reset-p! looks up "cold" first, falls back to "warm".
-    this.P = BOOT_NODES.includes(this.coord) ? 0xAA : 0xA9;
+    this.P = this.ioRing && BOOT_NODES.includes(this.coord) ? 0xAA : 0xA9;
   }
 
   private setupPorts(): void {
@@ -862,16 +892,20 @@ export class F18ANode {
       read: () => this.doPortRead(port),
       write: (v: number) => { this.portWrite(port, v); },
     });
-    const makeMultiPort = (ports: PortIndex[]): PortHandler => ({
-      read: () => this.doMultiportRead(ports),
-      write: (v: number) => { this.multiportWrite(ports, v); },
-    });
+    const makeMultiPort = (...ports: PortIndex[]): PortHandler => {
+      const mask = portBits(...ports);
+      return {
+        read: () => this.doMultiportRead(mask),
+        write: (v: number) => { this.multiportWrite(mask, v); },
+      };
+    };
 
     // Single ports
     this.memory[PORT.LEFT] = makeSinglePort(PortIndex.LEFT);
     this.memory[PORT.RIGHT] = makeSinglePort(PortIndex.RIGHT);
     this.memory[PORT.UP] = makeSinglePort(PortIndex.UP);
     this.memory[PORT.DOWN] = makeSinglePort(PortIndex.DOWN);
+    for (let p = 0; p < 4; p++) this.installExternalPort(p as PortIndex);
 
     // IO register
     this.memory[PORT.IO] = {
@@ -880,26 +914,28 @@ export class F18ANode {
     };
 
     // Multiport combinations
-    this.memory[0x165] = makeMultiPort([PortIndex.LEFT, PortIndex.UP]);         // --lu
-    this.memory[0x105] = makeMultiPort([PortIndex.DOWN, PortIndex.UP]);         // -d-u
-    this.memory[0x135] = makeMultiPort([PortIndex.DOWN, PortIndex.LEFT]);       // -dl-
-    this.memory[0x125] = makeMultiPort([PortIndex.DOWN, PortIndex.LEFT, PortIndex.UP]); // -dlu
-    this.memory[0x1C5] = makeMultiPort([PortIndex.RIGHT, PortIndex.UP]);        // r--u
-    this.memory[0x1F5] = makeMultiPort([PortIndex.RIGHT, PortIndex.LEFT]);      // r-l-
-    this.memory[0x1E5] = makeMultiPort([PortIndex.RIGHT, PortIndex.LEFT, PortIndex.UP]); // r-lu
-    this.memory[0x195] = makeMultiPort([PortIndex.RIGHT, PortIndex.DOWN]);      // rd--
-    this.memory[0x185] = makeMultiPort([PortIndex.RIGHT, PortIndex.DOWN, PortIndex.UP]); // rd-u
-    this.memory[0x1B5] = makeMultiPort([PortIndex.RIGHT, PortIndex.DOWN, PortIndex.LEFT]); // rdl-
-    this.memory[0x1A5] = makeMultiPort([PortIndex.RIGHT, PortIndex.DOWN, PortIndex.LEFT, PortIndex.UP]); // rdlu
+    this.memory[0x165] = makeMultiPort(PortIndex.LEFT, PortIndex.UP);         // --lu
+    this.memory[0x105] = makeMultiPort(PortIndex.DOWN, PortIndex.UP);         // -d-u
+    this.memory[0x135] = makeMultiPort(PortIndex.DOWN, PortIndex.LEFT);       // -dl-
+    this.memory[0x125] = makeMultiPort(PortIndex.DOWN, PortIndex.LEFT, PortIndex.UP); // -dlu
+    this.memory[0x1C5] = makeMultiPort(PortIndex.RIGHT, PortIndex.UP);        // r--u
+    this.memory[0x1F5] = makeMultiPort(PortIndex.RIGHT, PortIndex.LEFT);      // r-l-
+    this.memory[0x1E5] = makeMultiPort(PortIndex.RIGHT, PortIndex.LEFT, PortIndex.UP); // r-lu
+    this.memory[0x195] = makeMultiPort(PortIndex.RIGHT, PortIndex.DOWN);      // rd--
+    this.memory[0x185] = makeMultiPort(PortIndex.RIGHT, PortIndex.DOWN, PortIndex.UP); // rd-u
+    this.memory[0x1B5] = makeMultiPort(PortIndex.RIGHT, PortIndex.DOWN, PortIndex.LEFT); // rdl-
+    this.memory[0x1A5] = makeMultiPort(PortIndex.RIGHT, PortIndex.DOWN, PortIndex.LEFT, PortIndex.UP); // rdlu
 
     // DATA port — on analog nodes this is the VCO-based ADC counter.
     // The real VCO runs at ~2-4 GHz, driven by input voltage.
     // The clock worker computes counter values from thermal state
     // and writes them to SharedArrayBuffer slots.
-    if (ANALOG_NODES.includes(this.coord)) {
+    if (this.ioRing && ANALOG_NODES.includes(this.coord)) {
       this.memory[PORT.DATA] = {
         read: () => {
-          if (this.vcoCounter) {
+          if (this.analogSource !== null) {
+            this.fetchedData = this.analogSource(this.coord, this.thermal.simulatedTime) & 0x3FFFF;
+          } else if (this.vcoCounter) {
             this.fetchedData = Atomics.load(this.vcoCounter, this.vcoSlotIndex);
           } else {
             this.fetchedData = 0; // SAB not yet wired
@@ -913,10 +949,41 @@ export class F18ANode {
     } else {
       let dataVal = 0;
       this.memory[PORT.DATA] = {
-        read: () => { this.fetchedData = dataVal; return true; },
-        write: (v: number) => { dataVal = v; },
+        read: () => {
+          this.fetchedData = this.dataBus !== null
+            ? this.dataBus.read(this.coord, this.thermal.simulatedTime) & 0x3FFFF
+            : dataVal;
+          return true;
+        },
+        write: (v: number) => {
+          dataVal = v;
+          if (this.dataBus !== null) this.dataBus.write(this.coord, v, this.thermal.simulatedTime);
+        },
       };
     }
+
+    // Emulator debug channel — writes go to the GA144 debug log, reads
+    // behave like any other unmapped port slot.
+    this.memory[EMU_PORT.DEBUG] = {
+      read: () => { this.fetchedData = 0x134A9; return true; },
+      write: (v: number) => { this.ga144.onDebugWrite(this.index, v, this.thermal); },
+    };
+
+    // Emulator clock port — read-only time counter, unmapped while 'off'.
+    // The read is sampled after recordInstruction(), so it includes the
+    // cost of the fetching instruction.
+    this.memory[EMU_PORT.CLOCK] = {
+      read: () => { this.fetchedData = this.readClockCounter(); return true; },
+      write: (_: number) => {},
+    };
+  }
+
+  private readClockCounter(): number {
+    switch (this.clockMode) {
+      case 'ns': return Math.floor(this.thermal.simulatedTime) & WORD_MASK;
+      case 'steps': return this.stepCount & WORD_MASK;
+      default: return 0x134A9;
+    }
   }
 
   // ========================================================================
@@ -966,7 +1033,7 @@ export class F18ANode {
   getState(): NodeState {
     if (this.breakpointHit) return NodeState.SUSPENDED;
     if (!this.suspended) return NodeState.RUNNING;
-    if (this.currentReadingPort !== null) return NodeState.BLOCKED_READ;
+    if (this.readPorts !== 0) return NodeState.BLOCKED_READ;
     if (this.currentWritingPort !== null) return NodeState.BLOCKED_WRITE;
     return NodeState.SUSPENDED;
   }
@@ -975,42 +1042,73 @@ export class F18ANode {
     return this.suspended;
   }
 
+  /** Node indices this node is blocked on (every port of a multiport
+   *  read), or null while it runs or can be woken by its pin. */
+  getPortWaitTargets(): number[] | null {
+    if (!this.suspended || this.waitingOnWakePin) return null;
+    const ports = this.readPorts !== 0
+      ? this.readPorts
+      : this.currentWritingPort !== null ? 1 << this.currentWritingPort : 0;
+    const targets: number[] = [];
+    for (const port of MULTIPORT_ORDER) {
+      const idx = this.peers[port];
+      if ((ports & (1 << port)) !== 0 && idx !== NO_LINK) targets.push(idx);
+    }
+    return targets;
+  }
+
+  /** True when the current instruction word was fetched from RAM. */
+  isExecutingRam(): boolean {
+    return !isPortAddr(this.IIndex) && (this.IIndex & 0xFF) < 0x80;
+  }
+
+  /** True while spinning on a slot-0 jump to its own word, the halt loop
+   *  the CUBE emitter appends to every node program. */
+  isInHaltLoop(): boolean {
+    if (this.suspended) return false;
+    const opcode = (this.IXor >> 13) & 0x1F;
+    return opcode === 2 && (this.I & 0x1FF) === (this.IIndex & 0x1FF);
+  }
+
   getSnapshot(): NodeSnapshot {
-    return {
-      coord: this.coord,
-      index: this.index,
-      state: this.getState(),
-      registers: {
-        P: this.P,
-        I: this.I,
-        A: this.A,
-        B: this.B,
-        T: this.T,
-        S: this.S,
-        R: this.R,
-        IO: this.IO,
-      },
-      dstack: [this.T, this.S, ...this.dstack.toArray()],
-      rstack: [this.R, ...this.rstack.toArray()],
-      ram: this.getRAM(),
-      rom: this.getROM(),
-      slotIndex: this.iI,
-      stepCount: this.stepCount,
-      thermal: {
-        temperature: this.thermal.temperature,
-        totalEnergy: this.thermal.totalEnergy,
-        simulatedTime: this.thermal.simulatedTime,
-        lastJitteredTime: this.thermal.lastJitteredTime,
-      },
-      currentReadingPort: this.currentReadingPort !== null
-        ? (Array.isArray(this.currentReadingPort)
-          ? `multi(${this.currentReadingPort.length})`
-          : ['L', 'U', 'D', 'R'][this.currentReadingPort])
-        : null,
-      currentWritingPort: this.currentWritingPort !== null
-        ? ['L', 'U', 'D', 'R'][this.currentWritingPort]
-        : null,
-    };
+    const ints = new Int32Array(NODE_INTS.LENGTH);
+    const floats = new Float64Array(NODE_FLOATS.LENGTH);
+    this.pack(ints, floats);
+    return unpackNode(this.coord, this.index, ints, floats);
+  }
+
+  /** Write registers, stacks and memory into `ints` and counters into
+   *  `floats`, laid out as in node-pack.ts. Allocates nothing. */
+  pack(ints: Int32Array, floats: Float64Array): void {
+    ints[NODE_INTS.STATE] = nodeStateCode(this.getState());
+    ints[NODE_INTS.P] = this.P;
+    ints[NODE_INTS.I] = this.I;
+    ints[NODE_INTS.A] = this.A;
+    ints[NODE_INTS.B] = this.B;
+    ints[NODE_INTS.T] = this.T;
+    ints[NODE_INTS.S] = this.S;
+    ints[NODE_INTS.R] = this.R;
+    ints[NODE_INTS.IO] = this.IO;
+    ints[NODE_INTS.SLOT] = this.iI;
+    ints[NODE_INTS.READ_PORTS] = this.readPorts;
+    ints[NODE_INTS.READ_MULTI] = this.readIsMulti ? 1 : 0;
+    ints[NODE_INTS.WRITE_PORT] = this.currentWritingPort ?? -1;
+    ints[NODE_INTS.DSTACK] = this.T;
+    ints[NODE_INTS.DSTACK + 1] = this.S;
+    this.dstack.copyTo(ints, NODE_INTS.DSTACK + 2);
+    ints[NODE_INTS.RSTACK] = this.R;
+    this.rstack.copyTo(ints, NODE_INTS.RSTACK + 1);
+    for (let i = 0; i < 64; i++) {
+      const ram = this.memory[i];
+      const rom = this.memory[0x80 + i];
+      ints[NODE_INTS.RAM + i] = typeof ram === 'number' ? ram : 0;
+      ints[NODE_INTS.ROM + i] = typeof rom === 'number' ? rom : 0;
+    }
+    floats[NODE_FLOATS.STEPS] = this.stepCount;
+    floats[NODE_FLOATS.TEMPERATURE] = this.thermal.temperature;
+    floats[NODE_FLOATS.ENERGY] = this.thermal.totalEnergy;
+    floats[NODE_FLOATS.SIM_TIME] = this.thermal.simulatedTime;
+    floats[NODE_FLOATS.JITTERED_TIME] = this.thermal.lastJitteredTime;
   }
 
   getRAM(): number[] {
@@ -1022,6 +1120,12 @@ export class F18ANode {
     return ram;
   }
 
+  /** One RAM word, without building the full getRAM() array. */
+  peekRAM(addr: number): number {
+    const val = this.memory[addr & 0x3F];
+    return typeof val === 'number' ? val : 0;
+  }
+
   getROM(): number[] {
     const rom: number[] = [];
     for (let i = 0x80; i < 0xC0; i++) {
@@ -1058,14 +1162,7 @@ export class F18ANode {
       this.fetchedData = this.pin17 ? 1 : 0;
       this.waitingOnWakePin = false;
       // Cancel any multiport reads before waking
-      if (this.multiportReadPorts) {
-        for (const port of this.multiportReadPorts) {
-          const other = this.getPortNode(port);
-          if (other) other.receivePortRead(port, null);
-        }
-        this.multiportReadPorts = null;
-      }
-      this.currentReadingPort = null;
+      this.cancelReads();
       this.wakeup();
       if (this.fetchingInProgress) {
         this.finishFetch();
@@ -1077,4 +1174,69 @@ export class F18ANode {
   getPin17(): boolean {
     return this.pin17;
   }
+
+  /** Replace the neighbour on single port `port` with a device endpoint
+   *  (null restores the neighbour). Multiport addresses are unaffected. */
+  setExternalPort(port: PortIndex, endpoint: ExternalPort | null): void {
+    this.externalPorts[port] = endpoint;
+    this.installExternalPort(port);
+  }
+
+  private installExternalPort(port: PortIndex): void {
+    const addr = SINGLE_PORT_ADDR[port];
+    const endpoint = this.externalPorts[port];
+    if (endpoint === null) {
+      this.memory[addr] = {
+        read: () => this.doPortRead(port),
+        write: (v: number) => { this.portWrite(port, v); },
+      };
+      return;
+    }
+    this.memory[addr] = {
+      read: () => {
+        const r = endpoint.read(this.thermal.simulatedTime);
+        if (r === null) {
+          this.readPorts = 1 << port;
+          this.readIsMulti = false;
+          this.suspend();
+          return false;
+        }
+        this.idleUntil(r.readyNS);
+        this.fetchedData = r.value;
+        return true;
+      },
+      write: (v: number) => { this.idleUntil(endpoint.write(v, this.thermal.simulatedTime)); },
+    };
+  }
+
+  /** Complete a read blocked on an external port. Returns false if the
+   *  node is not waiting on one. */
+  deliverExternalRead(value: number): boolean {
+    if (!this.suspended || this.readPorts === 0 || this.readIsMulti) return false;
+    if (this.externalPorts[31 - Math.clz32(this.readPorts)] === null) return false;
+    this.finishPortRead(value);
+    return true;
+  }
+
+  /** Advance this node's clock to `timeNS` as idle time (never backwards). */
+  private idleUntil(timeNS: number): void {
+    const dt = timeNS - this.thermal.simulatedTime;
+    if (dt > 0) recordIdle(this.thermal, dt);
+  }
+
+  /** Drive the input level of pin 1, 3 or 5, read back at that io bit.
+   *  Pins the node does not have are ignored. These pins cannot wake. */
+  setPinInput(pin: 1 | 3 | 5, level: boolean): void {
+    const bit = 1 << pin;
+    if (((this.numGpioPins >= 2 && pin === 1) || (this.numGpioPins >= 3 && pin === 3)
+      || (this.numGpioPins >= 4 && pin === 5)) && level) {
+      this.pinInputs |= bit;
+    } else {
+      this.pinInputs &= ~bit;
+    }
+  }
+
+  getPinInput(pin: 1 | 3 | 5): boolean {
+    return (this.pinInputs & (1 << pin)) !== 0;
+  }
 }
@@ -1,59 +1,90 @@
 /**
- * GA144 chip controller - manages 144 F18A nodes.
+ * GA144 chip controller - manages the F18A nodes of one mesh (144 on the
+ * standard 8x18 layout).
  * Port of reference/ga144/src/ga144.rkt
  */
 import { F18ANode } from './f18a';
-import { NUM_NODES, coordToIndex, indexToCoord, ANALOG_NODES } from './constants';
+import { ANALOG_NODES } from './constants';
+import { GA144_MESH } from './mesh';
+import type { Mesh } from './mesh';
 import { NodeState } from './types';
-import type { GA144Snapshot, CompiledProgram } from './types';
+import type { GA144Snapshot, CompiledProgram, ClockCounterMode } from './types';
 import { recordIdle } from './thermal';
 import type { ThermalState } from './thermal';
 import {
-  createEventQueue, enqueue, dequeue, peekTime, isEmpty,
-  removeByTypeAndPayload, clearQueue,
-  EVT_NODE, EVT_SERIAL,
+  createEventQueue, enqueue, dequeue, peekTime, isEmpty, queueLength,
+  removeByTypeAndPayload, removeByType, clearQueue,
+  EVT_NODE, EVT_DEVICE,
   type EventQueue,
 } from './event-queue';
 import { SerialBits } from './serial';
 import type { SerialBit } from './serial';
-
-export interface IoWriteDelta {
-  writes: number[];
-  timestamps: number[];
-  startSeq: number;
-  totalSeq: number;
-}
+import { DebugLog } from './debug-log';
+import type { DebugLogDelta } from './debug-log';
+import { findStuckNodes, findWaitCycle } from './deadlock';
+import { NodeCoverage } from './coverage';
+import type { RamWatch } from './ram-watch';
+import type { StallReport } from './deadlock';
+import { IoBus, IoTrace } from './io-bus';
+import { IoWriteRing } from './io-ring';
+import { LinkTable } from './links';
+import type { LinkTraffic } from './links';
+import { SerialInputDevice } from './devices/serial-input';
+import type { Device, DeviceHost, DeviceSnapshot } from './devices/device';
+import type { IoWriteDelta } from './io-ring';
+import type { HostProfiler, HostCounters } from './host-profile';
+
+export type { IoWriteDelta } from './io-ring';
+
+/** Port-wait transition of a traced node (see GA144.tracePortWaits). */
+export type PortWaitHandler = (coord: number, readMask: number, writeMask: number, pinWait: boolean, timeNS: number) => void;
+
+/** Event queue slots beyond one per node, for device events. */
+const EVENT_HEADROOM = 880;
 
 export class GA144 {
   readonly name: string;
+  readonly mesh: Mesh;
+  /** Port handshake state of every neighbour link. */
+  readonly links: LinkTable;
+  private readonly numNodes: number;
   private nodes: F18ANode[];
   private activeNodes: F18ANode[];
-  private lastActiveIndex: number = NUM_NODES - 1;
+  private lastActiveIndex: number;
   private totalSteps = 0;
+  private totalEvents = 0;
+  private ioWriteCount = 0;
   private guestWallClock = 0;
   private _breakpointHit = false;
   private eventsSinceIdleSweep = 0;
 
   // Event queue for discrete event simulation
-  private eventQueue: EventQueue = createEventQueue();
+  private eventQueue: EventQueue;
   private readonly _evt = { time: 0, type: 0, payload: 0 }; // reusable dequeue scratch
 
-  // Serial bit state — only one EVT_SERIAL event in the queue at a time
-  private serialBitValues: boolean[] = [];
-  private serialBitTimes: number[] = [];  // absolute start time for each bit
-  private serialEndTime: number = 0;      // absolute end time of last bit
-  private serialBitIndex: number = 0;     // next bit to fire
-  private serialNode: F18ANode | null = null;
-
-  // IO write capture for VGA display — ring buffer of recent writes
-  private static readonly IO_WRITE_CAPACITY = 2_000_000;
-  private ioWriteBuffer: number[] = new Array(GA144.IO_WRITE_CAPACITY);
-  private ioWriteTimestamps: number[] = new Array(GA144.IO_WRITE_CAPACITY);
-  private ioWriteJitter: Float32Array = new Float32Array(GA144.IO_WRITE_CAPACITY);
-  private ioWriteStart = 0;     // ring start index
-  private ioWriteStartSeq = 0;  // sequence number at ring start
-  private ioWriteSeq = 0;       // next sequence number to write
-  private lastVsyncSeq: number | null = null;
+  // Attached peripherals; an EVT_DEVICE payload is the slot index
+  private devices: (Device | null)[] = [];
+  // Serial input (boot streams, terminal input) is the built-in device
+  private readonly serialInput = new SerialInputDevice();
+
+  // IO register writes fan out over the bus; the snapshot ring (VGA
+  // display, serial decode, worker deltas) is one subscriber among others
+  readonly ioBus: IoBus;
+  private ioRing = new IoWriteRing({ vsyncCoord: 217 });
+  private unsubscribeIoRing: (() => void) | null = null;
+
+  // Emulator-only debug channel (EMU_PORT.DEBUG) — separate from the IO ring
+  private debugLog = new DebugLog();
+  private debugEnabled = true;
+  private debugZeroTime = false;
+
+  // Stall detection: livelock is opt-in, measured in guest ns since the
+  // last IO or debug write (0 = disabled)
+  private livelockWindowNS = 0;
+  private lastProgressTime = 0;
+
+  // Host self-profiling (null = off); only IO publishes are timed here
+  private hostProfiler: HostProfiler | null = null;
 
   // ROM data loaded externally
   private romData: Record<number, number[]> = {};
@@ -67,21 +98,34 @@ export class GA144 {
   /** Boot UART baud rate. */
   static readonly BOOT_BAUD = 921_600;
 
-  constructor(name: string = 'chip1') {
-    this.name = name;
-    this.nodes = new Array(NUM_NODES);
-    this.activeNodes = new Array(NUM_NODES);
+  /** Device events stepProgramN() handles in a row, at least, before it
+   *  gives up on a node waking; lets a single step drain serial input. */
+  static readonly MIN_DEVICE_RUN = 1 << 20;
 
-    // Create 144 nodes
-    for (let i = 0; i < NUM_NODES; i++) {
+  constructor(name: string = 'chip1', mesh: Mesh = GA144_MESH) {
+    this.name = name;
+    this.mesh = mesh;
+    this.numNodes = mesh.numNodes;
+    this.lastActiveIndex = this.numNodes - 1;
+    // One pending event per node, plus room for device events
+    this.eventQueue = createEventQueue(this.numNodes + EVENT_HEADROOM);
+    this.ioBus = new IoBus(mesh);
+    this.links = new LinkTable(mesh);
+    this.nodes = new Array(this.numNodes);
+    this.activeNodes = new Array(this.numNodes);
+
+    for (let i = 0; i < this.numNodes; i++) {
       this.nodes[i] = new F18ANode(i, this);
       this.activeNodes[i] = this.nodes[i];
     }
 
-    // Initialize neighbor connections
+    // Wake pin ports and io read masks (neighbours come from the link table)
     for (const node of this.nodes) {
       node.init();
     }
+
+    this.setIoRingEnabled(true);
+    this.attachDevice(this.serialInput);
   }
 
   setRomData(romData: Record<number, number[]>): void {
@@ -93,7 +137,7 @@ export class GA144 {
   setVcoCounters(counters: Uint32Array | null): void {
     this.vcoCounters = counters;
     // Wire to existing analog nodes immediately
-    if (counters) {
+    if (counters && this.mesh.standard) {
       for (let i = 0; i < ANALOG_NODES.length; i++) {
         this.getNodeByCoord(ANALOG_NODES[i]).setVcoCounter(counters, i);
       }
@@ -101,16 +145,16 @@ export class GA144 {
   }
 
   /**
-   * Flush all 144 nodes' thermal temperatures and the guest wall clock
+   * Flush all nodes' thermal temperatures and the guest wall clock
    * to the SharedArrayBuffer. Called periodically by the emulator worker
    * so the clock worker can incorporate thermal jitter into VCO counter values.
    *
-   * SAB layout: [0..4] VCO counters, [5..148] thermal temps × 1000
+   * SAB layout: [0..4] VCO counters, then one thermal temp × 1000 per node
    */
   flushVcoTemperatures(): void {
     if (!this.vcoCounters) return;
     const thermalOffset = ANALOG_NODES.length; // = 5
-    for (let i = 0; i < NUM_NODES; i++) {
+    for (let i = 0; i < this.numNodes; i++) {
       const temp = this.nodes[i].thermal.temperature;
       Atomics.store(this.vcoCounters, thermalOffset + i, Math.floor(temp * 1000));
     }
@@ -184,25 +228,25 @@ export class GA144 {
     const q = this.eventQueue;
     const evt = this._evt;
     let remaining = n;
+    let deviceRun = 0;
+    const maxDeviceRun = Math.max(n, GA144.MIN_DEVICE_RUN);
 
     while (remaining > 0) {
       if (!dequeue(q, evt)) return false; // queue empty — chip idle
 
       this.guestWallClock = evt.time;
+      this.totalEvents++;
 
-      if (evt.type === EVT_SERIAL) {
-        // Serial pin17 edge — set pin and enqueue next bit
-        const bitIdx = evt.payload;
-        if (this.serialNode && bitIdx < this.serialBitValues.length) {
-          this.serialNode.setPin17(this.serialBitValues[bitIdx]);
-        }
-        this.serialBitIndex = bitIdx + 1;
-        if (this.serialBitIndex < this.serialBitValues.length) {
-          enqueue(q, this.serialBitTimes[this.serialBitIndex], EVT_SERIAL, this.serialBitIndex);
-        }
+      if (evt.type === EVT_DEVICE) {
+        this.devices[evt.payload]?.onEvent(evt.time);
         this.idleSweepTick();
-        continue; // serial events don't consume budget
+        // Device events don't consume budget, but a free-running device
+        // (a clock) must not spin forever once every node is asleep.
+        // Callers tell this from an idle chip by getDevicePending().
+        if (++deviceRun > maxDeviceRun) return false;
+        continue;
       }
+      deviceRun = 0;
 
       // EVT_NODE — step one instruction
       const node = this.nodes[evt.payload];
@@ -246,7 +290,7 @@ export class GA144 {
     this.eventsSinceIdleSweep++;
     if (this.eventsSinceIdleSweep >= 1000) {
       this.eventsSinceIdleSweep = 0;
-      for (let i = NUM_NODES - 1; i > this.lastActiveIndex; i--) {
+      for (let i = this.numNodes - 1; i > this.lastActiveIndex; i--) {
         const node = this.activeNodes[i];
         const dt = this.guestWallClock - node.thermal.simulatedTime;
         if (dt > 0) {
@@ -266,7 +310,7 @@ export class GA144 {
   advanceIdleTime(dtNS: number): void {
     if (dtNS <= 0) return;
     this.guestWallClock += dtNS;
-    for (let i = 0; i < NUM_NODES; i++) {
+    for (let i = 0; i < this.numNodes; i++) {
       const node = this.nodes[i];
       const dt = this.guestWallClock - node.thermal.simulatedTime;
       if (dt > 0) {
@@ -286,7 +330,8 @@ export class GA144 {
    *
    * `bits` is an array of {value: boolean, durationNS: number} pairs
    * with relative durations. They are converted to absolute times
-   * relative to guestWallClock and enqueued as EVT_SERIAL events.
+   * relative to guestWallClock and delivered by the built-in
+   * SerialInputDevice as EVT_DEVICE events.
    *
    * Returns true if a breakpoint was hit.
    */
@@ -304,39 +349,183 @@ export class GA144 {
   }
 
   /** Called by F18ANode when an IO register write occurs.
-   *  Each write is tagged with the node coordinate so the VGA display
-   *  can separate R/G/B channels from DAC nodes 117/617/717 and
-   *  sync signals from GPIO nodes.  Stored as (coord << 18) | value.
-   *  The thermal state provides jittered timing for analog output recording. */
+   *  The write is published on the IO bus with the node's simulated and
+   *  jittered time; the thermal state is optional so tests can inject
+   *  writes directly. */
   onIoWrite(nodeIndex: number, value: number, thermal?: ThermalState): void {
-    const coord = indexToCoord(nodeIndex);
-    const tagged = coord * 0x40000 + value;  // coord << 18 | value
-    // On VSYNC (node 217 pin17 driven high: bits 17:16 = 11),
-    // drop everything before the previous VSYNC to keep one full frame.
-    if (coord === 217 && (value & 0x30000) === 0x30000) {
-      if (this.lastVsyncSeq !== null && this.lastVsyncSeq > this.ioWriteStartSeq) {
-        const drop = this.lastVsyncSeq - this.ioWriteStartSeq;
-        this.ioWriteStart = (this.ioWriteStart + drop) % this.ioWriteBuffer.length;
-        this.ioWriteStartSeq = this.lastVsyncSeq;
+    this.lastProgressTime = this.guestWallClock;
+    this.ioWriteCount++;
+    const profiler = this.hostProfiler;
+    if (profiler === null) {
+      this.ioBus.publish(nodeIndex, value, thermal?.simulatedTime ?? 0, thermal?.lastJitteredTime ?? 0);
+      return;
+    }
+    const t0 = performance.now();
+    this.ioBus.publish(nodeIndex, value, thermal?.simulatedTime ?? 0, thermal?.lastJitteredTime ?? 0);
+    profiler.ioMS += performance.now() - t0;
+  }
+
+  /** Attach a host profiler to charge IO bus publishes to (null = off). */
+  setHostProfiler(profiler: HostProfiler | null): void {
+    this.hostProfiler = profiler;
+  }
+
+  /** Throughput counters for host profiling. Events are queue dequeues
+   *  (node and device); steps the hot loop runs without going through the
+   *  queue are not events. */
+  getHostCounters(): HostCounters {
+    return {
+      steps: this.totalSteps,
+      events: this.totalEvents,
+      ioWrites: this.ioWriteCount,
+      guestNS: this.guestWallClock,
+      queueDepth: queueLength(this.eventQueue),
+    };
+  }
+
+  /** Attach or detach the snapshot ring. Headless runs that only need a
+   *  few nodes' writes can detach it and subscribe to the bus instead;
+   *  snapshots then report no IO writes. */
+  setIoRingEnabled(enabled: boolean): void {
+    if (enabled && !this.unsubscribeIoRing) {
+      this.unsubscribeIoRing = this.ioBus.subscribe({}, this.ioRing.handler);
+    } else if (!enabled && this.unsubscribeIoRing) {
+      this.unsubscribeIoRing();
+      this.unsubscribeIoRing = null;
+    }
+  }
+
+  /** Record writes from the given nodes into a new IoTrace until the
+   *  returned unsubscribe function is called. Bus subscriptions survive
+   *  reset(); clear the trace yourself if needed. */
+  traceIoWrites(coords: number[]): { trace: IoTrace; unsubscribe: () => void } {
+    const trace = new IoTrace();
+    const unsubscribe = this.ioBus.subscribe({ coords }, trace.handler);
+    return { trace, unsubscribe };
+  }
+
+  /** Report port-wait transitions of the given nodes: the ports each one
+   *  blocks on when it suspends (read and write masks with bit = PortIndex,
+   *  plus whether it waits on its wake pin) and zeros when it resumes.
+   *  A node has one tracer at a time; the returned function removes it. */
+  tracePortWaits(coords: readonly number[], handler: PortWaitHandler): () => void {
+    const nodes = coords.map(c => this.getNodeByCoord(c));
+    for (const node of nodes) {
+      const coord = node.getCoord();
+      node.onPortWait = (readMask, writeMask, pinWait, timeNS) => handler(coord, readMask, writeMask, pinWait, timeNS);
+    }
+    return () => {
+      for (const node of nodes) node.onPortWait = null;
+    };
+  }
+
+  /** Called by F18ANode on a write to the emulator debug port.
+   *  With zero-time enabled the store's execution time is refunded, so
+   *  instrumented code keeps the same guest timing as uninstrumented code
+   *  apart from the instructions that load the value. */
+  onDebugWrite(nodeIndex: number, value: number, thermal: ThermalState): void {
+    if (!this.debugEnabled) return;
+    this.lastProgressTime = this.guestWallClock;
+    if (this.debugZeroTime) {
+      thermal.simulatedTime -= thermal.lastJitteredTime;
+    }
+    this.debugLog.push(this.mesh.indexToCoord(nodeIndex), value, thermal.simulatedTime);
+  }
+
+  /** Configure the debug channel. Disabled writes are dropped like any
+   *  other unmapped port write. */
+  setDebugChannel(options: { enabled?: boolean; zeroTime?: boolean }): void {
+    if (options.enabled !== undefined) this.debugEnabled = options.enabled;
+    if (options.zeroTime !== undefined) this.debugZeroTime = options.zeroTime;
+  }
+
+  /** Set the EMU_PORT.CLOCK mode for the given node coords, or for every
+   *  node when coords is omitted. */
+  setClockCounter(mode: ClockCounterMode, coords?: number[]): void {
+    if (coords) {
+      for (const c of coords) this.getNodeByCoord(c).clockMode = mode;
+    } else {
+      for (const node of this.nodes) node.clockMode = mode;
+    }
+  }
+
+  /** Enable livelock reporting: flag running nodes (other than halt loops)
+   *  that have executed for windowNS of guest time since the last IO or
+   *  debug write anywhere on the chip.
+   *  Pass 0 to disable. */
+  setLivelockWindow(windowNS: number): void {
+    this.livelockWindowNS = windowNS;
+  }
+
+  /**
+   * Check the port wait-for graph for a deadlock among RAM-executing nodes,
+   * then (if enabled) for a livelock. Cheap enough to run at snapshot rate.
+   */
+  detectStall(): StallReport | null {
+    const waits = this.nodes.map(node => node.getPortWaitTargets());
+    const stuck = findStuckNodes(waits);
+    const coords: number[] = [];
+    let start = -1;
+    for (let i = 0; i < this.numNodes; i++) {
+      if (stuck[i] && this.nodes[i].isExecutingRam()) {
+        if (start < 0) start = i;
+        coords.push(this.mesh.indexToCoord(i));
+      }
+    }
+    if (start >= 0) {
+      const cycle = findWaitCycle(start, waits, stuck);
+      return { kind: 'deadlock', coords, cycle: cycle.nodes.map(i => this.mesh.indexToCoord(i)), cycleClosed: cycle.closed };
+    }
+
+    // Skip livelock checks while serial input is still pending; a finished
+    // boot stream must not hide a spinning program
+    if (this.livelockWindowNS > 0 && this.getSerialInputPending() === 0) {
+      // A node spins if it has itself run a full window past the last
+      // progress point (nodes left unscheduled by load() never advance)
+      const horizon = this.lastProgressTime + this.livelockWindowNS;
+      const spinning: number[] = [];
+      for (let i = 0; i <= this.lastActiveIndex; i++) {
+        const node = this.activeNodes[i];
+        if (node.thermal.simulatedTime > horizon && !node.isInHaltLoop()) {
+          spinning.push(node.getCoord());
+        }
+      }
+      if (spinning.length > 0) {
+        spinning.sort((a, b) => a - b);
+        return { kind: 'livelock', coords: spinning, cycle: [], cycleClosed: false };
       }
-      this.lastVsyncSeq = this.ioWriteSeq;
     }
-    this.pushIoWrite(tagged, thermal?.simulatedTime ?? 0, thermal?.lastJitteredTime ?? 0);
+    return null;
   }
 
-  private pushIoWrite(value: number, simulatedTime: number, jitteredTime: number = 0): void {
-    const capacity = this.ioWriteBuffer.length;
-    const size = this.ioWriteSeq - this.ioWriteStartSeq;
-    if (size >= capacity) {
-      // Overwrite oldest entry
-      this.ioWriteStart = (this.ioWriteStart + 1) % capacity;
-      this.ioWriteStartSeq++;
+  /** Turn per-node coverage bitmaps on or off. Enabling starts from
+   *  empty bitmaps; reset() clears them but keeps coverage enabled. */
+  setCoverageEnabled(enabled: boolean): void {
+    for (const node of this.nodes) {
+      node.coverage = enabled ? new NodeCoverage() : null;
+    }
+  }
+
+  /** Coverage bitmaps keyed by node coordinate (empty when disabled). */
+  getCoverage(): Map<number, NodeCoverage> {
+    const map = new Map<number, NodeCoverage>();
+    for (const node of this.nodes) {
+      if (node.coverage) map.set(node.getCoord(), node.coverage);
+    }
+    return map;
+  }
+
+  /** Install a write-mode RAM watch's hooks on its nodes, or remove them
+   *  (null, or a sample-mode watch). Survives reset(). */
+  setRamWatch(watch: RamWatch | null): void {
+    for (const node of this.nodes) {
+      node.ramWatch = watch?.nodeWatches.get(node.getCoord()) ?? null;
     }
-    const idx = (this.ioWriteStart + (this.ioWriteSeq - this.ioWriteStartSeq)) % capacity;
-    this.ioWriteBuffer[idx] = value;
-    this.ioWriteTimestamps[idx] = simulatedTime;
-    this.ioWriteJitter[idx] = jitteredTime;
-    this.ioWriteSeq++;
+  }
+
+  /** Extract debug log entries since a given sequence number. */
+  getDebugLogDelta(sinceSeq: number): DebugLogDelta {
+    return this.debugLog.getDelta(sinceSeq);
   }
 
   // ========================================================================
@@ -344,13 +533,14 @@ export class GA144 {
   // ========================================================================
 
   load(compiled: CompiledProgram): void {
-    // Clear the event queue — non-loaded nodes (executing ROM) would
+    // Drop queued node events — non-loaded nodes (executing ROM) would
     // consume step budget without contributing to the test scenario.
-    clearQueue(this.eventQueue);
+    // Device events stay scheduled.
+    removeByType(this.eventQueue, EVT_NODE);
 
     for (const nodeData of compiled.nodes) {
-      const index = coordToIndex(nodeData.coord);
-      if (index >= 0 && index < NUM_NODES) {
+      if (this.mesh.validCoord(nodeData.coord)) {
+        const index = this.mesh.coordToIndex(nodeData.coord);
         this.nodes[index].load(nodeData);
         // node.load() calls fetchI(); enqueue the node so it participates
         enqueue(this.eventQueue, this.nodes[index].thermal.simulatedTime, EVT_NODE, index);
@@ -358,51 +548,115 @@ export class GA144 {
     }
   }
 
-  /** Inter-stream gap in ns when appending serial bits. */
-  private static readonly SERIAL_GAP_NS = 1_000_000; // 1 ms gap between streams to ensure clear separation
+  // ========================================================================
+  // Devices
+  // ========================================================================
+
+  /**
+   * Attach a peripheral. Its events run in guest-time order with the
+   * nodes; see devices/device.ts. Returns a function that detaches it and
+   * drops its queued events.
+   */
+  attachDevice(device: Device): () => void {
+    let slot = this.devices.indexOf(null);
+    if (slot < 0) {
+      slot = this.devices.length;
+      this.devices.push(null);
+    }
+    this.devices[slot] = device;
+    device.attach(this.makeDeviceHost(slot));
+    return () => {
+      if (this.devices[slot] !== device) return;
+      removeByTypeAndPayload(this.eventQueue, EVT_DEVICE, slot);
+      this.devices[slot] = null;
+      device.detach?.();
+    };
+  }
+
+  /** Attached devices' state, built-in serial input first. */
+  getDeviceSnapshots(): DeviceSnapshot[] {
+    const out: DeviceSnapshot[] = [];
+    for (const d of this.devices) if (d) out.push({ name: d.name, state: d.snapshot() });
+    return out;
+  }
+
+  private makeDeviceHost(slot: number): DeviceHost {
+    return {
+      now: () => this.guestWallClock,
+      schedule: (timeNS) => enqueue(this.eventQueue, timeNS, EVT_DEVICE, slot),
+      setPin: (coord, pin, level) => {
+        const node = this.getNodeByCoord(coord);
+        if (pin !== 17) {
+          node.setPinInput(pin, level);
+          return;
+        }
+        this.catchUpSuspended(node);
+        node.setPin17(level);
+      },
+      getPin: (coord, pin) => {
+        const node = this.getNodeByCoord(coord);
+        return pin === 17 ? node.getPin17() : node.getPinInput(pin);
+      },
+      setAnalogSource: (coord, source) => {
+        this.getNodeByCoord(coord).analogSource = source;
+      },
+      setDataBus: (coord, bus) => {
+        this.getNodeByCoord(coord).dataBus = bus;
+      },
+      setExternalPort: (coord, port, endpoint) => {
+        this.getNodeByCoord(coord).setExternalPort(port, endpoint);
+      },
+      deliverPortValue: (coord, value) => {
+        const node = this.getNodeByCoord(coord);
+        this.catchUpSuspended(node);
+        node.deliverExternalRead(value);
+      },
+      ioBus: this.ioBus,
+    };
+  }
+
+  /** A suspended node has been idle until now; bring its clock up so a
+   *  device-driven wakeup resumes at the current guest time. */
+  private catchUpSuspended(node: F18ANode): void {
+    const dt = this.guestWallClock - node.thermal.simulatedTime;
+    if (node.isSuspended() && dt > 0) recordIdle(node.thermal, dt);
+  }
 
   /**
-   * Append serial bits and enqueue the first new edge event if no serial
-   * event is currently in-flight. Can be called multiple times to extend
-   * an ongoing serial stream.
+   * Append serial bits to the built-in serial input device. Can be called
+   * multiple times to extend an ongoing serial stream.
    *
    * Bit durations are relative (each is the hold time for that bit value).
    * When appending to an existing stream, the new bits are time-shifted to
-   * start after the last existing bit's end time + a gap.
+   * start after the last existing bit's end time + a gap. Pass `startNS`
+   * to pin the first bit to an absolute guest time instead (replayed
+   * traces); it is still clamped to after the previous stream and now.
    */
   enqueueSerialBits(
     coord: number,
     bits: SerialBit[],
+    startNS?: number,
   ): void {
-    if (bits.length === 0) return;
-    this.serialNode = this.getNodeByCoord(coord);
-
-    const baseIdx = this.serialBitValues.length;
-
-    // Start time: after the last bit ends (+ gap), or guestWallClock,
-    // whichever is later. This ensures new bits are always scheduled in
-    // the future even if called long after the previous stream ended.
-    let absTime = Math.max(this.serialEndTime, this.guestWallClock) + GA144.SERIAL_GAP_NS;
+    this.serialInput.enqueue(coord, bits, startNS);
+  }
 
-    // Append values and pre-compute absolute times
-    for (let i = 0; i < bits.length; i++) {
-      this.serialBitValues.push(bits[i].value);
-      this.serialBitTimes.push(absTime);
-      absTime += bits[i].durationNS;
-    }
-    this.serialEndTime = absTime;
+  /** Returns true if a serial stream has targeted a node since reset. Stays
+   *  true after the stream ends; see getSerialInputPending for delivery. */
+  isBooting(): boolean {
+    return this.serialInput.node !== null;
+  }
 
-    // Enqueue first new bit only if no serial event is already in-flight.
-    // If a chain is running (serialBitIndex < baseIdx), it will naturally
-    // reach the appended bits via the bitIdx+1 chain in the handler.
-    if (this.serialBitIndex >= baseIdx) {
-      enqueue(this.eventQueue, this.serialBitTimes[baseIdx], EVT_SERIAL, baseIdx);
-    }
+  /** Input still to be delivered by all attached devices (see
+   *  Device.pending), including serial bits. */
+  getDevicePending(): number {
+    let pending = 0;
+    for (const device of this.devices) pending += device?.pending ?? 0;
+    return pending;
   }
 
-  /** Returns true if serial boot stream is still being delivered. */
-  isBooting(): boolean {
-    return this.serialNode !== null;
+  /** Serial input bits not yet driven onto the pin. */
+  getSerialInputPending(): number {
+    return this.serialInput.pending;
   }
 
   /**
@@ -423,10 +677,10 @@ export class GA144 {
    * are considered; data tags (bit 17 set, etc.) are skipped.
    */
   ioWritesToBits(nodeCoord: number): SerialBit[] {
-    const count = this.ioWriteSeq - this.ioWriteStartSeq;
+    const ring = this.ioRing;
     return GA144.ioWritesToBitsFromBuffer(
-      this.ioWriteBuffer, this.ioWriteTimestamps,
-      this.ioWriteStart, count, nodeCoord,
+      ring.writes, ring.writeTimestamps,
+      ring.startIndex, ring.count, nodeCoord,
     );
   }
 
@@ -489,31 +743,33 @@ export class GA144 {
 
   reset(): void {
     this.totalSteps = 0;
+    this.totalEvents = 0;
+    this.ioWriteCount = 0;
     this.guestWallClock = 0;
     this._breakpointHit = false;
     this.eventsSinceIdleSweep = 0;
-    this.ioWriteStart = 0;
-    this.ioWriteStartSeq = 0;
-    this.ioWriteSeq = 0;
-    this.ioWriteJitter = new Float32Array(GA144.IO_WRITE_CAPACITY);
-    this.lastVsyncSeq = null;
-    this.lastActiveIndex = NUM_NODES - 1;
-
-    // Clear the event queue
+    this.ioRing.reset();
+    this.debugLog.reset();
+    this.lastProgressTime = 0;
+    this.lastActiveIndex = this.numNodes - 1;
+
+    // Clear the event queue and every pending port handshake
     clearQueue(this.eventQueue);
+    this.links.reset();
 
-    for (let i = 0; i < NUM_NODES; i++) {
+    for (let i = 0; i < this.numNodes; i++) {
       this.activeNodes[i] = this.nodes[i];
       this.nodes[i].activeIndex = i;
     }
 
     for (const node of this.nodes) {
       const coord = node.getCoord();
-      node.reset(this.romData[coord]);
+      node.reset(this.romData[this.mesh.romCoord(coord)]);
+      node.coverage?.reset();
     }
 
     // Re-wire VCO counters after node reset (setupPorts() clears them)
-    if (this.vcoCounters) {
+    if (this.vcoCounters && this.mesh.standard) {
       for (let i = 0; i < ANALOG_NODES.length; i++) {
         this.getNodeByCoord(ANALOG_NODES[i]).setVcoCounter(this.vcoCounters, i);
       }
@@ -524,17 +780,12 @@ export class GA144 {
       node.fetchI();
     }
 
-    // Enqueue all 144 nodes at simulatedTime=0 (with collision nudging)
-    for (let i = 0; i < NUM_NODES; i++) {
+    // Enqueue all nodes at simulatedTime=0 (with collision nudging)
+    for (let i = 0; i < this.numNodes; i++) {
       enqueue(this.eventQueue, this.nodes[i].thermal.simulatedTime, EVT_NODE, i);
     }
 
-    // Clear serial state
-    this.serialBitValues = [];
-    this.serialBitTimes = [];
-    this.serialEndTime = 0;
-    this.serialBitIndex = 0;
-    this.serialNode = null;
+    for (const device of this.devices) device?.reset();
   }
 
   // ========================================================================
@@ -542,13 +793,18 @@ export class GA144 {
   // ========================================================================
 
   getNodeByCoord(coord: number): F18ANode {
-    return this.nodes[coordToIndex(coord)];
+    return this.nodes[this.mesh.coordToIndex(coord)];
   }
 
   getNodeByIndex(index: number): F18ANode {
     return this.nodes[index];
   }
 
+  /** Words carried by each inter-node link direction since reset. */
+  getLinkTraffic(): LinkTraffic[] {
+    return this.links.traffic();
+  }
+
   getActiveCount(): number {
     return this.lastActiveIndex + 1;
   }
@@ -557,65 +813,63 @@ export class GA144 {
     return this.totalSteps;
   }
 
+  /** Guest wall-clock time (ns) reached so far. */
+  getGuestTimeNS(): number {
+    return this.guestWallClock;
+  }
+
   // ========================================================================
   // Snapshots for React UI
   // ========================================================================
 
+  /** Cumulative energy dissipated across all nodes (picojoules). */
+  getTotalEnergyPJ(): number {
+    let total = 0;
+    for (let i = 0; i < this.numNodes; i++) total += this.nodes[i].thermal.totalEnergy;
+    return total;
+  }
+
+  /** Instantaneous power estimate: active nodes at typical power, idle at leakage. */
+  getChipPowerMW(): number {
+    const active = this.getActiveCount();
+    return active * 4.5 + (this.numNodes - active) * 100e-6; // 4.5 mW active, 100 nW idle
+  }
+
   /** Extract IO writes since a given sequence number (for delta transfer). */
   getIoWritesDelta(sinceSeq: number): IoWriteDelta {
-    const from = Math.max(sinceSeq, this.ioWriteStartSeq);
-    const count = this.ioWriteSeq - from;
-    if (count <= 0) {
-      return { writes: [], timestamps: [], startSeq: from, totalSeq: this.ioWriteSeq };
-    }
-    const writes = new Array(count);
-    const timestamps = new Array(count);
-    for (let i = 0; i < count; i++) {
-      const offset = from - this.ioWriteStartSeq + i;
-      const idx = (this.ioWriteStart + offset) % this.ioWriteBuffer.length;
-      writes[i] = this.ioWriteBuffer[idx];
-      timestamps[i] = this.ioWriteTimestamps[idx];
-    }
-    return { writes, timestamps, startSeq: from, totalSeq: this.ioWriteSeq };
+    return this.ioRing.getDelta(sinceSeq);
   }
 
   getSnapshot(selectedCoord?: number): GA144Snapshot {
-    const states: NodeState[] = new Array(NUM_NODES);
-    const coords: number[] = new Array(NUM_NODES);
+    const states: NodeState[] = new Array(this.numNodes);
+    const coords: number[] = new Array(this.numNodes);
 
-    let totalEnergyPJ = 0;
-    for (let i = 0; i < NUM_NODES; i++) {
+    for (let i = 0; i < this.numNodes; i++) {
       states[i] = this.nodes[i].getState();
       coords[i] = this.nodes[i].getCoord();
-      totalEnergyPJ += this.nodes[i].thermal.totalEnergy;
     }
-    // Instantaneous power estimate: active nodes at typical power, idle at leakage
-    const active = this.lastActiveIndex + 1;
-    const idle = NUM_NODES - active;
-    const chipPowerMW = active * 4.5 + idle * 100e-6; // 4.5 mW active, 100 nW idle
 
     let selectedNode = null;
     if (selectedCoord !== undefined) {
-      const idx = coordToIndex(selectedCoord);
-      if (idx >= 0 && idx < NUM_NODES) {
-        selectedNode = this.nodes[idx].getSnapshot();
+      if (this.mesh.validCoord(selectedCoord)) {
+        selectedNode = this.nodes[this.mesh.coordToIndex(selectedCoord)].getSnapshot();
       }
     }
 
     return {
       nodeStates: states,
       nodeCoords: coords,
-      activeCount: active,
+      activeCount: this.getActiveCount(),
       totalSteps: this.totalSteps,
       selectedNode,
-      ioWrites: this.ioWriteBuffer,
-      ioWriteTimestamps: this.ioWriteTimestamps,
-      ioWriteJitter: this.ioWriteJitter,
-      ioWriteStart: this.ioWriteStart,
-      ioWriteCount: this.ioWriteSeq - this.ioWriteStartSeq,
-      ioWriteSeq: this.ioWriteSeq,
-      totalEnergyPJ,
-      chipPowerMW,
+      ioWrites: this.ioRing.writes,
+      ioWriteTimestamps: this.ioRing.writeTimestamps,
+      ioWriteJitter: this.ioRing.writeJitter,
+      ioWriteStart: this.ioRing.startIndex,
+      ioWriteCount: this.ioRing.count,
+      ioWriteSeq: this.ioRing.totalSeq,
+      totalEnergyPJ: this.getTotalEnergyPJ(),
+      chipPowerMW: this.getChipPowerMW(),
       totalSimTimeNS: this.guestWallClock,
     };
   }
@@ -0,0 +1,82 @@
+/**
+ * Tests for host self-profiling: splitting step time into estimated
+ * subsystems, throughput rates, and the chip's profiling counters.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { PORT } from './constants';
+import { HostProfiler, calibrateHostCosts } from './host-profile';
+import type { HostCounters } from './host-profile';
+
+const counters = (steps: number, events: number, ioWrites: number, guestNS: number): HostCounters =>
+  ({ steps, events, ioWrites, guestNS, queueDepth: 3 });
+
+describe('HostProfiler', () => {
+  it('splits step time with calibrated costs and reports rates per window', () => {
+    let now = 0;
+    const profiler = new HostProfiler({ queueNS: 100, queueScanNS: 10, thermalNS: 50 }, () => now);
+    profiler.start(counters(1000, 500, 10, 0));
+
+    // 1M steps and 100k events in a 1 s window, 600 ms of it stepping
+    profiler.add('step', 600);
+    profiler.ioMS = 40;
+    profiler.sampleQueueDepth(3);
+    profiler.time('snapshot', () => { now += 25; });
+    profiler.add('post', 5);
+    now = 1000;
+    const report = profiler.report(counters(1_001_000, 100_500, 5010, 2e6));
+
+    // Depth 3: an insert scans one other event on average
+    expect(report.sections.queue).toBeCloseTo(100_000 * 110 / 1e6);
+    expect(report.sections.thermal).toBeCloseTo(50);
+    expect(report.sections.io).toBe(40);
+    expect(report.sections.guest).toBeCloseTo(600 - 11 - 50 - 40);
+    expect(report.sections.snapshot).toBe(25);
+    expect(report.busy).toBeCloseTo(0.63);
+    expect(report.mips).toBeCloseTo(1);
+    expect(report.eventsPerSec).toBeCloseTo(100_000);
+    expect(report.ioWritesPerSec).toBeCloseTo(5000);
+    expect(report.guestSpeed).toBeCloseTo(0.002);
+
+    // The next window starts empty, and estimates never exceed step time
+    now = 1500;
+    profiler.add('step', 1);
+    const next = profiler.report(counters(2_001_000, 100_500, 5010, 2e6));
+    expect(next.sections.snapshot).toBe(0);
+    expect(next.sections.thermal).toBe(1);
+    expect(next.sections.guest).toBe(0);
+  });
+
+  it('calibrates positive costs and times IO publishes on a chip', () => {
+    const costs = calibrateHostCosts(undefined, 20_000);
+    expect(costs.queueNS).toBeGreaterThan(0);
+    expect(costs.thermalNS).toBeGreaterThan(0);
+
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    const compiled = compileCube(`#include std
+node 600
+/\\
+std.forever{}
+/\\ std.send{port=${PORT.IO}, value=0x30000}
+/\\ std.repeat{}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    const profiler = new HostProfiler(costs);
+    ga.setHostProfiler(profiler);
+    profiler.start(ga.getHostCounters());
+    ga.stepProgramN(10_000);
+
+    const c = ga.getHostCounters();
+    expect(c.steps).toBe(10_000);
+    expect(c.events).toBeGreaterThan(0);
+    expect(c.ioWrites).toBeGreaterThan(1000);
+    expect(c.queueDepth).toBeGreaterThan(0);
+    expect(profiler.ioMS).toBeGreaterThan(0);
+    ga.reset();
+    expect(ga.getHostCounters()).toMatchObject({ steps: 0, events: 0, ioWrites: 0 });
+  });
+});
@@ -0,0 +1,182 @@
+/**
+ * Host self-profiling — where the emulator's own wall-clock time goes.
+ *
+ * Sections are accumulated in host milliseconds and reported per window
+ * alongside guest throughput (MIPS, events/s, IO writes/s) from the
+ * chip's counters. Work done per instruction or per event is too short
+ * to time one call at a time, so `queue` and `thermal` are estimated:
+ * counts from the chip times a per-operation cost measured once by
+ * calibrateHostCosts(). `io` is measured around every IO bus publish
+ * while a profiler is attached to the chip. `guest` is the rest of the
+ * stepping time — decoding and executing F18A instructions.
+ */
+import { createEventQueue, enqueue, dequeue, EVT_NODE } from './event-queue';
+import { createThermalState, recordInstruction } from './thermal';
+
+export const HOST_SECTIONS = ['guest', 'queue', 'thermal', 'io', 'snapshot', 'post', 'stall'] as const;
+export type HostSection = typeof HOST_SECTIONS[number];
+
+/** Sections timed directly by callers; `step` is split into guest, queue, thermal and io. */
+export type TimedSection = 'step' | 'snapshot' | 'post' | 'stall';
+
+/** Chip counters read at the end of each window (see GA144.getHostCounters). */
+export interface HostCounters {
+  steps: number;
+  events: number;
+  ioWrites: number;
+  guestNS: number;
+  queueDepth: number;
+}
+
+export interface HostCosts {
+  /** Host ns per event for one dequeue and one re-enqueue at the head. */
+  queueNS: number;
+  /** Host ns per queued event an insert scans past. */
+  queueScanNS: number;
+  /** Host ns per recordInstruction call. */
+  thermalNS: number;
+}
+
+export interface HostProfileReport {
+  /** Host ms covered by the report. */
+  windowMS: number;
+  /** Host ms spent per section in the window. */
+  sections: Record<HostSection, number>;
+  /** Share of the window spent in any section; the rest is idle or yields. */
+  busy: number;
+  mips: number;
+  eventsPerSec: number;
+  ioWritesPerSec: number;
+  /** Queue depth sampled at the end of each step chunk, averaged. */
+  queueDepth: number;
+  /** Guest ns per host ns (1 = real time). */
+  guestSpeed: number;
+}
+
+/** Host ns per dequeue plus re-enqueue behind `depth - 1` other events. */
+function timeQueueRoundTrip(now: () => number, ops: number, depth: number): number {
+  const q = createEventQueue(depth + 1);
+  for (let i = 0; i < depth; i++) enqueue(q, i * 7.5, EVT_NODE, i);
+  const evt = { time: 0, type: 0, payload: 0 };
+  const t0 = now();
+  for (let i = 0; i < ops; i++) {
+    dequeue(q, evt);
+    enqueue(q, evt.time + depth * 7.5, evt.type, evt.payload);
+  }
+  return ((now() - t0) * 1e6) / ops;
+}
+
+function timeThermal(now: () => number, ops: number): number {
+  const thermal = createThermalState(1);
+  const t0 = now();
+  for (let i = 0; i < ops; i++) recordInstruction(thermal, i & 0x1F);
+  return ((now() - t0) * 1e6) / ops;
+}
+
+/**
+ * Time queue round trips at two depths (for a fixed and a per-entry cost)
+ * and thermal updates, on scratch state. Each loop runs once to warm up
+ * the JIT before it is timed.
+ */
+export function calibrateHostCosts(now: () => number = () => performance.now(), ops = 200_000): HostCosts {
+  const DEEP = 129;
+  timeQueueRoundTrip(now, ops, DEEP);
+  timeThermal(now, ops);
+  const shallow = timeQueueRoundTrip(now, ops, 1);
+  const deep = timeQueueRoundTrip(now, ops, DEEP);
+  return {
+    queueNS: shallow,
+    queueScanNS: Math.max(deep - shallow, 0) / (DEEP - 1),
+    thermalNS: timeThermal(now, ops),
+  };
+}
+
+export class HostProfiler {
+  private readonly now: () => number;
+  private readonly costs: HostCosts;
+  private readonly timed: Record<TimedSection, number> = { step: 0, snapshot: 0, post: 0, stall: 0 };
+  /** Host ms inside IO bus publishes, counted by the chip. */
+  ioMS = 0;
+  private depthSum = 0;
+  private depthSamples = 0;
+  private windowStart: number;
+  private last: HostCounters | null = null;
+
+  constructor(costs: HostCosts, now: () => number = () => performance.now()) {
+    this.costs = costs;
+    this.now = now;
+    this.windowStart = now();
+  }
+
+  /** Add host ms to a section. */
+  add(section: TimedSection, ms: number): void {
+    this.timed[section] += ms;
+  }
+
+  /** Run `fn`, charging its host time to `section`. */
+  time<T>(section: TimedSection, fn: () => T): T {
+    const t0 = this.now();
+    try {
+      return fn();
+    } finally {
+      this.timed[section] += this.now() - t0;
+    }
+  }
+
+  sampleQueueDepth(depth: number): void {
+    this.depthSum += depth;
+    this.depthSamples++;
+  }
+
+  /** Start the first window from the chip's current counters. */
+  start(counters: HostCounters): void {
+    this.last = counters;
+    this.windowStart = this.now();
+  }
+
+  /** Close the window, report it, and start the next one. */
+  report(counters: HostCounters): HostProfileReport {
+    const end = this.now();
+    const windowMS = Math.max(end - this.windowStart, 1e-6);
+    const last = this.last ?? counters;
+    const steps = counters.steps - last.steps;
+    const events = counters.events - last.events;
+
+    // An insert scans about half the queue. Estimates can overshoot on a
+    // noisy timer; never let guest go negative.
+    const depth = this.depthSamples > 0 ? this.depthSum / this.depthSamples : counters.queueDepth;
+    const perEvent = this.costs.queueNS + this.costs.queueScanNS * Math.max(depth - 1, 0) / 2;
+    const queue = Math.min((events * perEvent) / 1e6, this.timed.step);
+    const thermal = Math.min((steps * this.costs.thermalNS) / 1e6, this.timed.step - queue);
+    const io = Math.min(this.ioMS, this.timed.step - queue - thermal);
+    const sections: Record<HostSection, number> = {
+      guest: this.timed.step - queue - thermal - io,
+      queue,
+      thermal,
+      io,
+      snapshot: this.timed.snapshot,
+      post: this.timed.post,
+      stall: this.timed.stall,
+    };
+    const busyMS = HOST_SECTIONS.reduce((sum, s) => sum + sections[s], 0);
+    const perSec = 1000 / windowMS;
+    const result: HostProfileReport = {
+      windowMS,
+      sections,
+      busy: Math.min(busyMS / windowMS, 1),
+      mips: (steps * perSec) / 1e6,
+      eventsPerSec: events * perSec,
+      ioWritesPerSec: (counters.ioWrites - last.ioWrites) * perSec,
+      queueDepth: depth,
+      guestSpeed: (counters.guestNS - last.guestNS) / (windowMS * 1e6),
+    };
+
+    for (const s of Object.keys(this.timed) as TimedSection[]) this.timed[s] = 0;
+    this.ioMS = 0;
+    this.depthSum = 0;
+    this.depthSamples = 0;
+    this.last = counters;
+    this.windowStart = end;
+    return result;
+  }
+}
@@ -0,0 +1,123 @@
+/**
+ * Tests for the IO event bus, its filters, and the snapshot ring consumer.
+ */
+import { describe, it, expect } from 'vitest';
+import { IoBus, IoTrace } from './io-bus';
+import { IoWriteRing } from './io-ring';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { coordToIndex } from './constants';
+import type { ThermalState } from './thermal';
+
+function write(bus: IoBus, coord: number, value: number, t = 0): void {
+  bus.publish(coordToIndex(coord), value, t, 0);
+}
+
+describe('IoBus', () => {
+  it('routes writes only to subscribers whose coords match', () => {
+    const bus = new IoBus();
+    const a = new IoTrace();
+    const b = new IoTrace();
+    bus.subscribe({ coords: [708] }, a.handler);
+    bus.subscribe({ coords: [117, 617] }, b.handler);
+
+    write(bus, 708, 3);
+    write(bus, 617, 0x155);
+    write(bus, 500, 1);
+
+    expect(a.writes).toEqual([708 * 0x40000 + 3]);
+    expect(b.writes).toEqual([617 * 0x40000 + 0x155]);
+    expect(bus.hasSubscribers(coordToIndex(500))).toBe(false);
+    expect(bus.hasSubscribers(coordToIndex(117))).toBe(true);
+  });
+
+  it('applies the value mask/match filter', () => {
+    const bus = new IoBus();
+    const vsync = new IoTrace();
+    bus.subscribe({ coords: [217], mask: 0x30000, match: 0x30000 }, vsync.handler);
+
+    write(bus, 217, 0x20000, 10);
+    write(bus, 217, 0x30000, 20);
+    write(bus, 217, 0x10000, 30);
+
+    expect(vsync.count).toBe(1);
+    expect(vsync.timestamps).toEqual([20]);
+  });
+
+  it('delivers to wildcard subscribers and stops after unsubscribe', () => {
+    const bus = new IoBus();
+    const all = new IoTrace();
+    const unsubscribe = bus.subscribe({}, all.handler);
+    write(bus, 0, 1);
+    write(bus, 715, 2);
+    unsubscribe();
+    write(bus, 715, 3);
+
+    expect(all.count).toBe(2);
+    expect(bus.hasSubscribers(coordToIndex(715))).toBe(false);
+  });
+});
+
+describe('IoWriteRing', () => {
+  it('grows on demand and keeps order across growth', () => {
+    const ring = new IoWriteRing({ capacity: 100_000 });
+    const initial = ring.writes.length;
+    for (let i = 0; i < initial * 3; i++) ring.handler(1, i & 0x3FFFF, i, 0);
+
+    expect(ring.writes.length).toBeGreaterThan(initial);
+    expect(ring.count).toBe(initial * 3);
+    const delta = ring.getDelta(0);
+    expect(delta.writes[0]).toBe(1 * 0x40000);
+    expect(delta.timestamps[initial * 3 - 1]).toBe(initial * 3 - 1);
+  });
+
+  it('overwrites the oldest entries once at capacity', () => {
+    const ring = new IoWriteRing({ capacity: 8 });
+    for (let i = 0; i < 20; i++) ring.handler(0, i, i, 0);
+
+    expect(ring.writes.length).toBe(8);
+    expect(ring.count).toBe(8);
+    expect(ring.totalSeq).toBe(20);
+    expect(ring.getDelta(0).writes).toEqual([12, 13, 14, 15, 16, 17, 18, 19]);
+  });
+
+  it('keeps one frame when a VSYNC coord is configured', () => {
+    const ring = new IoWriteRing({ vsyncCoord: 217 });
+    ring.handler(117, 1, 0, 0);
+    ring.handler(217, 0x30000, 1, 0);  // first VSYNC: nothing dropped
+    ring.handler(117, 2, 2, 0);
+    ring.handler(217, 0x30000, 3, 0);  // drops up to the first VSYNC
+    ring.handler(117, 3, 4, 0);
+
+    expect(ring.getDelta(0).timestamps).toEqual([1, 2, 3, 4]);
+  });
+});
+
+describe('GA144 IO bus', () => {
+  function makeGa(): GA144 {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    return ga;
+  }
+
+  it('feeds traces alongside the snapshot ring', () => {
+    const ga = makeGa();
+    const { trace } = ga.traceIoWrites([708]);
+    ga.onIoWrite(coordToIndex(708), 3, { simulatedTime: 100 } as ThermalState);
+    ga.onIoWrite(coordToIndex(117), 0x100, { simulatedTime: 200 } as ThermalState);
+
+    expect(trace.timestamps).toEqual([100]);
+    expect(ga.getSnapshot().ioWriteCount).toBe(2);
+  });
+
+  it('records nothing in snapshots when the ring is detached', () => {
+    const ga = makeGa();
+    ga.setIoRingEnabled(false);
+    const { trace } = ga.traceIoWrites([708]);
+    ga.onIoWrite(coordToIndex(708), 3, { simulatedTime: 100 } as ThermalState);
+
+    expect(ga.getSnapshot().ioWriteCount).toBe(0);
+    expect(trace.count).toBe(1);
+  });
+});
@@ -0,0 +1,121 @@
+/**
+ * IO event bus — fans IO register writes out to filtered consumers.
+ *
+ * Consumers subscribe with a filter (node coords plus a value mask/match)
+ * and a handler, and keep whatever buffering suits them: the snapshot ring
+ * keeps one VGA frame, a serial tap keeps one pin's transitions, a logger
+ * keeps nothing. Routing is precomputed per node, so a write from a node
+ * nobody listens to costs one array lookup.
+ */
+import { GA144_MESH } from './mesh';
+import type { Mesh } from './mesh';
+
+/** Which writes a subscriber receives. Omitted fields match everything. */
+export interface IoFilter {
+  /** Only writes from these node coordinates. */
+  coords?: readonly number[];
+  /** Deliver only when `(value & mask) === match`. */
+  mask?: number;
+  match?: number;
+}
+
+/** Receives one IO write: node coord, 18-bit value, and the node's
+ *  simulated and jittered time (ns) at the write. */
+export type IoHandler = (coord: number, value: number, timeNS: number, jitterNS: number) => void;
+
+interface IoSubscription {
+  coords: readonly number[] | null;
+  mask: number;
+  match: number;
+  handler: IoHandler;
+}
+
+const NO_SUBSCRIBERS: readonly IoSubscription[] = [];
+
+export class IoBus {
+  private readonly mesh: Mesh;
+  private subscriptions: IoSubscription[] = [];
+  /** Per node index: the subscriptions whose coord filter admits it. */
+  private routes: (readonly IoSubscription[])[];
+
+  constructor(mesh: Mesh = GA144_MESH) {
+    this.mesh = mesh;
+    this.routes = new Array(mesh.numNodes).fill(NO_SUBSCRIBERS);
+  }
+
+  /** Register a consumer. Returns a function that unsubscribes it. */
+  subscribe(filter: IoFilter, handler: IoHandler): () => void {
+    const sub: IoSubscription = {
+      coords: filter.coords ?? null,
+      mask: filter.mask ?? 0,
+      match: filter.match ?? 0,
+      handler,
+    };
+    this.subscriptions.push(sub);
+    this.rebuildRoutes();
+    return () => {
+      const i = this.subscriptions.indexOf(sub);
+      if (i < 0) return;
+      this.subscriptions.splice(i, 1);
+      this.rebuildRoutes();
+    };
+  }
+
+  /** True if any subscriber would see writes from this node. */
+  hasSubscribers(nodeIndex: number): boolean {
+    return this.routes[nodeIndex].length > 0;
+  }
+
+  publish(nodeIndex: number, value: number, timeNS: number, jitterNS: number): void {
+    const subs = this.routes[nodeIndex];
+    if (subs.length === 0) return;
+    const coord = this.mesh.indexToCoord(nodeIndex);
+    for (let i = 0; i < subs.length; i++) {
+      const s = subs[i];
+      if ((value & s.mask) === s.match) s.handler(coord, value, timeNS, jitterNS);
+    }
+  }
+
+  private rebuildRoutes(): void {
+    const routes: IoSubscription[][] = [];
+    for (let i = 0; i < this.mesh.numNodes; i++) routes.push([]);
+    for (const sub of this.subscriptions) {
+      if (sub.coords === null) {
+        for (const list of routes) list.push(sub);
+      } else {
+        for (const c of sub.coords) {
+          if (!this.mesh.validCoord(c)) continue;
+          const idx = this.mesh.coordToIndex(c);
+          if (!routes[idx].includes(sub)) routes[idx].push(sub);
+        }
+      }
+    }
+    this.routes = routes.map(list => (list.length > 0 ? list : NO_SUBSCRIBERS));
+  }
+}
+
+/**
+ * Unbounded recorder for a filtered subset of IO writes (GPIO traces,
+ * serial taps, user logging). Writes are stored tagged as
+ * (coord << 18) | value, the same encoding as the snapshot ring, so the
+ * ring helpers (e.g. GA144.ioWritesToBitsFromBuffer) work on it with
+ * start 0.
+ */
+export class IoTrace {
+  readonly writes: number[] = [];
+  readonly timestamps: number[] = [];
+
+  readonly handler: IoHandler = (coord, value, timeNS) => {
+    this.writes.push(coord * 0x40000 + value);
+    this.timestamps.push(timeNS);
+  };
+
+  get count(): number {
+    return this.writes.length;
+  }
+
+  clear(): void {
+    this.writes.length = 0;
+    this.timestamps.length = 0;
+  }
+}
@@ -0,0 +1,138 @@
+/**
+ * Snapshot ring of tagged IO writes — the IO bus consumer behind
+ * GA144Snapshot.ioWrites and the worker's delta transfer.
+ *
+ * Entries are stored as (coord << 18) | value with their timestamps under a
+ * monotonic sequence counter. Storage starts small and doubles on demand up
+ * to `capacity`, after which the oldest entries are overwritten. With
+ * `vsyncCoord` set, a VSYNC write from that node (pin17 driven high, bits
+ * 17:16 = 11) drops everything before the previous VSYNC, keeping one full
+ * frame for the VGA display.
+ */
+
+/** IO writes since a given sequence number (worker delta transfer). The
+ *  arrays are freshly allocated, so the worker can transfer their buffers. */
+export interface IoWriteDelta {
+  writes: Uint32Array;
+  timestamps: Float64Array;
+  startSeq: number;
+  totalSeq: number;
+}
+
+export interface IoWriteRingOptions {
+  capacity?: number;
+  /** GPIO node whose VSYNC trims the ring (null = never trim). */
+  vsyncCoord?: number | null;
+}
+
+export class IoWriteRing {
+  static readonly DEFAULT_CAPACITY = 2_000_000;
+  private static readonly INITIAL_SIZE = 4096;
+
+  readonly capacity: number;
+  readonly vsyncCoord: number | null;
+  private buffer: number[];
+  private timestamps: number[];
+  private jitter: Float32Array;
+  private start = 0;     // ring start index
+  private startSeq = 0;  // sequence number at ring start
+  private seq = 0;       // next sequence number to write
+  private lastVsyncSeq: number | null = null;
+
+  constructor(options: IoWriteRingOptions = {}) {
+    this.capacity = options.capacity ?? IoWriteRing.DEFAULT_CAPACITY;
+    this.vsyncCoord = options.vsyncCoord ?? null;
+    const size = Math.min(IoWriteRing.INITIAL_SIZE, this.capacity);
+    this.buffer = new Array(size);
+    this.timestamps = new Array(size);
+    this.jitter = new Float32Array(size);
+  }
+
+  /** Bus handler: append one write, applying the VSYNC trim policy. */
+  readonly handler = (coord: number, value: number, timeNS: number, jitterNS: number): void => {
+    if (coord === this.vsyncCoord && (value & 0x30000) === 0x30000) {
+      if (this.lastVsyncSeq !== null && this.lastVsyncSeq > this.startSeq) {
+        const drop = this.lastVsyncSeq - this.startSeq;
+        this.start = (this.start + drop) % this.buffer.length;
+        this.startSeq = this.lastVsyncSeq;
+      }
+      this.lastVsyncSeq = this.seq;
+    }
+    this.push(coord * 0x40000 + value, timeNS, jitterNS);
+  };
+
+  private push(tagged: number, timeNS: number, jitterNS: number): void {
+    let size = this.buffer.length;
+    if (this.seq - this.startSeq >= size) {
+      if (size < this.capacity) {
+        this.grow(Math.min(size * 2, this.capacity));
+        size = this.buffer.length;
+      } else {
+        // Overwrite oldest entry
+        this.start = (this.start + 1) % size;
+        this.startSeq++;
+      }
+    }
+    const idx = (this.start + (this.seq - this.startSeq)) % size;
+    this.buffer[idx] = tagged;
+    this.timestamps[idx] = timeNS;
+    this.jitter[idx] = jitterNS;
+    this.seq++;
+  }
+
+  /** Re-linearize into larger storage so the ring starts at index 0. */
+  private grow(size: number): void {
+    const count = this.seq - this.startSeq;
+    const old = this.buffer.length;
+    const buffer = new Array(size);
+    const timestamps = new Array(size);
+    const jitter = new Float32Array(size);
+    for (let i = 0; i < count; i++) {
+      const idx = (this.start + i) % old;
+      buffer[i] = this.buffer[idx];
+      timestamps[i] = this.timestamps[idx];
+      jitter[i] = this.jitter[idx];
+    }
+    this.buffer = buffer;
+    this.timestamps = timestamps;
+    this.jitter = jitter;
+    this.start = 0;
+  }
+
+  /** Backing arrays; their length is the current ring size. */
+  get writes(): number[] { return this.buffer; }
+  get writeTimestamps(): number[] { return this.timestamps; }
+  get writeJitter(): Float32Array { return this.jitter; }
+  get startIndex(): number { return this.start; }
+  get count(): number { return this.seq - this.startSeq; }
+  get totalSeq(): number { return this.seq; }
+
+  /** Extract writes since a given sequence number (for delta transfer). */
+  getDelta(sinceSeq: number): IoWriteDelta {
+    const from = Math.max(sinceSeq, this.startSeq);
+    const count = this.seq - from;
+    if (count <= 0) {
+      return { writes: new Uint32Array(0), timestamps: new Float64Array(0), startSeq: from, totalSeq: this.seq };
+    }
+    const writes = new Uint32Array(count);
+    const timestamps = new Float64Array(count);
+    for (let i = 0; i < count; i++) {
+      const idx = (this.start + (from - this.startSeq) + i) % this.buffer.length;
+      writes[i] = this.buffer[idx];
+      timestamps[i] = this.timestamps[idx];
+    }
+    return { writes, timestamps, startSeq: from, totalSeq: this.seq };
+  }
+
+  /** Empty the ring and release storage grown by the previous run. */
+  reset(): void {
+    this.start = 0;
+    this.startSeq = 0;
+    this.seq = 0;
+    this.lastVsyncSeq = null;
+    const size = Math.min(IoWriteRing.INITIAL_SIZE, this.capacity);
+    this.buffer = new Array(size);
+    this.timestamps = new Array(size);
+    this.jitter = new Float32Array(size);
+  }
+}
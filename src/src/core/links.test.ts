@@ -0,0 +1,78 @@
+/**
+ * Tests for the link table: link wiring by port parity, handshake state
+ * of blocked readers and writers, multiport waits and traffic counts.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { GA144_MESH, Mesh } from './mesh';
+import { PORT, PortIndex } from './constants';
+import { LinkTable, NO_LINK } from './links';
+
+describe('LinkTable', () => {
+  it('wires each neighbour pair once, with the same port name at both ends', () => {
+    const links = new LinkTable(GA144_MESH);
+    // 8 rows of 17 east links, 7 rows of 18 north links
+    expect(links.numLinks).toBe(8 * 17 + 7 * 18);
+    const i100 = GA144_MESH.coordToIndex(100);
+    const i101 = GA144_MESH.coordToIndex(101);
+    const i200 = GA144_MESH.coordToIndex(200);
+    expect(links.peer[i100 * 4 + PortIndex.RIGHT]).toBe(i101);
+    expect(links.peer[i101 * 4 + PortIndex.RIGHT]).toBe(i100);
+    expect(links.peer[i100 * 4 + PortIndex.UP]).toBe(i200);
+    expect(links.peer[i100 * 4 + PortIndex.LEFT]).toBe(NO_LINK);
+    expect(links.outChan[i100 * 4 + PortIndex.RIGHT]).toBe(links.inChan[i101 * 4 + PortIndex.RIGHT]);
+    expect(links.inChan[i100 * 4 + PortIndex.RIGHT]).toBe(links.outChan[i101 * 4 + PortIndex.RIGHT]);
+
+    expect(new LinkTable(new Mesh(1, 1)).numLinks).toBe(0);
+  });
+
+  it('records blocked readers, writers and traffic per direction', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    // 101 reads from 100 and from 001 with one multiport read, three times;
+    // 100 sends twice and 001 once
+    const compiled = compileCube(`#include std
+node 100
+/\\
+std.send{port=${PORT.RIGHT}, value=1}
+/\\
+std.send{port=${PORT.RIGHT}, value=2}
+node 001
+/\\
+std.send{port=${PORT.DOWN}, value=3}
+node 101
+/\\
+std.recv{port=0x195, value=a}
+/\\
+std.recv{port=0x195, value=b}
+/\\
+std.recv{port=0x195, value=c}
+/\\
+std.recv{port=0x195, value=d}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    ga.stepProgramN(50_000);
+
+    const links = ga.links;
+    const i101 = ga.mesh.coordToIndex(101);
+    // The fourth read waits on both links
+    for (const port of [PortIndex.RIGHT, PortIndex.DOWN]) {
+      const c = links.inChan[i101 * 4 + port];
+      expect(links.reader[c]).toBe(i101);
+      expect(links.writer[c]).toBe(NO_LINK);
+      expect(links.readNS[c]).toBeGreaterThan(0);
+    }
+    expect(ga.getNodeByIndex(i101).getSnapshot().currentReadingPort).toBe('multi(2)');
+    expect(ga.getLinkTraffic()).toEqual([
+      { from: 100, to: 101, port: PortIndex.RIGHT, words: 2 },
+      { from: 1, to: 101, port: PortIndex.DOWN, words: 1 },
+    ]);
+
+    ga.reset();
+    expect(ga.getLinkTraffic()).toEqual([]);
+    expect(links.reader.every(r => r === NO_LINK)).toBe(true);
+  });
+});
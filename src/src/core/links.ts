@@ -0,0 +1,124 @@
+/**
+ * Link table — handshake state of every inter-node port link on a chip.
+ *
+ * Each physical link joins two neighbouring nodes, and both ends use the
+ * same port name: port names follow row and column parity, so node 100's
+ * RIGHT port meets node 101's RIGHT port. A link carries two channels, one
+ * per direction of data flow, and each channel records the rendezvous in
+ * progress: the node blocked writing (with its value) or the node blocked
+ * reading, the guest time it blocked, and how many words have crossed.
+ *
+ * Everything lives in flat typed arrays indexed by channel (2 * link +
+ * direction), so a handshake reads and writes a few array slots with no
+ * allocation. Per node, `peer`, `inChan` and `outChan` (indexed by
+ * node * 4 + PortIndex) map a port to its neighbour and to the channels
+ * the node reads and writes; -1 means the port has no neighbour.
+ */
+import type { Mesh } from './mesh';
+import { PortIndex } from './types';
+
+/** No node / no channel. */
+export const NO_LINK = -1;
+
+export interface LinkTraffic {
+  /** Writing and reading node coords. */
+  from: number;
+  to: number;
+  /** PortIndex of the link at both ends. */
+  port: PortIndex;
+  words: number;
+}
+
+export class LinkTable {
+  readonly mesh: Mesh;
+  readonly numLinks: number;
+
+  // Per node port (node * 4 + PortIndex)
+  readonly peer: Int32Array;
+  readonly inChan: Int32Array;
+  readonly outChan: Int32Array;
+
+  // Per channel (2 * link + direction)
+  /** Node blocked writing into the channel, or NO_LINK. */
+  readonly writer: Int32Array;
+  /** Value offered by `writer`. */
+  readonly value: Int32Array;
+  /** Node blocked reading from the channel, or NO_LINK. */
+  readonly reader: Int32Array;
+  /** Guest time the writer or reader blocked. */
+  readonly writeNS: Float64Array;
+  readonly readNS: Float64Array;
+  /** Words transferred since reset. */
+  readonly transfers: Float64Array;
+  /** Sending and receiving node index of each channel, and its port. */
+  readonly chanFrom: Int32Array;
+  readonly chanTo: Int32Array;
+  readonly chanPort: Uint8Array;
+
+  constructor(mesh: Mesh) {
+    this.mesh = mesh;
+    const slots = mesh.numNodes * 4;
+    this.peer = new Int32Array(slots).fill(NO_LINK);
+    this.inChan = new Int32Array(slots).fill(NO_LINK);
+    this.outChan = new Int32Array(slots).fill(NO_LINK);
+
+    // Links to the north and east of every node cover each link once
+    const ends: [number, number, PortIndex][] = [];
+    for (let index = 0; index < mesh.numNodes; index++) {
+      const coord = mesh.indexToCoord(index);
+      const x = coord % 100;
+      const y = Math.floor(coord / 100);
+      if (y < mesh.rows - 1) ends.push([index, mesh.coordToIndex(coord + 100), y % 2 === 0 ? PortIndex.DOWN : PortIndex.UP]);
+      if (x < mesh.cols - 1) ends.push([index, mesh.coordToIndex(coord + 1), x % 2 === 0 ? PortIndex.RIGHT : PortIndex.LEFT]);
+    }
+
+    this.numLinks = ends.length;
+    const channels = ends.length * 2;
+    this.writer = new Int32Array(channels);
+    this.value = new Int32Array(channels);
+    this.reader = new Int32Array(channels);
+    this.writeNS = new Float64Array(channels);
+    this.readNS = new Float64Array(channels);
+    this.transfers = new Float64Array(channels);
+    this.chanFrom = new Int32Array(channels);
+    this.chanTo = new Int32Array(channels);
+    this.chanPort = new Uint8Array(channels);
+
+    ends.forEach(([a, b, port], link) => {
+      // Channel 2 * link carries a → b, 2 * link + 1 carries b → a
+      this.peer[a * 4 + port] = b;
+      this.peer[b * 4 + port] = a;
+      this.outChan[a * 4 + port] = this.inChan[b * 4 + port] = 2 * link;
+      this.outChan[b * 4 + port] = this.inChan[a * 4 + port] = 2 * link + 1;
+      this.chanFrom[2 * link] = this.chanTo[2 * link + 1] = a;
+      this.chanTo[2 * link] = this.chanFrom[2 * link + 1] = b;
+      this.chanPort[2 * link] = this.chanPort[2 * link + 1] = port;
+    });
+    this.reset();
+  }
+
+  /** Drop every pending handshake and zero the traffic counters. */
+  reset(): void {
+    this.writer.fill(NO_LINK);
+    this.reader.fill(NO_LINK);
+    this.value.fill(0);
+    this.writeNS.fill(0);
+    this.readNS.fill(0);
+    this.transfers.fill(0);
+  }
+
+  /** Words moved over each channel that carried any, busiest first. */
+  traffic(): LinkTraffic[] {
+    const out: LinkTraffic[] = [];
+    for (let c = 0; c < this.transfers.length; c++) {
+      if (this.transfers[c] === 0) continue;
+      out.push({
+        from: this.mesh.indexToCoord(this.chanFrom[c]),
+        to: this.mesh.indexToCoord(this.chanTo[c]),
+        port: this.chanPort[c] as PortIndex,
+        words: this.transfers[c],
+      });
+    }
+    return out.sort((a, b) => b.words - a.words);
+  }
+}
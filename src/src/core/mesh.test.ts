@@ -0,0 +1,68 @@
+/**
+ * Tests for mesh geometry: coordinate mapping, and chips built on meshes
+ * other than the standard 8x18 layout.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { EMU_PORT, PORT, coordToIndex } from './constants';
+import { Mesh, GA144_MESH } from './mesh';
+
+describe('Mesh', () => {
+  it('maps YXX coordinates row-major', () => {
+    const mesh = new Mesh(32, 32);
+    expect(mesh.numNodes).toBe(1024);
+    expect(mesh.coordToIndex(3131)).toBe(1023);
+    expect(mesh.indexToCoord(33)).toBe(101);
+    expect(mesh.validCoord(3131)).toBe(true);
+    expect(mesh.validCoord(3132)).toBe(false);
+    expect(mesh.validCoord(3200)).toBe(false);
+    expect(mesh.standard).toBe(false);
+    for (const coord of [0, 17, 100, 708, 717]) expect(GA144_MESH.coordToIndex(coord)).toBe(coordToIndex(coord));
+    expect(GA144_MESH.standard).toBe(true);
+
+    expect(Mesh.parse('4x6').toString()).toBe('4x6');
+    expect(() => Mesh.parse('4*6')).toThrow('expected ROWSxCOLS');
+    expect(() => new Mesh(0, 8)).toThrow('1x1 to 100x100');
+    expect(() => new Mesh(8, 101)).toThrow('1x1 to 100x100');
+  });
+
+  it('wires and runs a 32x32 mesh', () => {
+    const ga = new GA144('fabric', new Mesh(32, 32));
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    expect(ga.getSnapshot().nodeCoords).toHaveLength(1024);
+
+    // 3029 → north → 3129 → east → 3130 → east → 3131 → debug port.
+    // Port names follow row and column parity, as on the GA144.
+    const compiled = compileCube(`#include std
+node 3029
+/\\
+std.send{port=${PORT.DOWN}, value=42}
+node 3129
+/\\
+std.recv{port=${PORT.DOWN}, value=x}
+/\\
+std.send{port=${PORT.LEFT}, value=x}
+node 3130
+/\\
+std.recv{port=${PORT.LEFT}, value=x}
+/\\
+std.send{port=${PORT.RIGHT}, value=x}
+node 3131
+/\\
+std.recv{port=${PORT.RIGHT}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    ga.stepProgramN(20_000);
+
+    const log = ga.getDebugLogDelta(0);
+    expect(log.coords).toEqual([3131]);
+    expect(log.values).toEqual([42]);
+    expect(ga.detectStall()).toBeNull();
+  });
+});
@@ -0,0 +1,64 @@
+/**
+ * Mesh geometry — the grid of F18A nodes in a chip model.
+ *
+ * Nodes keep the GA144's YXX coordinates (row * 100 + column) and are
+ * stored row-major, so a mesh is at most 100 nodes on a side. The
+ * standard 8x18 layout is the GA144 itself; other sizes model a
+ * hypothetical fabric of F18A cores for scaling studies. Only the
+ * standard layout has the I/O ring (GPIO pins, analog nodes and boot
+ * nodes) and per-node ROMs: every node of another mesh gets the ROM of an
+ * interior node, whose warm entry waits on all neighbour ports.
+ */
+
+/** Interior GA144 node whose ROM fills every node of a non-standard mesh. */
+const INTERIOR_ROM_COORD = 101;
+
+export class Mesh {
+  readonly rows: number;
+  readonly cols: number;
+  readonly numNodes: number;
+
+  constructor(rows: number, cols: number) {
+    if (!Number.isInteger(rows) || !Number.isInteger(cols) || rows < 1 || cols < 1 || rows > 100 || cols > 100) {
+      throw new Error(`Mesh must be 1x1 to 100x100 nodes, got ${rows}x${cols}`);
+    }
+    this.rows = rows;
+    this.cols = cols;
+    this.numNodes = rows * cols;
+  }
+
+  /** The GA144's own 8x18 layout, with its I/O ring. */
+  get standard(): boolean {
+    return this.rows === 8 && this.cols === 18;
+  }
+
+  coordToIndex(coord: number): number {
+    return Math.floor(coord / 100) * this.cols + (coord % 100);
+  }
+
+  indexToCoord(index: number): number {
+    return Math.floor(index / this.cols) * 100 + (index % this.cols);
+  }
+
+  validCoord(coord: number): boolean {
+    return Number.isInteger(coord) && coord >= 0 && coord % 100 < this.cols && Math.floor(coord / 100) < this.rows;
+  }
+
+  /** Node whose ROM image a node loads at reset. */
+  romCoord(coord: number): number {
+    return this.standard ? coord : INTERIOR_ROM_COORD;
+  }
+
+  toString(): string {
+    return `${this.rows}x${this.cols}`;
+  }
+
+  /** Parse `ROWSxCOLS`, e.g. `32x32`. */
+  static parse(text: string): Mesh {
+    const m = /^(\d+)x(\d+)$/i.exec(text.trim());
+    if (!m) throw new Error(`expected ROWSxCOLS, got '${text}'`);
+    return new Mesh(Number(m[1]), Number(m[2]));
+  }
+}
+
+export const GA144_MESH = new Mesh(8, 18);
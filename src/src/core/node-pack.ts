@@ -0,0 +1,107 @@
+/**
+ * Packed node state — a NodeSnapshot flattened into typed arrays.
+ *
+ * Node states travel as one-byte codes, and a node's registers, stacks and
+ * memory as a fixed Int32 block with its counters and thermal state in a
+ * small Float64 block. The worker ships these inside a single transferable
+ * buffer (see worker/snapshotCodec.ts); `unpackNode` rebuilds the
+ * NodeSnapshot the UI panels consume.
+ */
+import { NodeState } from './types';
+import type { NodeSnapshot } from './types';
+
+/** NodeState by code; a state's code is its index. */
+export const NODE_STATE_CODES: readonly NodeState[] = [
+  NodeState.RUNNING,
+  NodeState.BLOCKED_READ,
+  NodeState.BLOCKED_WRITE,
+  NodeState.SUSPENDED,
+];
+
+export function nodeStateCode(state: NodeState): number {
+  switch (state) {
+    case NodeState.RUNNING: return 0;
+    case NodeState.BLOCKED_READ: return 1;
+    case NodeState.BLOCKED_WRITE: return 2;
+    case NodeState.SUSPENDED: return 3;
+  }
+}
+
+/** Offsets into the Int32 block. Stacks are listed top first, as in
+ *  NodeSnapshot: T, S and the 8 deep data stack; R and the 8 deep return stack. */
+export const NODE_INTS = {
+  STATE: 0,
+  P: 1,
+  I: 2,
+  A: 3,
+  B: 4,
+  T: 5,
+  S: 6,
+  R: 7,
+  IO: 8,
+  SLOT: 9,
+  READ_PORTS: 10,   // PortIndex bitmask of a pending read
+  READ_MULTI: 11,   // 1 when the pending read is a multiport read
+  WRITE_PORT: 12,   // PortIndex of a pending write, or -1
+  DSTACK: 13,
+  RSTACK: 23,
+  RAM: 32,
+  ROM: 96,
+  LENGTH: 160,
+} as const;
+
+export const DSTACK_DEPTH = NODE_INTS.RSTACK - NODE_INTS.DSTACK;
+export const RSTACK_DEPTH = NODE_INTS.RAM - NODE_INTS.RSTACK;
+
+/** Offsets into the Float64 block. */
+export const NODE_FLOATS = {
+  STEPS: 0,
+  TEMPERATURE: 1,
+  ENERGY: 2,
+  SIM_TIME: 3,
+  JITTERED_TIME: 4,
+  LENGTH: 5,
+} as const;
+
+const PORT_LETTERS = ['L', 'U', 'D', 'R'];
+
+/** Rebuild a NodeSnapshot from its packed blocks. */
+export function unpackNode(coord: number, index: number, ints: Int32Array, floats: Float64Array): NodeSnapshot {
+  const readPorts = ints[NODE_INTS.READ_PORTS];
+  const writePort = ints[NODE_INTS.WRITE_PORT];
+  let readCount = 0;
+  for (let m = readPorts; m !== 0; m &= m - 1) readCount++;
+  return {
+    coord,
+    index,
+    state: NODE_STATE_CODES[ints[NODE_INTS.STATE]],
+    registers: {
+      P: ints[NODE_INTS.P],
+      I: ints[NODE_INTS.I],
+      A: ints[NODE_INTS.A],
+      B: ints[NODE_INTS.B],
+      T: ints[NODE_INTS.T],
+      S: ints[NODE_INTS.S],
+      R: ints[NODE_INTS.R],
+      IO: ints[NODE_INTS.IO],
+    },
+    dstack: Array.from(ints.subarray(NODE_INTS.DSTACK, NODE_INTS.RSTACK)),
+    rstack: Array.from(ints.subarray(NODE_INTS.RSTACK, NODE_INTS.RAM)),
+    ram: Array.from(ints.subarray(NODE_INTS.RAM, NODE_INTS.ROM)),
+    rom: Array.from(ints.subarray(NODE_INTS.ROM, NODE_INTS.LENGTH)),
+    slotIndex: ints[NODE_INTS.SLOT],
+    stepCount: floats[NODE_FLOATS.STEPS],
+    thermal: {
+      temperature: floats[NODE_FLOATS.TEMPERATURE],
+      totalEnergy: floats[NODE_FLOATS.ENERGY],
+      simulatedTime: floats[NODE_FLOATS.SIM_TIME],
+      lastJitteredTime: floats[NODE_FLOATS.JITTERED_TIME],
+    },
+    currentReadingPort: readPorts !== 0
+      ? (ints[NODE_INTS.READ_MULTI] !== 0
+        ? `multi(${readCount})`
+        : PORT_LETTERS[31 - Math.clz32(readPorts)])
+      : null,
+    currentWritingPort: writePort >= 0 ? PORT_LETTERS[writePort] : null,
+  };
+}
@@ -0,0 +1,47 @@
+/**
+ * Tests for pcap capture file writing and reading.
+ */
+import { describe, it, expect } from 'vitest';
+import { PcapWriter, parsePcap } from './pcap';
+
+function concat(chunks: Uint8Array[]): Uint8Array {
+  const out = new Uint8Array(chunks.reduce((n, c) => n + c.length, 0));
+  let off = 0;
+  for (const c of chunks) {
+    out.set(c, off);
+    off += c.length;
+  }
+  return out;
+}
+
+describe('pcap', () => {
+  it('round-trips packets with nanosecond times', () => {
+    const chunks: Uint8Array[] = [];
+    const writer = new PcapWriter(b => chunks.push(b));
+    writer.write(1_500_000_123, new Uint8Array([1, 2, 3]));
+    writer.write(2_000_000_000, new Uint8Array(60).fill(0xAA));
+
+    const packets = parsePcap(concat(chunks));
+    expect(packets.map(p => p.timeNS)).toEqual([1_500_000_123, 2_000_000_000]);
+    expect(Array.from(packets[0].data)).toEqual([1, 2, 3]);
+    expect(packets[1].data).toHaveLength(60);
+  });
+
+  it('reads big-endian microsecond captures and rejects other link types', () => {
+    const header = new Uint8Array(24);
+    const view = new DataView(header.buffer);
+    view.setUint32(0, 0xA1B2C3D4);
+    view.setUint32(20, 1);
+    const record = new Uint8Array(18);
+    const rv = new DataView(record.buffer);
+    rv.setUint32(0, 3);
+    rv.setUint32(4, 250);
+    rv.setUint32(8, 2);
+    rv.setUint32(12, 2);
+    record.set([0xDE, 0xAD], 16);
+
+    expect(parsePcap(concat([header, record]))).toEqual([{ timeNS: 3_000_250_000, data: new Uint8Array([0xDE, 0xAD]) }]);
+    view.setUint32(20, 105);
+    expect(() => parsePcap(header)).toThrow('not Ethernet');
+  });
+});
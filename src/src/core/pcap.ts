@@ -0,0 +1,73 @@
+/**
+ * libpcap capture files (Ethernet link type) — a streaming writer and a
+ * reader for microsecond and nanosecond captures in either byte order.
+ *
+ * Times are guest nanoseconds. The writer produces nanosecond-resolution
+ * files so edge-level timing from the emulator is kept.
+ */
+
+export interface PcapPacket {
+  timeNS: number;
+  data: Uint8Array;
+}
+
+const MAGIC_US = 0xA1B2C3D4;
+const MAGIC_NS = 0xA1B23C4D;
+const LINKTYPE_ETHERNET = 1;
+
+export class PcapWriter {
+  private readonly sink: (bytes: Uint8Array) => void;
+
+  /** Writes the file header at once. */
+  constructor(sink: (bytes: Uint8Array) => void, snapLen = 65535) {
+    this.sink = sink;
+    const header = new Uint8Array(24);
+    const view = new DataView(header.buffer);
+    view.setUint32(0, MAGIC_NS, true);
+    view.setUint16(4, 2, true);
+    view.setUint16(6, 4, true);
+    view.setUint32(16, snapLen, true);
+    view.setUint32(20, LINKTYPE_ETHERNET, true);
+    sink(header);
+  }
+
+  write(timeNS: number, data: Uint8Array): void {
+    const record = new Uint8Array(16 + data.length);
+    const view = new DataView(record.buffer);
+    const t = Math.max(0, Math.round(timeNS));
+    view.setUint32(0, Math.floor(t / 1e9), true);
+    view.setUint32(4, t % 1e9, true);
+    view.setUint32(8, data.length, true);
+    view.setUint32(12, data.length, true);
+    record.set(data, 16);
+    this.sink(record);
+  }
+}
+
+/** Parse a pcap file. Only Ethernet captures are accepted. */
+export function parsePcap(bytes: Uint8Array): PcapPacket[] {
+  if (bytes.length < 24) throw new Error('pcap: file too short');
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  let little = true;
+  let magic = view.getUint32(0, true);
+  if (magic !== MAGIC_US && magic !== MAGIC_NS) {
+    little = false;
+    magic = view.getUint32(0, false);
+    if (magic !== MAGIC_US && magic !== MAGIC_NS) throw new Error('pcap: bad magic (pcapng is not supported)');
+  }
+  const fracNS = magic === MAGIC_NS ? 1 : 1000;
+  const linkType = view.getUint32(20, little);
+  if (linkType !== LINKTYPE_ETHERNET) throw new Error(`pcap: link type ${linkType} is not Ethernet`);
+
+  const packets: PcapPacket[] = [];
+  let off = 24;
+  while (off + 16 <= bytes.length) {
+    const sec = view.getUint32(off, little);
+    const frac = view.getUint32(off + 4, little);
+    const capLen = view.getUint32(off + 8, little);
+    if (off + 16 + capLen > bytes.length) throw new Error('pcap: truncated record');
+    packets.push({ timeNS: sec * 1e9 + frac * fracNS, data: bytes.slice(off + 16, off + 16 + capLen) });
+    off += 16 + capLen;
+  }
+  return packets;
+}
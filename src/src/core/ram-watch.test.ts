@@ -0,0 +1,87 @@
+/**
+ * Tests for RAM watches and the compiler's watch symbol list.
+ */
+import { describe, it, expect } from 'vitest';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { RamWatch } from './ram-watch';
+
+// Adds into x three times, then halts
+const SOURCE = `#include std
+node 404
+/\\
+std.loop{n=3}
+/\\ std.plus{a=1, b=2, c=x}
+/\\ std.again{}
+`;
+
+function setup() {
+  const compiled = compileCube(SOURCE);
+  expect(compiled.errors).toHaveLength(0);
+  const ga = new GA144('test');
+  ga.setRomData(ROM_DATA);
+  ga.reset();
+  ga.load(compiled);
+  return { ga, compiled };
+}
+
+describe('watch symbols', () => {
+  it('lists RAM variables per node', () => {
+    const { compiled } = setup();
+    const x = compiled.watchSymbols!.find(s => s.name === 'x');
+    expect(x).toEqual({ coord: 404, name: 'x', addr: 0x3F, kind: 'var' });
+  });
+
+  it('names constructor fields after their constructor', () => {
+    const result = compileCube('Pair = Lambda{}. pair{fst: Int, snd: Int}\n/\\\npair{fst=1, snd=2}');
+    expect(result.errors).toHaveLength(0);
+    const fields = result.watchSymbols!.filter(s => s.kind === 'field');
+    expect(fields.map(f => [f.name, f.addr])).toEqual([['pair.fst', 0x20], ['pair.snd', 0x21]]);
+  });
+});
+
+describe('RamWatch', () => {
+  it('logs every guest write to a watched word in write mode', () => {
+    const { ga } = setup();
+    const watch = new RamWatch([{ coord: 404, addr: 0x3F }, { coord: 404, addr: 0x3E }], 'write');
+    ga.setRamWatch(watch);
+    ga.stepProgramN(5000);
+    const delta = watch.drain();
+    expect(Array.from(delta.indices)).toEqual([0, 0, 0]);
+    expect(Array.from(delta.values)).toEqual([3, 3, 3]);
+    expect(delta.timestamps[1]).toBeGreaterThan(delta.timestamps[0]);
+    expect(watch.drain().indices).toHaveLength(0);
+
+    // Hooks survive reset until removed
+    ga.reset();
+    ga.setRamWatch(null);
+    expect(ga.getNodeByCoord(404).ramWatch).toBeNull();
+  });
+
+  it('logs only changed words when sampled', () => {
+    const { ga } = setup();
+    const watch = new RamWatch([{ coord: 404, addr: 0x3F }, { coord: 404, addr: 0x00 }], 'sample');
+    ga.setRamWatch(watch);
+    expect(ga.getNodeByCoord(404).ramWatch).toBeNull();
+    watch.sample(ga);
+    expect(watch.drain().indices).toHaveLength(2);
+    ga.stepProgramN(5000);
+    watch.sample(ga);
+    const delta = watch.drain();
+    expect(Array.from(delta.indices)).toEqual([0]);
+    expect(delta.values[0]).toBe(3);
+    watch.sample(ga);
+    expect(watch.drain().indices).toHaveLength(0);
+    watch.sample(ga, true);
+    expect(watch.drain().indices).toHaveLength(2);
+  });
+
+  it('keeps the newest entries when the log overflows', () => {
+    const watch = new RamWatch([{ coord: 0, addr: 0 }], 'write', 4);
+    for (let i = 0; i < 6; i++) watch.push(0, i, i);
+    const delta = watch.drain();
+    expect(Array.from(delta.values)).toEqual([2, 3, 4, 5]);
+    expect(delta.dropped).toBe(2);
+  });
+});
@@ -0,0 +1,137 @@
+/**
+ * RAM watches for the debugger's watch panel.
+ *
+ * A RamWatch names a handful of RAM words across the chip and logs their
+ * values into a ring of typed arrays, as the debug log does. How values
+ * reach the log depends on the mode:
+ *
+ * - 'write': each watched node carries a NodeRamWatch. F18ANode calls it,
+ *   behind a null check, on every store to RAM, so the log records every
+ *   guest write to a watched word with its node-local time.
+ * - 'sample': nothing is installed on the nodes. The owner calls sample()
+ *   at its chosen rate, and only words that changed since the last sample
+ *   are logged.
+ *
+ * Either way, observing a few values costs a few words per update instead
+ * of full node snapshots.
+ */
+import type { GA144 } from './ga144';
+
+export type WatchMode = 'sample' | 'write';
+
+/** A watched RAM word (addr 0x00–0x3F). */
+export interface WatchTarget {
+  coord: number;
+  addr: number;
+}
+
+/** Watch log entries since the last drain, oldest first. `dropped` counts
+ *  entries overwritten before they were drained. */
+export interface WatchDelta {
+  indices: Uint16Array;
+  values: Uint32Array;
+  timestamps: Float64Array;
+  dropped: number;
+}
+
+const RAM_WORDS = 0x40;
+
+/** Per-node hook: maps RAM words to watch target indices. */
+export class NodeRamWatch {
+  /** Target index per RAM word, -1 when unwatched. */
+  readonly slots = new Int16Array(RAM_WORDS).fill(-1);
+  private readonly watch: RamWatch;
+
+  constructor(watch: RamWatch) {
+    this.watch = watch;
+  }
+
+  /** Called by F18ANode after a store to RAM word `index`. */
+  written(index: number, value: number, timeNS: number): void {
+    const target = this.slots[index];
+    if (target >= 0) this.watch.push(target, value, timeNS);
+  }
+}
+
+export class RamWatch {
+  static readonly DEFAULT_CAPACITY = 4096;
+
+  readonly targets: readonly WatchTarget[];
+  readonly mode: WatchMode;
+  readonly capacity: number;
+  /** Hooks to install per node coordinate ('write' mode only). */
+  readonly nodeWatches = new Map<number, NodeRamWatch>();
+
+  private readonly indices: Uint16Array;
+  private readonly values: Uint32Array;
+  private readonly timestamps: Float64Array;
+  private readonly lastSampled: Int32Array;
+  private start = 0;
+  private count = 0;
+  private dropped = 0;
+
+  constructor(targets: readonly WatchTarget[], mode: WatchMode, capacity: number = RamWatch.DEFAULT_CAPACITY) {
+    this.targets = targets;
+    this.mode = mode;
+    this.capacity = capacity;
+    this.indices = new Uint16Array(capacity);
+    this.values = new Uint32Array(capacity);
+    this.timestamps = new Float64Array(capacity);
+    this.lastSampled = new Int32Array(targets.length).fill(-1);
+    if (mode === 'write') {
+      targets.forEach((t, i) => {
+        let hook = this.nodeWatches.get(t.coord);
+        if (!hook) this.nodeWatches.set(t.coord, hook = new NodeRamWatch(this));
+        hook.slots[t.addr & (RAM_WORDS - 1)] = i;
+      });
+    }
+  }
+
+  /** Log a value for target `index`, overwriting the oldest entry when full. */
+  push(index: number, value: number, timeNS: number): void {
+    if (this.count === this.capacity) {
+      this.start = (this.start + 1) % this.capacity;
+      this.count--;
+      this.dropped++;
+    }
+    const slot = (this.start + this.count) % this.capacity;
+    this.indices[slot] = index;
+    this.values[slot] = value;
+    this.timestamps[slot] = timeNS;
+    this.count++;
+  }
+
+  /** Read every target from the chip and log those that changed since the
+   *  last sample, or all of them when `force` is set (after a reset or a
+   *  new watch list, so the panel starts from the current values). */
+  sample(chip: GA144, force = false): void {
+    const timeNS = chip.getGuestTimeNS();
+    this.targets.forEach((t, i) => {
+      const value = chip.getNodeByCoord(t.coord).peekRAM(t.addr);
+      if (!force && value === this.lastSampled[i]) return;
+      this.lastSampled[i] = value;
+      this.push(i, value, timeNS);
+    });
+  }
+
+  /** Take everything logged since the last drain. */
+  drain(): WatchDelta {
+    const n = this.count;
+    const delta: WatchDelta = {
+      indices: new Uint16Array(n),
+      values: new Uint32Array(n),
+      timestamps: new Float64Array(n),
+      dropped: this.dropped,
+    };
+    for (let i = 0; i < n; i++) {
+      const slot = (this.start + i) % this.capacity;
+      delta.indices[i] = this.indices[slot];
+      delta.values[i] = this.values[slot];
+      delta.timestamps[i] = this.timestamps[slot];
+    }
+    this.start = 0;
+    this.count = 0;
+    this.dropped = 0;
+    return delta;
+  }
+}
@@ -5,7 +5,7 @@
 
 import { describe, it, expect } from 'vitest';
 import { GA144 } from './ga144';
-import { SerialBits, type SerialBit } from './serial';
+import { SerialBits, SerialDecoder, type SerialBit } from './serial';
 import { compileCube } from './cube';
 
 // Test baud rates expressed in Hz. These are chosen to give round nanosecond values.
@@ -113,3 +113,34 @@ describe('SerialBits.decodeBits', () => {
     expect(SerialBits.decodeBits(idleOnly, BAUD_150NS)).toEqual([]);
   });
 });
+
+describe('SerialDecoder', () => {
+  /** Feed `bits` as level changes; returns the bytes and their times. */
+  function decodeLive(bits: SerialBit[], baud: number) {
+    const out: { byte: number; timeNS: number }[] = [];
+    const decoder = new SerialDecoder(baud, (byte, timeNS) => out.push({ byte, timeNS }));
+    let t = 0;
+    for (const b of bits) {
+      decoder.write(b.value, t);
+      t += b.durationNS;
+    }
+    return { out, decoder, endNS: t };
+  }
+
+  it('matches decodeBits and emits each byte at its last data bit', () => {
+    const input = Array.from({ length: 256 }, (_, i) => i);
+    const bits = SerialBits.buildBits(input, BAUD_150NS, BAUD_150NS_IDLE_300NS);
+    const { out, decoder, endNS } = decodeLive(bits, BAUD_150NS);
+    decoder.advance(endNS);
+    expect(out.map(o => o.byte)).toEqual(input);
+    expect(out[0].timeNS).toBe(300 + 8.5 * 150);
+  });
+
+  it('holds a byte whose stop bit has no edge until time moves on', () => {
+    const bits = SerialBits.buildBits([0x80], BAUD_150NS);
+    const { out, decoder } = decodeLive(bits, BAUD_150NS);
+    expect(out).toHaveLength(0);
+    decoder.advance(10 * 150);
+    expect(out.map(o => o.byte)).toEqual([0x80]);
+  });
+});
@@ -113,3 +113,49 @@ export class SerialBits {
     return bytes;
   }
 }
+
+/**
+ * Incremental counterpart of SerialBits.decodeBits for live output: feed
+ * line levels as they change, in time order, and bytes come out as soon
+ * as their last data bit has been sampled. Same polarity and framing as
+ * decodeBits (idle LOW, start HIGH, inverted data, LSB first).
+ */
+export class SerialDecoder {
+  private readonly bitNS: number;
+  private readonly onByte: (byte: number, timeNS: number) => void;
+  private level = false;
+  private frameStart: number | null = null;
+  private bit = 0;
+  private byte = 0;
+
+  constructor(baud: number, onByte: (byte: number, timeNS: number) => void) {
+    this.bitNS = 1e9 / baud;
+    this.onByte = onByte;
+  }
+
+  /** The line changes to `level` at `timeNS`. */
+  write(level: boolean, timeNS: number): void {
+    this.advance(timeNS);
+    this.level = level;
+    if (level && this.frameStart === null) this.frameStart = timeNS;
+  }
+
+  /** Sample everything before `timeNS` at the current level. */
+  advance(timeNS: number): void {
+    while (this.frameStart !== null) {
+      if (this.bit < 8) {
+        const centre = this.frameStart + (1.5 + this.bit) * this.bitNS;
+        if (centre >= timeNS) return;
+        if (!this.level) this.byte |= 1 << this.bit;
+        if (++this.bit === 8) this.onByte(this.byte, centre);
+      } else {
+        // Past the stop bit: a line still HIGH starts the next frame at once
+        const end = this.frameStart + 10 * this.bitNS;
+        if (end >= timeNS) return;
+        this.frameStart = this.level ? end : null;
+        this.bit = 0;
+        this.byte = 0;
+      }
+    }
+  }
+}
@@ -34,6 +34,13 @@ export class CircularStack {
     return result;
   }
 
+  /** Write values top to bottom into `out` starting at `offset`. */
+  copyTo(out: Int32Array, offset: number): void {
+    for (let i = 0; i < this.size; i++) {
+      out[offset + i] = this.body[(this.sp - i + this.size * 2) % this.size];
+    }
+  }
+
   reset(init: number = 0): void {
     this.sp = 0;
     this.body.fill(init);
@@ -20,6 +20,11 @@ export const PortIndex = {
 } as const;
 export type PortIndex = typeof PortIndex[keyof typeof PortIndex];
 
+/** What a read of EMU_PORT.CLOCK returns; 'off' leaves the port unmapped.
+ *  'ns' is the node's simulated time in whole nanoseconds, 'steps' its
+ *  executed instruction count. Both wrap at 18 bits. */
+export type ClockCounterMode = 'off' | 'ns' | 'steps';
+
 export interface F18ARegisters {
   P: number;
   I: Word18;
@@ -55,8 +60,8 @@ export interface NodeSnapshot {
 }
 
 export interface GA144Snapshot {
-  nodeStates: NodeState[];   // 144 entries
-  nodeCoords: number[];      // 144 entries
+  nodeStates: NodeState[];   // one per node (144 on the standard mesh)
+  nodeCoords: number[];      // one per node, in index order
   activeCount: number;
   totalSteps: number;
   selectedNode: NodeSnapshot | null;
@@ -0,0 +1,96 @@
+/**
+ * GA144 waveform probe — records pin, DAC and port handshake activity of
+ * selected nodes into a VcdWriter.
+ *
+ * Per node (scope `node_YXX`):
+ *   pin17, pin1, pin3, pin5  drive state of each GPIO pin the node has
+ *                            (00 → z, 01 weak pulldown → 0, 10 → 0, 11 → 1)
+ *   dac[8:0]                 DAC output of analog nodes (XOR encoding removed)
+ *   port_rd[3:0], port_wr[3:0]  ports the node is blocked reading/writing,
+ *                            bits R D L U as in the io register
+ *   pin_wait                 blocked on the wake pin
+ *
+ * Pin and DAC values come from the IO bus; handshakes from
+ * GA144.tracePortWaits, so untraced nodes cost nothing.
+ */
+import type { GA144 } from './ga144';
+import { NODE_GPIO_PINS, ANALOG_NODES } from './constants';
+import { PortIndex } from './types';
+import { VcdWriter } from './vcd';
+import type { VcdValue } from './vcd';
+
+const DAC_XOR = 0x155;
+
+/** Pin name and the shift of its 2-bit control field, in pin-count order. */
+const PINS: [string, number][] = [['pin17', 16], ['pin1', 0], ['pin3', 2], ['pin5', 4]];
+
+const PIN_LEVEL: VcdValue[] = ['z', 0, 0, 1];
+
+/** io register order: R D L U, high to low. */
+function ioOrderMask(mask: number): number {
+  return ((mask >> PortIndex.RIGHT) & 1) << 3 | ((mask >> PortIndex.DOWN) & 1) << 2
+    | ((mask >> PortIndex.LEFT) & 1) << 1 | ((mask >> PortIndex.UP) & 1);
+}
+
+interface NodeVars {
+  pins: { handle: number; shift: number }[];
+  dac: number;  // -1 when not analog
+  rd: number;
+  wr: number;
+  pinWait: number;
+}
+
+export class VcdProbe {
+  readonly writer: VcdWriter;
+  private readonly vars = new Map<number, NodeVars>();
+  private unsubscribers: (() => void)[] = [];
+
+  /** Probe `coords` on `ga`; changes go to `writer`, which must not have begun. */
+  constructor(ga: GA144, writer: VcdWriter, coords: readonly number[]) {
+    this.writer = writer;
+    const initial: VcdValue[] = [];
+    const ioRing = ga.mesh.standard;
+    for (const coord of coords) {
+      const scope = ['ga144', `node_${coord.toString().padStart(3, '0')}`];
+      const pins = PINS.slice(0, ioRing ? NODE_GPIO_PINS[coord] ?? 0 : 0).map(([name, shift]) => {
+        initial.push(0);  // io reset value: weak pulldown
+        return { handle: writer.addVar(scope, name, 1), shift };
+      });
+      let dac = -1;
+      if (ioRing && ANALOG_NODES.includes(coord)) {
+        dac = writer.addVar(scope, 'dac', 9);
+        initial.push('x');
+      }
+      const rd = writer.addVar(scope, 'port_rd', 4);
+      const wr = writer.addVar(scope, 'port_wr', 4);
+      const pinWait = writer.addVar(scope, 'pin_wait', 1);
+      initial.push(0, 0, 0);
+      this.vars.set(coord, { pins, dac, rd, wr, pinWait });
+    }
+    writer.begin(initial);
+
+    this.unsubscribers.push(ga.ioBus.subscribe({ coords }, (coord, value, timeNS) => {
+      const v = this.vars.get(coord)!;
+      for (const pin of v.pins) writer.change(pin.handle, timeNS, PIN_LEVEL[(value >> pin.shift) & 3]);
+      if (v.dac >= 0) writer.change(v.dac, timeNS, (value & 0x1FF) ^ DAC_XOR);
+    }));
+    this.unsubscribers.push(ga.tracePortWaits(coords, (coord, readMask, writeMask, pinWait, timeNS) => {
+      const v = this.vars.get(coord)!;
+      writer.change(v.rd, timeNS, ioOrderMask(readMask));
+      writer.change(v.wr, timeNS, ioOrderMask(writeMask));
+      writer.change(v.pinWait, timeNS, pinWait ? 1 : 0);
+    }));
+  }
+
+  /** Write out changes that are outside the reorder window. */
+  flush(): void {
+    this.writer.flush();
+  }
+
+  /** Detach from the chip and write everything, ending the dump at `endNS`. */
+  close(endNS?: number): void {
+    for (const unsubscribe of this.unsubscribers) unsubscribe();
+    this.unsubscribers = [];
+    this.writer.close(endNS);
+  }
+}
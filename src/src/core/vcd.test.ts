@@ -0,0 +1,160 @@
+/**
+ * Tests for the VCD writer/reader and the GA144 waveform probe.
+ */
+import { describe, it, expect } from 'vitest';
+import { VcdWriter, parseVcd, findVcdSignal, vcdToPinBits } from './vcd';
+import { VcdProbe } from './vcd-probe';
+import { GA144 } from './ga144';
+import { ROM_DATA } from './rom-data';
+import { compileCube } from './cube';
+import { coordToIndex } from './constants';
+import type { ThermalState } from './thermal';
+
+function capture(build: (w: VcdWriter) => void, reorderWindowNS = 100): string {
+  const chunks: string[] = [];
+  const w = new VcdWriter(text => chunks.push(text), { reorderWindowNS });
+  build(w);
+  return chunks.join('');
+}
+
+describe('VcdWriter', () => {
+  it('round-trips scalar and vector changes through parseVcd', () => {
+    const text = capture(w => {
+      const pin = w.addVar(['ga144', 'node_708'], 'pin17', 1);
+      const dac = w.addVar(['ga144', 'node_117'], 'dac', 9);
+      w.begin([0, 'x']);
+      w.change(pin, 10, 1);
+      w.change(dac, 10.5, 0x1FF);
+      w.change(pin, 20, 'z');
+      w.close(30);
+    });
+    expect(text).toContain('$timescale 1ps $end');
+    expect(text).toContain('$var wire 9 " dac [8:0] $end');
+
+    const signals = parseVcd(text);
+    const pin = findVcdSignal(signals, 'ga144.node_708.pin17');
+    expect(pin.changes).toEqual([
+      { timeNS: 0, value: '0' }, { timeNS: 10, value: '1' }, { timeNS: 20, value: 'z' },
+    ]);
+    expect(findVcdSignal(signals, 'dac').changes.map(c => c.value)).toEqual(['x', '111111111']);
+  });
+
+  it('sorts changes inside the reorder window and clamps later stragglers', () => {
+    const text = capture(w => {
+      const a = w.addVar(['t'], 'a', 1);
+      const b = w.addVar(['t'], 'b', 1);
+      w.begin([0, 0]);
+      w.change(a, 50, 1);
+      w.change(b, 40, 1);
+      w.change(a, 300, 0);
+      w.flush();          // writes #40 and #50, keeps #300 (inside the window)
+      w.change(b, 45, 0);  // behind written time: clamped to 50 ns
+      w.close();
+    });
+    const body = text.slice(text.indexOf('$end\n', text.indexOf('$dumpvars')) + 5);
+    expect(body.trim().split('\n')).toEqual(['#40000', '1"', '#50000', '1!', '0"', '#300000', '0!']);
+  });
+
+  it('drops changes that repeat the current value', () => {
+    const text = capture(w => {
+      const a = w.addVar(['t'], 'a', 1);
+      w.begin([1]);
+      w.change(a, 5, 1);
+      w.close();
+    });
+    expect(text).not.toContain('#5000');
+  });
+});
+
+describe('parseVcd', () => {
+  it('reads dumps from other tools', () => {
+    const text = `$date today $end
+$comment logic analyser capture $end
+$timescale 10 ns $end
+$scope module top $end
+$var wire 1 ! sda $end
+$var wire 1 " scl $end
+$var reg 8 # data [7:0] $end
+$upscope $end
+$enddefinitions $end
+$dumpvars
+1!
+1"
+bx #
+$end
+#3
+0!
+#5
+0" b1010 #
+`;
+    const signals = parseVcd(text);
+    expect(signals.map(s => s.name)).toEqual(['sda', 'scl', 'data']);
+    expect(findVcdSignal(signals, 'sda').changes).toEqual([{ timeNS: 0, value: '1' }, { timeNS: 30, value: '0' }]);
+    expect(findVcdSignal(signals, 'top.data').changes[1]).toEqual({ timeNS: 50, value: '1010' });
+    expect(() => findVcdSignal(signals, 'sck')).toThrow(/no signal/);
+  });
+});
+
+describe('vcdToPinBits', () => {
+  it('converts changes into held levels starting at the first change', () => {
+    const [sig] = parseVcd(`$timescale 1ns $end $var wire 1 ! p $end $enddefinitions $end
+#100 0! #200 1! #250 1! #400 z! #500 0!`);
+    expect(vcdToPinBits(sig)).toEqual({
+      startNS: 100,
+      bits: [
+        { value: false, durationNS: 100 },
+        { value: true, durationNS: 200 },
+        { value: false, durationNS: 100 },
+      ],
+    });
+    expect(vcdToPinBits(sig, true).bits.map(b => b.value)).toEqual([false, true, false]);
+  });
+});
+
+describe('VcdProbe', () => {
+  function makeGa(): GA144 {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    ga.reset();
+    return ga;
+  }
+
+  it('records pin drive states and DAC values from IO writes', () => {
+    const ga = makeGa();
+    const chunks: string[] = [];
+    const probe = new VcdProbe(ga, new VcdWriter(t => chunks.push(t)), [217, 117]);
+    ga.onIoWrite(coordToIndex(217), 0x30000, { simulatedTime: 100 } as ThermalState);
+    ga.onIoWrite(coordToIndex(217), 0x00000, { simulatedTime: 200 } as ThermalState);
+    ga.onIoWrite(coordToIndex(117), 0x1FF ^ 0x155, { simulatedTime: 150 } as ThermalState);
+    probe.close(300);
+
+    const signals = parseVcd(chunks.join(''));
+    expect(findVcdSignal(signals, 'ga144.node_217.pin17').changes.map(c => [c.timeNS, c.value]))
+      .toEqual([[0, '0'], [100, '1'], [200, 'z']]);
+    expect(findVcdSignal(signals, 'ga144.node_117.dac').changes.at(-1)).toEqual({ timeNS: 150, value: '111111111' });
+  });
+
+  it('records blocked port reads as handshake signals', () => {
+    // 404 and 405 both read their shared port (R on both sides) and stay blocked
+    const compiled = compileCube(`#include std
+node 404
+/\\
+std.recv{port=0x1D5, value=x}
+/\\
+node 405
+/\\
+std.recv{port=0x1D5, value=y}
+`);
+    const ga = makeGa();
+    const chunks: string[] = [];
+    const probe = new VcdProbe(ga, new VcdWriter(t => chunks.push(t)), [404, 405]);
+    ga.load(compiled);
+    ga.stepProgramN(5000);
+    probe.close();
+
+    const signals = parseVcd(chunks.join(''));
+    expect(findVcdSignal(signals, 'ga144.node_404.port_rd').changes.at(-1)!.value).toBe('1000');
+    expect(findVcdSignal(signals, 'ga144.node_405.port_rd').changes.at(-1)!.value).toBe('1000');
+    expect(findVcdSignal(signals, 'ga144.node_404.port_wr').changes.at(-1)!.value).toBe('0');
+  });
+});
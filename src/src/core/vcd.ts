@@ -0,0 +1,291 @@
+/**
+ * Value Change Dump (IEEE 1364 §18) writer and reader.
+ *
+ * The writer streams text to a sink as the run goes, so dumps of any
+ * length need only bounded memory. Changes may arrive slightly out of time
+ * order (nodes run ahead of each other between port handshakes), so they
+ * are held in a reorder window and written sorted; anything that still
+ * arrives behind already-written time is clamped forward. Times are guest
+ * nanoseconds, written with a 1 ps timescale.
+ *
+ * The reader parses scalar and vector changes from any conforming dump
+ * into per-signal change lists in nanoseconds.
+ */
+import type { SerialBit } from './serial';
+
+/** A scalar or vector value: a number, or 'x'/'z' for unknown/floating. */
+export type VcdValue = number | 'x' | 'z';
+
+export interface VcdWriterOptions {
+  /** Changes newer than (latest change − window) stay buffered (ns). */
+  reorderWindowNS?: number;
+  /** Buffered changes that force a flush regardless of the window. */
+  maxPending?: number;
+}
+
+interface VcdVarDef {
+  scope: string[];
+  name: string;
+  width: number;
+  id: string;
+}
+
+/** Short printable identifier code for variable n ('!'..'~', then two chars, ...). */
+function idCode(n: number): string {
+  let s = '';
+  do {
+    s += String.fromCharCode(33 + (n % 94));
+    n = Math.floor(n / 94);
+  } while (n > 0);
+  return s;
+}
+
+function formatValue(value: VcdValue, width: number, id: string): string {
+  if (width === 1) {
+    return (typeof value === 'number' ? (value & 1).toString() : value) + id;
+  }
+  return 'b' + (typeof value === 'number' ? value.toString(2) : value) + ' ' + id;
+}
+
+export class VcdWriter {
+  private readonly sink: (text: string) => void;
+  private readonly reorderWindowNS: number;
+  private readonly maxPending: number;
+  private vars: VcdVarDef[] = [];
+  private last: (VcdValue | undefined)[] = [];
+  private started = false;
+
+  // Pending changes in parallel arrays
+  private pTime: number[] = [];
+  private pVar: number[] = [];
+  private pValue: VcdValue[] = [];
+  private maxTimeNS = 0;
+  private lastWrittenPs = -1;
+
+  constructor(sink: (text: string) => void, options: VcdWriterOptions = {}) {
+    this.sink = sink;
+    this.reorderWindowNS = options.reorderWindowNS ?? 10_000;
+    this.maxPending = options.maxPending ?? 65_536;
+  }
+
+  /** Declare a variable; returns its handle. Must precede begin(). */
+  addVar(scope: string[], name: string, width: number): number {
+    if (this.started) throw new Error('VcdWriter: variables must be declared before begin()');
+    this.vars.push({ scope, name, width, id: idCode(this.vars.length) });
+    this.last.push(undefined);
+    return this.vars.length - 1;
+  }
+
+  /** Write the header and the initial values (all 'x' unless given). */
+  begin(initial: VcdValue[] = []): void {
+    if (this.started) return;
+    this.started = true;
+    const out: string[] = ['$version cubed GA144 emulator $end', '$timescale 1ps $end'];
+    let open: string[] = [];
+    // Variables are grouped by scope in declaration order
+    const order = this.vars.map((_, i) => i).sort((a, b) =>
+      this.vars[a].scope.join('.').localeCompare(this.vars[b].scope.join('.')) || a - b);
+    for (const i of order) {
+      const v = this.vars[i];
+      let common = 0;
+      while (common < open.length && common < v.scope.length && open[common] === v.scope[common]) common++;
+      for (let k = open.length; k > common; k--) out.push('$upscope $end');
+      for (let k = common; k < v.scope.length; k++) out.push(`$scope module ${v.scope[k]} $end`);
+      open = v.scope;
+      const range = v.width > 1 ? ` [${v.width - 1}:0]` : '';
+      out.push(`$var wire ${v.width} ${v.id} ${v.name}${range} $end`);
+    }
+    for (let k = open.length; k > 0; k--) out.push('$upscope $end');
+    out.push('$enddefinitions $end', '#0', '$dumpvars');
+    for (let i = 0; i < this.vars.length; i++) {
+      const value = initial[i] ?? 'x';
+      this.last[i] = value;
+      out.push(formatValue(value, this.vars[i].width, this.vars[i].id));
+    }
+    out.push('$end', '');
+    this.lastWrittenPs = 0;
+    this.sink(out.join('\n'));
+  }
+
+  /** Record a change of variable `handle` at guest time `timeNS`. */
+  change(handle: number, timeNS: number, value: VcdValue): void {
+    this.pTime.push(timeNS);
+    this.pVar.push(handle);
+    this.pValue.push(value);
+    if (timeNS > this.maxTimeNS) this.maxTimeNS = timeNS;
+    if (this.pTime.length >= this.maxPending) this.flush();
+  }
+
+  /**
+   * Write buffered changes older than the reorder window, or all of them
+   * when `final` is set.
+   */
+  flush(final = false): void {
+    if (!this.started) this.begin();
+    const n = this.pTime.length;
+    if (n === 0) return;
+    const horizon = final || n >= this.maxPending ? Infinity : this.maxTimeNS - this.reorderWindowNS;
+    const order: number[] = [];
+    for (let i = 0; i < n; i++) if (this.pTime[i] <= horizon) order.push(i);
+    if (order.length === 0) return;
+    order.sort((a, b) => this.pTime[a] - this.pTime[b] || a - b);
+
+    const out: string[] = [];
+    for (const i of order) {
+      const h = this.pVar[i];
+      const value = this.pValue[i];
+      if (this.last[h] === value) continue;
+      this.last[h] = value;
+      const ps = Math.max(Math.round(this.pTime[i] * 1000), this.lastWrittenPs);
+      if (ps !== this.lastWrittenPs) {
+        out.push(`#${ps}`);
+        this.lastWrittenPs = ps;
+      }
+      const v = this.vars[h];
+      out.push(formatValue(value, v.width, v.id));
+    }
+    if (out.length > 0) this.sink(out.join('\n') + '\n');
+
+    // Keep what is still inside the window
+    const keep = new Uint8Array(n).fill(1);
+    for (const i of order) keep[i] = 0;
+    const t: number[] = [], h: number[] = [], val: VcdValue[] = [];
+    for (let i = 0; i < n; i++) {
+      if (keep[i]) {
+        t.push(this.pTime[i]);
+        h.push(this.pVar[i]);
+        val.push(this.pValue[i]);
+      }
+    }
+    this.pTime = t;
+    this.pVar = h;
+    this.pValue = val;
+  }
+
+  /** Flush everything and mark the end time. */
+  close(endNS?: number): void {
+    this.flush(true);
+    if (endNS !== undefined) {
+      const ps = Math.round(endNS * 1000);
+      if (ps > this.lastWrittenPs) {
+        this.sink(`#${ps}\n`);
+        this.lastWrittenPs = ps;
+      }
+    }
+  }
+}
+
+// ---- Reader ----
+
+export interface VcdChange {
+  timeNS: number;
+  /** Raw value text: '0', '1', 'x', 'z' for scalars, binary digits for vectors. */
+  value: string;
+}
+
+export interface VcdSignal {
+  scope: string[];
+  name: string;
+  width: number;
+  changes: VcdChange[];
+}
+
+const TIMESCALE_NS: Record<string, number> = { s: 1e9, ms: 1e6, us: 1e3, ns: 1, ps: 1e-3, fs: 1e-6 };
+
+/** Parse a VCD file. Signals sharing an identifier code share a change list. */
+export function parseVcd(text: string): VcdSignal[] {
+  const tokens = text.split(/\s+/).filter(t => t.length > 0);
+  const signals: VcdSignal[] = [];
+  const byId = new Map<string, VcdChange[]>();
+  const scope: string[] = [];
+  let unitNS = 1;
+  let timeNS = 0;
+  let i = 0;
+
+  const skipToEnd = () => {
+    while (i < tokens.length && tokens[i] !== '$end') i++;
+    i++;
+  };
+  const record = (id: string, value: string) => {
+    const list = byId.get(id);
+    if (list) list.push({ timeNS, value });
+  };
+
+  while (i < tokens.length) {
+    const tok = tokens[i];
+    if (tok === '$timescale') {
+      const spec = [];
+      i++;
+      while (i < tokens.length && tokens[i] !== '$end') spec.push(tokens[i++]);
+      i++;
+      const m = /^(\d+)\s*([a-z]+)$/.exec(spec.join(''));
+      if (!m || TIMESCALE_NS[m[2]] === undefined) throw new Error(`VCD: bad timescale '${spec.join(' ')}'`);
+      unitNS = Number(m[1]) * TIMESCALE_NS[m[2]];
+    } else if (tok === '$scope') {
+      scope.push(tokens[i + 2]);
+      skipToEnd();
+    } else if (tok === '$upscope') {
+      scope.pop();
+      skipToEnd();
+    } else if (tok === '$var') {
+      const width = Number(tokens[i + 2]);
+      const id = tokens[i + 3];
+      const name = tokens[i + 4];
+      let changes = byId.get(id);
+      if (!changes) {
+        changes = [];
+        byId.set(id, changes);
+      }
+      signals.push({ scope: [...scope], name, width, changes });
+      skipToEnd();
+    } else if (tok === '$dumpvars' || tok === '$dumpall' || tok === '$dumpon' || tok === '$dumpoff' || tok === '$end') {
+      // Value changes inside these blocks are parsed like any others
+      i++;
+    } else if (tok[0] === '$') {
+      skipToEnd();
+    } else if (tok[0] === '#') {
+      timeNS = Number(tok.slice(1)) * unitNS;
+      i++;
+    } else if (tok[0] === 'b' || tok[0] === 'B' || tok[0] === 'r' || tok[0] === 'R') {
+      record(tokens[i + 1], tok.slice(1).toLowerCase());
+      i += 2;
+    } else {
+      record(tok.slice(1), tok[0].toLowerCase());
+      i++;
+    }
+  }
+  return signals;
+}
+
+/**
+ * Find a signal by name or dotted scope path ('ga144.node_708.pin17').
+ * A bare name must be unique.
+ */
+export function findVcdSignal(signals: VcdSignal[], path: string): VcdSignal {
+  const matches = signals.filter(s => s.name === path || [...s.scope, s.name].join('.') === path);
+  if (matches.length === 0) throw new Error(`VCD: no signal '${path}'`);
+  if (matches.length > 1) throw new Error(`VCD: signal '${path}' is ambiguous; use its scope path`);
+  return matches[0];
+}
+
+/**
+ * Convert a 1-bit signal into pin17 stimulus for GA144.enqueueSerialBits,
+ * starting at the signal's first change. '1' (and 'z' when `floatHigh`,
+ * for lines with a pull-up) drives the pin high; anything else low.
+ */
+export function vcdToPinBits(signal: VcdSignal, floatHigh = false): { startNS: number; bits: SerialBit[] } {
+  const level = (v: string) => v === '1' || (floatHigh && v === 'z');
+  const bits: SerialBit[] = [];
+  const changes = signal.changes;
+  for (let i = 0; i < changes.length; i++) {
+    const value = level(changes[i].value);
+    if (bits.length > 0 && bits[bits.length - 1].value === value) {
+      // Repeated level: extend the previous bit
+      bits[bits.length - 1].durationNS += (changes[i + 1]?.timeNS ?? changes[i].timeNS) - changes[i].timeNS;
+      continue;
+    }
+    const next = changes[i + 1]?.timeNS ?? changes[i].timeNS;
+    bits.push({ value, durationNS: next - changes[i].timeNS });
+  }
+  return { startNS: changes[0]?.timeNS ?? 0, bits };
+}
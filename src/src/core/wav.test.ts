@@ -0,0 +1,43 @@
+/**
+ * Tests for WAV file writing and reading.
+ */
+import { describe, it, expect } from 'vitest';
+import { WavWriter, parseWavHeader, decodeWavSamples } from './wav';
+
+describe('wav', () => {
+  it('round-trips interleaved 16-bit and float samples', () => {
+    for (const float of [false, true]) {
+      const chunks: Uint8Array[] = [];
+      const writer = new WavWriter(b => chunks.push(b), 44_100, 2, float);
+      writer.write(new Float32Array([0.5, -0.5, 1.5, 0, -1, 0.25]));
+      chunks[0] = writer.header();
+      const bytes = new Uint8Array(chunks.reduce((n, c) => n + c.length, 0));
+      chunks.reduce((off, c) => { bytes.set(c, off); return off + c.length; }, 0);
+
+      const read = (off: number, len: number) => bytes.subarray(off, off + len);
+      const format = parseWavHeader(read);
+      expect(format).toMatchObject({ channels: 2, sampleRate: 44_100, float, dataOffset: 44, dataLength: 6 * (float ? 4 : 2) });
+      const right = new Float64Array(8);
+      expect(decodeWavSamples(format, read(44, format.dataLength), 1, right)).toBe(3);
+      expect(Array.from(right.subarray(0, 3)).map(v => Math.round(v * 1000) / 1000)).toEqual([-0.5, 0, 0.25]);
+    }
+  });
+
+  it('skips unknown chunks and rejects unsupported formats', () => {
+    const bytes = new Uint8Array(12 + 8 + 4 + 8 + 16 + 8);
+    const view = new DataView(bytes.buffer);
+    const ascii = (off: number, s: string) => { for (let i = 0; i < 4; i++) bytes[off + i] = s.charCodeAt(i); };
+    ascii(0, 'RIFF');
+    ascii(8, 'WAVE');
+    ascii(12, 'LIST');
+    view.setUint32(16, 4, true);
+    ascii(24, 'fmt ');
+    view.setUint32(28, 16, true);
+    view.setUint16(32, 2, true);  // ADPCM
+    view.setUint16(46, 4, true);
+    ascii(48, 'data');
+    const read = (off: number, len: number) => bytes.subarray(off, off + len);
+    expect(() => parseWavHeader(read)).toThrow('unsupported format 2');
+    expect(() => parseWavHeader(() => new Uint8Array(4))).toThrow('not a RIFF/WAVE file');
+  });
+});
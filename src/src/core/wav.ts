@@ -0,0 +1,145 @@
+/**
+ * RIFF/WAVE files — header parsing and sample decoding for PCM (8, 16, 24
+ * and 32-bit integer) and 32/64-bit float data, and a streaming writer for
+ * 16-bit PCM or 32-bit float.
+ *
+ * Files are read through a ByteReader, so long recordings can be streamed
+ * from disk a chunk at a time instead of being loaded whole.
+ */
+
+/** Read up to `length` bytes at `offset`; a short result means end of file. */
+export type ByteReader = (offset: number, length: number) => Uint8Array;
+
+export interface WavFormat {
+  channels: number;
+  sampleRate: number;
+  bitsPerSample: number;
+  float: boolean;
+  /** Byte offset and length of the sample data. */
+  dataOffset: number;
+  dataLength: number;
+}
+
+const FORMAT_PCM = 1;
+const FORMAT_FLOAT = 3;
+const FORMAT_EXTENSIBLE = 0xFFFE;
+
+function tag(bytes: Uint8Array, off: number): string {
+  return String.fromCharCode(bytes[off], bytes[off + 1], bytes[off + 2], bytes[off + 3]);
+}
+
+/** Locate the fmt and data chunks. Chunks between them are skipped unread. */
+export function parseWavHeader(read: ByteReader): WavFormat {
+  const riff = read(0, 12);
+  if (riff.length < 12 || tag(riff, 0) !== 'RIFF' || tag(riff, 8) !== 'WAVE') {
+    throw new Error('wav: not a RIFF/WAVE file');
+  }
+  let format: Omit<WavFormat, 'dataOffset' | 'dataLength'> | null = null;
+  let off = 12;
+  for (;;) {
+    const header = read(off, 8);
+    if (header.length < 8) throw new Error('wav: no data chunk');
+    const id = tag(header, 0);
+    const size = new DataView(header.buffer, header.byteOffset, 8).getUint32(4, true);
+    if (id === 'fmt ') {
+      const body = read(off + 8, Math.min(size, 40));
+      const view = new DataView(body.buffer, body.byteOffset, body.byteLength);
+      let code = view.getUint16(0, true);
+      if (code === FORMAT_EXTENSIBLE && body.length >= 26) code = view.getUint16(24, true);
+      const bitsPerSample = view.getUint16(14, true);
+      const float = code === FORMAT_FLOAT;
+      if ((code !== FORMAT_PCM && !float) || (float ? bitsPerSample !== 32 && bitsPerSample !== 64 : ![8, 16, 24, 32].includes(bitsPerSample))) {
+        throw new Error(`wav: unsupported format ${code} with ${bitsPerSample}-bit samples`);
+      }
+      format = { channels: view.getUint16(2, true), sampleRate: view.getUint32(4, true), bitsPerSample, float };
+    } else if (id === 'data') {
+      if (!format) throw new Error('wav: data chunk before fmt chunk');
+      return { ...format, dataOffset: off + 8, dataLength: size };
+    }
+    off += 8 + size + (size & 1);
+  }
+}
+
+/**
+ * Decode whole frames from `bytes` (sample data starting on a frame
+ * boundary), taking one channel, as values in [-1, 1). Returns the number
+ * of samples written to `out`.
+ */
+export function decodeWavSamples(format: WavFormat, bytes: Uint8Array, channel: number, out: Float64Array): number {
+  const width = format.bitsPerSample >> 3;
+  const frame = width * format.channels;
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const n = Math.min(out.length, Math.floor(bytes.length / frame));
+  for (let i = 0, off = channel * width; i < n; i++, off += frame) {
+    switch (format.bitsPerSample) {
+      case 8: out[i] = (bytes[off] - 128) / 128; break;
+      case 16: out[i] = view.getInt16(off, true) / 0x8000; break;
+      case 24: out[i] = ((bytes[off] | (bytes[off + 1] << 8) | (bytes[off + 2] << 16)) << 8 >> 8) / 0x800000; break;
+      case 32: out[i] = format.float ? view.getFloat32(off, true) : view.getInt32(off, true) / 0x80000000; break;
+      default: out[i] = view.getFloat64(off, true);
+    }
+  }
+  return n;
+}
+
+/** The 44-byte header of a PCM or float file with `dataLength` bytes of samples. */
+export function wavHeader(sampleRate: number, channels: number, float: boolean, dataLength: number): Uint8Array {
+  const bitsPerSample = float ? 32 : 16;
+  const blockAlign = channels * (bitsPerSample >> 3);
+  const header = new Uint8Array(44);
+  const view = new DataView(header.buffer);
+  const ascii = (off: number, s: string) => { for (let i = 0; i < 4; i++) header[off + i] = s.charCodeAt(i); };
+  ascii(0, 'RIFF');
+  view.setUint32(4, Math.min(0xFFFFFFFF, 36 + dataLength), true);
+  ascii(8, 'WAVE');
+  ascii(12, 'fmt ');
+  view.setUint32(16, 16, true);
+  view.setUint16(20, float ? FORMAT_FLOAT : FORMAT_PCM, true);
+  view.setUint16(22, channels, true);
+  view.setUint32(24, sampleRate, true);
+  view.setUint32(28, sampleRate * blockAlign, true);
+  view.setUint16(32, blockAlign, true);
+  view.setUint16(34, bitsPerSample, true);
+  ascii(36, 'data');
+  view.setUint32(40, Math.min(0xFFFFFFFF - 36, dataLength), true);
+  return header;
+}
+
+/**
+ * Streams interleaved samples in [-1, 1] to a sink. The header goes out
+ * first with the sizes left at their maximum, as for an unbounded stream;
+ * a caller that can seek rewrites it with `header()` when done.
+ */
+export class WavWriter {
+  readonly sampleRate: number;
+  readonly channels: number;
+  readonly float: boolean;
+  private readonly sink: (bytes: Uint8Array) => void;
+  private dataLength = 0;
+
+  constructor(sink: (bytes: Uint8Array) => void, sampleRate: number, channels: number, float = false) {
+    this.sink = sink;
+    this.sampleRate = sampleRate;
+    this.channels = channels;
+    this.float = float;
+    sink(wavHeader(sampleRate, channels, float, 0xFFFFFFFF));
+  }
+
+  /** Write `count` samples of `samples` (whole frames, interleaved). */
+  write(samples: Float32Array, count = samples.length): void {
+    const bytes = new Uint8Array(count * (this.float ? 4 : 2));
+    const view = new DataView(bytes.buffer);
+    for (let i = 0; i < count; i++) {
+      const s = Math.max(-1, Math.min(1, samples[i]));
+      if (this.float) view.setFloat32(i * 4, s, true);
+      else view.setInt16(i * 2, Math.round(s * 0x7FFF), true);
+    }
+    this.dataLength += bytes.length;
+    this.sink(bytes);
+  }
+
+  /** The header with the final sizes. */
+  header(): Uint8Array {
+    return wavHeader(this.sampleRate, this.channels, this.float, this.dataLength);
+  }
+}
@@ -0,0 +1,26 @@
+/**
+ * End-to-end check of the ga144run wrapper script: host bytes piped into
+ * it must reach node 708 through --serial-stdio. Needs esbuild from
+ * node_modules, so it is skipped in trees without installed dependencies.
+ */
+import { describe, it, expect } from 'vitest';
+import { spawnSync } from 'node:child_process';
+import { existsSync } from 'node:fs';
+import { resolve } from 'node:path';
+
+const ROOT = resolve(import.meta.dirname, '..');
+const haveEsbuild = existsSync(resolve(ROOT, 'node_modules/.bin/esbuild'));
+const runIt = haveEsbuild ? it : it.skip;
+
+describe('ga144run wrapper', () => {
+  runIt('bridges piped stdin to the serial port with --serial-stdio', () => {
+    const result = spawnSync(resolve(ROOT, 'ga144run'), ['samples/ECHO2.cube', '--serial-stdio', '--realtime'], {
+      cwd: ROOT,
+      input: 'H',
+      timeout: 30_000,
+    });
+    expect(result.signal).toBeNull();
+    expect(result.status).toBe(0);
+    expect(result.stdout.toString('latin1')).toBe('H');
+  });
+});
@@ -0,0 +1,85 @@
+/**
+ * Bounded async channel — hands emulator output to one consumer as an
+ * async iterable, with backpressure on the producer.
+ *
+ * The emulator pushes items between run chunks and, before the next
+ * chunk, awaits `drained()` on any channel holding `highWaterMark` items
+ * or more, so a slow consumer pauses the chip instead of growing a
+ * buffer. A consumer that stops iterating (break, return or throw) closes
+ * the channel, and later items are dropped without blocking the run.
+ */
+export class Channel<T> implements AsyncIterable<T> {
+  readonly highWaterMark: number;
+  private readonly queue: T[] = [];
+  private readonly readers: ((result: IteratorResult<T>) => void)[] = [];
+  private drainWaiters: (() => void)[] = [];
+  private done = false;
+  private iterated = false;
+
+  constructor(highWaterMark: number) {
+    if (!(highWaterMark >= 1)) throw new Error(`highWaterMark must be at least 1, got ${highWaterMark}`);
+    this.highWaterMark = highWaterMark;
+  }
+
+  /** Items waiting for the consumer. */
+  get size(): number {
+    return this.queue.length;
+  }
+
+  get closed(): boolean {
+    return this.done;
+  }
+
+  /** True while the producer should wait for `drained()`. */
+  get full(): boolean {
+    return !this.done && this.queue.length >= this.highWaterMark;
+  }
+
+  /** Queue an item, or hand it straight to a waiting reader. Dropped once closed. */
+  push(item: T): void {
+    if (this.done) return;
+    const reader = this.readers.shift();
+    if (reader) reader({ value: item, done: false });
+    else this.queue.push(item);
+  }
+
+  /** Resolves once the queue is below the high-water mark or the channel closes. */
+  drained(): Promise<void> {
+    if (!this.full) return Promise.resolve();
+    return new Promise(resolve => this.drainWaiters.push(resolve));
+  }
+
+  /** End the stream; the consumer still gets the items already queued. */
+  close(): void {
+    if (this.done) return;
+    this.done = true;
+    for (const reader of this.readers.splice(0)) reader({ value: undefined, done: true });
+    this.releaseDrain();
+  }
+
+  private releaseDrain(): void {
+    if (this.full) return;
+    for (const resolve of this.drainWaiters.splice(0)) resolve();
+  }
+
+  [Symbol.asyncIterator](): AsyncIterator<T> {
+    if (this.iterated) throw new Error('Channel supports a single consumer');
+    this.iterated = true;
+    return {
+      next: () => {
+        if (this.queue.length > 0) {
+          const value = this.queue.shift()!;
+          this.releaseDrain();
+          return Promise.resolve({ value, done: false });
+        }
+        if (this.done) return Promise.resolve({ value: undefined, done: true });
+        return new Promise(resolve => this.readers.push(resolve));
+      },
+      return: () => {
+        this.queue.length = 0;
+        this.close();
+        return Promise.resolve({ value: undefined, done: true });
+      },
+    };
+  }
+}
@@ -0,0 +1,128 @@
+/**
+ * Tests for the headless emulator: booting and echoing over serial,
+ * GPIO edge batches, backpressure from a slow consumer, and stop events.
+ */
+import { describe, it, expect } from 'vitest';
+import { readFileSync } from 'fs';
+import { fileURLToPath } from 'url';
+import { dirname, join } from 'path';
+import { EMU_PORT, PORT } from '../core/constants';
+import { Emulator, PIN_HIGH, PIN_FLOAT } from './emulator';
+import { Channel } from './channel';
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+
+/** Node 600 toggling pin 17 forever. */
+const TOGGLE = `#include std
+node 600
+/\\
+std.forever{}
+/\\ std.send{port=${PORT.IO}, value=0x30000}
+/\\ std.send{port=${PORT.IO}, value=0x00000}
+/\\ std.repeat{}
+`;
+
+describe('Channel', () => {
+  it('queues up to the high-water mark and releases the producer on drain', async () => {
+    const ch = new Channel<number>(2);
+    ch.push(1);
+    ch.push(2);
+    expect(ch.full).toBe(true);
+    let drained = false;
+    const wait = ch.drained().then(() => { drained = true; });
+    const it = ch[Symbol.asyncIterator]();
+    expect(await it.next()).toEqual({ value: 1, done: false });
+    await wait;
+    expect(drained).toBe(true);
+
+    ch.close();
+    ch.push(3);
+    expect(await it.next()).toEqual({ value: 2, done: false });
+    expect((await it.next()).done).toBe(true);
+    expect(() => ch[Symbol.asyncIterator]()).toThrow('single consumer');
+  });
+});
+
+describe('Emulator', () => {
+  it('boots ECHO2 and streams the echoed bytes', { timeout: 60_000 }, async () => {
+    const source = readFileSync(join(__dirname, '../../samples/ECHO2.cube'), 'utf-8');
+    const emu = new Emulator({ program: source, boot: true });
+    const serial = emu.serial();
+    const received: number[] = [];
+    const times: number[] = [];
+    const reader = (async () => {
+      for await (const chunk of serial) {
+        received.push(...chunk.bytes);
+        times.push(...chunk.timesNS);
+      }
+    })();
+
+    // ECHO2 polls its RX pin, so it never idles: run by step budget
+    expect((await emu.run({ maxSteps: 3_000_000 })).reason).toBe('steps');
+    for (const byte of [0x41, 0x42]) {
+      emu.sendSerial([byte]);
+      await emu.run({ maxSteps: 2_000_000 });
+    }
+    emu.close();
+    await reader;
+
+    expect(received).toEqual([0x41, 0x42]);
+    expect(times[1]).toBeGreaterThan(times[0]);
+  });
+
+  it('batches GPIO edges and pauses the chip for a slow consumer', async () => {
+    const emu = new Emulator({ program: TOGGLE });
+    const edges = emu.gpio({ coords: [600], highWaterMark: 2 });
+    const stop = emu.run({ chunkSteps: 1_000, maxSteps: 20_000 });
+
+    // Nothing is read yet, so the run stalls on the full channel
+    await new Promise(resolve => setTimeout(resolve, 20));
+    expect(edges.size).toBe(2);
+    const stepsWhileFull = emu.chip.getTotalSteps();
+    expect(stepsWhileFull).toBeLessThan(20_000);
+
+    let count = 0;
+    let lastTime = -1;
+    for await (const batch of edges) {
+      expect(batch.coords.every(c => c === 600)).toBe(true);
+      expect(batch.pins.every(p => p === 17)).toBe(true);
+      for (let i = 0; i < batch.count; i++) {
+        // First edge leaves the reset level; after that the pin alternates
+        expect(batch.levels[i]).toBe((count + i) % 2 === 0 ? PIN_HIGH : PIN_FLOAT);
+        expect(batch.timesNS[i]).toBeGreaterThan(lastTime);
+        lastTime = batch.timesNS[i];
+      }
+      count += batch.count;
+      if (emu.chip.getTotalSteps() >= 20_000 && edges.size === 0) break;
+    }
+    const event = await stop;
+    expect(event.reason).toBe('steps');
+    expect(event.steps).toBeGreaterThan(stepsWhileFull);
+    expect(count).toBeGreaterThan(100);
+  });
+
+  it('reports stops for breakpoints, stalls and stop()', async () => {
+    const emu = new Emulator({ program: TOGGLE });
+    const running = emu.run({ chunkSteps: 1_000 });
+    emu.stop();
+    expect((await running).reason).toBe('stopped');
+    const controller = new AbortController();
+    controller.abort();
+    expect((await emu.run({ signal: controller.signal })).reason).toBe('stopped');
+
+    // 100 waits on a neighbour that never writes
+    const stuck = new Emulator({ program: `#include std
+node 100
+/\\
+std.recv{port=${PORT.RIGHT}, value=x}
+/\\
+std.send{port=${EMU_PORT.DEBUG}, value=x}
+` });
+    const event = await stuck.run({ maxSteps: 1_000_000 });
+    expect(['idle', 'deadlock']).toContain(event.reason);
+
+    expect(() => new Emulator({ program: 'node 100\n/\\\nstd.nope{}' })).toThrow('error');
+    expect(() => emu.gpio({ coords: [101] })).toThrow('Node 101 has no GPIO pins');
+  });
+});
@@ -0,0 +1,326 @@
+/**
+ * Headless emulator — compile, boot and run a program with its output
+ * streamed to the caller instead of polled from snapshots.
+ *
+ * Output streams are opened before `run()`: decoded serial bytes, VGA
+ * frames and GPIO edges each come out of a Channel as batches built from
+ * one run chunk. Batches are freshly allocated typed arrays whose
+ * ownership passes to the consumer, so nothing is copied after delivery
+ * and the arrays can be transferred to a worker as they are. The run
+ * loop awaits any full channel between chunks (backpressure), and
+ * `run()` resolves with the reason the chip stopped.
+ *
+ * The snapshot ring is turned off: nothing here reads it, and it would
+ * otherwise keep 2M IO writes.
+ */
+import { GA144 } from '../core/ga144';
+import { ROM_DATA } from '../core/rom-data';
+import { compileCube } from '../core/cube/compiler';
+import { compile } from '../core/assembler';
+import { buildBootStream } from '../core/bootstream';
+import { SerialBits, SerialDecoder } from '../core/serial';
+import { NODE_GPIO_PINS } from '../core/constants';
+import type { CompiledProgram } from '../core/types';
+import type { StallReport } from '../core/deadlock';
+import type { Mesh } from '../core/mesh';
+import { VgaFrameCapture } from '../ui/emulator/vgaCapture';
+import type { VgaFrame } from '../ui/emulator/vgaCapture';
+import { Channel } from './channel';
+
+export interface EmulatorOptions {
+  /** CUBE or arrayForth source, or a compiled program. */
+  program: string | CompiledProgram;
+  /** Language of a source string (default 'cube'). */
+  language?: 'cube' | 'aforth';
+  /** Deliver the program as a serial boot stream to node 708 instead of
+   *  loading node RAM directly. */
+  boot?: boolean;
+  mesh?: Mesh;
+  romData?: Record<number, number[]>;
+  name?: string;
+}
+
+export interface RunOptions {
+  /** Node-step budget for this call (default unlimited). */
+  maxSteps?: number;
+  /** Steps between stream flushes and backpressure checks (default 100000). */
+  chunkSteps?: number;
+  signal?: AbortSignal;
+}
+
+export type StopReason = 'steps' | 'idle' | 'breakpoint' | 'deadlock' | 'livelock' | 'stopped';
+
+export interface StopEvent {
+  reason: StopReason;
+  /** Steps and guest time since reset. */
+  steps: number;
+  timeNS: number;
+  /** Set for deadlock and livelock. */
+  stall: StallReport | null;
+}
+
+export interface SerialChunk {
+  bytes: Uint8Array;
+  /** Guest time each byte's last data bit was sampled. */
+  timesNS: Float64Array;
+}
+
+export const PIN_LOW = 0;
+export const PIN_HIGH = 1;
+export const PIN_FLOAT = 2;
+
+/** Pin level changes, as parallel arrays. */
+export interface GpioEdges {
+  count: number;
+  coords: Uint16Array;
+  /** 17, 1, 3 or 5. */
+  pins: Uint8Array;
+  /** PIN_LOW, PIN_HIGH or PIN_FLOAT (high-Z). */
+  levels: Uint8Array;
+  timesNS: Float64Array;
+}
+
+export interface StreamOptions {
+  /** Batches queued before the run waits for the consumer (default 64). */
+  highWaterMark?: number;
+}
+
+/** Drive field (00 high-Z, 01 weak pulldown, 10 low, 11 high) to level. */
+const FIELD_LEVEL = [PIN_FLOAT, PIN_LOW, PIN_LOW, PIN_HIGH];
+
+/** Pin number and the shift of its drive field, in pin-count order. */
+const PIN_FIELDS: [number, number][] = [[17, 16], [1, 0], [3, 2], [5, 4]];
+
+const SERIAL_NODE = 708;
+
+class SerialStream {
+  readonly channel: Channel<SerialChunk>;
+  readonly decoder: SerialDecoder;
+  private bytes: number[] = [];
+  private times: number[] = [];
+
+  constructor(baud: number, highWaterMark: number) {
+    this.channel = new Channel(highWaterMark);
+    this.decoder = new SerialDecoder(baud, (byte, timeNS) => {
+      this.bytes.push(byte);
+      this.times.push(timeNS);
+    });
+  }
+
+  flush(timeNS: number): void {
+    this.decoder.advance(timeNS);
+    if (this.bytes.length === 0) return;
+    this.channel.push({ bytes: Uint8Array.from(this.bytes), timesNS: Float64Array.from(this.times) });
+    this.bytes = [];
+    this.times = [];
+  }
+}
+
+class GpioStream {
+  readonly channel: Channel<GpioEdges>;
+  /** Last level per coord and pin field index. */
+  private readonly levels = new Map<number, number[]>();
+  private coords = new Uint16Array(256);
+  private pins = new Uint8Array(256);
+  private values = new Uint8Array(256);
+  private times = new Float64Array(256);
+  private count = 0;
+
+  constructor(coords: readonly number[], highWaterMark: number) {
+    this.channel = new Channel(highWaterMark);
+    // Pins start as inputs with the io register's reset value
+    for (const c of coords) this.levels.set(c, new Array(NODE_GPIO_PINS[c]).fill(PIN_LOW));
+  }
+
+  write(coord: number, value: number, timeNS: number): void {
+    const last = this.levels.get(coord)!;
+    for (let i = 0; i < last.length; i++) {
+      const level = FIELD_LEVEL[(value >> PIN_FIELDS[i][1]) & 3];
+      if (level === last[i]) continue;
+      last[i] = level;
+      if (this.count === this.times.length) this.grow();
+      this.coords[this.count] = coord;
+      this.pins[this.count] = PIN_FIELDS[i][0];
+      this.values[this.count] = level;
+      this.times[this.count] = timeNS;
+      this.count++;
+    }
+  }
+
+  private grow(): void {
+    const n = this.times.length * 2;
+    const grow = <A extends Uint8Array | Uint16Array | Float64Array>(a: A, make: (n: number) => A): A => {
+      const b = make(n);
+      b.set(a);
+      return b;
+    };
+    this.coords = grow(this.coords, k => new Uint16Array(k));
+    this.pins = grow(this.pins, k => new Uint8Array(k));
+    this.values = grow(this.values, k => new Uint8Array(k));
+    this.times = grow(this.times, k => new Float64Array(k));
+  }
+
+  /** Hand the batch over as views of arrays the stream then forgets. */
+  flush(): void {
+    if (this.count === 0) return;
+    const n = this.count;
+    this.channel.push({
+      count: n,
+      coords: this.coords.subarray(0, n),
+      pins: this.pins.subarray(0, n),
+      levels: this.values.subarray(0, n),
+      timesNS: this.times.subarray(0, n),
+    });
+    const size = this.times.length;
+    this.coords = new Uint16Array(size);
+    this.pins = new Uint8Array(size);
+    this.values = new Uint8Array(size);
+    this.times = new Float64Array(size);
+    this.count = 0;
+  }
+}
+
+function compileProgram(options: EmulatorOptions): CompiledProgram {
+  if (typeof options.program !== 'string') return options.program;
+  const compiled = options.language === 'aforth' ? compile(options.program) : compileCube(options.program);
+  if (compiled.errors.length > 0) {
+    const list = compiled.errors.map(e => `${e.line}:${e.col}: ${e.message}`).join('\n  ');
+    throw new Error(`Program has ${compiled.errors.length} error(s):\n  ${list}`);
+  }
+  return compiled;
+}
+
+/** Macrotask yield, so I/O and timers run between chunks. */
+const yieldToHost = (): Promise<void> => new Promise(resolve => {
+  if (typeof setImmediate === 'function') setImmediate(resolve);
+  else setTimeout(resolve, 0);
+});
+
+export class Emulator {
+  /** The chip, for attaching devices, breakpoints and inspection. */
+  readonly chip: GA144;
+  readonly program: CompiledProgram;
+  private readonly channels: Channel<unknown>[] = [];
+  private readonly flushers: ((timeNS: number) => void)[] = [];
+  private readonly closers: (() => void)[] = [];
+  private running = false;
+  private stopRequested = false;
+
+  constructor(options: EmulatorOptions) {
+    this.program = compileProgram(options);
+    this.chip = new GA144(options.name ?? 'headless', options.mesh);
+    this.chip.setRomData(options.romData ?? ROM_DATA);
+    this.chip.reset();
+    this.chip.setIoRingEnabled(false);
+    if (options.boot) {
+      const bytes = Array.from(buildBootStream(this.program.nodes).bytes);
+      this.chip.enqueueSerialBits(SERIAL_NODE, SerialBits.bootStreamBits(bytes, GA144.BOOT_BAUD));
+    } else {
+      this.chip.load(this.program);
+    }
+  }
+
+  private open<T>(channel: Channel<T>, flush: (timeNS: number) => void, close: () => void): Channel<T> {
+    if (this.running) throw new Error('Open streams before run()');
+    this.channels.push(channel as Channel<unknown>);
+    this.flushers.push(flush);
+    this.closers.push(close);
+    return channel;
+  }
+
+  /** Bytes decoded from node 708's serial TX pin (pin 1). */
+  serial(options: StreamOptions & { baud?: number } = {}): Channel<SerialChunk> {
+    const stream = new SerialStream(options.baud ?? GA144.BOOT_BAUD, options.highWaterMark ?? 64);
+    const unsubscribe = this.chip.ioBus.subscribe({ coords: [SERIAL_NODE] }, (_coord, value, timeNS) => {
+      if (value <= 3) stream.decoder.write((value & 1) !== 0, timeNS);
+    });
+    return this.open(stream.channel, t => stream.flush(t), unsubscribe);
+  }
+
+  /** Frames decoded from the VGA nodes (R 117, G 617, B 717, sync 217). */
+  vga(options: StreamOptions & { width?: number; height?: number } = {}): Channel<VgaFrame> {
+    const channel = new Channel<VgaFrame>(options.highWaterMark ?? 4);
+    const capture = new VgaFrameCapture(this.chip.ioBus, frame => channel.push(frame), options.width, options.height);
+    return this.open(channel, () => capture.flush(), () => capture.close());
+  }
+
+  /** Level changes of GPIO pins on `coords` (default: every GPIO node). */
+  gpio(options: StreamOptions & { coords?: readonly number[] } = {}): Channel<GpioEdges> {
+    const coords = options.coords ?? Object.keys(NODE_GPIO_PINS).map(Number);
+    for (const c of coords) {
+      if (!NODE_GPIO_PINS[c] || !this.chip.mesh.standard) throw new Error(`Node ${c} has no GPIO pins`);
+    }
+    const stream = new GpioStream(coords, options.highWaterMark ?? 64);
+    const unsubscribe = this.chip.ioBus.subscribe({ coords }, (coord, value, timeNS) => stream.write(coord, value, timeNS));
+    return this.open(stream.channel, () => stream.flush(), unsubscribe);
+  }
+
+  /** Send bytes to node 708's serial RX pin, after any input still queued. */
+  sendSerial(bytes: ArrayLike<number>, baud: number = GA144.BOOT_BAUD): void {
+    this.chip.sendSerialInput(Array.from(bytes), baud);
+  }
+
+  /** Ask a running `run()` to return at the end of its chunk. */
+  stop(): void {
+    this.stopRequested = true;
+  }
+
+  /**
+   * Run until the budget is spent, every node is idle with no serial
+   * input left, a breakpoint or stall, or `stop()`/`signal`. Can be
+   * called again to continue.
+   */
+  async run(options: RunOptions = {}): Promise<StopEvent> {
+    if (this.running) throw new Error('Emulator is already running');
+    this.running = true;
+    this.stopRequested = false;
+    const chip = this.chip;
+    const maxSteps = options.maxSteps ?? Infinity;
+    const chunkSteps = options.chunkSteps ?? 100_000;
+    const start = chip.getTotalSteps();
+    let reason: StopReason | null = null;
+    let stall: StallReport | null = null;
+    try {
+      while (reason === null) {
+        const done = chip.getTotalSteps() - start;
+        if (this.stopRequested || options.signal?.aborted) {
+          reason = 'stopped';
+        } else if (done >= maxSteps) {
+          reason = 'steps';
+        } else {
+          const before = chip.getTotalSteps();
+          const hit = chip.stepProgramN(Math.min(chunkSteps, maxSteps - done));
+          this.flush();
+          stall = hit ? null : chip.detectStall();
+          if (hit) reason = 'breakpoint';
+          else if (stall) reason = stall.kind;
+          else if (chip.getTotalSteps() === before && chip.getDevicePending() === 0) reason = 'idle';
+          else await this.backpressure();
+        }
+      }
+    } finally {
+      this.running = false;
+    }
+    return { reason, steps: chip.getTotalSteps(), timeNS: chip.getGuestTimeNS(), stall };
+  }
+
+  private flush(): void {
+    const timeNS = this.chip.getGuestTimeNS();
+    for (const flush of this.flushers) flush(timeNS);
+  }
+
+  private async backpressure(): Promise<void> {
+    for (const channel of this.channels) {
+      if (channel.full) await channel.drained();
+    }
+    await yieldToHost();
+  }
+
+  /** Detach the streams and end them; consumers get what is queued. */
+  close(): void {
+    this.flush();
+    for (const close of this.closers.splice(0)) close();
+    for (const channel of this.channels.splice(0)) channel.close();
+    this.flushers.length = 0;
+  }
+}
@@ -0,0 +1,22 @@
+/**
+ * Headless emulator package entry point — everything needed to compile,
+ * boot and run GA144 programs outside the browser. See docs/headless.md.
+ */
+export { Emulator, PIN_LOW, PIN_HIGH, PIN_FLOAT } from './emulator';
+export type {
+  EmulatorOptions, RunOptions, StreamOptions, StopEvent, StopReason, SerialChunk, GpioEdges,
+} from './emulator';
+export { Channel } from './channel';
+export type { VgaFrame } from '../ui/emulator/vgaCapture';
+
+export { GA144 } from '../core/ga144';
+export { Mesh, GA144_MESH } from '../core/mesh';
+export { compileCube } from '../core/cube';
+export { compile } from '../core/assembler';
+export { buildBootStream } from '../core/bootstream';
+export { SerialBits, SerialDecoder } from '../core/serial';
+export { StimulusDevice, clockStimulus, bitsStimulus, serialStimulus } from '../core/devices/stimulus';
+export type { PinEvent } from '../core/devices/stimulus';
+export type { Device, DeviceHost } from '../core/devices/device';
+export type { StallReport } from '../core/deadlock';
+export type { CompiledProgram, CompileError } from '../core/types';
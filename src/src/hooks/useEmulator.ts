@@ -1,20 +1,40 @@
 import { useState, useCallback, useRef, useEffect } from 'react';
-import type { GA144Snapshot, CompileError, CompiledProgram } from '../core/types';
+import type { CompileError, CompiledProgram, ClockCounterMode } from '../core/types';
 import { ROM_DATA } from '../core/rom-data';
 import { compile } from '../core/assembler';
 import { compileCube, tokenizeCube, parseCube } from '../core/cube';
 import type { CubeProgram, CubeCompileResult } from '../core/cube';
 import type { EditorLanguage } from '../ui/editor/CodeEditor';
 import { buildBootStream } from '../core/bootstream';
-import type { MainToWorker, WorkerToMain, WorkerSnapshot } from '../worker/emulatorProtocol';
+import type { MainToWorker, WorkerToMain } from '../worker/emulatorProtocol';
 import { IoWriteBuffer } from '../worker/ioWriteBuffer';
+import { PROTOCOL_VERSION, decodeSnapshot } from '../worker/snapshotCodec';
+import { ChipActivity } from '../worker/chipActivity';
+import { DebugLogBuffer } from '../worker/debugLogBuffer';
+import { WatchBuffer } from '../worker/watchBuffer';
+import type { WatchTarget, WatchMode } from '../core/ram-watch';
+import type { StallReport } from '../core/deadlock';
+import type { HostProfileReport } from '../core/host-profile';
+import { FrameCoalescer } from '../stores/frameCoalescer';
+import { commitFrame } from '../stores/emulatorStore';
+import type { EmulatorState } from '../stores/emulatorStore';
+
+/** What changed since the last frame. */
+interface PendingFrame {
+  /** Latest snapshot buffer; earlier ones in the same frame are dropped. */
+  snapshot: ArrayBuffer;
+  io: boolean;
+  debug: boolean;
+  watch: boolean;
+  hostProfile: HostProfileReport | null;
+}
 
 export function useEmulator() {
   const workerRef = useRef<Worker | null>(null);
   const ioBufferRef = useRef(new IoWriteBuffer());
-  const workerSnapshotRef = useRef<WorkerSnapshot | null>(null);
+  const debugBufferRef = useRef(new DebugLogBuffer());
+  const watchBufferRef = useRef(new WatchBuffer());
 
-  const [snapshot, setSnapshot] = useState<GA144Snapshot | null>(null);
   const [selectedCoord, setSelectedCoord] = useState<number | null>(null);
   const [isRunning, setIsRunning] = useState(false);
   const [compileErrors, setCompileErrors] = useState<CompileError[]>([]);
@@ -24,29 +44,39 @@ export function useEmulator() {
   const [compiledProgram, setCompiledProgram] = useState<CompiledProgram | null>(null);
   const [bootStreamBytes, setBootStreamBytes] = useState<Uint8Array | null>(null);
   const [emulatorError, setEmulatorError] = useState<string | null>(null);
+  const [stall, setStall] = useState<StallReport | null>(null);
+  const [activity, setActivity] = useState<ChipActivity | null>(null);
 
-  // Compose a GA144Snapshot-compatible object from worker snapshot + IO buffer
-  const buildSnapshot = useCallback((): GA144Snapshot | null => {
-    const ws = workerSnapshotRef.current;
-    if (!ws) return null;
-    const io = ioBufferRef.current;
-    return {
-      nodeStates: ws.nodeStates,
-      nodeCoords: ws.nodeCoords,
-      activeCount: ws.activeCount,
-      totalSteps: ws.totalSteps,
-      selectedNode: ws.selectedNode,
-      ioWrites: io.writes,
-      ioWriteTimestamps: io.timestamps,
-      ioWriteJitter: new Float32Array(0), // not used by UI
-      ioWriteStart: io.start,
-      ioWriteCount: io.count,
-      ioWriteSeq: io.seq,
-      totalEnergyPJ: ws.totalEnergyPJ,
-      chipPowerMW: ws.chipPowerMW,
-      totalSimTimeNS: ws.totalSimTimeNS,
-    };
-  }, []);
+  // Worker output reaches the emulator store at most once per frame
+  const [coalescer] = useState(() => new FrameCoalescer<PendingFrame>((pending) => {
+    const update: Partial<EmulatorState> = {};
+    if (pending.snapshot) {
+      const ws = decodeSnapshot(pending.snapshot);
+      update.ready = true;
+      update.totals = {
+        activeCount: ws.activeCount,
+        totalSteps: ws.totalSteps,
+        totalEnergyPJ: ws.totalEnergyPJ,
+        chipPowerMW: ws.chipPowerMW,
+        totalSimTimeNS: ws.totalSimTimeNS,
+      };
+      update.selectedNode = ws.selectedNode;
+    }
+    if (pending.io) {
+      const io = ioBufferRef.current;
+      update.io = {
+        ioWrites: io.writes,
+        ioWriteTimestamps: io.timestamps,
+        ioWriteStart: io.start,
+        ioWriteCount: io.count,
+        ioWriteSeq: io.seq,
+      };
+    }
+    if (pending.debug) update.debugEntries = debugBufferRef.current.entries;
+    if (pending.watch) update.watch = watchBufferRef.current.view;
+    if (pending.hostProfile !== undefined) update.hostProfile = pending.hostProfile;
+    commitFrame(update);
+  }));
 
   // Initialize worker
   useEffect(() => {
@@ -60,27 +90,45 @@ export function useEmulator() {
       const msg = e.data;
       switch (msg.type) {
         case 'ready':
+          if (msg.version !== PROTOCOL_VERSION) {
+            setEmulatorError(`Emulator worker protocol v${msg.version}, expected v${PROTOCOL_VERSION}. Reload the page.`);
+            break;
+          }
+          setActivity(new ChipActivity(msg.activity));
           break;
         case 'error':
           setEmulatorError(msg.message);
           break;
         case 'snapshot':
-          workerSnapshotRef.current = msg.snapshot;
-          setSnapshot(buildSnapshot());
+          coalescer.queue({ snapshot: msg.buffer });
           break;
         case 'ioWriteBatch':
           ioBufferRef.current.appendBatch(msg.batch);
-          setSnapshot(buildSnapshot());
+          coalescer.queue({ io: true });
+          break;
+        case 'debugBatch':
+          debugBufferRef.current.appendBatch(msg.batch);
+          coalescer.queue({ debug: true });
           break;
         case 'stopped':
           setIsRunning(false);
+          setStall(msg.stall ?? null);
+          break;
+        case 'watchBatch':
+          if (watchBufferRef.current.appendBatch(msg.batch)) coalescer.queue({ watch: true });
+          break;
+        case 'hostProfile':
+          coalescer.queue({ hostProfile: msg.profile });
           break;
       }
     };
 
     worker.postMessage({ type: 'init', romData: ROM_DATA } satisfies MainToWorker);
-    return () => worker.terminate();
-  }, [buildSnapshot]);
+    return () => {
+      worker.terminate();
+      coalescer.cancel();
+    };
+  }, [coalescer]);
 
   const post = useCallback((msg: MainToWorker) => {
     workerRef.current?.postMessage(msg);
@@ -92,6 +140,7 @@ export function useEmulator() {
 
   const run = useCallback(() => {
     setIsRunning(true);
+    setStall(null);
     post({ type: 'run' });
   }, [post]);
 
@@ -99,10 +148,18 @@ export function useEmulator() {
     post({ type: 'stop' });
   }, [post]);
 
+  const resetDebugLog = useCallback(() => {
+    debugBufferRef.current.reset();
+    coalescer.queue({ debug: true });
+  }, [coalescer]);
+
   const reset = useCallback(() => {
     ioBufferRef.current.reset();
+    coalescer.queue({ io: true });
+    resetDebugLog();
+    setStall(null);
     post({ type: 'reset' });
-  }, [post]);
+  }, [post, coalescer, resetDebugLog]);
 
   const compileAndLoad = useCallback((source: string, options?: { asLanguage?: EditorLanguage }) => {
     const effectiveLang = options?.asLanguage ?? language;
@@ -130,6 +187,9 @@ export function useEmulator() {
         const bytes = buildBootStream(result.nodes).bytes;
         setBootStreamBytes(bytes);
         ioBufferRef.current.reset();
+        coalescer.queue({ io: true });
+        resetDebugLog();
+        setStall(null);
         post({ type: 'loadBootStream', bytes });
       }
     } else {
@@ -141,22 +201,51 @@ export function useEmulator() {
         const bytes = buildBootStream(result.nodes).bytes;
         setBootStreamBytes(bytes);
         ioBufferRef.current.reset();
+        coalescer.queue({ io: true });
+        resetDebugLog();
+        setStall(null);
         post({ type: 'loadBootStream', bytes });
       }
     }
-  }, [language, post]);
+  }, [language, post, coalescer, resetDebugLog]);
 
   const sendSerialInput = useCallback((bytes: number[], baud: number) => {
     post({ type: 'sendSerialInput', bytes, baud });
   }, [post]);
 
+  const setDebugChannel = useCallback((enabled: boolean, zeroTime: boolean) => {
+    post({ type: 'setDebugChannel', enabled, zeroTime });
+  }, [post]);
+
+  const setClockCounter = useCallback((mode: ClockCounterMode, coords: number[] | null = null) => {
+    post({ type: 'setClockCounter', mode, coords });
+  }, [post]);
+
+  const setLivelockWindow = useCallback((windowNS: number) => {
+    post({ type: 'setLivelockWindow', windowNS });
+  }, [post]);
+
+  const setHostProfiling = useCallback((enabled: boolean) => {
+    if (!enabled) coalescer.queue({ hostProfile: null });
+    post({ type: 'setHostProfiling', enabled });
+  }, [post, coalescer]);
+
+  /** Replace the watched RAM words. The worker streams their values every
+   *  intervalMs: each guest write in 'write' mode, changes in 'sample' mode. */
+  const setWatches = useCallback((targets: WatchTarget[], mode: WatchMode, intervalMs: number) => {
+    const buffer = watchBufferRef.current;
+    const id = buffer.id + 1;
+    buffer.reset(id, targets);
+    coalescer.queue({ watch: true });
+    post({ type: 'setWatches', id, targets, mode, intervalMs });
+  }, [post, coalescer]);
+
   const selectNode = useCallback((coord: number | null) => {
     setSelectedCoord(coord);
     post({ type: 'selectNode', coord });
   }, [post]);
 
   return {
-    snapshot,
     selectedCoord,
     isRunning,
     compileErrors,
@@ -166,6 +255,8 @@ export function useEmulator() {
     compiledProgram,
     bootStreamBytes,
     emulatorError,
+    stall,
+    activity,
     step,
     stepN,
     run,
@@ -173,6 +264,12 @@ export function useEmulator() {
     reset,
     compileAndLoad,
     sendSerialInput,
+    setDebugChannel,
+    setClockCounter,
+    setLivelockWindow,
+    setHostProfiling,
+    setWatches,
+    resetDebugLog,
     selectNode,
     setLanguage,
   };
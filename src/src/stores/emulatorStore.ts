@@ -0,0 +1,64 @@
+/**
+ * Zustand store for emulator output: chip totals, the selected node, the IO
+ * write ring and debug log, watched RAM values and the host profile.
+ *
+ * useEmulator writes it at most once per animation frame (see
+ * frameCoalescer.ts). Panels subscribe to the slice they draw, and a slice
+ * whose values did not change keeps its reference, so a running chip
+ * re-renders only what actually moved.
+ */
+import { create } from 'zustand';
+import { shallow } from 'zustand/shallow';
+import type { NodeSnapshot } from '../core/types';
+import type { DebugLogEntry } from '../core/debug-log';
+import type { HostProfileReport } from '../core/host-profile';
+import type { WatchView } from '../worker/watchBuffer';
+
+export interface ChipTotals {
+  activeCount: number;
+  totalSteps: number;
+  totalEnergyPJ: number;
+  chipPowerMW: number;
+  totalSimTimeNS: number;
+}
+
+/** Main-thread IO write ring. The arrays are updated in place, so
+ *  consumers key their effects on ioWriteSeq. */
+export interface IoWriteView {
+  ioWrites: number[];
+  ioWriteTimestamps: number[];
+  ioWriteStart: number;
+  ioWriteCount: number;
+  ioWriteSeq: number;
+}
+
+export interface EmulatorState {
+  /** False until the worker's first snapshot arrives. */
+  ready: boolean;
+  totals: ChipTotals;
+  selectedNode: NodeSnapshot | null;
+  io: IoWriteView;
+  debugEntries: DebugLogEntry[];
+  watch: WatchView;
+  hostProfile: HostProfileReport | null;
+}
+
+export const useEmulatorStore = create<EmulatorState>(() => ({
+  ready: false,
+  totals: { activeCount: 0, totalSteps: 0, totalEnergyPJ: 0, chipPowerMW: 0, totalSimTimeNS: 0 },
+  selectedNode: null,
+  io: { ioWrites: [], ioWriteTimestamps: [], ioWriteStart: 0, ioWriteCount: 0, ioWriteSeq: 0 },
+  debugEntries: [],
+  watch: { targets: [], samples: [], dropped: 0 },
+  hostProfile: null,
+}));
+
+/** Apply one frame's updates, skipping totals and IO views equal to the
+ *  current ones. */
+export function commitFrame(update: Partial<EmulatorState>): void {
+  const current = useEmulatorStore.getState();
+  const next: Partial<EmulatorState> = { ...update };
+  if (next.totals && shallow(next.totals, current.totals)) delete next.totals;
+  if (next.io && shallow(next.io, current.io)) delete next.io;
+  if (Object.keys(next).length > 0) useEmulatorStore.setState(next);
+}
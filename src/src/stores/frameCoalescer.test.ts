@@ -0,0 +1,59 @@
+import { describe, it, expect } from 'vitest';
+import { FrameCoalescer } from './frameCoalescer';
+
+interface Frame {
+  snapshot: number;
+  io: boolean;
+}
+
+/** Manual frame clock standing in for requestAnimationFrame. */
+function fakeFrames() {
+  const callbacks = new Map<number, () => void>();
+  let next = 1;
+  return {
+    schedule: (cb: () => void) => { callbacks.set(next, cb); return next++; },
+    unschedule: (id: number) => { callbacks.delete(id); },
+    pending: () => callbacks.size,
+    tick: () => {
+      const due = [...callbacks.values()];
+      callbacks.clear();
+      due.forEach(cb => cb());
+    },
+  };
+}
+
+describe('FrameCoalescer', () => {
+  it('merges a burst of updates into one flush with the latest values', () => {
+    const frames = fakeFrames();
+    const flushed: Partial<Frame>[] = [];
+    const coalescer = new FrameCoalescer<Frame>(u => flushed.push(u), frames.schedule, frames.unschedule);
+    coalescer.queue({ snapshot: 1 });
+    coalescer.queue({ io: true });
+    coalescer.queue({ snapshot: 2 });
+    expect(frames.pending()).toBe(1);
+    expect(flushed).toEqual([]);
+    frames.tick();
+    expect(flushed).toEqual([{ snapshot: 2, io: true }]);
+
+    // The next queue schedules a fresh frame holding only the new update
+    coalescer.queue({ snapshot: 3 });
+    frames.tick();
+    expect(flushed).toEqual([{ snapshot: 2, io: true }, { snapshot: 3 }]);
+    frames.tick();
+    expect(flushed).toHaveLength(2);
+  });
+
+  it('drops pending updates when cancelled', () => {
+    const frames = fakeFrames();
+    const flushed: Partial<Frame>[] = [];
+    const coalescer = new FrameCoalescer<Frame>(u => flushed.push(u), frames.schedule, frames.unschedule);
+    coalescer.queue({ snapshot: 1 });
+    coalescer.cancel();
+    expect(frames.pending()).toBe(0);
+    frames.tick();
+    expect(flushed).toEqual([]);
+    coalescer.queue({ io: true });
+    frames.tick();
+    expect(flushed).toEqual([{ io: true }]);
+  });
+});
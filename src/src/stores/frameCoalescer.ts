@@ -0,0 +1,43 @@
+/**
+ * Coalesces bursts of updates into one flush per animation frame.
+ *
+ * Producers queue partial updates as messages arrive; later values for a
+ * key replace earlier ones. The first queue after a flush schedules the
+ * next one, which receives everything queued since. A snapshot that is
+ * superseded within a frame is therefore never decoded or rendered.
+ */
+export class FrameCoalescer<T extends object> {
+  private pending: Partial<T> = {};
+  private frame: number | null = null;
+  private readonly flush: (update: Partial<T>) => void;
+  private readonly schedule: (cb: () => void) => number;
+  private readonly unschedule: (frame: number) => void;
+
+  constructor(
+    flush: (update: Partial<T>) => void,
+    schedule: (cb: () => void) => number = requestAnimationFrame,
+    unschedule: (frame: number) => void = cancelAnimationFrame,
+  ) {
+    this.flush = flush;
+    this.schedule = schedule;
+    this.unschedule = unschedule;
+  }
+
+  queue(update: Partial<T>): void {
+    Object.assign(this.pending, update);
+    if (this.frame !== null) return;
+    this.frame = this.schedule(() => {
+      this.frame = null;
+      const update = this.pending;
+      this.pending = {};
+      this.flush(update);
+    });
+  }
+
+  /** Drop anything queued (on unmount). */
+  cancel(): void {
+    if (this.frame !== null) this.unschedule(this.frame);
+    this.frame = null;
+    this.pending = {};
+  }
+}
@@ -0,0 +1,204 @@
+import React, { useEffect, useRef } from 'react';
+import { NODE_STATE_CODES, nodeStateCode } from '../../core/node-pack';
+import { NodeState } from '../../core/types';
+import { GA144_MESH } from '../../core/mesh';
+import { BOOT_NODES, ANALOG_NODES } from '../../core/constants';
+import type { ChipActivity } from '../../worker/chipActivity';
+import { NODE_COLORS } from '../theme';
+import { ActivityRates, HOT_TEMPERATURE, heatColor, maxOf } from './heatmap';
+
+/** Stall highlight: 'cycle' marks the reported wait-for cycle, 'involved'
+ *  any other node named in the stall report. */
+export type StallHighlight = 'cycle' | 'involved' | null;
+
+/** What the cell fill shows. */
+export type ChipLayer = 'state' | 'activity' | 'temperature';
+
+interface ChipCanvasProps {
+  activity: ChipActivity | null;
+  layer: ChipLayer;
+  showTraffic: boolean;
+  selectedCoord: number | null;
+  highlights: Map<number, StallHighlight>;
+  onNodeClick: (coord: number) => void;
+}
+
+const CELL = 26;
+const PITCH = CELL + 1;
+const STATE_FILL = NODE_STATE_CODES.map(s => NODE_COLORS[s]);
+const IDLE = nodeStateCode(NodeState.SUSPENDED);
+
+/**
+ * The node grid drawn on one canvas. A requestAnimationFrame loop reads the
+ * worker's shared activity buffer directly, so running the chip costs no
+ * React renders; props only change what is drawn. Row 0 is at the bottom.
+ */
+export const ChipCanvas: React.FC<ChipCanvasProps> = React.memo((props) => {
+  const { activity } = props;
+  const canvasRef = useRef<HTMLCanvasElement>(null);
+  const propsRef = useRef(props);
+  const dirtyRef = useRef(true);
+  useEffect(() => {
+    propsRef.current = props;
+    dirtyRef.current = true;
+  });
+
+  const mesh = activity?.mesh ?? GA144_MESH;
+  const width = mesh.cols * PITCH - 1;
+  const height = mesh.rows * PITCH - 1;
+
+  useEffect(() => {
+    const canvas = canvasRef.current;
+    const ctx = canvas?.getContext('2d');
+    if (!canvas || !ctx) return;
+    const dpr = window.devicePixelRatio || 1;
+    canvas.width = width * dpr;
+    canvas.height = height * dpr;
+    ctx.setTransform(dpr, 0, 0, dpr, 0, 0);
+
+    const source = activity;
+    const rates = source ? new ActivityRates(mesh.numNodes, source.transfers.length) : null;
+    let generation = -1;
+    let lastFrame = performance.now();
+    let frame = 0;
+
+    const cellX = (index: number) => (mesh.indexToCoord(index) % 100) * PITCH;
+    const cellY = (index: number) => (mesh.rows - 1 - Math.floor(mesh.indexToCoord(index) / 100)) * PITCH;
+
+    const draw = () => {
+      const { layer, showTraffic, selectedCoord, highlights } = propsRef.current;
+      ctx.fillStyle = '#0a0a0a';
+      ctx.fillRect(0, 0, width, height);
+      const peakRate = rates ? maxOf(rates.nodeRate, 1e-9) : 1;
+
+      ctx.font = '7px monospace';
+      ctx.textAlign = 'center';
+      ctx.textBaseline = 'middle';
+      for (let i = 0; i < mesh.numNodes; i++) {
+        const coord = mesh.indexToCoord(i);
+        const x = cellX(i);
+        const y = cellY(i);
+        const state = source ? source.states[i] : IDLE;
+        if (layer === 'state' || !source || !rates) {
+          ctx.fillStyle = STATE_FILL[state];
+        } else if (layer === 'activity') {
+          ctx.fillStyle = heatColor(rates.nodeRate[i] / peakRate);
+        } else {
+          ctx.fillStyle = heatColor(source.temperature[i] / HOT_TEMPERATURE);
+        }
+        ctx.fillRect(x, y, CELL, CELL);
+        if (layer !== 'state') {
+          ctx.fillStyle = STATE_FILL[state];
+          ctx.fillRect(x + 2, y + 2, 4, 4);
+        }
+
+        const selected = coord === selectedCoord;
+        const stall = highlights.get(coord) ?? null;
+        ctx.setLineDash(!selected && stall === 'involved' ? [3, 2] : []);
+        ctx.lineWidth = selected || stall === 'cycle' ? 2 : 1;
+        ctx.strokeStyle = selected ? NODE_COLORS.selected : stall ? NODE_COLORS.stalled : '#333';
+        ctx.strokeRect(x + ctx.lineWidth / 2, y + ctx.lineWidth / 2, CELL - ctx.lineWidth, CELL - ctx.lineWidth);
+
+        ctx.fillStyle = '#fff';
+        ctx.font = selected ? 'bold 7px monospace' : '7px monospace';
+        ctx.fillText(coord.toString().padStart(3, '0'), x + CELL / 2, y + CELL / 2);
+        if (mesh.standard && BOOT_NODES.includes(coord)) dot(ctx, x + CELL - 2, y + 2, '#FF5722');
+        if (mesh.standard && ANALOG_NODES.includes(coord)) dot(ctx, x + CELL - 2, y + CELL - 2, '#9C27B0');
+      }
+      ctx.setLineDash([]);
+
+      if (showTraffic && source && rates) {
+        const peakLink = maxOf(rates.linkRate, 1e-9);
+        const { chanFrom, chanTo } = source.links;
+        for (let c = 0; c < rates.linkRate.length; c++) {
+          const t = rates.linkRate[c] / peakLink;
+          if (t < 0.02) continue;
+          arrow(ctx, cellX(chanFrom[c]), cellY(chanFrom[c]), cellX(chanTo[c]), cellY(chanTo[c]), t);
+        }
+      }
+    };
+
+    const tick = (now: number) => {
+      frame = requestAnimationFrame(tick);
+      const frameMS = now - lastFrame;
+      lastFrame = now;
+      if (source && rates) {
+        const gen = source.generation;
+        if (gen !== generation) {
+          generation = gen;
+          dirtyRef.current = true;
+        }
+        if (rates.update(source.steps, source.transfers, now, frameMS)) dirtyRef.current = true;
+      }
+      if (!dirtyRef.current) return;
+      dirtyRef.current = false;
+      draw();
+    };
+    frame = requestAnimationFrame(tick);
+    return () => cancelAnimationFrame(frame);
+  }, [activity, mesh, width, height]);
+
+  const coordAt = (e: React.MouseEvent<HTMLCanvasElement>): number | null => {
+    const rect = e.currentTarget.getBoundingClientRect();
+    const px = e.clientX - rect.left;
+    const py = e.clientY - rect.top;
+    if (px % PITCH >= CELL || py % PITCH >= CELL) return null;
+    const col = Math.floor(px / PITCH);
+    const row = mesh.rows - 1 - Math.floor(py / PITCH);
+    return col >= 0 && col < mesh.cols && row >= 0 && row < mesh.rows ? row * 100 + col : null;
+  };
+
+  const describe = (coord: number): string => {
+    if (!activity) return `${coord}`;
+    const i = mesh.coordToIndex(coord);
+    const state = NODE_STATE_CODES[activity.states[i]];
+    const stall = props.highlights.get(coord) ? ', stalled' : '';
+    return `${coord} (${state}${stall}) — temperature ${activity.temperature[i].toFixed(2)}`;
+  };
+
+  return (
+    <canvas
+      ref={canvasRef}
+      style={{ width, height, display: 'block', cursor: 'pointer' }}
+      onClick={(e) => {
+        const coord = coordAt(e);
+        if (coord !== null) props.onNodeClick(coord);
+      }}
+      onMouseMove={(e) => {
+        const coord = coordAt(e);
+        e.currentTarget.title = coord !== null ? describe(coord) : '';
+      }}
+    />
+  );
+});
+
+function dot(ctx: CanvasRenderingContext2D, x: number, y: number, color: string): void {
+  ctx.fillStyle = color;
+  ctx.beginPath();
+  ctx.arc(x, y, 2, 0, Math.PI * 2);
+  ctx.fill();
+}
+
+/** Traffic arrow between two cells, offset to the right of its direction so
+ *  the two channels of a link sit side by side. */
+function arrow(ctx: CanvasRenderingContext2D, x0: number, y0: number, x1: number, y1: number, t: number): void {
+  const dx = Math.sign(x1 - x0);
+  const dy = Math.sign(y1 - y0);
+  const cx = CELL / 2 - dy * 4;
+  const cy = CELL / 2 + dx * 4;
+  const ax = x0 + cx + dx * (CELL / 2 - 4);
+  const ay = y0 + cy + dy * (CELL / 2 - 4);
+  const bx = x1 + cx - dx * (CELL / 2 - 4);
+  const by = y1 + cy - dy * (CELL / 2 - 4);
+  ctx.strokeStyle = ctx.fillStyle = `rgba(0, 229, 255, ${0.35 + 0.65 * t})`;
+  ctx.lineWidth = 1 + 2 * t;
+  ctx.beginPath();
+  ctx.moveTo(ax, ay);
+  ctx.lineTo(bx, by);
+  ctx.stroke();
+  ctx.beginPath();
+  ctx.moveTo(bx + dx * 3, by + dy * 3);
+  ctx.lineTo(bx - dx * 2 - dy * 3, by - dy * 2 + dx * 3);
+  ctx.lineTo(bx - dx * 2 + dy * 3, by - dy * 2 - dx * 3);
+  ctx.fill();
+}
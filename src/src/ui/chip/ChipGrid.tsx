@@ -1,52 +1,130 @@
-import React from 'react';
-import { Box, Typography, Paper } from '@mui/material';
-import { NodeCell } from './NodeCell';
-import { NodeState } from '../../core/types';
-import { coordToIndex } from '../../core/constants';
+import React, { useMemo, useState } from 'react';
+import { Box, Typography, Paper, Select, MenuItem, Checkbox, FormControlLabel } from '@mui/material';
+import { ChipCanvas } from './ChipCanvas';
+import type { ChipLayer, StallHighlight } from './ChipCanvas';
+import type { StallReport } from '../../core/deadlock';
+import type { ChipActivity } from '../../worker/chipActivity';
+import { NODE_COLORS } from '../theme';
+import { HEAT_RAMP } from './heatmap';
 
 interface ChipGridProps {
-  nodeStates: NodeState[];
-  nodeCoords: number[];
+  activity: ChipActivity | null;
   selectedCoord: number | null;
+  stall?: StallReport | null;
   onNodeClick: (coord: number) => void;
+  onSetLivelockWindow?: (windowNS: number) => void;
 }
 
-export const ChipGrid: React.FC<ChipGridProps> = ({ nodeStates, selectedCoord, onNodeClick }) => {
-  // Render grid: row 7 at top, row 0 at bottom, cols 0-17 left to right
-  const rows = [];
-  for (let row = 7; row >= 0; row--) {
-    const cells = [];
-    for (let col = 0; col <= 17; col++) {
-      const coord = row * 100 + col;
-      const index = coordToIndex(coord);
-      cells.push(
-        <NodeCell
-          key={coord}
-          coord={coord}
-          state={nodeStates[index]}
-          isSelected={selectedCoord === coord}
-          onClick={onNodeClick}
-        />
-      );
-    }
-    rows.push(
-      <Box key={row} sx={{ display: 'flex', gap: '1px' }}>
-        {cells}
-      </Box>
-    );
+/** Livelock window choices in guest nanoseconds (0 = off). */
+const LIVELOCK_WINDOWS: { ns: number; label: string }[] = [
+  { ns: 0, label: 'off' },
+  { ns: 1e6, label: '1 ms' },
+  { ns: 10e6, label: '10 ms' },
+  { ns: 100e6, label: '100 ms' },
+];
+
+const LAYERS: { layer: ChipLayer; label: string; low: string; high: string }[] = [
+  { layer: 'state', label: 'state', low: '', high: '' },
+  { layer: 'activity', label: 'activity', low: 'idle', high: 'busiest' },
+  { layer: 'temperature', label: 'temperature', low: 'ambient', high: 'hot' },
+];
+
+const HEAT_GRADIENT = `linear-gradient(to right, ${HEAT_RAMP.filter((_, i) => i % 32 === 0 || i === 255).join(', ')})`;
+
+const selectSx = { fontSize: '10px', height: 20, '& .MuiSelect-select': { py: 0, px: 0.75 } };
+
+function describeStall(stall: StallReport): string {
+  const pad = (c: number) => c.toString().padStart(3, '0');
+  if (stall.kind === 'livelock') {
+    return `Livelock: ${stall.coords.map(pad).join(', ')} spinning without IO`;
   }
+  const chain = stall.cycle.map(pad).join(' → ');
+  const closed = stall.cycleClosed ? ` → ${pad(stall.cycle[0])}` : ' → (unconnected port)';
+  return `Deadlock: ${chain}${closed}`;
+}
+
+/** Node grid with state, activity or temperature fill and optional link
+ *  traffic arrows. Memoised: running the chip re-renders nothing here, the
+ *  canvas animates itself from the shared activity buffer. */
+export const ChipGrid: React.FC<ChipGridProps> = React.memo(({
+  activity, selectedCoord, stall = null, onNodeClick, onSetLivelockWindow,
+}) => {
+  const [livelockWindow, setLivelockWindow] = useState(0);
+  const [layer, setLayer] = useState<ChipLayer>('state');
+  const [showTraffic, setShowTraffic] = useState(false);
+  const layerInfo = LAYERS.find(l => l.layer === layer)!;
+
+  const highlights = useMemo(() => {
+    const map = new Map<number, StallHighlight>();
+    if (stall) {
+      for (const c of stall.coords) map.set(c, 'involved');
+      for (const c of stall.cycle) map.set(c, 'cycle');
+    }
+    return map;
+  }, [stall]);
 
   return (
     <Paper
       elevation={2}
       sx={{ p: 1, backgroundColor: '#0a0a0a', overflow: 'auto' }}
     >
-      <Typography variant="caption" sx={{ mb: 0.5, display: 'block', color: '#888' }}>
-        GA144 Chip — 8×18 Node Grid
-      </Typography>
-      <Box sx={{ display: 'flex', flexDirection: 'column', gap: '1px' }}>
-        {rows}
+      <Box sx={{ mb: 0.5, display: 'flex', alignItems: 'center', gap: 1 }}>
+        <Typography variant="caption" sx={{ color: '#888' }}>
+          GA144 Chip — 8×18 Node Grid
+        </Typography>
+        <Select
+          size="small"
+          value={layer}
+          onChange={(e) => setLayer(e.target.value as ChipLayer)}
+          sx={{ ...selectSx, ml: 'auto' }}
+        >
+          {LAYERS.map(l => (
+            <MenuItem key={l.layer} value={l.layer} sx={{ fontSize: '11px' }}>{l.label}</MenuItem>
+          ))}
+        </Select>
+        <FormControlLabel
+          control={<Checkbox size="small" checked={showTraffic} onChange={(e) => setShowTraffic(e.target.checked)} sx={{ p: 0.25 }} />}
+          label="traffic"
+          sx={{ mr: 0, '& .MuiFormControlLabel-label': { fontSize: '10px', color: '#888' } }}
+        />
+        {onSetLivelockWindow && (
+          <>
+            <Typography variant="caption" sx={{ color: '#666', fontSize: '10px' }}>
+              Livelock check
+            </Typography>
+            <Select
+              size="small"
+              value={livelockWindow}
+              onChange={(e) => {
+                const ns = Number(e.target.value);
+                setLivelockWindow(ns);
+                onSetLivelockWindow(ns);
+              }}
+              sx={selectSx}
+            >
+              {LIVELOCK_WINDOWS.map(w => (
+                <MenuItem key={w.ns} value={w.ns} sx={{ fontSize: '11px' }}>{w.label}</MenuItem>
+              ))}
+            </Select>
+          </>
+        )}
       </Box>
+      {stall && (
+        <Typography
+          variant="caption"
+          sx={{ mb: 0.5, display: 'block', color: NODE_COLORS.stalled, fontFamily: 'monospace' }}
+        >
+          {describeStall(stall)}
+        </Typography>
+      )}
+      <ChipCanvas
+        activity={activity}
+        layer={layer}
+        showTraffic={showTraffic}
+        selectedCoord={selectedCoord}
+        highlights={highlights}
+        onNodeClick={onNodeClick}
+      />
       <Box sx={{ mt: 0.5, display: 'flex', gap: 2, fontSize: '10px', color: '#888' }}>
         <Box sx={{ display: 'flex', alignItems: 'center', gap: 0.5 }}>
           <Box sx={{ width: 8, height: 8, backgroundColor: '#4CAF50', borderRadius: 1 }} /> Running
@@ -60,7 +138,14 @@ export const ChipGrid: React.FC<ChipGridProps> = ({ nodeStates, selectedCoord, o
         <Box sx={{ display: 'flex', alignItems: 'center', gap: 0.5 }}>
           <Box sx={{ width: 8, height: 8, backgroundColor: '#424242', borderRadius: 1 }} /> Idle
         </Box>
+        {layer !== 'state' && (
+          <Box sx={{ ml: 'auto', display: 'flex', alignItems: 'center', gap: 0.5 }}>
+            {layerInfo.low}
+            <Box sx={{ width: 60, height: 8, background: HEAT_GRADIENT, borderRadius: 1 }} />
+            {layerInfo.high}
+          </Box>
+        )}
       </Box>
     </Paper>
   );
-};
+});
@@ -0,0 +1,49 @@
+import { describe, it, expect } from 'vitest';
+import { ActivityRates, RATE_WINDOW_MS, HEAT_RAMP, heatColor, maxOf } from './heatmap';
+
+const FRAME = 1000 / 60;
+
+describe('ActivityRates', () => {
+  it('measures rates per window and eases the displayed values toward them', () => {
+    const rates = new ActivityRates(2, 1);
+    rates.update([0, 0], [0], 0, FRAME);
+    // 1000 instructions on node 0 and 50 words over the link in one window
+    expect(rates.update([1000, 0], [50], RATE_WINDOW_MS, FRAME)).toBe(true);
+    expect(rates.nodeRate[0]).toBeCloseTo(10 * 0.25);
+    expect(rates.linkRate[0]).toBeCloseTo(0.5 * 0.25);
+
+    let now = RATE_WINDOW_MS;
+    for (let i = 0; i < 5; i++) rates.update([1000, 0], [50], now += FRAME, FRAME);
+    expect(rates.nodeRate[0]).toBeGreaterThan(2.5);
+    expect(rates.nodeRate[0]).toBeLessThan(10);
+    expect(rates.nodeRate[1]).toBe(0);
+
+    // Easing settles, then a window with no progress decays to zero
+    for (let i = 0; i < 100; i++) rates.update([1000, 0], [50], now += 0.01, FRAME);
+    expect(rates.nodeRate[0]).toBe(10);
+    let moving = true;
+    for (let i = 0; i < 200 && moving; i++) moving = rates.update([1000, 0], [50], now += FRAME, FRAME);
+    expect(moving).toBe(false);
+    expect(rates.nodeRate[0]).toBe(0);
+  });
+
+  it('treats counters going backwards after a reset as idle', () => {
+    const rates = new ActivityRates(1, 0);
+    rates.update([5000], [], 0, FRAME);
+    rates.update([0], [], RATE_WINDOW_MS, 1000);
+    expect(rates.nodeRate[0]).toBe(0);
+    rates.update([300], [], 2 * RATE_WINDOW_MS, 1000);
+    expect(rates.nodeRate[0]).toBeCloseTo(3);
+  });
+});
+
+describe('heat ramp', () => {
+  it('clamps intensities onto the ramp ends', () => {
+    expect(heatColor(-1)).toBe(HEAT_RAMP[0]);
+    expect(heatColor(0)).toBe('rgb(40,40,40)');
+    expect(heatColor(2)).toBe(HEAT_RAMP[255]);
+    expect(heatColor(NaN)).toBe(HEAT_RAMP[0]);
+    expect(maxOf(new Float64Array([0.5, 3, 1]), 1e-9)).toBe(3);
+    expect(maxOf(new Float64Array(2), 1e-9)).toBe(1e-9);
+  });
+});
@@ -0,0 +1,106 @@
+/**
+ * Heat map helpers for the chip grid canvas: per-node instruction rates and
+ * per-channel link rates sampled from the shared activity counters, eased
+ * frame by frame so the grid animates smoothly between samples, and a
+ * precomputed colour ramp.
+ */
+
+/** Window over which rates are measured (ms of host time). */
+export const RATE_WINDOW_MS = 100;
+
+/** Fraction of the remaining gap closed per 60 Hz frame while easing. */
+const EASE_PER_FRAME = 0.25;
+
+/** Temperature (thermal units) drawn at the top of the ramp; ~1.0 is a
+ *  node running flat out at steady state. */
+export const HOT_TEMPERATURE = 1.5;
+
+export class ActivityRates {
+  /** Eased instructions per host ms, per node. */
+  readonly nodeRate: Float64Array;
+  /** Eased words per host ms, per link channel. */
+  readonly linkRate: Float64Array;
+  private readonly nodeTarget: Float64Array;
+  private readonly linkTarget: Float64Array;
+  private readonly lastSteps: Float64Array;
+  private readonly lastTransfers: Float64Array;
+  private lastSampleMS: number | null = null;
+
+  constructor(numNodes: number, numChannels: number) {
+    this.nodeRate = new Float64Array(numNodes);
+    this.linkRate = new Float64Array(numChannels);
+    this.nodeTarget = new Float64Array(numNodes);
+    this.linkTarget = new Float64Array(numChannels);
+    this.lastSteps = new Float64Array(numNodes);
+    this.lastTransfers = new Float64Array(numChannels);
+  }
+
+  /**
+   * Take a new rate sample once RATE_WINDOW_MS has passed, then ease the
+   * displayed rates toward it. Counters going backwards (chip reset) count
+   * as zero. Returns true while the displayed rates are still moving.
+   */
+  update(steps: ArrayLike<number>, transfers: ArrayLike<number>, nowMS: number, frameMS: number): boolean {
+    if (this.lastSampleMS === null) {
+      this.lastSampleMS = nowMS;
+      copy(steps, this.lastSteps);
+      copy(transfers, this.lastTransfers);
+    } else if (nowMS - this.lastSampleMS >= RATE_WINDOW_MS) {
+      const dt = nowMS - this.lastSampleMS;
+      this.lastSampleMS = nowMS;
+      sampleRates(steps, this.lastSteps, this.nodeTarget, dt);
+      sampleRates(transfers, this.lastTransfers, this.linkTarget, dt);
+    }
+    const k = 1 - Math.pow(1 - EASE_PER_FRAME, frameMS / (1000 / 60));
+    const moving = ease(this.nodeRate, this.nodeTarget, k);
+    return ease(this.linkRate, this.linkTarget, k) || moving;
+  }
+}
+
+function copy(from: ArrayLike<number>, to: Float64Array): void {
+  for (let i = 0; i < to.length; i++) to[i] = from[i];
+}
+
+function sampleRates(counts: ArrayLike<number>, last: Float64Array, target: Float64Array, dtMS: number): void {
+  for (let i = 0; i < target.length; i++) {
+    const delta = counts[i] - last[i];
+    target[i] = delta > 0 ? delta / dtMS : 0;
+    last[i] = counts[i];
+  }
+}
+
+function ease(value: Float64Array, target: Float64Array, k: number): boolean {
+  let moving = false;
+  for (let i = 0; i < value.length; i++) {
+    const gap = target[i] - value[i];
+    if (Math.abs(gap) <= Math.abs(target[i]) * 1e-3 + 1e-6) {
+      value[i] = target[i];
+    } else {
+      value[i] += gap * k;
+      moving = true;
+    }
+  }
+  return moving;
+}
+
+/** Largest value in `values`, or `floor` if all are smaller. */
+export function maxOf(values: Float64Array, floor: number): number {
+  let max = floor;
+  for (let i = 0; i < values.length; i++) if (values[i] > max) max = values[i];
+  return max;
+}
+
+/** 256-step ramp: near black through red and orange to pale yellow. */
+export const HEAT_RAMP: readonly string[] = Array.from({ length: 256 }, (_, i) => {
+  const t = i / 255;
+  const r = Math.round(40 + 215 * Math.min(1, t * 2));
+  const g = Math.round(40 + 200 * Math.max(0, t * 1.6 - 0.6));
+  const b = Math.round(40 + 140 * Math.max(0, t * 2.5 - 1.5));
+  return `rgb(${r},${g},${b})`;
+});
+
+/** Ramp colour for an intensity, clamped to [0, 1]. */
+export function heatColor(intensity: number): string {
+  const i = Math.round(Math.min(1, Math.max(0, intensity)) * 255);
+  return HEAT_RAMP[Number.isNaN(i) ? 0 : i];
+}
@@ -5,7 +5,7 @@ import FullscreenIcon from '@mui/icons-material/Fullscreen';
 import FullscreenExitIcon from '@mui/icons-material/FullscreenExit';
 import DownloadIcon from '@mui/icons-material/Download';
 import type { CubeProgram } from '../../core/cube/ast';
-import { layoutAST, filterSceneGraph } from './layoutEngine';
+import { layoutAST, filterSceneGraph, LayoutCache } from './layoutEngine';
 import type { SceneNode, PipeInfo } from './layoutEngine';
 import { CubeScene } from './CubeScene';
 import { sceneGraphToSVG } from './svgExport';
@@ -22,10 +22,12 @@ export function CubeRenderer({ ast }: CubeRendererProps) {
   const [hoveredPipeId, setHoveredPipeId] = useState<string | null>(null);
   const [focusStack, setFocusStack] = useState<string[]>([]);
 
+  // Relayouts reuse unchanged definitions and node groups from earlier passes
+  const [layoutCache] = useState(() => new LayoutCache());
   const fullSceneGraph = useMemo(() => {
     if (!ast) return { nodes: [], pipes: [] };
-    return layoutAST(ast);
-  }, [ast]);
+    return layoutAST(ast, layoutCache);
+  }, [ast, layoutCache]);
 
   const focusStackSafe = useMemo(() => {
     if (focusStack.length === 0) return focusStack;
@@ -14,7 +14,7 @@ import RedoIcon from '@mui/icons-material/Redo';
 import { useState } from 'react';
 import { useEditorStore, type ContextMenuState } from '../../stores/editorStore';
 import type { CubeProgram } from '../../core/cube/ast';
-import { layoutAST, filterSceneGraph } from './layoutEngine';
+import { layoutAST, filterSceneGraph, LayoutCache } from './layoutEngine';
 import type { SceneNode, PipeInfo, SceneGraph, GridCellInfo } from './layoutEngine';
 import { CubeScene } from './CubeScene';
 import { ContextMenu3D } from './ContextMenu3D';
@@ -147,11 +147,13 @@ export function WysiwygEditor() {
     startEditing,
   } = useEditorStore.getState();
 
+  // Relayouts reuse unchanged definitions and node groups from earlier passes
+  const [layoutCache] = useState(() => new LayoutCache());
   const fullSceneGraph = useMemo(() => {
     if (!ast) return { nodes: [], pipes: [] };
-    const sg = layoutAST(ast);
+    const sg = layoutAST(ast, layoutCache);
     return addPlaceholderNodes(sg, ast);
-  }, [ast]);
+  }, [ast, layoutCache]);
 
   const focusStackSafe = useMemo(() => {
     if (focusStack.length === 0) return focusStack;
@@ -0,0 +1,129 @@
+import { describe, it, expect } from 'vitest';
+import { tokenizeCube } from '../../core/cube/tokenizer';
+import { parseCube } from '../../core/cube/parser';
+import type { CubeProgram } from '../../core/cube/ast';
+import { layoutAST, LayoutCache } from './layoutEngine';
+import type { SceneGraph } from './layoutEngine';
+
+function parse(source: string): CubeProgram {
+  const { tokens } = tokenizeCube(source);
+  const { ast, errors } = parseCube(tokens);
+  expect(errors).toHaveLength(0);
+  return ast;
+}
+
+const SOURCE = `
+Bit = Lambda{}. zero + one
+/\\
+inc = lambda{a, b}. (plus{a=a, b=1, c=b})
+/\\
+dbl = lambda{a, b}. (plus{a=a, b=a, c=b} \\/ times{a=a, b=2, c=b})
+/\\
+inc{a=3, b=x}
+/\\
+y = 7
+`;
+
+const EDITED = SOURCE.replace('b=1', 'b=5');
+
+const MULTI = `
+node 0
+/\\
+inc = lambda{a, b}. (plus{a=a, b=1, c=b})
+/\\
+inc{a=1, b=x}
+/\\
+node 1
+/\\
+dbl = lambda{a, b}. (plus{a=a, b=a, c=b})
+/\\
+dbl{a=x, b=2}
+`;
+
+const byId = (sg: SceneGraph) => new Map(sg.nodes.map(n => [n.id, n]));
+
+describe('layoutAST scene IDs', () => {
+  it('derives IDs from AST paths, unique across the scene', () => {
+    const sg = layoutAST(parse(SOURCE));
+    const ids = sg.nodes.map(n => n.id);
+    expect(new Set(ids).size).toBe(ids.length);
+    expect(new Set(sg.pipes.map(p => p.id)).size).toBe(sg.pipes.length);
+    for (const id of ['typedef:i0', 'variant:i0.t1', 'def:i1', 'plane:i2.c1', 'app:i3', 'holder:i4', 'lit:i4.v']) {
+      expect(ids).toContain(id);
+    }
+    expect(byId(sg).get('def:i1')!.ports.map(p => p.id)).toEqual(['port:i1.p0', 'port:i1.p1']);
+  });
+
+  it('keeps IDs of untouched nodes when a literal is edited', () => {
+    const before = layoutAST(parse(SOURCE));
+    const after = layoutAST(parse(EDITED));
+    expect(after.nodes.map(n => n.id)).toEqual(before.nodes.map(n => n.id));
+    expect(after.pipes.map(p => p.id)).toEqual(before.pipes.map(p => p.id));
+  });
+
+  it('sets astPath on item-level nodes only', () => {
+    const nodes = byId(layoutAST(parse(SOURCE)));
+    expect(nodes.get('def:i1')!.astPath).toBe('i1');
+    expect(nodes.get('typedef:i0')!.astPath).toBe('i0');
+    expect(nodes.get('app:i3')!.astPath).toBe('i3');
+    expect(nodes.get('app:i1.c0.i0')!.astPath).toBe('i1.c0.i0');
+    expect(nodes.get('holder:i4')!.astPath).toBe('i4');
+    expect(nodes.get('lit:i4.v')!.astPath).toBeUndefined();
+    expect(nodes.get('plane:i1.c0')!.astPath).toBeUndefined();
+  });
+
+  it('points pipes from inline applications at the application node', () => {
+    const sg = layoutAST(parse('f{a=g{b=1}}'));
+    const pipe = sg.pipes.find(p => p.id === 'pipe:i0.a0.v')!;
+    expect(pipe.toNodeId).toBe('app:i0.a0.v');
+  });
+});
+
+describe('LayoutCache', () => {
+  it('lays out only the edited definition', () => {
+    const cache = new LayoutCache();
+    const first = layoutAST(parse(SOURCE), cache);
+    expect(cache.misses).toBe(3);
+
+    const second = layoutAST(parse(EDITED), cache);
+    expect(cache.hits).toBe(2);
+    expect(cache.misses).toBe(1);
+    expect(cache.size).toBe(3);
+
+    // Unchanged subtrees keep their objects; the edited one is new
+    const a = byId(first), b = byId(second);
+    expect(b.get('typedef:i0')).toBe(a.get('typedef:i0'));
+    expect(b.get('def:i2')).toBe(a.get('def:i2'));
+    expect(b.get('lit:i1.c0.i0.a1.v')).not.toBe(a.get('lit:i1.c0.i0.a1.v'));
+    expect(b.get('lit:i1.c0.i0.a1.v')!.label).toBe('5');
+  });
+
+  it('gives the same layout as an uncached pass', () => {
+    const cache = new LayoutCache();
+    for (const source of [SOURCE, EDITED, SOURCE.replace('y = 7', 'y = 7\n/\\\nz = 8'), MULTI, MULTI.replace('b=1', 'b=4')]) {
+      const cached = layoutAST(parse(source), cache);
+      const fresh = layoutAST(parse(source));
+      expect(cached.nodes.map(n => n.id)).toEqual(fresh.nodes.map(n => n.id));
+      cached.nodes.forEach((n, i) => {
+        n.position.forEach((v, k) => expect(v).toBeCloseTo(fresh.nodes[i].position[k], 9));
+      });
+      cached.pipes.forEach((p, i) => {
+        p.to.forEach((v, k) => expect(v).toBeCloseTo(fresh.pipes[i].to[k], 9));
+      });
+      expect(cached.gridCells).toEqual(fresh.gridCells);
+    }
+  });
+
+  it('reuses unchanged node groups and drops stale entries', () => {
+    const cache = new LayoutCache();
+    layoutAST(parse(MULTI), cache);
+    const groups = cache.size;
+    layoutAST(parse(MULTI.replace('b=2', 'b=3')), cache);
+    expect(cache.hits).toBeGreaterThan(0);
+    expect(cache.misses).toBeGreaterThan(0);
+    expect(cache.size).toBe(groups);
+
+    layoutAST(parse('x = 1'), cache);
+    expect(cache.size).toBe(0);
+  });
+});
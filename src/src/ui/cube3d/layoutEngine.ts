@@ -2,6 +2,10 @@
  * Layout engine: transforms a CubeProgram AST into a flat list of
  * positioned 3D objects (SceneGraph) for rendering.
  *
+ * Layout is incremental: self-contained subtrees (definitions and node
+ * groups) are cached in a LayoutCache between passes, so an edit lays out
+ * only the subtrees it changed and the containers above them.
+ *
  * Spatial semantics from the CUBE spec:
  *   X axis = conjunction (horizontal AND)
  *   Y axis = disjunction (vertical OR)
@@ -11,6 +15,9 @@ import type {
   CubeProgram, Conjunction, ConjunctionItem,
   PredicateDef, Application, Unification, Term, TypeDef,
 } from '../../core/cube/ast';
+import {
+  itemPath, clausePath, argPath, termPath, variantPath, paramPath, fieldPath, hashSubtree,
+} from '../../core/cube/ast-path';
 
 // ---- Scene graph types ----
 
@@ -157,11 +164,29 @@ function pipeColorsForDirection(dir: PipeDirection): [string, string] {
   }
 }
 
-// ---- ID generation ----
+// ---- Scene node IDs ----
+//
+// IDs are derived from AST paths (see core/cube/ast-path.ts), so an edit
+// keeps the IDs of everything it did not move in the tree, and React keeps
+// those objects mounted across relayouts.
+
+function sceneId(prefix: string, path: string): string {
+  return `${prefix}:${path}`;
+}
+
+/** Item paths ("i3", "i2.c1.i0") are what the editor's mutations take. */
+function isItemPath(path: string): boolean {
+  return /(^|\.)i\d+$/.test(path);
+}
+
+/** A conjunction item with its AST path. */
+interface PathedItem {
+  item: ConjunctionItem;
+  path: string;
+}
 
-let idCounter = 0;
-function nextId(prefix: string): string {
-  return `${prefix}_${idCounter++}`;
+function withPaths(conj: Conjunction, prefix: string): PathedItem[] {
+  return conj.items.map((item, i) => ({ item, path: prefix ? `${prefix}.${itemPath(i)}` : itemPath(i) }));
 }
 
 // ---- Scene graph filtering (for focus/drill-down) ----
@@ -237,15 +262,16 @@ const HOLDER_SIZE = 0.5;
 const LITERAL_SIZE = 0.6;
 const PORT_SIZE = 0.25;
 
-// ---- Main entry point ----
-
 // GA144 grid layout: node groups positioned by chip coordinate (YXX)
 const GRID_GAP = 1.0; // gap between grid cells
 const MIN_CELL_X = 4.0; // minimum horizontal cell size
 const MIN_CELL_Y = 3.0; // minimum vertical cell size
 
+
+type Bounds = { minX: number; maxX: number; minY: number; maxY: number; minZ: number; maxZ: number };
+
 /** Compute bounding box for a set of scene nodes. */
-function computeBounds(groupNodes: SceneNode[]): { minX: number; maxX: number; minY: number; maxY: number; minZ: number; maxZ: number } {
+function computeBounds(groupNodes: SceneNode[]): Bounds {
   let minX = Infinity, maxX = -Infinity, minY = Infinity, maxY = -Infinity, minZ = Infinity, maxZ = -Infinity;
   for (const n of groupNodes) {
     const [px, py, pz] = n.position;
@@ -260,26 +286,164 @@ function computeBounds(groupNodes: SceneNode[]): { minX: number; maxX: number; m
   return { minX, maxX, minY, maxY, minZ, maxZ };
 }
 
-/** Translate scene nodes and pipes by an offset vector. */
-function translateGroup(groupNodes: SceneNode[], groupPipes: PipeInfo[], dx: number, dy: number, dz: number) {
-  for (const n of groupNodes) {
-    n.position = [n.position[0] + dx, n.position[1] + dy, n.position[2] + dz];
-    for (const p of n.ports) {
-      p.worldPos = [p.worldPos[0] + dx, p.worldPos[1] + dy, p.worldPos[2] + dz];
+/** Copies of scene nodes and pipes moved by an offset vector. Cached
+ *  layouts are shared with earlier scene graphs, so they are never moved
+ *  in place. */
+function translateGroup(
+  groupNodes: SceneNode[], groupPipes: PipeInfo[], dx: number, dy: number, dz: number,
+): { nodes: SceneNode[]; pipes: PipeInfo[] } {
+  const move = (p: [number, number, number]): [number, number, number] => [p[0] + dx, p[1] + dy, p[2] + dz];
+  return {
+    nodes: groupNodes.map(n => ({
+      ...n,
+      position: move(n.position),
+      ports: n.ports.map(p => ({ ...p, worldPos: move(p.worldPos) })),
+    })),
+    pipes: groupPipes.map(p => ({ ...p, from: move(p.from), to: move(p.to) })),
+  };
+}
+
+// ---- Incremental layout ----
+
+/** A laid-out subtree and the origin it was placed at. */
+interface CachedLayout {
+  origin: [number, number, number];
+  nodes: SceneNode[];
+  pipes: PipeInfo[];
+  extent: LayoutExtent;
+  /** Node groups only: bounds of the group laid out at the zero origin. */
+  bounds?: Bounds;
+  /** Keys of the nested entries this layout was built from. */
+  children: string[];
+}
+
+/**
+ * Subtrees laid out by earlier layoutAST passes. Definitions and node
+ * groups are self-contained (each scopes its own variables), so their
+ * layout depends only on the subtree, its AST path, its parent and the
+ * program's constructor names. Entries are keyed by all four; a pass
+ * reuses an unchanged subtree, translating it if it moved, and lays out
+ * only the edited ones and the containers above them. Entries a pass did
+ * not use, directly or nested in a reused entry, are dropped when it ends.
+ *
+ * Keep one cache per view: reused subtrees keep their SceneNode objects,
+ * so React skips re-rendering them.
+ */
+export class LayoutCache {
+  private entries = new Map<string, CachedLayout>();
+  private used = new Set<string>();
+  /** Child keys of the entries being built, innermost last. */
+  private building: string[][] = [];
+  /** Subtrees reused and laid out during the last pass. */
+  hits = 0;
+  misses = 0;
+
+  get size(): number {
+    return this.entries.size;
+  }
+
+  beginPass(): void {
+    this.used.clear();
+    this.building = [];
+    this.hits = 0;
+    this.misses = 0;
+  }
+
+  endPass(): void {
+    for (const key of this.entries.keys()) {
+      if (!this.used.has(key)) this.entries.delete(key);
     }
   }
-  for (const p of groupPipes) {
-    p.from = [p.from[0] + dx, p.from[1] + dy, p.from[2] + dz];
-    p.to = [p.to[0] + dx, p.to[1] + dy, p.to[2] + dz];
+
+  /** The entry for `key`, marked as used by this pass. */
+  lookup(key: string): CachedLayout | undefined {
+    const entry = this.entries.get(key);
+    if (!entry) return undefined;
+    this.building.at(-1)?.push(key);
+    this.markUsed(key);
+    this.hits++;
+    return entry;
+  }
+
+  private markUsed(key: string): void {
+    this.used.add(key);
+    for (const child of this.entries.get(key)?.children ?? []) this.markUsed(child);
   }
+
+  /** Start building a new entry, to be finished by store(). */
+  beginEntry(): void {
+    this.building.push([]);
+  }
+
+  /** `entry` placed at `origin`: itself if it is already there, else a
+   *  translated copy that replaces it. */
+  moveTo(key: string, entry: CachedLayout, origin: [number, number, number]): CachedLayout {
+    const dx = origin[0] - entry.origin[0];
+    const dy = origin[1] - entry.origin[1];
+    const dz = origin[2] - entry.origin[2];
+    if (dx === 0 && dy === 0 && dz === 0) return entry;
+    const moved = { ...entry, ...translateGroup(entry.nodes, entry.pipes, dx, dy, dz), origin };
+    this.entries.set(key, moved);
+    return moved;
+  }
+
+  store(key: string, entry: Omit<CachedLayout, 'children'>): CachedLayout {
+    const stored = { ...entry, children: this.building.pop() ?? [] };
+    this.entries.set(key, stored);
+    this.building.at(-1)?.push(key);
+    this.used.add(key);
+    this.misses++;
+    return stored;
+  }
+}
+
+// Cache and constructor-set key of the layoutAST pass in progress
+let activeCache = new LayoutCache();
+let constructorKey = '';
+
+/** Lay out a self-contained subtree at `origin`, reusing the cached one
+ *  when `key` matches. */
+function layoutCached(
+  key: string,
+  origin: [number, number, number],
+  nodes: SceneNode[],
+  pipes: PipeInfo[],
+  build: (nodes: SceneNode[], pipes: PipeInfo[]) => LayoutExtent,
+): LayoutExtent {
+  let entry = activeCache.lookup(key);
+  if (entry) {
+    entry = activeCache.moveTo(key, entry, origin);
+  } else {
+    const subNodes: SceneNode[] = [];
+    const subPipes: PipeInfo[] = [];
+    activeCache.beginEntry();
+    const extent = build(subNodes, subPipes);
+    entry = activeCache.store(key, { origin, nodes: subNodes, pipes: subPipes, extent });
+  }
+  nodes.push(...entry.nodes);
+  pipes.push(...entry.pipes);
+  return entry.extent;
 }
 
-export function layoutAST(program: CubeProgram): SceneGraph {
-  idCounter = 0;
+// ---- Main entry point ----
+
+/**
+ * Lay out a program. Pass the same `cache` on every call for a view to
+ * make relayouts incremental; without one every subtree is laid out anew.
+ */
+export function layoutAST(program: CubeProgram, cache: LayoutCache = new LayoutCache()): SceneGraph {
+  activeCache = cache;
+  cache.beginPass();
+  try {
+    return layoutProgram(program);
+  } finally {
+    cache.endPass();
+  }
+}
+
+function layoutProgram(program: CubeProgram): SceneGraph {
   const nodes: SceneNode[] = [];
   const pipes: PipeInfo[] = [];
-  const holderPositions = new Map<string, [number, number, number]>();
-  const holderNodeIds = new Map<string, string>(); // variable name → node id
 
   // Collect constructor names from type definitions for coloring
   const constructorNames = new Set<string>();
@@ -290,14 +454,17 @@ export function layoutAST(program: CubeProgram): SceneGraph {
       }
     }
   }
+  constructorKey = [...constructorNames].join(',');
 
   // Split top-level items into groups by __node directives.
   // Items before the first __node go into an unnamed group.
   // Each __node starts a new group with that node number as label.
-  const groups: { label: string | null; coord: number | null; items: ConjunctionItem[] }[] = [];
-  let currentGroup: { label: string | null; coord: number | null; items: ConjunctionItem[] } = { label: null, coord: null, items: [] };
+  type Group = { label: string | null; coord: number | null; path: string | null; items: PathedItem[] };
+  const groups: Group[] = [];
+  let currentGroup: Group = { label: null, coord: null, path: null, items: [] };
 
-  for (const item of program.conjunction.items) {
+  for (const pathed of withPaths(program.conjunction, '')) {
+    const item = pathed.item;
     if (item.kind === 'application' && item.functor === '__node') {
       // Start a new group
       if (currentGroup.items.length > 0 || currentGroup.label !== null) {
@@ -305,9 +472,9 @@ export function layoutAST(program: CubeProgram): SceneGraph {
       }
       const coordVal = item.args[0]?.value.kind === 'literal' ? item.args[0].value.value : null;
       const nodeNum = coordVal !== null ? String(coordVal) : '?';
-      currentGroup = { label: `node ${nodeNum}`, coord: coordVal, items: [] };
+      currentGroup = { label: `node ${nodeNum}`, coord: coordVal, path: pathed.path, items: [] };
     } else {
-      currentGroup.items.push(item);
+      currentGroup.items.push(pathed);
     }
   }
   if (currentGroup.items.length > 0 || currentGroup.label !== null) {
@@ -317,8 +484,8 @@ export function layoutAST(program: CubeProgram): SceneGraph {
   // If there's only one group (no node directives, or just one node),
   // lay out flat as before
   if (groups.length <= 1) {
-    const conj: Conjunction = { kind: 'conjunction', items: groups[0]?.items ?? program.conjunction.items, loc: program.conjunction.loc };
-    layoutConjunction(conj, [0, 0, 0], nodes, pipes, holderPositions, holderNodeIds, undefined, constructorNames, true);
+    const items = groups[0]?.items ?? [];
+    layoutConjunction(items, [0, 0, 0], nodes, pipes, new Map(), new Map(), undefined, constructorNames, true);
     return { nodes, pipes };
   }
 
@@ -327,15 +494,18 @@ export function layoutAST(program: CubeProgram): SceneGraph {
   // Pass 1: Lay out each group at the origin to measure actual size.
   // Pass 2: Compute per-column widths and per-row heights from actual
   //          bounding boxes, then position groups on the grid.
+  //
+  // Each group is a separate node's program, so it gets its own variable
+  // scope and is cached as one subtree.
 
   interface LayoutResult {
-    group: typeof groups[0];
+    group: Group;
     col: number;
     row: number;
     groupId: string;
-    groupNodes: SceneNode[];
-    groupPipes: PipeInfo[];
-    bounds: ReturnType<typeof computeBounds>;
+    cacheKey: string;
+    entry: CachedLayout;
+    bounds: Bounds;
     width: number;  // padded width
     height: number; // padded height
   }
@@ -352,19 +522,24 @@ export function layoutAST(program: CubeProgram): SceneGraph {
       row = Math.floor(group.coord / 100);
     }
 
-    const groupId = nextId('nodegroup');
-    const groupNodes: SceneNode[] = [];
-    const groupPipes: PipeInfo[] = [];
-    const conj: Conjunction = { kind: 'conjunction', items: group.items, loc: program.conjunction.loc };
-
-    // Layout at origin (0,0,0) — we'll translate later
-    layoutConjunction(conj, [0, 0, 0], groupNodes, groupPipes, holderPositions, holderNodeIds, groupId, constructorNames, true);
+    const groupId = sceneId('nodegroup', group.path ?? 'global');
+    const cacheKey = `group|${groupId}|${group.items[0].path}|${constructorKey}|${hashSubtree(group.items.map(p => p.item))}`;
+
+    // Layout at origin (0,0,0) — placed on the grid in pass 2
+    let entry = activeCache.lookup(cacheKey);
+    if (!entry) {
+      const groupNodes: SceneNode[] = [];
+      const groupPipes: PipeInfo[] = [];
+      activeCache.beginEntry();
+      const extent = layoutConjunction(group.items, [0, 0, 0], groupNodes, groupPipes, new Map(), new Map(), groupId, constructorNames, true);
+      entry = activeCache.store(cacheKey, { origin: [0, 0, 0], nodes: groupNodes, pipes: groupPipes, extent, bounds: computeBounds(groupNodes) });
+    }
 
-    const bounds = computeBounds(groupNodes);
+    const bounds = entry.bounds!;
     const width = Math.max((bounds.maxX - bounds.minX) + pad * 2, MIN_CELL_X);
     const height = Math.max((bounds.maxY - bounds.minY) + pad * 2, MIN_CELL_Y);
 
-    layoutResults.push({ group, col, row, groupId, groupNodes, groupPipes, bounds, width, height });
+    layoutResults.push({ group, col, row, groupId, cacheKey, entry, bounds, width, height });
   }
 
   // Compute per-column widths and per-row heights
@@ -396,7 +571,7 @@ export function layoutAST(program: CubeProgram): SceneGraph {
     yCursor += rowHeights.get(r)! + GRID_GAP;
   }
 
-  // Pass 2: translate each group to its grid cell and build containers
+  // Pass 2: move each group to its grid cell and build containers
   for (const r of layoutResults) {
     const cellX = colStart.get(r.col) ?? 0;
     const cellY = rowStart.get(r.row) ?? 0;
@@ -415,10 +590,14 @@ export function layoutAST(program: CubeProgram): SceneGraph {
     const dy = targetCenterY - contentCenterY;
     const dz = -contentCenterZ; // center Z at 0
 
-    translateGroup(r.groupNodes, r.groupPipes, dx, dy, dz);
+    const placed = activeCache.moveTo(r.cacheKey, r.entry, [dx, dy, dz]);
 
-    // Recompute bounds after translation
-    const finalBounds = computeBounds(r.groupNodes);
+    // Bounds after translation
+    const finalBounds: Bounds = {
+      minX: r.bounds.minX + dx, maxX: r.bounds.maxX + dx,
+      minY: r.bounds.minY + dy, maxY: r.bounds.maxY + dy,
+      minZ: r.bounds.minZ + dz, maxZ: r.bounds.maxZ + dz,
+    };
     const gw = (finalBounds.maxX - finalBounds.minX) + pad * 2;
     const gh = (finalBounds.maxY - finalBounds.minY) + pad * 2;
     const gd = (finalBounds.maxZ - finalBounds.minZ) + pad * 2;
@@ -440,8 +619,8 @@ export function layoutAST(program: CubeProgram): SceneGraph {
       ports: [],
     });
 
-    nodes.push(...r.groupNodes);
-    pipes.push(...r.groupPipes);
+    nodes.push(...placed.nodes);
+    pipes.push(...placed.pipes);
   }
 
   // Build grid cell info for placeholder rendering
@@ -466,7 +645,7 @@ export function layoutAST(program: CubeProgram): SceneGraph {
 // with each item offset in Z by the cumulative depth of prior items.
 
 function layoutConjunction(
-  conj: Conjunction,
+  items: PathedItem[],
   origin: [number, number, number],
   nodes: SceneNode[],
   pipes: PipeInfo[],
@@ -482,25 +661,24 @@ function layoutConjunction(
     let zCursor = origin[2];
 
     let i = 0;
-    while (i < conj.items.length) {
-      const item = conj.items[i];
+    while (i < items.length) {
+      const item = items[i].item;
 
       if (item.kind === 'predicate_def' || item.kind === 'type_def') {
         // Definition: own Z row
-        const ext = layoutItem(item, [origin[0], origin[1], zCursor], nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+        const ext = layoutItem(items[i], [origin[0], origin[1], zCursor], nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
         zCursor += ext.depth + TOP_LEVEL_SPACING_Z;
         i++;
       } else {
         // Invocation run: collect consecutive applications/unifications
         // and lay them out along X on the same Z row
         const runStart = i;
-        while (i < conj.items.length && conj.items[i].kind !== 'predicate_def' && conj.items[i].kind !== 'type_def') {
+        while (i < items.length && items[i].item.kind !== 'predicate_def' && items[i].item.kind !== 'type_def') {
           i++;
         }
-        const runItems = conj.items.slice(runStart, i);
-        const runConj: Conjunction = { kind: 'conjunction', items: runItems, loc: conj.loc };
+        const runItems = items.slice(runStart, i);
         // Lay out this run as a nested conjunction (along X with Z zigzag)
-        const ext = layoutConjunction(runConj, [origin[0], origin[1], zCursor], nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames, false);
+        const ext = layoutConjunction(runItems, [origin[0], origin[1], zCursor], nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames, false);
         zCursor += ext.depth + TOP_LEVEL_SPACING_Z;
       }
     }
@@ -518,17 +696,16 @@ function layoutConjunction(
   let totalDepth = 0;
   let rowItemCount = 0;
 
-  for (let i = 0; i < conj.items.length; i++) {
-    const item = conj.items[i];
+  for (let i = 0; i < items.length; i++) {
     // Alternate Z within a row for pipe routing
     const zOff = (rowItemCount % 2 === 1) ? ITEM_SPACING_Z : 0;
-    const ext = layoutItem(item, [xCursor, origin[1], zCursor + zOff], nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+    const ext = layoutItem(items[i], [xCursor, origin[1], zCursor + zOff], nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
     xCursor += ext.width + ITEM_SPACING_X;
     rowMaxDepth = Math.max(rowMaxDepth, zOff + ext.depth);
     rowItemCount++;
 
     // Wrap to next row if we've hit the limit (unless last item)
-    if (rowItemCount >= MAX_ROW_ITEMS && i < conj.items.length - 1) {
+    if (rowItemCount >= MAX_ROW_ITEMS && i < items.length - 1) {
       totalWidth = Math.max(totalWidth, xCursor - origin[0] - ITEM_SPACING_X);
       zCursor += rowMaxDepth + ITEM_SPACING_Z;
       totalDepth = zCursor - origin[2];
@@ -550,7 +727,7 @@ function layoutConjunction(
 // ---- Single item dispatch ----
 
 function layoutItem(
-  item: ConjunctionItem,
+  { item, path }: PathedItem,
   pos: [number, number, number],
   nodes: SceneNode[],
   pipes: PipeInfo[],
@@ -560,30 +737,40 @@ function layoutItem(
   constructorNames?: Set<string>,
 ): LayoutExtent {
   switch (item.kind) {
-    case 'predicate_def':
-      return layoutPredicateDef(item, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+    // Definitions scope their own variables: cache them as whole subtrees
+    case 'predicate_def': {
+      const def = item;
+      return layoutCached(defCacheKey(item, path, parentId), pos, nodes, pipes, (defNodes, defPipes) =>
+        layoutPredicateDef(def, path, pos, defNodes, defPipes, parentId, constructorNames));
+    }
+    case 'type_def': {
+      const typeDef = item;
+      return layoutCached(defCacheKey(item, path, parentId), pos, nodes, pipes, (defNodes) =>
+        layoutTypeDef(typeDef, path, pos, defNodes, parentId));
+    }
     case 'application':
-      return layoutApplication(item, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+      return layoutApplication(item, path, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
     case 'unification':
-      return layoutUnification(item, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
-    case 'type_def':
-      return layoutTypeDef(item, pos, nodes, parentId);
+      return layoutUnification(item, path, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
   }
 }
 
+function defCacheKey(def: PredicateDef | TypeDef, path: string, parentId?: string): string {
+  return `${def.kind}|${path}|${parentId ?? ''}|${constructorKey}|${hashSubtree(def)}`;
+}
+
 // ---- Predicate definition ----
 
 function layoutPredicateDef(
   def: PredicateDef,
+  path: string,
   origin: [number, number, number],
   nodes: SceneNode[],
   pipes: PipeInfo[],
-  _holderPositions: Map<string, [number, number, number]>,
-  _holderNodeIds: Map<string, string>,
   parentId?: string,
   constructorNames?: Set<string>,
 ): LayoutExtent {
-  const defId = nextId('def');
+  const defId = sceneId('def', path);
   const clauseNodes: SceneNode[][] = [];
   const clausePipes: PipeInfo[][] = [];
   let maxClauseWidth = 0;
@@ -606,7 +793,8 @@ function layoutPredicateDef(
     ];
 
     const ext = layoutConjunction(
-      def.clauses[i], innerOrigin, clauseSceneNodes, clauseScenePipes, localHolderPositions, localHolderNodeIds, defId, constructorNames,
+      withPaths(def.clauses[i], clausePath(path, i)), innerOrigin, clauseSceneNodes, clauseScenePipes,
+      localHolderPositions, localHolderNodeIds, defId, constructorNames,
     );
     maxClauseWidth = Math.max(maxClauseWidth, ext.width);
     maxClauseDepth = Math.max(maxClauseDepth, ext.depth);
@@ -614,7 +802,7 @@ function layoutPredicateDef(
     clausePipes.push(clauseScenePipes);
 
     // Plane box for this clause (Z sized to content depth)
-    const planeId = nextId('plane');
+    const planeId = sceneId('plane', clausePath(path, i));
     const planeDepth = ext.depth + DEF_DEPTH_PAD;
     nodes.push({
       id: planeId,
@@ -648,7 +836,7 @@ function layoutPredicateDef(
       origin[2],
     ];
     return {
-      id: nextId('port'),
+      id: sceneId('port', paramPath(path, i)),
       name: p.name,
       side: 'left' as const,
       offset: frac,
@@ -676,6 +864,7 @@ function layoutPredicateDef(
     opacity: 0.2,
     parentId,
     ports,
+    astPath: path,
   });
 
   // Add all clause nodes and pipes
@@ -694,11 +883,12 @@ const FIELD_SPACING_X = 1.2;
 
 function layoutTypeDef(
   typeDef: TypeDef,
+  path: string,
   origin: [number, number, number],
   nodes: SceneNode[],
   parentId?: string,
 ): LayoutExtent {
-  const defId = nextId('typedef');
+  const defId = sceneId('typedef', path);
   let maxVariantWidth = 0;
 
   // Layout each variant stacked on Y (sum type = disjunction)
@@ -708,7 +898,7 @@ function layoutTypeDef(
     const isNullary = variant.fields.length === 0;
 
     // Variant constructor node
-    const variantId = nextId('variant');
+    const variantId = sceneId('variant', variantPath(path, vi));
     const variantPos: [number, number, number] = [
       origin[0] + DEF_PADDING,
       variantY,
@@ -738,7 +928,7 @@ function layoutTypeDef(
         variantY,
         origin[2],
       ];
-      const fieldId = nextId('field');
+      const fieldId = sceneId('field', fieldPath(variantPath(path, vi), fi));
 
       const typeLabel = field.type.kind === 'type_var' ? field.type.name
         : field.type.kind === 'type_app' ? field.type.constructor
@@ -783,6 +973,7 @@ function layoutTypeDef(
     opacity: 0.15,
     parentId,
     ports: [],
+    astPath: path,
   });
 
   return { width: totalWidth, depth: typeDefDepth };
@@ -790,8 +981,14 @@ function layoutTypeDef(
 
 // ---- Application ----
 
+/** Scene ID of the application (or inline application term) at `path`. */
+function applicationId(functor: string, path: string, constructorNames?: Set<string>): string {
+  return sceneId(constructorNames?.has(functor) ? 'ctor' : 'app', path);
+}
+
 function layoutApplication(
   app: Application,
+  path: string,
   pos: [number, number, number],
   nodes: SceneNode[],
   pipes: PipeInfo[],
@@ -803,7 +1000,7 @@ function layoutApplication(
   if (app.functor === '__node') return { width: 0, depth: 0 }; // node directive is invisible
 
   const isConstructor = constructorNames?.has(app.functor) ?? false;
-  const appId = nextId(isConstructor ? 'ctor' : 'app');
+  const appId = applicationId(app.functor, path, constructorNames);
   const color = isConstructor ? COLORS.constructor : appColor(app.functor);
 
   // Scale the cube height based on arg count so ports don't overlap
@@ -824,7 +1021,7 @@ function layoutApplication(
       pos[2],
     ];
     return {
-      id: nextId('port'),
+      id: sceneId('port', argPath(path, i)),
       name: arg.name,
       side,
       offset: frac,
@@ -843,6 +1040,8 @@ function layoutApplication(
     opacity: 1,
     parentId,
     ports,
+    // Inline application terms have no item path the editor could act on
+    astPath: isItemPath(path) ? path : undefined,
   });
 
   // Layout arg values (holders, literals) and create pipes
@@ -852,7 +1051,7 @@ function layoutApplication(
     const port = ports[i];
     const dir = argDirection(app.functor, i);
     const [appEndColor, termEndColor] = pipeColorsForDirection(dir);
-    layoutTermForPort(arg.value, port, appId, pos, nodes, pipes, holderPositions, holderNodeIds, appId, constructorNames, appEndColor, termEndColor);
+    layoutTermForPort(arg.value, termPath(argPath(path, i)), port, appId, pos, nodes, pipes, holderPositions, holderNodeIds, appId, constructorNames, appEndColor, termEndColor);
   }
 
   return { width: APP_SIZE, depth: APP_SIZE };
@@ -862,6 +1061,7 @@ function layoutApplication(
 
 function layoutUnification(
   uni: Unification,
+  path: string,
   pos: [number, number, number],
   nodes: SceneNode[],
   pipes: PipeInfo[],
@@ -871,7 +1071,7 @@ function layoutUnification(
   constructorNames?: Set<string>,
 ): LayoutExtent {
   // Left holder for the variable
-  const holderId = nextId('holder');
+  const holderId = sceneId('holder', path);
   const holderPos: [number, number, number] = [pos[0], pos[1], pos[2]];
 
   nodes.push({
@@ -885,6 +1085,7 @@ function layoutUnification(
     opacity: 0.5,
     parentId,
     ports: [],
+    astPath: path,
   });
 
   holderPositions.set(uni.variable, holderPos);
@@ -892,11 +1093,11 @@ function layoutUnification(
 
   // Right side: the term
   const termPos: [number, number, number] = [pos[0] + 1.5, pos[1], pos[2]];
-  const termNodeId = layoutTerm(uni.term, termPos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+  const termNodeId = layoutTerm(uni.term, termPath(path), termPos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
 
   // Pipe from holder to term (unification = bidirectional)
   pipes.push({
-    id: nextId('pipe'),
+    id: sceneId('pipe', path),
     from: holderPos,
     to: termPos,
     color: COLORS.pipe_bidi,
@@ -914,6 +1115,7 @@ function layoutUnification(
 /** Returns the node ID of the created node (or null if no node was created) */
 function layoutTerm(
   term: Term,
+  path: string,
   pos: [number, number, number],
   nodes: SceneNode[],
   pipes: PipeInfo[],
@@ -926,7 +1128,7 @@ function layoutTerm(
     case 'var': {
       // Check if this is a nullary constructor (e.g. `true`, `nil`)
       if (constructorNames?.has(term.name)) {
-        const ctorId = nextId('ctor');
+        const ctorId = sceneId('ctor', path);
         nodes.push({
           id: ctorId,
           type: 'constructor',
@@ -945,11 +1147,11 @@ function layoutTerm(
       if (existing) {
         // Pipe to existing holder
         const existingNodeId = holderNodeIds.get(term.name);
-        pipes.push({ id: nextId('pipe'), from: pos, to: existing, color: COLORS.pipe_bidi, fromColor: COLORS.pipe_bidi, toColor: COLORS.pipe_bidi, toNodeId: existingNodeId });
+        pipes.push({ id: sceneId('pipe', path), from: pos, to: existing, color: COLORS.pipe_bidi, fromColor: COLORS.pipe_bidi, toColor: COLORS.pipe_bidi, toNodeId: existingNodeId });
         return existingNodeId ?? null;
       }
       // New holder
-      const holderId = nextId('holder');
+      const holderId = sceneId('holder', path);
       nodes.push({
         id: holderId,
         type: 'holder',
@@ -967,7 +1169,7 @@ function layoutTerm(
       return holderId;
     }
     case 'literal': {
-      const litId = nextId('lit');
+      const litId = sceneId('lit', path);
       nodes.push({
         id: litId,
         type: 'literal',
@@ -990,9 +1192,8 @@ function layoutTerm(
         args: term.args,
         loc: term.loc,
       };
-      layoutApplication(inlineApp, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
-      // The application node was just added as the last node
-      return nodes[nodes.length - 1]?.id ?? null;
+      layoutApplication(inlineApp, path, pos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+      return term.functor === '__node' ? null : applicationId(term.functor, path, constructorNames);
     }
     case 'rename':
       return null; // Rename terms are structural, not visual
@@ -1004,6 +1205,7 @@ function layoutTerm(
 
 function layoutTermForPort(
   term: Term,
+  path: string,
   port: PortInfo,
   appNodeId: string,
   parentPos: [number, number, number],
@@ -1022,12 +1224,13 @@ function layoutTermForPort(
     port.worldPos[1],
     parentPos[2],
   ];
+  const pipeId = sceneId('pipe', path);
 
   switch (term.kind) {
     case 'var': {
       // Check if this is a nullary constructor
       if (constructorNames?.has(term.name)) {
-        const ctorId = nextId('ctor');
+        const ctorId = sceneId('ctor', path);
         nodes.push({
           id: ctorId,
           type: 'constructor',
@@ -1040,17 +1243,17 @@ function layoutTermForPort(
           parentId,
           ports: [],
         });
-        pipes.push({ id: nextId('pipe'), from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: ctorId });
+        pipes.push({ id: pipeId, from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: ctorId });
         break;
       }
       const existing = holderPositions.get(term.name);
       if (existing) {
         // Pipe from port to existing holder
         const existingNodeId = holderNodeIds.get(term.name);
-        pipes.push({ id: nextId('pipe'), from: port.worldPos, to: existing, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: existingNodeId });
+        pipes.push({ id: pipeId, from: port.worldPos, to: existing, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: existingNodeId });
       } else {
         // New holder
-        const holderId = nextId('holder');
+        const holderId = sceneId('holder', path);
         nodes.push({
           id: holderId,
           type: 'holder',
@@ -1065,12 +1268,12 @@ function layoutTermForPort(
         });
         holderPositions.set(term.name, termPos);
         holderNodeIds.set(term.name, holderId);
-        pipes.push({ id: nextId('pipe'), from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: holderId });
+        pipes.push({ id: pipeId, from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: holderId });
       }
       break;
     }
     case 'literal': {
-      const litId = nextId('lit');
+      const litId = sceneId('lit', path);
       nodes.push({
         id: litId,
         type: 'literal',
@@ -1083,7 +1286,7 @@ function layoutTermForPort(
         parentId,
         ports: [],
       });
-      pipes.push({ id: nextId('pipe'), from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: litId });
+      pipes.push({ id: pipeId, from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: litId });
       break;
     }
     case 'app_term': {
@@ -1093,9 +1296,9 @@ function layoutTermForPort(
         args: term.args,
         loc: term.loc,
       };
-      layoutApplication(inlineApp, termPos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
-      const inlineAppNodeId = nodes[nodes.length - 1]?.id;
-      pipes.push({ id: nextId('pipe'), from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: inlineAppNodeId });
+      layoutApplication(inlineApp, path, termPos, nodes, pipes, holderPositions, holderNodeIds, parentId, constructorNames);
+      const inlineAppNodeId = term.functor === '__node' ? undefined : applicationId(term.functor, path, constructorNames);
+      pipes.push({ id: pipeId, from: port.worldPos, to: termPos, color: appEndColor, fromColor: appEndColor, toColor: termEndColor, fromNodeId: appNodeId, toNodeId: inlineAppNodeId });
       break;
     }
     case 'rename':
@@ -28,7 +28,7 @@ export const NodeDetailPanel: React.FC<NodeDetailPanelProps> = ({ node, sourceMa
   const stateColor = NODE_COLORS[node.state] || NODE_COLORS.suspended;
 
   // Find current CUBE source location from source map
-  const cubeLocation = sourceMap ? findCubeLocation(sourceMap, node.registers.P) : null;
+  const cubeLocation = sourceMap ? findCubeLocation(sourceMap, node.coord, node.registers.P) : null;
 
   return (
     <Paper elevation={2} sx={{ p: 1, height: '100%', overflow: 'auto' }}>
@@ -88,11 +88,11 @@ export const NodeDetailPanel: React.FC<NodeDetailPanelProps> = ({ node, sourceMa
   );
 };
 
-function findCubeLocation(sourceMap: SourceMapEntry[], pc: number): SourceMapEntry | null {
+function findCubeLocation(sourceMap: SourceMapEntry[], coord: number, pc: number): SourceMapEntry | null {
   // Find the source map entry whose addr is <= pc (the most recent one before this address)
   let best: SourceMapEntry | null = null;
   for (const entry of sourceMap) {
-    if (entry.addr <= pc) {
+    if (entry.coord === coord && entry.addr <= pc) {
       if (!best || entry.addr > best.addr) {
         best = entry;
       }
@@ -2,22 +2,27 @@ import React from 'react';
 import { Box } from '@mui/material';
 import { ChipGrid } from '../chip/ChipGrid';
 import { NodeDetailPanel } from '../detail/NodeDetailPanel';
-import type { NodeState, NodeSnapshot } from '../../core/types';
 import type { SourceMapEntry } from '../../core/cube/emitter';
+import type { StallReport } from '../../core/deadlock';
+import type { ChipActivity } from '../../worker/chipActivity';
+import { useEmulatorStore } from '../../stores/emulatorStore';
 
 interface EmulatorPanelProps {
-  nodeStates: NodeState[];
-  nodeCoords: number[];
+  activity: ChipActivity | null;
   selectedCoord: number | null;
-  selectedNode: NodeSnapshot | null;
   sourceMap: SourceMapEntry[] | null;
+  stall: StallReport | null;
   onNodeClick: (coord: number) => void;
+  onSetLivelockWindow: (windowNS: number) => void;
   compileOutput?: React.ReactNode;
+  watchPanel?: React.ReactNode;
 }
 
 export const EmulatorPanel: React.FC<EmulatorPanelProps> = ({
-  nodeStates, nodeCoords, selectedCoord, selectedNode, sourceMap, onNodeClick, compileOutput,
+  activity, selectedCoord, sourceMap, stall,
+  onNodeClick, onSetLivelockWindow, compileOutput, watchPanel,
 }) => {
+  const selectedNode = useEmulatorStore(s => s.selectedNode);
   return (
     <Box sx={{ height: '100%', display: 'flex', overflow: 'hidden' }}>
       <Box sx={{
@@ -28,14 +33,18 @@ export const EmulatorPanel: React.FC<EmulatorPanelProps> = ({
         p: 1,
       }}>
         <ChipGrid
-          nodeStates={nodeStates}
-          nodeCoords={nodeCoords}
+          activity={activity}
           selectedCoord={selectedCoord}
+          stall={stall}
           onNodeClick={onNodeClick}
+          onSetLivelockWindow={onSetLivelockWindow}
         />
       </Box>
-      <Box sx={{ flex: 1, overflow: 'auto' }}>
-        <NodeDetailPanel node={selectedNode} sourceMap={sourceMap} />
+      <Box sx={{ flex: 1, overflow: 'auto', display: 'flex', flexDirection: 'column' }}>
+        <Box sx={{ flex: 1, minHeight: 240 }}>
+          <NodeDetailPanel node={selectedNode} sourceMap={sourceMap} />
+        </Box>
+        {watchPanel}
       </Box>
       {compileOutput && (
         <Box sx={{
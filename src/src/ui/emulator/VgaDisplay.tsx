@@ -1,16 +1,8 @@
 import React, { useRef, useEffect, useState, useMemo, useCallback } from 'react';
 import { Box, Chip, TextField, Typography, Button } from '@mui/material';
-import {
-  detectResolution,
-  ResolutionTracker,
-  type Resolution,
-} from './vgaResolution';
-import {
-  renderIoWrites,
-  fillNoise,
-  createRenderState,
-  type VgaRenderState,
-} from './vgaRenderer';
+import type { Resolution } from './vgaResolution';
+import { fillNoise } from './vgaRenderer';
+import { VgaDecoder } from './vgaDecoder';
 
 // ---- Recording helpers ----
 
@@ -149,15 +141,20 @@ function initWebGL(canvas: HTMLCanvasElement): GlState | null {
 export const VgaDisplay: React.FC<VgaDisplayProps> = ({ ioWrites, ioWriteTimestamps, ioWriteCount, ioWriteStart, ioWriteSeq }) => {
   const canvasRef = useRef<HTMLCanvasElement>(null);
   const glStateRef = useRef<GlState | null>(null);
+  // The texture exists before WebGL does, so decoding never waits on GL init
   const texDataRef = useRef<Uint8Array>(new Uint8Array(0));
-  const texWRef = useRef(0);
-  const texHRef = useRef(0);
-  const renderStateRef = useRef<VgaRenderState>(createRenderState());
+  const texWRef = useRef(NOISE_W);
+  const texHRef = useRef(NOISE_H);
+  const decoderRef = useRef<VgaDecoder | null>(null);
+  if (decoderRef.current === null) {
+    texDataRef.current = new Uint8Array(NOISE_W * NOISE_H * 4);
+    fillNoise(texDataRef.current);
+    decoderRef.current = new VgaDecoder({ data: texDataRef.current, width: NOISE_W, height: NOISE_H });
+  }
   const dirtyRef = useRef(true);
   const vsyncPendingRef = useRef(false);
   const rafRef = useRef(0);
   const [pixelScale, setPixelScale] = useState(0);
-  const resTrackerRef = useRef(new ResolutionTracker());
 
   // ---- Recording state ----
   const [isRecording, setIsRecording] = useState(false);
@@ -214,16 +211,23 @@ export const VgaDisplay: React.FC<VgaDisplayProps> = ({ ioWrites, ioWriteTimesta
     }
   }, [isRecording]);
 
-  // ---- Resolution (stateful incremental tracker) ----
+  // ---- Decode (one streaming pass: sync timing, resolution, pixels) ----
+  // Rows go straight into the texture; the RAF loop uploads it when dirty.
 
   const resolution = useMemo<Resolution & { complete: boolean }>(() => {
-    return detectResolution(resTrackerRef.current, ioWrites, ioWriteCount, ioWriteStart, ioWriteSeq, ioWriteTimestamps);
+    const decoder = decoderRef.current!;
+    if (ioWriteCount > 0) {
+      const result = decoder.decode(ioWrites, ioWriteCount, ioWriteStart, ioWriteSeq, ioWriteTimestamps);
+      if (result.dirty) dirtyRef.current = true;
+      if (result.vsyncCount > 0) vsyncPendingRef.current = true;
+    }
+    return decoder.getResolution();
   }, [ioWrites, ioWriteCount, ioWriteStart, ioWriteSeq, ioWriteTimestamps]);
 
   const [hsyncHz, vsyncHz] = useMemo(() => {
-    const t = resTrackerRef.current;
-    return [t.hsyncHz, t.vsyncHz] as const;
-    // resolution is a dependency to ensure we re-read after detectResolution updates the tracker
+    const d = decoderRef.current!;
+    return [d.hsyncHz, d.vsyncHz] as const;
+    // resolution is a dependency to ensure we re-read after decode() updates the decoder
     // eslint-disable-next-line react-hooks/exhaustive-deps
   }, [resolution]);
 
@@ -254,16 +258,8 @@ export const VgaDisplay: React.FC<VgaDisplayProps> = ({ ioWrites, ioWriteTimesta
       if (!state) return null;
       glStateRef.current = state;
 
-      const w = texWRef.current || NOISE_W;
-      const h = texHRef.current || NOISE_H;
-      let data = texDataRef.current;
-      if (data.length !== w * h * 4) {
-        data = new Uint8Array(NOISE_W * NOISE_H * 4);
-        fillNoise(data);
-        texDataRef.current = data;
-        texWRef.current = NOISE_W;
-        texHRef.current = NOISE_H;
-      }
+      // Upload whatever has been decoded so far (noise until the first row)
+      const data = texDataRef.current;
 
       canvas.width = texWRef.current;
       canvas.height = texHRef.current;
@@ -340,39 +336,12 @@ export const VgaDisplay: React.FC<VgaDisplayProps> = ({ ioWrites, ioWriteTimesta
     };
   }, []);
 
-  // ---- Incremental pixel updates ----
-  // Delegates to the pure renderIoWrites() function for testability.
-
-  useEffect(() => {
-    if (!glStateRef.current || ioWriteCount === 0) return;
-
-    const result = renderIoWrites(
-      renderStateRef.current,
-      texDataRef.current,
-      texWRef.current,
-      texHRef.current,
-      ioWrites,
-      ioWriteCount,
-      ioWriteStart,
-      ioWriteSeq,
-      resolution.hasSyncSignals,
-      ioWriteTimestamps,
-    );
-    if (result.dirty) dirtyRef.current = true;
-    if (result.vsyncCount > 0) vsyncPendingRef.current = true;
-  }, [ioWriteCount, ioWriteSeq, ioWriteStart, resolution, ioWrites, ioWriteTimestamps]);
-
-  // Force full redraw when user changes scale/width settings
+  // Force full redraw when user changes scale/width settings: a reset
+  // decoder re-reads everything still in the ring on the next update
   useEffect(() => {
-    const rs = renderStateRef.current;
-    rs.forceFullRedraw = true;
-    rs.cursor.x = 0;
-    rs.cursor.y = 0;
-    rs.lastDrawnSeq = 0;
-    rs.hasReceivedSignal = false;
+    decoderRef.current!.reset();
     fillNoise(texDataRef.current);
     dirtyRef.current = true;
-    resTrackerRef.current.reset();
   }, [effectiveScale]);
 
   // ---- Render ----
@@ -0,0 +1,124 @@
+/**
+ * Tests for headless VGA frame capture and the PPM/PNG encoders.
+ */
+import { describe, it, expect } from 'vitest';
+import { inflateSync, deflateSync } from 'zlib';
+import { VgaFrameCapture, crc32, encodePpm, encodePng } from './vgaCapture';
+import type { VgaFrame } from './vgaCapture';
+import { IoBus } from '../../core/io-bus';
+import { DAC_XOR } from './vgaResolution';
+import { coordToIndex, VGA_NODE_R, VGA_NODE_G, VGA_NODE_B, VGA_NODE_SYNC } from '../../core/constants';
+
+const W = 640;
+const H = 480;
+const NS_PER_PIXEL = 14.3;
+
+/** Publish one frame of solid-colour rows (BGR per pixel, HSYNC per row, trailing VSYNC). */
+function publishFrame(bus: IoBus, rows: number, color: { r: number; g: number; b: number }, t0: number): number {
+  let t = t0;
+  const pub = (coord: number, value: number) => bus.publish(coordToIndex(coord), value, t, t);
+  for (let y = 0; y < rows; y++) {
+    for (let x = 0; x < W; x++) {
+      pub(VGA_NODE_B, color.b ^ DAC_XOR);
+      pub(VGA_NODE_G, color.g ^ DAC_XOR);
+      pub(VGA_NODE_R, color.r ^ DAC_XOR);
+      t += NS_PER_PIXEL;
+    }
+    pub(VGA_NODE_SYNC, 0x20000);
+  }
+  pub(VGA_NODE_SYNC, 0x30000);
+  return t + NS_PER_PIXEL;
+}
+
+function capture(chunked: boolean): VgaFrame[] {
+  const bus = new IoBus();
+  const frames: VgaFrame[] = [];
+  const cap = new VgaFrameCapture(bus, f => frames.push(f), W, H);
+  let t = 1000;
+  bus.publish(coordToIndex(VGA_NODE_SYNC), 0x30000, t, t);
+  const colors = [{ r: 0x1FF, g: 0, b: 0 }, { r: 0x1FF, g: 0, b: 0 }, { r: 0, g: 0, b: 0x1FF }];
+  for (const c of colors) {
+    t = publishFrame(bus, 4, c, t);
+    if (chunked) cap.flush();
+  }
+  cap.close();
+  return frames;
+}
+
+describe('crc32', () => {
+  it('matches the IEEE check value', () => {
+    expect(crc32(new TextEncoder().encode('123456789'))).toBe(0xCBF43926);
+  });
+
+  it('continues a previous result', () => {
+    const data = new TextEncoder().encode('123456789');
+    expect(crc32(data.subarray(4), crc32(data.subarray(0, 4)))).toBe(0xCBF43926);
+  });
+});
+
+describe('VgaFrameCapture', () => {
+  it('emits one frame per VSYNC with content-stable CRCs', () => {
+    const frames = capture(false);
+    expect(frames.map(f => f.index)).toEqual([0, 1, 2]);
+    expect(frames[0].crc).toBe(frames[1].crc);
+    expect(frames[2].crc).not.toBe(frames[0].crc);
+    expect(frames[1].timeNS).toBeGreaterThan(frames[0].timeNS);
+
+    const rgb = frames[0].rgb;
+    expect(rgb.length).toBe(W * H * 3);
+    expect([rgb[300], rgb[301], rgb[302]]).toEqual([255, 0, 0]);
+    // Rows below the drawn ones stay black
+    const below = (10 * W + 100) * 3;
+    expect([rgb[below], rgb[below + 1], rgb[below + 2]]).toEqual([0, 0, 0]);
+  });
+
+  it('produces the same frames when flushed per chunk', () => {
+    const whole = capture(false);
+    const chunked = capture(true);
+    expect(chunked.map(f => f.crc)).toEqual(whole.map(f => f.crc));
+  });
+
+  it('ignores writes after close', () => {
+    const bus = new IoBus();
+    const frames: VgaFrame[] = [];
+    const cap = new VgaFrameCapture(bus, f => frames.push(f), W, H);
+    cap.close();
+    publishFrame(bus, 2, { r: 0x1FF, g: 0x1FF, b: 0x1FF }, 0);
+    cap.flush();
+    expect(frames).toHaveLength(0);
+    expect(bus.hasSubscribers(coordToIndex(VGA_NODE_R))).toBe(false);
+  });
+});
+
+describe('frame encoders', () => {
+  const frame: VgaFrame = {
+    index: 0, timeNS: 0, width: 2, height: 2,
+    rgb: new Uint8Array([255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255]),
+    crc: 0,
+  };
+
+  it('writes a binary PPM', () => {
+    const ppm = encodePpm(frame);
+    const header = 'P6\n2 2\n255\n';
+    expect(new TextDecoder().decode(ppm.subarray(0, header.length))).toBe(header);
+    expect(Array.from(ppm.subarray(header.length))).toEqual(Array.from(frame.rgb));
+  });
+
+  it('writes a PNG with valid chunk CRCs and filtered scanlines', () => {
+    const png = encodePng(frame, data => deflateSync(data));
+    expect(Array.from(png.subarray(0, 8))).toEqual([0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A]);
+
+    const view = new DataView(png.buffer, png.byteOffset, png.byteLength);
+    const chunks: { type: string; data: Uint8Array }[] = [];
+    for (let off = 8; off < png.length;) {
+      const len = view.getUint32(off);
+      const type = String.fromCharCode(...png.subarray(off + 4, off + 8));
+      const data = png.subarray(off + 8, off + 8 + len);
+      expect(view.getUint32(off + 8 + len)).toBe(crc32(png.subarray(off + 4, off + 8 + len)));
+      chunks.push({ type, data });
+      off += 12 + len;
+    }
+    expect(chunks.map(c => c.type)).toEqual(['IHDR', 'IDAT', 'IEND']);
+    expect(Array.from(inflateSync(chunks[1].data))).toEqual([0, 255, 0, 0, 0, 255, 0, 0, 0, 0, 255, 255, 255, 255]);
+  });
+});
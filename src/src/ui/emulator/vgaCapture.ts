@@ -0,0 +1,150 @@
+/**
+ * Headless VGA capture — decodes the VGA nodes' IO writes off the IO bus
+ * into whole frames without React, WebGL or MediaRecorder.
+ *
+ * Writes from the DAC and sync nodes are buffered as they happen and fed
+ * to a VgaDecoder on flush(). At every VSYNC that ended at least one row
+ * the texture is copied out as an RGB frame with a CRC-32 and the texture
+ * is cleared to black, so each frame depends only on its own rows and
+ * golden comparisons are stable.
+ */
+import type { IoBus } from '../../core/io-bus';
+import { VGA_NODE_R, VGA_NODE_G, VGA_NODE_B, VGA_NODE_SYNC } from '../../core/constants';
+import { VgaDecoder } from './vgaDecoder';
+import { clearToBlack } from './vgaRenderer';
+import { crc32 } from '../../core/crc32';
+
+export { crc32 };
+
+export interface VgaFrame {
+  /** 0-based frame number. */
+  index: number;
+  /** Guest time (ns) of the VSYNC that ended the frame. */
+  timeNS: number;
+  width: number;
+  height: number;
+  /** Packed 8-bit RGB, row-major. */
+  rgb: Uint8Array;
+  /** CRC-32 of `rgb`. */
+  crc: number;
+}
+
+// ---- Capture ----
+
+export class VgaFrameCapture {
+  readonly width: number;
+  readonly height: number;
+  private readonly texData: Uint8Array;
+  private readonly decoder: VgaDecoder;
+  private writes: number[] = [];
+  private timestamps: number[] = [];
+  private seq = 0;
+  private frameCount = 0;
+  private unsubscribe: (() => void) | null;
+
+  constructor(bus: IoBus, onFrame: (frame: VgaFrame) => void, width = 640, height = 480) {
+    this.width = width;
+    this.height = height;
+    this.texData = new Uint8Array(width * height * 4);
+    clearToBlack(this.texData);
+    this.decoder = new VgaDecoder({ data: this.texData, width, height });
+    this.decoder.onFrameEnd = (timeNS) => {
+      if (this.decoder.cursorY === 0) return;  // no rows since the last VSYNC
+      onFrame(this.takeFrame(timeNS));
+    };
+    this.unsubscribe = bus.subscribe(
+      { coords: [VGA_NODE_R, VGA_NODE_G, VGA_NODE_B, VGA_NODE_SYNC] },
+      (coord, value, timeNS) => {
+        this.writes.push(coord * 0x40000 + value);
+        this.timestamps.push(timeNS);
+      },
+    );
+  }
+
+  /** Number of frames emitted so far. */
+  get frames(): number {
+    return this.frameCount;
+  }
+
+  /** Decode buffered writes, emitting any frames they complete. */
+  flush(): void {
+    const n = this.writes.length;
+    if (n === 0) return;
+    this.seq += n;
+    this.decoder.decode(this.writes, n, 0, this.seq, this.timestamps);
+    this.writes = [];
+    this.timestamps = [];
+  }
+
+  /** Flush and stop listening to the bus. */
+  close(): void {
+    this.flush();
+    this.unsubscribe?.();
+    this.unsubscribe = null;
+  }
+
+  private takeFrame(timeNS: number): VgaFrame {
+    const { width, height, texData } = this;
+    const rgb = new Uint8Array(width * height * 3);
+    for (let i = 0, j = 0; i < texData.length; i += 4, j += 3) {
+      rgb[j] = texData[i];
+      rgb[j + 1] = texData[i + 1];
+      rgb[j + 2] = texData[i + 2];
+    }
+    clearToBlack(texData);
+    return { index: this.frameCount++, timeNS, width, height, rgb, crc: crc32(rgb) };
+  }
+}
+
+// ---- Image encoders ----
+
+/** Binary PPM (P6). */
+export function encodePpm(frame: VgaFrame): Uint8Array {
+  const header = new TextEncoder().encode(`P6\n${frame.width} ${frame.height}\n255\n`);
+  const out = new Uint8Array(header.length + frame.rgb.length);
+  out.set(header);
+  out.set(frame.rgb, header.length);
+  return out;
+}
+
+/**
+ * 8-bit RGB PNG. `deflate` must produce a zlib stream (e.g. node's
+ * zlib.deflateSync); it is injected so this module stays browser-safe.
+ */
+export function encodePng(frame: VgaFrame, deflate: (data: Uint8Array) => Uint8Array): Uint8Array {
+  const { width, height, rgb } = frame;
+  const stride = width * 3;
+  // Each scanline is prefixed with filter type 0 (none)
+  const raw = new Uint8Array((stride + 1) * height);
+  for (let y = 0; y < height; y++) {
+    raw.set(rgb.subarray(y * stride, (y + 1) * stride), y * (stride + 1) + 1);
+  }
+
+  const ihdr = new Uint8Array(13);
+  const view = new DataView(ihdr.buffer);
+  view.setUint32(0, width);
+  view.setUint32(4, height);
+  ihdr[8] = 8;  // bit depth
+  ihdr[9] = 2;  // colour type: truecolour
+
+  const chunks = [pngChunk('IHDR', ihdr), pngChunk('IDAT', deflate(raw)), pngChunk('IEND', new Uint8Array(0))];
+  const signature = [0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A];
+  const out = new Uint8Array(signature.length + chunks.reduce((n, c) => n + c.length, 0));
+  out.set(signature);
+  let off = signature.length;
+  for (const c of chunks) {
+    out.set(c, off);
+    off += c.length;
+  }
+  return out;
+}
+
+function pngChunk(type: string, data: Uint8Array): Uint8Array {
+  const out = new Uint8Array(12 + data.length);
+  const view = new DataView(out.buffer);
+  view.setUint32(0, data.length);
+  for (let i = 0; i < 4; i++) out[4 + i] = type.charCodeAt(i);
+  out.set(data, 8);
+  view.setUint32(8 + data.length, crc32(out.subarray(4, 8 + data.length)));
+  return out;
+}
@@ -0,0 +1,412 @@
+/**
+ * Streaming VGA decoder — sync timing, resolution detection and pixel
+ * rendering in a single pass over the IO write ring.
+ *
+ * Every tagged write is consumed exactly once. State that spans calls (the
+ * in-progress row, a deferred HSYNC, line and frame counters) lives in the
+ * decoder, so a row split across two batches simply continues in the next
+ * call instead of being re-read. Finished rows are rasterized straight into
+ * the attached RGBA texture; the in-progress row is previewed at the width
+ * of the previous row.
+ */
+import { VGA_NODE_R, VGA_NODE_G, VGA_NODE_B, VGA_NODE_SYNC } from '../../core/constants';
+import {
+  PIN17_MASK,
+  PIN17_DRIVE_HIGH,
+  PIN17_DRIVE_LOW,
+  PIN17_PULLDOWN,
+  DAC_XOR,
+  type Resolution,
+} from './vgaResolution';
+import {
+  DAC_TO_8BIT,
+  fillNoise,
+  rasterizeRow,
+  rasterizeRowSequential,
+  type ChannelSamples,
+  type RenderResult,
+} from './vgaRenderer';
+
+/** R written within this many ns of an HSYNC belongs to the line before it
+ *  (same node step, just ordered after the sync node). */
+const SAME_STEP_NS = 10;
+
+const INITIAL_ROW_CAPACITY = 1024;
+
+/** RGBA target for decoded rows. */
+export interface VgaTexture {
+  data: Uint8Array;
+  width: number;
+  height: number;
+}
+
+class ChannelBuffer implements ChannelSamples {
+  ts = new Float64Array(INITIAL_ROW_CAPACITY);
+  val = new Uint8Array(INITIAL_ROW_CAPACITY);
+  n = 0;
+
+  push(ts: number, val: number): void {
+    if (this.n === this.ts.length) {
+      const ts2 = new Float64Array(this.n * 2);
+      const val2 = new Uint8Array(this.n * 2);
+      ts2.set(this.ts);
+      val2.set(this.val);
+      this.ts = ts2;
+      this.val = val2;
+    }
+    this.ts[this.n] = ts;
+    this.val[this.n] = val;
+    this.n++;
+  }
+
+  lastTs(): number {
+    return this.n > 0 ? this.ts[this.n - 1] : 0;
+  }
+}
+
+export class VgaDecoder {
+  // ---- Resolution (read by the UI) ----
+  /** Detected width (R-writes per line). */
+  width = 640;
+  /** Detected height (lines per frame). */
+  height = 480;
+  /** True once we have seen at least one sync signal. */
+  hasSyncSignals = false;
+  /** True once we have a VSYNC-confirmed frame size. */
+  complete = false;
+  /** HSYNC frequency in Hz (null if not enough data). */
+  hsyncHz: number | null = null;
+  /** VSYNC frequency in Hz (null if not enough data). */
+  vsyncHz: number | null = null;
+
+  // ---- Render state ----
+  /** Texture row the in-progress line will land on. */
+  cursorY = 0;
+  /** True once any R pixel has been decoded. */
+  hasReceivedSignal = false;
+  /** Sequence number of the next write to consume. */
+  processedSeq = 0;
+  /** Duration of the last finished row, used to place a partial row's
+   *  pixels at the right columns. */
+  lastRowDuration = 0;
+
+  /** Called at every VSYNC once the frame's last row is drawn, before the
+   *  cursor returns to the top. Headless capture snapshots the texture here. */
+  onFrameEnd: ((timeNS: number) => void) | null = null;
+
+  private texture: VgaTexture | null;
+
+  // ---- In-progress row ----
+  private rowR = new ChannelBuffer();
+  private rowG = new ChannelBuffer();
+  private rowB = new ChannelBuffer();
+  /** First pixel timestamp of the row (fallback row start). */
+  private rowStartTs = -1;
+  /** Active-period start: h-blank end or HSYNC time; -1 if unknown
+   *  (first row of the stream or after VSYNC). */
+  private rowRefTs = -1;
+  /** HSYNC seen but not yet assigned to a row boundary. */
+  private pendingHsyncTs = -1;
+  /** H-blank end seen since the last row break. */
+  private hblankEndTs = -1;
+
+  // ---- Line/frame counters for resolution ----
+  // Width counts R writes only and resolves a deferred HSYNC on the next R;
+  // row breaks resolve it on the next write of any kind, so the two keep
+  // their own pending state.
+  private rCountSinceHsync = 0;
+  private hsyncCountSinceVsync = 0;
+  private linePendingHsyncTs = -1;
+  private lastHsyncTs = -1;
+  private lastVsyncTs = -1;
+  /** First R-write timestamp, the start of the first frame for V-rate. */
+  private firstPixelTs = -1;
+
+  constructor(texture: VgaTexture | null = null) {
+    this.texture = texture;
+  }
+
+  /** Render into a different texture (or none for resolution-only use). */
+  attachTexture(texture: VgaTexture | null): void {
+    this.texture = texture;
+  }
+
+  /** Forget everything, as for a new stream. Does not touch the texture. */
+  reset(): void {
+    this.width = 640;
+    this.height = 480;
+    this.hasSyncSignals = false;
+    this.complete = false;
+    this.hsyncHz = null;
+    this.vsyncHz = null;
+    this.cursorY = 0;
+    this.hasReceivedSignal = false;
+    this.processedSeq = 0;
+    this.lastRowDuration = 0;
+    this.lastHsyncTs = -1;
+    this.lastVsyncTs = -1;
+    this.firstPixelTs = -1;
+    this.dropPartialState();
+  }
+
+  /** Discard the in-progress line, keeping confirmed resolution and clocks. */
+  private dropPartialState(): void {
+    this.clearRow(-1);
+    this.pendingHsyncTs = -1;
+    this.hblankEndTs = -1;
+    this.rCountSinceHsync = 0;
+    this.hsyncCountSinceVsync = 0;
+    this.linePendingHsyncTs = -1;
+  }
+
+  /**
+   * Consume IO writes up to `ioWriteSeq` from the ring. Rows are only
+   * buffered when a texture is attached and timestamps are given; otherwise
+   * just the resolution and sync clocks are tracked (without timestamps,
+   * HSYNCs apply immediately).
+   */
+  decode(
+    ioWrites: number[],
+    ioWriteCount: number,
+    ioWriteStart: number,
+    ioWriteSeq: number,
+    timestamps?: number[],
+  ): RenderResult {
+    const startSeq = ioWriteSeq - ioWriteCount;
+    const tex = timestamps ? this.texture : null;
+    let dirty = false;
+
+    // Stream reset (seq went backwards) — start over on a noisy screen
+    if (ioWriteSeq < this.processedSeq) {
+      this.reset();
+      if (tex) {
+        fillNoise(tex.data);
+        dirty = true;
+      }
+    }
+    // Data drop (ring overwrote unconsumed entries) — restart the frame
+    // from the oldest retained write
+    if (this.processedSeq < startSeq) {
+      this.dropPartialState();
+      this.cursorY = 0;
+      this.processedSeq = startSeq;
+    }
+
+    const cap = ioWrites.length;
+    let vsyncCount = 0;
+    for (let s = this.processedSeq; s < ioWriteSeq; s++) {
+      let pos = ioWriteStart + (s - startSeq);
+      if (pos >= cap) pos -= cap;
+      const tagged = ioWrites[pos];
+      const coord = (tagged / 0x40000) | 0;
+      const val = tagged & 0x3FFFF;
+      const ts = timestamps ? timestamps[pos] : NaN;
+
+      if (coord === VGA_NODE_SYNC) {
+        const pin = val & PIN17_MASK;
+        if (pin === PIN17_DRIVE_HIGH) {
+          this.onVsync(ts, timestamps !== undefined, tex);
+          vsyncCount++;
+          dirty = true;
+          continue;
+        }
+        if (pin === PIN17_DRIVE_LOW) {
+          this.hasSyncSignals = true;
+          if (timestamps) {
+            if (this.lastHsyncTs >= 0 && ts > this.lastHsyncTs) {
+              this.hsyncHz = 1e9 / (ts - this.lastHsyncTs);
+            }
+            this.lastHsyncTs = ts;
+            this.linePendingHsyncTs = ts;
+          } else {
+            this.applyLineHsync();
+          }
+          if (tex) this.pendingHsyncTs = ts;
+          continue;
+        }
+        if (pin === PIN17_PULLDOWN) {
+          // H-blank end: start of the active pixel period for the row that
+          // begins once the pending HSYNC is resolved
+          if (tex) this.hblankEndTs = ts;
+          continue;
+        }
+      }
+
+      if (!tex) {
+        if (coord === VGA_NODE_R) this.countR(ts, timestamps !== undefined);
+        continue;
+      }
+
+      // Resolve a deferred HSYNC into a row break
+      if (this.pendingHsyncTs >= 0) {
+        const hsTs = this.pendingHsyncTs;
+        const refTs = this.hblankEndTs >= 0 ? this.hblankEndTs : hsTs;
+        this.pendingHsyncTs = -1;
+        this.hblankEndTs = -1;
+        if (coord === VGA_NODE_R && Math.abs(ts - hsTs) <= SAME_STEP_NS) {
+          // Same step as HSYNC — this R ends the current row
+          this.pushPixel(coord, val, ts);
+          this.countR(ts, timestamps !== undefined);
+          this.finishRow(hsTs, tex);
+          this.clearRow(refTs);
+          dirty = true;
+          continue;
+        }
+        // Different step — HSYNC was a real line break
+        if (this.rowHasData()) {
+          this.finishRow(hsTs, tex);
+          dirty = true;
+        }
+        this.clearRow(refTs);
+      }
+
+      // Only DAC pixel writes (R, G, B nodes) affect rows; other IO writes
+      // (e.g. sync node blanking) would distort row timing
+      if (coord !== VGA_NODE_R && coord !== VGA_NODE_G && coord !== VGA_NODE_B) continue;
+      if (coord === VGA_NODE_R) this.countR(ts, timestamps !== undefined);
+      this.pushPixel(coord, val, ts);
+    }
+    this.processedSeq = ioWriteSeq;
+
+    if (tex && this.rowHasData()) {
+      this.previewRow(tex);
+      dirty = true;
+    }
+    return { dirty, vsyncCount };
+  }
+
+  /** Return a snapshot of the current resolution state. */
+  getResolution(): Resolution & { complete: boolean } {
+    return {
+      width: this.width,
+      height: this.height,
+      hasSyncSignals: this.hasSyncSignals,
+      complete: this.complete,
+    };
+  }
+
+  // ---- Sync handling ----
+
+  private onVsync(ts: number, timed: boolean, tex: VgaTexture | null): void {
+    this.hasSyncSignals = true;
+
+    // Resolution: close the frame, counting an in-progress line with pixels
+    if (this.linePendingHsyncTs >= 0) this.applyLineHsync();
+    const lines = this.hsyncCountSinceVsync + (this.rCountSinceHsync > 0 ? 1 : 0);
+    if (lines > 0) {
+      this.height = lines;
+      this.complete = true;
+    }
+    if (timed) {
+      const prevTs = this.lastVsyncTs >= 0 ? this.lastVsyncTs : this.firstPixelTs;
+      if (prevTs >= 0 && ts > prevTs) this.vsyncHz = 1e9 / (ts - prevTs);
+      this.lastVsyncTs = ts;
+    }
+    this.hsyncCountSinceVsync = 0;
+    this.rCountSinceHsync = 0;
+    this.linePendingHsyncTs = -1;
+
+    // Rendering: the current row ends at VSYNC and the next starts at the top
+    if (this.rowHasData()) this.finishRow(ts, tex);
+    if (this.onFrameEnd) this.onFrameEnd(ts);
+    this.pendingHsyncTs = -1;
+    this.clearRow(-1);
+    this.cursorY = 0;
+  }
+
+  private countR(ts: number, timed: boolean): void {
+    if (this.firstPixelTs < 0 && timed) this.firstPixelTs = ts;
+    if (this.linePendingHsyncTs >= 0) {
+      if (Math.abs(ts - this.linePendingHsyncTs) <= SAME_STEP_NS) {
+        // Same step — R belongs to the line before HSYNC
+        this.rCountSinceHsync++;
+        this.applyLineHsync();
+        return;
+      }
+      this.applyLineHsync();
+    }
+    this.rCountSinceHsync++;
+  }
+
+  private applyLineHsync(): void {
+    if (this.rCountSinceHsync > 0) this.width = this.rCountSinceHsync;
+    this.hsyncCountSinceVsync++;
+    this.rCountSinceHsync = 0;
+    this.linePendingHsyncTs = -1;
+  }
+
+  // ---- Row buffer ----
+
+  private pushPixel(coord: number, val: number, ts: number): void {
+    const decoded = DAC_TO_8BIT[(val & 0x1FF) ^ DAC_XOR];
+    if (this.rowStartTs < 0) this.rowStartTs = ts;
+    if (coord === VGA_NODE_R) {
+      this.hasReceivedSignal = true;
+      this.rowR.push(ts, decoded);
+    } else if (coord === VGA_NODE_G) {
+      this.rowG.push(ts, decoded);
+    } else {
+      this.rowB.push(ts, decoded);
+    }
+  }
+
+  private rowHasData(): boolean {
+    return this.rowR.n > 0 || this.rowG.n > 0 || this.rowB.n > 0;
+  }
+
+  private clearRow(refTs: number): void {
+    this.rowR.n = 0;
+    this.rowG.n = 0;
+    this.rowB.n = 0;
+    this.rowStartTs = -1;
+    this.rowRefTs = refTs;
+  }
+
+  /** Rasterize the finished row ending at endTs and advance the cursor. */
+  private finishRow(endTs: number, tex: VgaTexture | null): void {
+    // The h-blank end / HSYNC time is the VGA-correct active period start;
+    // the first pixel stands in for rows without one
+    const rowStart = this.rowRefTs >= 0 ? this.rowRefTs : this.rowStartTs;
+    const duration = endTs - rowStart;
+    if (duration > 0) this.lastRowDuration = duration;
+    if (!tex || this.cursorY >= tex.height) return;
+    if (duration > 0) {
+      rasterizeRow(tex.data, tex.width, this.cursorY, this.rowR, this.rowG, this.rowB,
+        rowStart, duration / tex.width, tex.width);
+    } else {
+      rasterizeRowSequential(tex.data, tex.width, this.cursorY, this.rowR, this.rowG, this.rowB);
+    }
+    this.cursorY++;
+  }
+
+  /** Draw the columns the in-progress row covers so far, without
+   *  advancing; the row is drawn in full once its HSYNC arrives. */
+  private previewRow(tex: VgaTexture): void {
+    if (this.cursorY >= tex.height) return;
+    const rowStart = this.rowRefTs >= 0 ? this.rowRefTs : this.rowStartTs;
+    const lastTs = Math.max(this.rowR.lastTs(), this.rowG.lastTs(), this.rowB.lastTs());
+    const span = lastTs - rowStart;
+    const reference = this.lastRowDuration > 0 ? this.lastRowDuration : span;
+    if (reference <= 0) {
+      rasterizeRowSequential(tex.data, tex.width, this.cursorY, this.rowR, this.rowG, this.rowB);
+      return;
+    }
+    const pixelDt = reference / tex.width;
+    const cols = Math.min(tex.width, Math.ceil(span / pixelDt) + 1);
+    rasterizeRow(tex.data, tex.width, this.cursorY, this.rowR, this.rowG, this.rowB, rowStart, pixelDt, cols);
+  }
+}
+
+/** Feed IO writes to a decoder and return the current resolution.
+ *  Pass the same decoder across calls for incremental updates. */
+export function detectResolution(
+  decoder: VgaDecoder,
+  ioWrites: number[],
+  count: number,
+  start: number,
+  ioWriteSeq: number,
+  timestamps?: number[],
+): Resolution & { complete: boolean } {
+  decoder.decode(ioWrites, count, start, ioWriteSeq, timestamps);
+  return decoder.getResolution();
+}
@@ -3,19 +3,16 @@ import { readFileSync } from 'fs';
 import { fileURLToPath } from 'url';
 import { dirname, join } from 'path';
 import {
-  renderIoWrites,
-  createRenderState,
   clearToBlack,
   DAC_TO_8BIT,
 } from './vgaRenderer';
 import {
   DAC_XOR,
-  detectResolution,
-  ResolutionTracker,
   readIoWrite,
   taggedCoord,
   isHsync as isHsyncCheck,
 } from './vgaResolution';
+import { VgaDecoder, detectResolution } from './vgaDecoder';
 import {
   VGA_NODE_R,
   VGA_NODE_G,
@@ -122,8 +119,8 @@ function buildFrame(rows: { r: number; g: number; b: number }[][]): { writes: nu
 /** Create a 640×480 test setup */
 function setup() {
   const texData = new Uint8Array(W * H * 4);
-  const state = createRenderState();
-  return { texData, state };
+  const decoder = new VgaDecoder({ data: texData, width: W, height: H });
+  return { texData, decoder };
 }
 
 // ---- Tests ----
@@ -131,10 +128,10 @@ function setup() {
 describe('vgaRenderer', () => {
   describe('basic pixel rendering with sync signals', () => {
     it('renders a row of solid red', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
       const { writes, timestamps } = buildFrame([solidRow(0x1FF, 0, 0)]);
 
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       expect(readPixel(texData, W, 0, 0)).toEqual({ r: 255, g: 0, b: 0, a: 255 });
       expect(readPixel(texData, W, 319, 0)).toEqual({ r: 255, g: 0, b: 0, a: 255 });
@@ -142,17 +139,17 @@ describe('vgaRenderer', () => {
     });
 
     it('renders a row of solid white', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
       const { writes, timestamps } = buildFrame([solidRow(0x1FF, 0x1FF, 0x1FF)]);
 
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       expect(readPixel(texData, W, 0, 0)).toEqual({ r: 255, g: 255, b: 255, a: 255 });
       expect(readPixel(texData, W, 639, 0)).toEqual({ r: 255, g: 255, b: 255, a: 255 });
     });
 
     it('renders a row with distinct pixel colors', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // Build a row: first half red, second half green
       const row: { r: number; g: number; b: number }[] = [];
@@ -160,7 +157,7 @@ describe('vgaRenderer', () => {
       for (let i = 0; i < 320; i++) row.push({ r: 0, g: 0x1FF, b: 0 });
 
       const { writes, timestamps } = buildFrame([row]);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       // Well within red region
       expect(readPixel(texData, W, 0, 0)).toEqual({ r: 255, g: 0, b: 0, a: 255 });
@@ -173,13 +170,13 @@ describe('vgaRenderer', () => {
 
   describe('HSYNC row advancement', () => {
     it('advances to next row on HSYNC', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
       const { writes, timestamps } = buildFrame([
         solidRow(0x1FF, 0, 0),
         solidRow(0, 0x1FF, 0),
       ]);
 
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
       expect(readPixel(texData, W, 0, 0).g).toBe(0);
@@ -188,7 +185,7 @@ describe('vgaRenderer', () => {
     });
 
     it('ignores HSYNC when no pixels have been written on the row', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // VSYNC, empty HSYNCs, then a full row, HSYNC, VSYNC
       const writes: number[] = [vsync(), hsync(), hsync()];
@@ -201,7 +198,7 @@ describe('vgaRenderer', () => {
       writes.push(hsync(), vsync());
       const ts = guestTimestamps(writes);
 
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, ts);
+      decoder.decode(writes, writes.length, 0, writes.length, ts);
 
       // Pixel should be on row 0 (empty HSYNCs don't advance)
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
@@ -211,7 +208,7 @@ describe('vgaRenderer', () => {
 
   describe('VSYNC handling', () => {
     it('resets cursor to (0,0) on VSYNC', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // Row 0: red, row 1: green, then VSYNC, then row 0: blue
       const writes: number[] = [];
@@ -228,7 +225,7 @@ describe('vgaRenderer', () => {
       }
       const ts = guestTimestamps(writes);
 
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, ts);
+      decoder.decode(writes, writes.length, 0, writes.length, ts);
 
       // After VSYNC, blue row overwrites row 0
       expect(readPixel(texData, W, 0, 0)).toEqual({ r: 0, g: 0, b: 255, a: 255 });
@@ -236,11 +233,11 @@ describe('vgaRenderer', () => {
     });
 
     it('does not clear to black when VSYNC is the last entry', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
       clearToBlack(texData);
 
       const { writes, timestamps } = buildFrame([solidRow(0x1FF, 0, 0)]);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       // Pixel was rendered — trailing VSYNC doesn't clear it
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
@@ -248,18 +245,18 @@ describe('vgaRenderer', () => {
     });
 
     it('preserves background when VSYNC has subsequent DAC writes', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // Fill with white
       for (let i = 0; i < texData.length; i += 4) {
         texData[i] = texData[i+1] = texData[i+2] = 255;
         texData[i+3] = 255;
       }
-      state.hasReceivedSignal = true;
+      decoder.hasReceivedSignal = true;
 
       // Render one red row
       const { writes, timestamps } = buildFrame([solidRow(0x1FF, 0, 0)]);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       // Row 0: red
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
@@ -271,7 +268,7 @@ describe('vgaRenderer', () => {
 
   describe('incremental rendering', () => {
     it('processes only new writes on incremental update', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // Batch 1: VSYNC + one red row + HSYNC
       const batch1Writes: number[] = [vsync()];
@@ -280,7 +277,7 @@ describe('vgaRenderer', () => {
       }
       batch1Writes.push(hsync());
       const ts1 = guestTimestamps(batch1Writes);
-      renderIoWrites(state, texData, W, H, batch1Writes, batch1Writes.length, 0, batch1Writes.length, true, ts1);
+      decoder.decode(batch1Writes, batch1Writes.length, 0, batch1Writes.length, ts1);
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
 
       // Batch 2: extends buffer with a green row
@@ -290,40 +287,59 @@ describe('vgaRenderer', () => {
       }
       batch2Writes.push(hsync());
       const ts2 = guestTimestamps(batch2Writes);
-      renderIoWrites(state, texData, W, H, batch2Writes, batch2Writes.length, 0, batch2Writes.length, true, ts2);
+      decoder.decode(batch2Writes, batch2Writes.length, 0, batch2Writes.length, ts2);
 
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
       expect(readPixel(texData, W, 0, 1).g).toBe(255);
     });
 
     it('triggers full redraw when data is dropped', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // Batch 1: red row
       const { writes: b1, timestamps: ts1 } = buildFrame([solidRow(0x1FF, 0, 0)]);
-      renderIoWrites(state, texData, W, H, b1, b1.length, 0, b1.length, true, ts1);
-      expect(state.lastDrawnSeq).toBe(b1.length);
+      decoder.decode(b1, b1.length, 0, b1.length, ts1);
+      expect(decoder.processedSeq).toBe(b1.length);
 
       // Batch 2: green row with a big gap in seq (data dropped)
       const { writes: b2, timestamps: ts2 } = buildFrame([solidRow(0, 0x1FF, 0)]);
       const fakeSeq = b1.length + 100000;
-      renderIoWrites(state, texData, W, H, b2, b2.length, 0, fakeSeq, true, ts2);
+      decoder.decode(b2, b2.length, 0, fakeSeq, ts2);
 
       // Full redraw from batch2: green
       expect(readPixel(texData, W, 0, 0).g).toBe(255);
       expect(readPixel(texData, W, 0, 0).r).toBe(0);
     });
+
+    it('renders the same image whether fed in one batch or many', () => {
+      const rows = [solidRow(0x1FF, 0, 0), solidRow(0, 0x1FF, 0), solidRow(0, 0, 0x1FF)];
+      rows[1][100] = { r: 0x1FF, g: 0x1FF, b: 0x1FF };
+      const { writes, timestamps } = buildFrame(rows);
+
+      const { texData: whole, decoder: wholeDecoder } = setup();
+      wholeDecoder.decode(writes, writes.length, 0, writes.length, timestamps);
+
+      // Chunk boundaries fall mid-row, so rows continue across calls
+      const { texData: chunked, decoder } = setup();
+      for (let n = 97; n < writes.length + 97; n += 97) {
+        const seq = Math.min(n, writes.length);
+        decoder.decode(writes, seq, 0, seq, timestamps);
+      }
+
+      expect(Array.from(chunked.subarray(0, 3 * W * 4))).toEqual(Array.from(whole.subarray(0, 3 * W * 4)));
+      expect(readPixel(chunked, W, 100, 1).r).toBe(255);
+    });
   });
 
   describe('row wrapping with sync signals', () => {
     it('wraps to next row via HSYNC', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
       const { writes, timestamps } = buildFrame([
         solidRow(0x1FF, 0, 0),
         solidRow(0, 0x1FF, 0),
       ]);
 
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
       expect(readPixel(texData, W, 639, 0).r).toBe(255);
@@ -334,7 +350,7 @@ describe('vgaRenderer', () => {
 
   describe('full frame rendering with CH.cube-like data', () => {
     it('renders a simplified Swiss flag pattern', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       const BLACK = { r: 0, g: 0, b: 0 };
       const RED   = { r: 0x1FF, g: 0, b: 0 };
@@ -361,7 +377,7 @@ describe('vgaRenderer', () => {
       }
 
       const { writes, timestamps } = buildFrame(rows);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       // Corners: black
       expect(readPixel(texData, W, 0, 0)).toEqual({ r: 0, g: 0, b: 0, a: 255 });
@@ -374,11 +390,11 @@ describe('vgaRenderer', () => {
     });
 
     it('preserves frame on trailing VSYNC after full frame', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       const rows = Array.from({ length: H }, () => solidRow(0x1FF, 0, 0));
       const { writes, timestamps } = buildFrame(rows);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, timestamps);
+      decoder.decode(writes, writes.length, 0, writes.length, timestamps);
 
       // Spot-check several pixels
       for (const [x, y] of [[0,0], [319,239], [639,479]]) {
@@ -392,7 +408,7 @@ describe('vgaRenderer', () => {
 
   describe('integration with GA144 snapshot data', () => {
     it('renders from a ring buffer with non-zero start offset', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // Build a single-row frame and place it at a non-zero offset in a ring buffer
       const frameWrites: number[] = [vsync()];
@@ -417,7 +433,7 @@ describe('vgaRenderer', () => {
         tsBuf[(startOffset + i) % capacity] = allTs[i];
       }
 
-      renderIoWrites(state, texData, W, H, buffer, frameWrites.length, startOffset, frameWrites.length, true, tsBuf);
+      decoder.decode(buffer, frameWrites.length, startOffset, frameWrites.length, tsBuf);
 
       // Row 0: red
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
@@ -438,7 +454,7 @@ describe('vgaRenderer', () => {
 
   describe('HSYNC interleaving with DAC writes (timestamp-based)', () => {
     it('handles HSYNC arriving between G and R writes using timestamps', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // 640 pixels on row 0. On the last pixel, HSYNC arrives between G and R
       // (same step as R → deferred HSYNC). Then 640 green pixels on row 1.
@@ -458,7 +474,7 @@ describe('vgaRenderer', () => {
       writes.push(hsync(), vsync());
 
       const ts = guestTimestamps(writes);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, ts);
+      decoder.decode(writes, writes.length, 0, writes.length, ts);
 
       // Row 0: all 640 red pixels (including the last one where HSYNC was deferred)
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
@@ -469,7 +485,7 @@ describe('vgaRenderer', () => {
     });
 
     it('applies HSYNC immediately when R write is in a different step', () => {
-      const { texData, state } = setup();
+      const { texData, decoder } = setup();
 
       // 640 red pixels, then HSYNC (different step from next R), then 640 green pixels
       const writes: number[] = [vsync()];
@@ -483,7 +499,7 @@ describe('vgaRenderer', () => {
       writes.push(hsync(), vsync());
 
       const ts = guestTimestamps(writes);
-      renderIoWrites(state, texData, W, H, writes, writes.length, 0, writes.length, true, ts);
+      decoder.decode(writes, writes.length, 0, writes.length, ts);
 
       // Row 0: red
       expect(readPixel(texData, W, 0, 0).r).toBe(255);
@@ -527,13 +543,13 @@ describe('vgaRenderer', () => {
     });
 
     it('renders Swiss flag with correct color distribution', () => {
-      const res = detectResolution(new ResolutionTracker(), snap.ioWrites, snap.ioWriteCount, snap.ioWriteStart, snap.ioWriteSeq, snap.ioWriteTimestamps);
+      const res = detectResolution(new VgaDecoder(), snap.ioWrites, snap.ioWriteCount, snap.ioWriteStart, snap.ioWriteSeq, snap.ioWriteTimestamps);
       expect(res.hasSyncSignals).toBe(true);
       expect(res.complete).toBe(true);
 
       const texData = new Uint8Array(W * H * 4);
-      const state = createRenderState();
-      renderIoWrites(state, texData, W, H, snap.ioWrites, snap.ioWriteCount, snap.ioWriteStart, snap.ioWriteSeq, true, snap.ioWriteTimestamps);
+      const decoder = new VgaDecoder({ data: texData, width: W, height: H });
+      decoder.decode(snap.ioWrites, snap.ioWriteCount, snap.ioWriteStart, snap.ioWriteSeq, snap.ioWriteTimestamps);
 
       expect(readPixel(texData, W, 0, 0)).toEqual({ r: 0, g: 0, b: 0, a: 255 });
       expect(readPixel(texData, W, 320, 0)).toEqual({ r: 0, g: 0, b: 0, a: 255 });
@@ -1,7 +1,5 @@
 import { describe, it, expect } from 'vitest';
 import {
-  detectResolution,
-  ResolutionTracker,
   readIoWrite,
   taggedCoord,
   taggedValue,
@@ -12,6 +10,7 @@ import {
   PIN17_DRIVE_LOW,
   PIN17_DRIVE_HIGH,
 } from './vgaResolution';
+import { VgaDecoder, detectResolution } from './vgaDecoder';
 import { VGA_NODE_R, VGA_NODE_G, VGA_NODE_B, VGA_NODE_SYNC } from '../../core/constants';
 
 /** Build a tagged IO write value: (coord << 18) | ioValue */
@@ -19,9 +18,9 @@ function tag(coord: number, value: number): number {
   return coord * 0x40000 + value;
 }
 
-/** Helper: run detectResolution with a fresh tracker. */
+/** Helper: run detectResolution with a fresh decoder. */
 function detect(ioWrites: number[], count?: number, start?: number) {
-  const tracker = new ResolutionTracker();
+  const tracker = new VgaDecoder();
   const n = count ?? ioWrites.length;
   const s = start ?? 0;
   return detectResolution(tracker, ioWrites, n, s, n);
@@ -131,7 +130,7 @@ describe('detectResolution', () => {
       tag(VGA_NODE_R, 3),
       tag(VGA_NODE_SYNC, PIN17_DRIVE_HIGH),     // VSYNC end → height=2
     ];
-    const tracker = new ResolutionTracker();
+    const tracker = new VgaDecoder();
     const res = detectResolution(tracker, ioWrites, 6, 1, 6);
     expect(res.complete).toBe(true);
     expect(res.width).toBe(2);
@@ -153,7 +152,7 @@ describe('detectResolution', () => {
   });
 
   it('incremental processing across batches', () => {
-    const tracker = new ResolutionTracker();
+    const tracker = new VgaDecoder();
     // Feed first batch: VSYNC + 2 R writes
     const batch1 = [
       tag(VGA_NODE_SYNC, PIN17_DRIVE_HIGH),
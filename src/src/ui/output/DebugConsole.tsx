@@ -0,0 +1,112 @@
+import React, { useState, useCallback, useEffect, useRef } from 'react';
+import { Box, Typography, FormControlLabel, Checkbox, Button, Select, MenuItem } from '@mui/material';
+import type { ClockCounterMode } from '../../core/types';
+import { EMU_PORT } from '../../core/constants';
+import { useEmulatorStore } from '../../stores/emulatorStore';
+
+interface DebugConsoleProps {
+  onSetDebugChannel: (enabled: boolean, zeroTime: boolean) => void;
+  onSetClockCounter: (mode: ClockCounterMode) => void;
+  onClear: () => void;
+}
+
+/** Only the tail is rendered; the buffer itself keeps more history. */
+const VISIBLE_ENTRIES = 500;
+
+function formatTime(ns: number): string {
+  if (ns < 1e3) return `${ns.toFixed(1)} ns`;
+  if (ns < 1e6) return `${(ns / 1e3).toFixed(3)} µs`;
+  return `${(ns / 1e6).toFixed(3)} ms`;
+}
+
+export const DebugConsole: React.FC<DebugConsoleProps> = ({ onSetDebugChannel, onSetClockCounter, onClear }) => {
+  const entries = useEmulatorStore(s => s.debugEntries);
+  const [enabled, setEnabled] = useState(true);
+  const [zeroTime, setZeroTime] = useState(false);
+  const [clockMode, setClockMode] = useState<ClockCounterMode>('off');
+  const scrollRef = useRef<HTMLDivElement>(null);
+
+  const handleEnabled = useCallback((checked: boolean) => {
+    setEnabled(checked);
+    onSetDebugChannel(checked, zeroTime);
+  }, [zeroTime, onSetDebugChannel]);
+
+  const handleZeroTime = useCallback((checked: boolean) => {
+    setZeroTime(checked);
+    onSetDebugChannel(enabled, checked);
+  }, [enabled, onSetDebugChannel]);
+
+  const handleClockMode = useCallback((mode: ClockCounterMode) => {
+    setClockMode(mode);
+    onSetClockCounter(mode);
+  }, [onSetClockCounter]);
+
+  // Keep the newest entry in view
+  useEffect(() => {
+    const el = scrollRef.current;
+    if (el) el.scrollTop = el.scrollHeight;
+  }, [entries]);
+
+  const visible = entries.length > VISIBLE_ENTRIES ? entries.slice(entries.length - VISIBLE_ENTRIES) : entries;
+
+  return (
+    <Box sx={{ borderTop: '1px solid #333', bgcolor: '#111' }}>
+      <Box sx={{ display: 'flex', alignItems: 'center', gap: 1, px: 1, py: 0.25, borderBottom: '1px solid #222' }}>
+        <Typography variant="caption" sx={{ color: '#888', fontWeight: 'bold', fontSize: '10px' }}>
+          Debug Channel (port 0x{EMU_PORT.DEBUG.toString(16).toUpperCase()})
+        </Typography>
+        <FormControlLabel
+          control={<Checkbox size="small" checked={enabled} onChange={(e) => handleEnabled(e.target.checked)} sx={{ p: 0.25 }} />}
+          label={<Typography sx={{ fontSize: '10px' }}>Capture</Typography>}
+          sx={{ m: 0 }}
+        />
+        <FormControlLabel
+          control={<Checkbox size="small" checked={zeroTime} onChange={(e) => handleZeroTime(e.target.checked)} sx={{ p: 0.25 }} />}
+          label={<Typography sx={{ fontSize: '10px' }} title="Refund the store's guest execution time">Zero time</Typography>}
+          sx={{ m: 0 }}
+        />
+        <Typography
+          variant="caption"
+          sx={{ color: '#888', fontSize: '10px' }}
+          title={`Reads of port 0x${EMU_PORT.CLOCK.toString(16).toUpperCase()} return the node's time counter`}
+        >
+          Clock
+        </Typography>
+        <Select
+          size="small"
+          value={clockMode}
+          onChange={(e) => handleClockMode(e.target.value as ClockCounterMode)}
+          sx={{ fontSize: '10px', height: 20, '& .MuiSelect-select': { py: 0, px: 0.75 } }}
+        >
+          <MenuItem value="off" sx={{ fontSize: '11px' }}>off</MenuItem>
+          <MenuItem value="ns" sx={{ fontSize: '11px' }}>ns</MenuItem>
+          <MenuItem value="steps" sx={{ fontSize: '11px' }}>steps</MenuItem>
+        </Select>
+        <Typography variant="caption" sx={{ color: '#555', fontSize: '9px' }}>
+          {entries.length} entries
+        </Typography>
+        <Button
+          size="small"
+          variant="outlined"
+          onClick={onClear}
+          disabled={entries.length === 0}
+          sx={{ ml: 'auto', textTransform: 'none', fontSize: '10px', height: 20, minWidth: 0, px: 1 }}
+        >
+          Clear
+        </Button>
+      </Box>
+      <Box ref={scrollRef} sx={{ maxHeight: 160, overflowY: 'auto', px: 1, py: 0.25 }}>
+        {visible.map((e, i) => (
+          <Typography
+            key={entries.length - visible.length + i}
+            variant="caption"
+            display="block"
+            sx={{ fontFamily: 'monospace', fontSize: '11px', color: '#ccc', whiteSpace: 'pre' }}
+          >
+            {formatTime(e.timeNS).padStart(14)}  {e.coord.toString().padStart(3, '0')}  0x{e.value.toString(16).padStart(5, '0')}  {e.value}
+          </Typography>
+        ))}
+      </Box>
+    </Box>
+  );
+};
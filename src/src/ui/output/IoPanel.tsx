@@ -3,24 +3,24 @@ import { Box, Chip, TextField, IconButton } from '@mui/material';
 import SendIcon from '@mui/icons-material/Send';
 import { VgaDisplay } from '../emulator/VgaDisplay';
 import { SerialOutput } from '../emulator/SerialOutput';
+import { DebugConsole } from './DebugConsole';
+import type { ClockCounterMode } from '../../core/types';
+import { useEmulatorStore } from '../../stores/emulatorStore';
 
 interface IoPanelProps {
-  ioWrites: number[];
-  ioWriteTimestamps: number[];
-  ioWriteCount: number;
-  ioWriteStart: number;
-  ioWriteSeq: number;
   onSendSerialInput: (bytes: number[], baud: number) => void;
+  onSetDebugChannel: (enabled: boolean, zeroTime: boolean) => void;
+  onSetClockCounter: (mode: ClockCounterMode) => void;
+  onClearDebugLog: () => void;
 }
 
 export const IoPanel: React.FC<IoPanelProps> = ({
-  ioWrites,
-  ioWriteTimestamps,
-  ioWriteCount,
-  ioWriteStart,
-  ioWriteSeq,
   onSendSerialInput,
+  onSetDebugChannel,
+  onSetClockCounter,
+  onClearDebugLog,
 }) => {
+  const { ioWrites, ioWriteTimestamps, ioWriteCount, ioWriteStart, ioWriteSeq } = useEmulatorStore(s => s.io);
   const [serialText, setSerialText] = useState('');
   const [baudRate, setBaudRate] = useState(921600);
 
@@ -85,6 +85,11 @@ export const IoPanel: React.FC<IoPanelProps> = ({
           <SendIcon fontSize="small" />
         </IconButton>
       </Box>
+      <DebugConsole
+        onSetDebugChannel={onSetDebugChannel}
+        onSetClockCounter={onSetClockCounter}
+        onClear={onClearDebugLog}
+      />
     </Box>
   );
 };
@@ -30,4 +30,5 @@ export const NODE_COLORS = {
   blocked_write: '#FF9800',
   suspended: '#424242',
   selected: '#FFD700',
+  stalled: '#F44336',
 } as const;
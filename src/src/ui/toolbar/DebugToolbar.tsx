@@ -8,14 +8,12 @@ import PauseIcon from '@mui/icons-material/Pause';
 import SkipNextIcon from '@mui/icons-material/SkipNext';
 import RestartAltIcon from '@mui/icons-material/RestartAlt';
 import FastForwardIcon from '@mui/icons-material/FastForward';
+import SpeedIcon from '@mui/icons-material/Speed';
 import type { EditorLanguage } from '../editor/CodeEditor';
+import { HostProfileHud } from './HostProfileHud';
+import { useEmulatorStore } from '../../stores/emulatorStore';
 
 interface DebugToolbarProps {
-  activeCount: number;
-  totalSteps: number;
-  totalEnergyPJ: number;
-  chipPowerMW: number;
-  totalSimTimeNS: number;
   language: EditorLanguage;
   isRunning: boolean;
   onCompile: () => void;
@@ -25,6 +23,7 @@ interface DebugToolbarProps {
   onRun: () => void;
   onStop: () => void;
   onReset: () => void;
+  onSetHostProfiling: (enabled: boolean) => void;
 }
 
 function formatRate(rate: number): string {
@@ -55,10 +54,12 @@ function formatPower(mw: number): string {
 }
 
 export const DebugToolbar: React.FC<DebugToolbarProps> = ({
-  activeCount, totalSteps, totalEnergyPJ, chipPowerMW, totalSimTimeNS,
   language, isRunning,
-  onCompile, onSetLanguage, onStep, onStepN, onRun, onStop, onReset,
+  onCompile, onSetLanguage, onStep, onStepN, onRun, onStop, onReset, onSetHostProfiling,
 }) => {
+  const { activeCount, totalSteps, totalEnergyPJ, chipPowerMW, totalSimTimeNS } = useEmulatorStore(s => s.totals);
+  const hostProfile = useEmulatorStore(s => s.hostProfile);
+  const [profiling, setProfiling] = useState(false);
   const totalStepsRef = useRef(totalSteps);
   const totalEnergyRef = useRef(totalEnergyPJ);
   const totalSimTimeRef = useRef(totalSimTimeNS);
@@ -168,6 +169,21 @@ export const DebugToolbar: React.FC<DebugToolbarProps> = ({
         </Button>
       </ButtonGroup>
 
+      <ToggleButton
+        value="profile"
+        size="small"
+        selected={profiling}
+        onChange={() => {
+          onSetHostProfiling(!profiling);
+          setProfiling(!profiling);
+        }}
+        title="Profile the emulator's host time per subsystem"
+        sx={{ height: 26, px: 0.5 }}
+      >
+        <SpeedIcon fontSize="small" />
+      </ToggleButton>
+      {profiling && hostProfile && <HostProfileHud profile={hostProfile} />}
+
       <Box sx={{ ml: 'auto', display: 'flex', gap: 1 }}>
         <Chip
           size="small"
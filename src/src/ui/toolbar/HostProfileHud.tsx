@@ -0,0 +1,75 @@
+import React from 'react';
+import { Box, Chip, Tooltip, Typography } from '@mui/material';
+import { HOST_SECTIONS } from '../../core/host-profile';
+import type { HostProfileReport, HostSection } from '../../core/host-profile';
+
+const SECTION_COLORS: Record<HostSection, string> = {
+  guest: '#4caf50',
+  queue: '#2196f3',
+  thermal: '#ff9800',
+  io: '#9c27b0',
+  snapshot: '#00bcd4',
+  post: '#f44336',
+  stall: '#795548',
+};
+
+const SECTION_LABELS: Record<HostSection, string> = {
+  guest: 'guest code',
+  queue: 'event queue (est.)',
+  thermal: 'thermal (est.)',
+  io: 'IO push',
+  snapshot: 'snapshots',
+  post: 'postMessage',
+  stall: 'stall checks',
+};
+
+function formatCount(rate: number): string {
+  if (rate >= 1e6) return `${(rate / 1e6).toFixed(1)}M`;
+  if (rate >= 1e3) return `${(rate / 1e3).toFixed(1)}K`;
+  return `${Math.round(rate)}`;
+}
+
+interface HostProfileHudProps {
+  profile: HostProfileReport;
+}
+
+/** Emulator worker's host time per subsystem as a stacked bar, plus throughput. */
+export const HostProfileHud: React.FC<HostProfileHudProps> = ({ profile }) => {
+  const { sections, windowMS } = profile;
+  const details = (
+    <Box sx={{ fontSize: '10px', fontFamily: 'monospace', whiteSpace: 'pre' }}>
+      {HOST_SECTIONS.map(s => (
+        <div key={s}>
+          <span style={{ color: SECTION_COLORS[s] }}>■</span>{' '}
+          {SECTION_LABELS[s].padEnd(20, ' ')}
+          {(sections[s] / windowMS * 100).toFixed(1).padStart(5, ' ')}%
+        </div>
+      ))}
+      <div>events/s {formatCount(profile.eventsPerSec)}</div>
+      <div>IO writes/s {formatCount(profile.ioWritesPerSec)}</div>
+      <div>queue depth {profile.queueDepth.toFixed(1)}</div>
+      <div>guest speed {profile.guestSpeed.toFixed(3)}× real time</div>
+    </Box>
+  );
+
+  return (
+    <Tooltip title={details}>
+      <Box sx={{ display: 'flex', alignItems: 'center', gap: 0.5 }}>
+        <Box sx={{ display: 'flex', width: 96, height: 10, bgcolor: 'action.hover', borderRadius: 0.5, overflow: 'hidden' }}>
+          {HOST_SECTIONS.map(s => (
+            <Box key={s} sx={{ width: `${(sections[s] / windowMS) * 100}%`, bgcolor: SECTION_COLORS[s] }} />
+          ))}
+        </Box>
+        <Typography sx={{ fontSize: '10px', whiteSpace: 'nowrap' }}>
+          {`${Math.round(profile.busy * 100)}% busy`}
+        </Typography>
+        <Chip
+          size="small"
+          label={`${profile.mips.toFixed(1)} MIPS`}
+          variant="outlined"
+          sx={{ fontSize: '10px', height: 20 }}
+        />
+      </Box>
+    </Tooltip>
+  );
+};
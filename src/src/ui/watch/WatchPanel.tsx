@@ -0,0 +1,140 @@
+import React, { useEffect, useMemo, useState } from 'react';
+import { Box, Paper, Typography, Autocomplete, TextField, Select, MenuItem } from '@mui/material';
+import type { WatchSymbol } from '../../core/cube';
+import type { WatchTarget, WatchMode } from '../../core/ram-watch';
+import type { WatchSample } from '../../worker/watchBuffer';
+import { useEmulatorStore } from '../../stores/emulatorStore';
+
+const hex18 = (v: number): string => (v & 0x3FFFF).toString(16).toUpperCase().padStart(5, '0');
+const signed18 = (v: number): number => (v & 0x20000 ? (v & 0x3FFFF) - 0x40000 : v & 0x3FFFF);
+const symbolKey = (s: WatchSymbol): string => `${s.coord}:${s.name}`;
+const targetKey = (t: WatchTarget): string => `${t.coord}:${t.addr}`;
+
+const INTERVALS_MS = [16, 50, 100, 250, 1000];
+
+interface WatchPanelProps {
+  symbols: WatchSymbol[];
+  onSetWatches: (targets: WatchTarget[], mode: WatchMode, intervalMs: number) => void;
+}
+
+/**
+ * Live values of chosen CUBE variables and constructor fields. The worker
+ * streams only the watched words, either every guest write or, when
+ * sampled, each change it sees at the chosen rate.
+ */
+export const WatchPanel: React.FC<WatchPanelProps> = ({ symbols, onSetWatches }) => {
+  const [selected, setSelected] = useState<string[]>([]);
+  const [mode, setMode] = useState<WatchMode>('write');
+  const [intervalMs, setIntervalMs] = useState(100);
+  const watch = useEmulatorStore(s => s.watch);
+
+  // Selections follow symbols across recompiles by name; their addresses may move
+  const watched = useMemo(() => {
+    const byKey = new Map(symbols.map(s => [symbolKey(s), s]));
+    return selected.flatMap(k => byKey.get(k) ?? []);
+  }, [symbols, selected]);
+  const targetList = watched.map(s => targetKey(s)).join(',');
+
+  useEffect(() => {
+    const targets = targetList
+      ? targetList.split(',').map(k => {
+        const [coord, addr] = k.split(':').map(Number);
+        return { coord, addr };
+      })
+      : [];
+    onSetWatches(targets, mode, intervalMs);
+  }, [targetList, mode, intervalMs, onSetWatches]);
+
+  const samples = useMemo(() => {
+    const map = new Map<string, WatchSample | null>();
+    watch.targets.forEach((t, i) => map.set(targetKey(t), watch.samples[i]));
+    return map;
+  }, [watch]);
+
+  return (
+    <Paper elevation={2} sx={{ p: 1 }}>
+      <Box sx={{ display: 'flex', alignItems: 'center', gap: 1, mb: 1 }}>
+        <Typography variant="subtitle2" sx={{ fontWeight: 'bold' }}>Watch</Typography>
+        <Select
+          size="small"
+          value={mode}
+          onChange={(e) => setMode(e.target.value as WatchMode)}
+          sx={{ fontSize: '11px', height: 24 }}
+        >
+          <MenuItem value="write" sx={{ fontSize: '11px' }}>every write</MenuItem>
+          <MenuItem value="sample" sx={{ fontSize: '11px' }}>sampled</MenuItem>
+        </Select>
+        <Select
+          size="small"
+          value={intervalMs}
+          onChange={(e) => setIntervalMs(Number(e.target.value))}
+          sx={{ fontSize: '11px', height: 24 }}
+        >
+          {INTERVALS_MS.map(ms => (
+            <MenuItem key={ms} value={ms} sx={{ fontSize: '11px' }}>{ms} ms</MenuItem>
+          ))}
+        </Select>
+        {watch.dropped > 0 && (
+          <Typography variant="caption" sx={{ color: '#ff9800', ml: 'auto' }}>
+            {watch.dropped} writes dropped
+          </Typography>
+        )}
+      </Box>
+
+      <Autocomplete
+        multiple
+        size="small"
+        options={symbols}
+        value={watched}
+        onChange={(_, v) => setSelected(v.map(symbolKey))}
+        groupBy={s => `node ${s.coord.toString().padStart(3, '0')}`}
+        getOptionLabel={s => s.name}
+        isOptionEqualToValue={(a, b) => symbolKey(a) === symbolKey(b)}
+        noOptionsText="Compile a CUBE program to watch its variables"
+        renderInput={(params) => <TextField {...params} placeholder="Add variable or field" />}
+        sx={{ mb: 1, '& .MuiInputBase-root': { fontSize: '11px' } }}
+      />
+
+      {watched.map(s => {
+        const sample = samples.get(targetKey(s)) ?? null;
+        return (
+          <Box
+            key={symbolKey(s)}
+            sx={{ display: 'flex', alignItems: 'center', fontFamily: 'monospace', fontSize: '10px', py: 0.25, px: 0.5 }}
+          >
+            <Box sx={{ width: 120, color: s.kind === 'field' ? '#88ccff' : '#88ff88', overflow: 'hidden', textOverflow: 'ellipsis' }}>
+              {s.name}
+            </Box>
+            <Box sx={{ width: 70, color: '#666' }}>
+              {s.coord.toString().padStart(3, '0')}:{s.addr.toString(16).toUpperCase().padStart(2, '0')}
+            </Box>
+            <Box sx={{ width: 50, color: '#ccc' }}>{sample ? hex18(sample.value) : '—'}</Box>
+            <Box sx={{ width: 60, color: '#888' }}>{sample ? signed18(sample.value) : ''}</Box>
+            <Sparkline history={sample?.history ?? []} />
+            <Box sx={{ width: 50, color: '#666', textAlign: 'right' }}>{sample?.updates ?? 0}</Box>
+          </Box>
+        );
+      })}
+    </Paper>
+  );
+};
+
+const SPARK_W = 96;
+const SPARK_H = 16;
+
+/** Recent values of one word, scaled to their own range. */
+const Sparkline: React.FC<{ history: number[] }> = React.memo(({ history }) => {
+  if (history.length < 2) return <Box sx={{ width: SPARK_W, height: SPARK_H }} />;
+  const values = history.map(signed18);
+  const lo = Math.min(...values);
+  const span = Math.max(...values) - lo || 1;
+  const step = SPARK_W / (values.length - 1);
+  const points = values
+    .map((v, i) => `${(i * step).toFixed(1)},${(SPARK_H - 1 - ((v - lo) / span) * (SPARK_H - 2)).toFixed(1)}`)
+    .join(' ');
+  return (
+    <svg width={SPARK_W} height={SPARK_H} style={{ display: 'block' }}>
+      <polyline points={points} fill="none" stroke="#00e5ff" strokeWidth={1} />
+    </svg>
+  );
+});
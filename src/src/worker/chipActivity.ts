@@ -0,0 +1,77 @@
+/**
+ * Chip activity buffer — per-node and per-link counters the emulator worker
+ * publishes into a SharedArrayBuffer and the chip grid canvas reads every
+ * animation frame, with no messages or React renders in between.
+ *
+ * SAB layout (n nodes, c link channels):
+ *   Int32[4]     rows, cols, c, generation (bumped after each publish)
+ *   Float64[n]   instructions executed per node
+ *   Float64[n]   thermal temperature per node
+ *   Float64[c]   words transferred per link channel (LinkTable order)
+ *   Uint8[n]     node state codes (NODE_STATE_CODES)
+ *
+ * Values are written without locking; a frame may mix two publishes, which
+ * is harmless for a visualisation.
+ */
+import type { GA144 } from '../core/ga144';
+import { Mesh } from '../core/mesh';
+import { LinkTable } from '../core/links';
+import { nodeStateCode } from '../core/node-pack';
+
+const HEADER_BYTES = 16;
+const GENERATION = 3;
+
+export class ChipActivity {
+  readonly sab: SharedArrayBuffer;
+  readonly mesh: Mesh;
+  /** Link channel ends, for drawing traffic. */
+  readonly links: LinkTable;
+  readonly steps: Float64Array;
+  readonly temperature: Float64Array;
+  readonly transfers: Float64Array;
+  readonly states: Uint8Array;
+  private readonly header: Int32Array;
+
+  /** Allocate a buffer for the chip's mesh (worker side). */
+  static create(mesh: Mesh): ChipActivity {
+    const links = new LinkTable(mesh);
+    const channels = links.numLinks * 2;
+    const sab = new SharedArrayBuffer(HEADER_BYTES + (mesh.numNodes * 2 + channels) * 8 + mesh.numNodes);
+    const header = new Int32Array(sab, 0, 4);
+    header[0] = mesh.rows;
+    header[1] = mesh.cols;
+    header[2] = channels;
+    return new ChipActivity(sab);
+  }
+
+  /** View an existing buffer (main thread side). */
+  constructor(sab: SharedArrayBuffer) {
+    this.sab = sab;
+    this.header = new Int32Array(sab, 0, 4);
+    this.mesh = new Mesh(this.header[0], this.header[1]);
+    this.links = new LinkTable(this.mesh);
+    const n = this.mesh.numNodes;
+    const channels = this.header[2];
+    this.steps = new Float64Array(sab, HEADER_BYTES, n);
+    this.temperature = new Float64Array(sab, HEADER_BYTES + n * 8, n);
+    this.transfers = new Float64Array(sab, HEADER_BYTES + n * 16, channels);
+    this.states = new Uint8Array(sab, HEADER_BYTES + (n * 2 + channels) * 8, n);
+  }
+
+  /** Copy the chip's current counters in and bump the generation. */
+  publish(chip: GA144): void {
+    for (let i = 0; i < this.steps.length; i++) {
+      const node = chip.getNodeByIndex(i);
+      this.steps[i] = node.stepCount;
+      this.temperature[i] = node.thermal.temperature;
+      this.states[i] = nodeStateCode(node.getState());
+    }
+    this.transfers.set(chip.links.transfers);
+    Atomics.add(this.header, GENERATION, 1);
+  }
+
+  /** Changes whenever the worker publishes. */
+  get generation(): number {
+    return Atomics.load(this.header, GENERATION);
+  }
+}
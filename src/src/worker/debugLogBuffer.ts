@@ -0,0 +1,32 @@
+/**
+ * Main-thread store for debug-channel entries received from the worker.
+ * Keeps the most recent CAPACITY entries for the debug console. Each
+ * non-empty batch produces a new `entries` array so React can compare
+ * by reference.
+ */
+import type { DebugLogBatch } from './emulatorProtocol';
+import type { DebugLogEntry } from '../core/debug-log';
+
+const CAPACITY = 10_000;
+
+export class DebugLogBuffer {
+  entries: DebugLogEntry[] = [];
+  seq = 0;
+
+  appendBatch(batch: DebugLogBatch): void {
+    if (batch.values.length > 0) {
+      const added: DebugLogEntry[] = new Array(batch.values.length);
+      for (let i = 0; i < batch.values.length; i++) {
+        added[i] = { coord: batch.coords[i], value: batch.values[i], timeNS: batch.timestamps[i] };
+      }
+      const merged = this.entries.concat(added);
+      this.entries = merged.length > CAPACITY ? merged.slice(merged.length - CAPACITY) : merged;
+    }
+    this.seq = batch.totalSeq;
+  }
+
+  reset(): void {
+    this.entries = [];
+    this.seq = 0;
+  }
+}
@@ -1,7 +1,16 @@
 /**
  * Message protocol between main thread and emulator Web Worker.
+ *
+ * Bulk data crosses as binary: snapshots are packed into one ArrayBuffer
+ * (see snapshotCodec.ts) and batches carry typed arrays, all transferred
+ * rather than structured-cloned. The worker announces PROTOCOL_VERSION in
+ * 'ready' so a stale cached worker is caught up front, and hands over the
+ * shared activity buffer (see chipActivity.ts) the chip grid reads.
  */
-import type { NodeState, NodeSnapshot } from '../core/types';
+import type { NodeState, NodeSnapshot, ClockCounterMode } from '../core/types';
+import type { StallReport } from '../core/deadlock';
+import type { HostProfileReport } from '../core/host-profile';
+import type { WatchTarget, WatchMode, WatchDelta } from '../core/ram-watch';
 
 // ============================================================================
 // Main → Worker messages
@@ -16,13 +25,19 @@ export type MainToWorker =
   | { type: 'stepN'; count: number }
   | { type: 'reset' }
   | { type: 'selectNode'; coord: number | null }
-  | { type: 'sendSerialInput'; bytes: number[]; baud: number };
+  | { type: 'sendSerialInput'; bytes: number[]; baud: number }
+  | { type: 'setDebugChannel'; enabled: boolean; zeroTime: boolean }
+  | { type: 'setClockCounter'; mode: ClockCounterMode; coords: number[] | null }
+  | { type: 'setLivelockWindow'; windowNS: number }
+  | { type: 'setHostProfiling'; enabled: boolean }
+  | { type: 'setWatches'; id: number; targets: WatchTarget[]; mode: WatchMode; intervalMs: number };
 
 // ============================================================================
 // Worker → Main messages
 // ============================================================================
 
-/** Snapshot of chip state (excludes IO write arrays — those go via IoWriteBatch). */
+/** Snapshot of chip state as decoded on the main thread (excludes IO write
+ *  arrays — those go via IoWriteBatch). */
 export interface WorkerSnapshot {
   nodeStates: NodeState[];
   nodeCoords: number[];
@@ -36,15 +51,36 @@ export interface WorkerSnapshot {
 
 /** Delta batch of IO writes since the last batch. */
 export interface IoWriteBatch {
-  writes: number[];
-  timestamps: number[];
+  writes: Uint32Array;
+  timestamps: Float64Array;
   startSeq: number;
   totalSeq: number;
 }
 
+/** Delta batch of debug-channel entries since the last batch. */
+export interface DebugLogBatch {
+  coords: Uint16Array;
+  values: Uint32Array;
+  timestamps: Float64Array;
+  startSeq: number;
+  totalSeq: number;
+}
+
+/** Watched RAM values logged since the last batch. `id` is that of the
+ *  setWatches message the indices refer to. */
+export interface WatchBatch extends WatchDelta {
+  id: number;
+}
+
+/** Why the run loop stopped. 'deadlock'/'livelock' carry a StallReport. */
+export type StopReason = 'user' | 'breakpoint' | 'allSuspended' | 'deadlock' | 'livelock';
+
 export type WorkerToMain =
-  | { type: 'snapshot'; snapshot: WorkerSnapshot }
+  | { type: 'snapshot'; buffer: ArrayBuffer }
   | { type: 'ioWriteBatch'; batch: IoWriteBatch }
-  | { type: 'stopped'; reason: 'user' | 'breakpoint' | 'allSuspended' }
-  | { type: 'ready' }
+  | { type: 'debugBatch'; batch: DebugLogBatch }
+  | { type: 'stopped'; reason: StopReason; stall?: StallReport }
+  | { type: 'hostProfile'; profile: HostProfileReport }
+  | { type: 'watchBatch'; batch: WatchBatch }
+  | { type: 'ready'; version: number; activity: SharedArrayBuffer }
   | { type: 'error'; message: string };
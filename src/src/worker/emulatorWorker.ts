@@ -2,74 +2,149 @@
  * Web Worker for GA144 emulation.
  *
  * Runs the GA144 chip at full speed in a background thread.
- * Communicates with the main thread via postMessage.
+ * Communicates with the main thread via postMessage, transferring the
+ * binary snapshot and batch buffers (see snapshotCodec.ts).
  */
 import { GA144 } from '../core/ga144';
 import { SerialBits } from '../core/serial';
 import type { SerialBit } from '../core/serial';
-import type { MainToWorker, WorkerToMain, WorkerSnapshot } from './emulatorProtocol';
+import type { MainToWorker, WorkerToMain } from './emulatorProtocol';
+import { PROTOCOL_VERSION, encodeSnapshot, encodeDebugBatch, batchTransfer } from './snapshotCodec';
 import { createVcoClocks } from './vcoClock';
+import { ChipActivity } from './chipActivity';
+import { HostProfiler, calibrateHostCosts } from '../core/host-profile';
+import { RamWatch } from '../core/ram-watch';
 
 const STEPS_PER_CHUNK = 50_000;
 const SNAPSHOT_INTERVAL_MS = 50;  // 20 Hz
 const IO_BATCH_INTERVAL_MS = 33; // 30 Hz
+const STALL_CHECK_INTERVAL_MS = 100;
+const HOST_PROFILE_INTERVAL_MS = 500;  // 2 Hz
 
 let ga144: GA144 | null = null;
+let activity: ChipActivity | null = null;
 let lastBootBits: SerialBit[] | null = null;
 let running = false;
 let selectedCoord: number | null = null;
 let lastIoSeq = 0;
+let lastDebugSeq = 0;
 let lastSnapshotTime = 0;
 let lastIoBatchTime = 0;
 let lastIdleAdvanceTime = 0;
+let lastStallCheckTime = 0;
+let profiler: HostProfiler | null = null;
+let lastProfileTime = 0;
+let watch: RamWatch | null = null;
+let watchId = 0;
+let watchIntervalMs = 100;
+let lastWatchTime = 0;
 
-function post(msg: WorkerToMain): void {
-  self.postMessage(msg);
+function post(msg: WorkerToMain, transfer: Transferable[] = []): void {
+  if (profiler) profiler.time('post', () => self.postMessage(msg, { transfer }));
+  else self.postMessage(msg, { transfer });
+}
+
+function setHostProfiling(enabled: boolean): void {
+  if (!ga144 || enabled === (profiler !== null)) return;
+  profiler = enabled ? new HostProfiler(calibrateHostCosts()) : null;
+  ga144.setHostProfiler(profiler);
+  profiler?.start(ga144.getHostCounters());
+  lastProfileTime = performance.now();
+}
+
+/** Start a fresh profile window: counters restart at chip reset, and a
+ *  window spanning a pause would only measure the pause. */
+function restartHostProfile(): void {
+  if (ga144 && profiler) profiler.start(ga144.getHostCounters());
+}
+
+/** Refresh the shared activity buffer the chip grid animates from. */
+function publishActivity(): void {
+  if (!ga144 || !activity) return;
+  const chip = ga144;
+  const target = activity;
+  if (profiler) profiler.time('snapshot', () => target.publish(chip));
+  else target.publish(chip);
 }
 
 function sendSnapshot(): void {
   if (!ga144) return;
-  const full = ga144.getSnapshot(selectedCoord ?? undefined);
-  const snapshot: WorkerSnapshot = {
-    nodeStates: full.nodeStates,
-    nodeCoords: full.nodeCoords,
-    activeCount: full.activeCount,
-    totalSteps: full.totalSteps,
-    selectedNode: full.selectedNode,
-    totalEnergyPJ: full.totalEnergyPJ,
-    chipPowerMW: full.chipPowerMW,
-    totalSimTimeNS: full.totalSimTimeNS,
-  };
-  post({ type: 'snapshot', snapshot });
+  const chip = ga144;
+  const buffer = profiler
+    ? profiler.time('snapshot', () => encodeSnapshot(chip, selectedCoord))
+    : encodeSnapshot(chip, selectedCoord);
+  post({ type: 'snapshot', buffer }, [buffer]);
+  publishActivity();
 }
 
 function sendIoBatch(): void {
   if (!ga144) return;
-  const delta = ga144.getIoWritesDelta(lastIoSeq);
-  if (delta.writes.length > 0 || delta.totalSeq !== lastIoSeq) {
-    post({
-      type: 'ioWriteBatch',
-      batch: {
-        writes: delta.writes,
-        timestamps: delta.timestamps,
-        startSeq: delta.startSeq,
-        totalSeq: delta.totalSeq,
-      },
-    });
-    lastIoSeq = delta.totalSeq;
+  const batch = ga144.getIoWritesDelta(lastIoSeq);
+  if (batch.writes.length > 0 || batch.totalSeq !== lastIoSeq) {
+    post({ type: 'ioWriteBatch', batch }, batchTransfer(batch));
+    lastIoSeq = batch.totalSeq;
   }
+  // Debug-channel entries ride along at the same cadence
+  sendDebugBatch();
+}
+
+function sendDebugBatch(): void {
+  if (!ga144) return;
+  const delta = ga144.getDebugLogDelta(lastDebugSeq);
+  if (delta.values.length > 0 || delta.totalSeq !== lastDebugSeq) {
+    const batch = encodeDebugBatch(delta);
+    post({ type: 'debugBatch', batch }, batchTransfer(batch));
+    lastDebugSeq = delta.totalSeq;
+  }
+}
+
+/** Post watched values logged since the last batch. Sample-mode watches
+ *  are read first; `force` reads every target, for when the chip's RAM was
+ *  replaced by a reset or boot. */
+function sendWatchBatch(force = false): void {
+  if (!ga144 || !watch) return;
+  if (force || watch.mode === 'sample') watch.sample(ga144, force);
+  const delta = watch.drain();
+  if (delta.indices.length === 0 && delta.dropped === 0) return;
+  const batch = { id: watchId, ...delta };
+  post({ type: 'watchBatch', batch }, batchTransfer(batch));
+}
+
+/** Stop the run if the chip has deadlocked (or livelocked, when enabled).
+ *  Returns true if the run was stopped. */
+function checkStall(): boolean {
+  if (!ga144) return false;
+  const chip = ga144;
+  const stall = profiler ? profiler.time('stall', () => chip.detectStall()) : chip.detectStall();
+  if (!stall) return false;
+  running = false;
+  sendSnapshot();
+  sendIoBatch();
+  sendWatchBatch();
+  post({ type: 'stopped', reason: stall.kind, stall });
+  return true;
 }
 
 function runLoop(): void {
   if (!running || !ga144) {
     sendSnapshot();
     sendIoBatch();
+    sendWatchBatch();
     post({ type: 'stopped', reason: 'user' });
     return;
   }
 
-  const hit = ga144.stepProgramN(STEPS_PER_CHUNK);
+  let hit: boolean;
+  if (profiler) {
+    const t0 = performance.now();
+    hit = ga144.stepProgramN(STEPS_PER_CHUNK);
+    profiler.add('step', performance.now() - t0);
+    profiler.sampleQueueDepth(ga144.getHostCounters().queueDepth);
+  } else {
+    hit = ga144.stepProgramN(STEPS_PER_CHUNK);
+  }
 
+  publishActivity();
   const now = performance.now();
   lastIdleAdvanceTime = now; // keep fresh for active→idle transition
   if (now - lastSnapshotTime >= SNAPSHOT_INTERVAL_MS) {
@@ -81,16 +156,33 @@ function runLoop(): void {
     sendIoBatch();
     lastIoBatchTime = now;
   }
+  if (watch && now - lastWatchTime >= watchIntervalMs) {
+    sendWatchBatch();
+    lastWatchTime = now;
+  }
+  if (profiler && now - lastProfileTime >= HOST_PROFILE_INTERVAL_MS) {
+    post({ type: 'hostProfile', profile: profiler.report(ga144.getHostCounters()) });
+    lastProfileTime = now;
+  }
 
   if (hit) {
     running = false;
     sendSnapshot();
     sendIoBatch();
+    sendWatchBatch();
     post({ type: 'stopped', reason: 'breakpoint' });
     return;
   }
 
-  if (ga144.getActiveCount() === 0) {
+  // Partial deadlocks can leave other nodes running, so check the wait-for
+  // graph periodically as well as when the whole chip goes idle
+  const idle = ga144.getActiveCount() === 0;
+  if (idle || now - lastStallCheckTime >= STALL_CHECK_INTERVAL_MS) {
+    lastStallCheckTime = now;
+    if (checkStall()) return;
+  }
+
+  if (idle) {
     // All nodes idle (blocked on ports / suspended). Keep the run loop alive
     // but yield longer — no work until an external event arrives.
     // Advance guest clock at host wall-clock rate so power/energy reporting
@@ -122,7 +214,8 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
       ga144.reset();
       const vcoState = createVcoClocks();
       ga144.setVcoCounters(vcoState.counters);
-      post({ type: 'ready' });
+      activity = ChipActivity.create(ga144.mesh);
+      post({ type: 'ready', version: PROTOCOL_VERSION, activity: activity.sab });
       sendSnapshot();
       break;
     }
@@ -134,8 +227,11 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
         ga144.reset();
         ga144.enqueueSerialBits(708, lastBootBits);
         lastIoSeq = 0;
+        lastDebugSeq = 0;
+        restartHostProfile();
         sendSnapshot();
         sendIoBatch();
+        sendWatchBatch(true);
       }
       break;
 
@@ -144,6 +240,10 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
       lastSnapshotTime = performance.now();
       lastIoBatchTime = performance.now();
       lastIdleAdvanceTime = performance.now();
+      lastStallCheckTime = performance.now();
+      lastProfileTime = performance.now();
+      lastWatchTime = performance.now();
+      restartHostProfile();
       runLoop();
       break;
 
@@ -157,6 +257,7 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
         ga144.stepProgram();
         sendSnapshot();
         sendIoBatch();
+        sendWatchBatch();
       }
       break;
 
@@ -165,6 +266,7 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
         ga144.stepProgramN(msg.count);
         sendSnapshot();
         sendIoBatch();
+        sendWatchBatch();
       }
       break;
 
@@ -174,8 +276,11 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
         ga144.reset();
         if (lastBootBits) ga144.enqueueSerialBits(708, lastBootBits);
         lastIoSeq = 0;
+        lastDebugSeq = 0;
+        restartHostProfile();
         sendSnapshot();
         sendIoBatch();
+        sendWatchBatch(true);
       }
       break;
 
@@ -189,5 +294,29 @@ self.onmessage = (e: MessageEvent<MainToWorker>) => {
         ga144.sendSerialInput(msg.bytes, msg.baud);
       }
       break;
+
+    case 'setDebugChannel':
+      ga144?.setDebugChannel({ enabled: msg.enabled, zeroTime: msg.zeroTime });
+      break;
+
+    case 'setClockCounter':
+      ga144?.setClockCounter(msg.mode, msg.coords ?? undefined);
+      break;
+
+    case 'setLivelockWindow':
+      ga144?.setLivelockWindow(msg.windowNS);
+      break;
+
+    case 'setHostProfiling':
+      setHostProfiling(msg.enabled);
+      break;
+
+    case 'setWatches':
+      watchId = msg.id;
+      watchIntervalMs = msg.intervalMs;
+      watch = msg.targets.length > 0 ? new RamWatch(msg.targets, msg.mode) : null;
+      ga144?.setRamWatch(watch);
+      sendWatchBatch(true);
+      break;
   }
 };
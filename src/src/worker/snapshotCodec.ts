@@ -0,0 +1,135 @@
+/**
+ * Binary encoding of worker snapshots and batches.
+ *
+ * A snapshot is one ArrayBuffer, transferred rather than cloned:
+ *
+ *   Uint32[4]   magic, PROTOCOL_VERSION, node count, flags
+ *   Float64[5]  totalSteps, totalEnergyPJ, chipPowerMW, totalSimTimeNS, activeCount
+ *   Float64[]   selected node counters (NODE_FLOATS)
+ *   Int32[2]    selected node coord and index
+ *   Int32[]     selected node registers, stacks and memory (NODE_INTS)
+ *   Uint16[n]   node coords in index order
+ *   Uint8[n]    node state codes (NODE_STATE_CODES)
+ *
+ * The selected-node blocks are always present and only meaningful with
+ * FLAG_SELECTED set. IO, debug and watch batches carry typed arrays whose
+ * buffers `batchTransfer` lists for postMessage.
+ */
+import type { GA144 } from '../core/ga144';
+import type { DebugLogDelta } from '../core/debug-log';
+import { NODE_INTS, NODE_FLOATS, NODE_STATE_CODES, nodeStateCode, unpackNode } from '../core/node-pack';
+import type { NodeState } from '../core/types';
+import type { WorkerSnapshot, IoWriteBatch, DebugLogBatch, WatchBatch } from './emulatorProtocol';
+
+/** Bumped whenever the snapshot layout or a message shape changes. */
+export const PROTOCOL_VERSION = 2;
+
+const MAGIC = 0x43554245; // 'CUBE'
+const FLAG_SELECTED = 1;
+
+const HEADER_BYTES = 16;
+const TOTALS = 5;
+const NODE_FLOATS_AT = HEADER_BYTES + TOTALS * 8;
+const NODE_INTS_AT = NODE_FLOATS_AT + NODE_FLOATS.LENGTH * 8;
+const COORDS_AT = NODE_INTS_AT + (2 + NODE_INTS.LENGTH) * 4;
+
+const snapshotBytes = (numNodes: number): number => COORDS_AT + numNodes * 3;
+
+/** Pack the chip's state, plus the node at `selectedCoord` when given. */
+export function encodeSnapshot(chip: GA144, selectedCoord: number | null): ArrayBuffer {
+  const numNodes = chip.mesh.numNodes;
+  const buffer = new ArrayBuffer(snapshotBytes(numNodes));
+  const selected = selectedCoord !== null && chip.mesh.validCoord(selectedCoord);
+
+  const header = new Uint32Array(buffer, 0, 4);
+  header[0] = MAGIC;
+  header[1] = PROTOCOL_VERSION;
+  header[2] = numNodes;
+  header[3] = selected ? FLAG_SELECTED : 0;
+
+  const totals = new Float64Array(buffer, HEADER_BYTES, TOTALS);
+  totals[0] = chip.getTotalSteps();
+  totals[1] = chip.getTotalEnergyPJ();
+  totals[2] = chip.getChipPowerMW();
+  totals[3] = chip.getGuestTimeNS();
+  totals[4] = chip.getActiveCount();
+
+  if (selected) {
+    const index = chip.mesh.coordToIndex(selectedCoord);
+    const ids = new Int32Array(buffer, NODE_INTS_AT, 2 + NODE_INTS.LENGTH);
+    ids[0] = selectedCoord;
+    ids[1] = index;
+    chip.getNodeByIndex(index).pack(
+      ids.subarray(2),
+      new Float64Array(buffer, NODE_FLOATS_AT, NODE_FLOATS.LENGTH),
+    );
+  }
+
+  const coords = new Uint16Array(buffer, COORDS_AT, numNodes);
+  const states = new Uint8Array(buffer, COORDS_AT + numNodes * 2, numNodes);
+  for (let i = 0; i < numNodes; i++) {
+    const node = chip.getNodeByIndex(i);
+    coords[i] = node.coord;
+    states[i] = nodeStateCode(node.getState());
+  }
+  return buffer;
+}
+
+/** Unpack a buffer from `encodeSnapshot`. Throws on a foreign or
+ *  different-version buffer, e.g. from a stale cached worker. */
+export function decodeSnapshot(buffer: ArrayBuffer): WorkerSnapshot {
+  const header = new Uint32Array(buffer, 0, 4);
+  if (header[0] !== MAGIC) throw new Error('Not an emulator snapshot');
+  if (header[1] !== PROTOCOL_VERSION) {
+    throw new Error(`Emulator worker protocol v${header[1]}, expected v${PROTOCOL_VERSION}`);
+  }
+  const numNodes = header[2];
+  const totals = new Float64Array(buffer, HEADER_BYTES, TOTALS);
+  const coords = new Uint16Array(buffer, COORDS_AT, numNodes);
+  const codes = new Uint8Array(buffer, COORDS_AT + numNodes * 2, numNodes);
+
+  const nodeStates: NodeState[] = new Array(numNodes);
+  const nodeCoords: number[] = new Array(numNodes);
+  for (let i = 0; i < numNodes; i++) {
+    nodeStates[i] = NODE_STATE_CODES[codes[i]];
+    nodeCoords[i] = coords[i];
+  }
+
+  let selectedNode = null;
+  if (header[3] & FLAG_SELECTED) {
+    const ids = new Int32Array(buffer, NODE_INTS_AT, 2 + NODE_INTS.LENGTH);
+    selectedNode = unpackNode(ids[0], ids[1], ids.subarray(2), new Float64Array(buffer, NODE_FLOATS_AT, NODE_FLOATS.LENGTH));
+  }
+
+  return {
+    nodeStates,
+    nodeCoords,
+    activeCount: totals[4],
+    totalSteps: totals[0],
+    selectedNode,
+    totalEnergyPJ: totals[1],
+    chipPowerMW: totals[2],
+    totalSimTimeNS: totals[3],
+  };
+}
+
+/** Debug-channel delta as a batch of typed arrays. */
+export function encodeDebugBatch(delta: DebugLogDelta): DebugLogBatch {
+  return {
+    coords: Uint16Array.from(delta.coords),
+    values: Uint32Array.from(delta.values),
+    timestamps: Float64Array.from(delta.timestamps),
+    startSeq: delta.startSeq,
+    totalSeq: delta.totalSeq,
+  };
+}
+
+/** Buffers to transfer with a batch. */
+export function batchTransfer(batch: IoWriteBatch | DebugLogBatch | WatchBatch): ArrayBuffer[] {
+  const arrays = 'writes' in batch
+    ? [batch.writes, batch.timestamps]
+    : 'indices' in batch
+      ? [batch.indices, batch.values, batch.timestamps]
+      : [batch.coords, batch.values, batch.timestamps];
+  return arrays.map(a => a.buffer as ArrayBuffer);
+}
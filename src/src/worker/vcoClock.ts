@@ -2,35 +2,39 @@
  * VCO Clock Manager — spawns a single SharedArrayBuffer-backed clock worker
  * that updates all 5 analog node VCO counters.
  *
- * SAB layout (150 × Uint32 = 600 bytes):
+ * SAB layout (150 × Uint32 = 600 bytes on the standard 8x18 mesh):
  *   Slots 0-4:    VCO counters (18-bit, written by clock worker)
  *   Slots 5-148:  Thermal temperatures (scaled ×1000, written by emulator worker)
  *                 Index = THERMAL_OFFSET + linearNodeIndex (0-143)
  *   Slot 149:     Control flag (0 = run, non-zero = exit; written by main thread)
+ * Other meshes have one thermal slot per node, and the flag follows them.
  */
 import { ANALOG_NODES } from '../core/constants';
+import { GA144_MESH } from '../core/mesh';
+import type { Mesh } from '../core/mesh';
 
 /** Offset into the Uint32Array where thermal temperature slots begin. */
 export const THERMAL_OFFSET = ANALOG_NODES.length;
 
 /** Offset for the control flag (0 = run, non-zero = exit). */
-export const CONTROL_OFFSET = THERMAL_OFFSET + 144;
-
-/** Total number of Uint32 slots in the SAB. */
-export const SAB_SLOT_COUNT = CONTROL_OFFSET + 1;
+export function controlOffset(mesh: Mesh): number {
+  return THERMAL_OFFSET + mesh.numNodes;
+}
 
 export interface VcoClockState {
   sab: SharedArrayBuffer;
   counters: Uint32Array;
   workers: Worker[];
+  controlOffset: number;
 }
 
 /**
  * Create a single VCO clock worker backed by SharedArrayBuffer.
  * Requires cross-origin isolation (COOP/COEP headers).
  */
-export function createVcoClocks(): VcoClockState {
-  const sab = new SharedArrayBuffer(SAB_SLOT_COUNT * 4);
+export function createVcoClocks(mesh: Mesh = GA144_MESH): VcoClockState {
+  const control = controlOffset(mesh);
+  const sab = new SharedArrayBuffer((control + 1) * 4);
   const counters = new Uint32Array(sab);
 
   const w = new Worker(
@@ -39,15 +43,18 @@ export function createVcoClocks(): VcoClockState {
   );
   w.postMessage({
     sab,
-    analogNodes: ANALOG_NODES.map((coord, slotIndex) => ({ slotIndex, coord })),
+    rows: mesh.rows,
+    cols: mesh.cols,
+    // Only the standard layout has analog nodes
+    analogNodes: mesh.standard ? ANALOG_NODES.map((coord, slotIndex) => ({ slotIndex, coord })) : [],
   });
 
-  return { sab, counters, workers: [w] };
+  return { sab, counters, workers: [w], controlOffset: control };
 }
 
 /** Signal VCO clock worker to exit and terminate. */
 export function destroyVcoClocks(state: VcoClockState): void {
-  Atomics.store(state.counters, CONTROL_OFFSET, 1);
+  Atomics.store(state.counters, state.controlOffset, 1);
   for (const w of state.workers) {
     w.terminate();
   }
@@ -1,11 +1,11 @@
 /**
  * VCO Clock Worker — single worker that updates all 5 analog node VCO counters.
  *
- * Reads thermal temperatures of all 144 nodes from SAB to compute VCO values
+ * Reads thermal temperatures of all nodes from SAB to compute VCO values
  * that reflect both per-node and neighborhood thermal conditions (substrate
  * thermal coupling). Runs a tight loop, checking a control flag for exit.
  *
- * SAB layout:
+ * SAB layout (standard 8x18 mesh; other meshes have rows × cols thermal slots):
  *   [0..4]     VCO counters (written here)
  *   [5..148]   Thermal temps × 1000 for 144 nodes (read here)
  *   [149]      Control flag (0 = run, non-zero = exit)
@@ -18,28 +18,29 @@ interface AnalogNodeInit {
 
 interface VcoClockInit {
   sab: SharedArrayBuffer;
+  rows: number;
+  cols: number;
   analogNodes: AnalogNodeInit[];
 }
 
 const VCO_TICKS_PER_MS = 3_000_000; // ~3 GHz nominal VCO frequency
 const WRAP_PERIOD_MS = 0x40000 / VCO_TICKS_PER_MS; // ~0.0874 ms per 18-bit wrap
 const THERMAL_OFFSET = 5; // thermal slots start at index 5
-const CONTROL_SLOT = THERMAL_OFFSET + 144; // = 149
 
-/** Convert YXX coord to linear index (0-143). Inlined to avoid importing core. */
-function coordToIndex(coord: number): number {
-  return Math.floor(coord / 100) * 18 + (coord % 100);
+/** Convert YXX coord to linear index. Inlined to avoid importing core. */
+function coordToIndex(coord: number, cols: number): number {
+  return Math.floor(coord / 100) * cols + (coord % 100);
 }
 
 /** Get neighbor coords for a node (up to 4, excluding out-of-bounds). */
-function getNeighborIndices(coord: number): number[] {
+function getNeighborIndices(coord: number, rows: number, cols: number): number[] {
   const row = Math.floor(coord / 100);
   const col = coord % 100;
   const indices: number[] = [];
-  if (row < 7) indices.push(coordToIndex(coord + 100)); // north
-  if (row > 0) indices.push(coordToIndex(coord - 100)); // south
-  if (col < 17) indices.push(coordToIndex(coord + 1));  // east
-  if (col > 0) indices.push(coordToIndex(coord - 1));   // west
+  if (row < rows - 1) indices.push(coordToIndex(coord + 100, cols)); // north
+  if (row > 0) indices.push(coordToIndex(coord - 100, cols));        // south
+  if (col < cols - 1) indices.push(coordToIndex(coord + 1, cols));   // east
+  if (col > 0) indices.push(coordToIndex(coord - 1, cols));          // west
   return indices;
 }
 
@@ -51,20 +52,21 @@ interface PreparedNode {
 }
 
 self.onmessage = (e: MessageEvent<VcoClockInit>) => {
-  const { sab, analogNodes } = e.data;
+  const { sab, rows, cols, analogNodes } = e.data;
   const counters = new Uint32Array(sab);
+  const controlSlot = THERMAL_OFFSET + rows * cols;
 
   // Pre-compute per-node constants
   const prepared: PreparedNode[] = analogNodes.map(({ slotIndex, coord }) => ({
     slotIndex,
     nodeOffset: (coord * 40499 + 112771) & 0x3FFFF,
-    thermalSlot: THERMAL_OFFSET + coordToIndex(coord),
-    neighborSlots: getNeighborIndices(coord).map(i => THERMAL_OFFSET + i),
+    thermalSlot: THERMAL_OFFSET + coordToIndex(coord, cols),
+    neighborSlots: getNeighborIndices(coord, rows, cols).map(i => THERMAL_OFFSET + i),
   }));
 
   // Tight loop — exits when control flag is set
   for (;;) {
-    if (Atomics.load(counters, CONTROL_SLOT) !== 0) break;
+    if (Atomics.load(counters, controlSlot) !== 0) break;
 
     const nowMs = performance.now();
     const phase = (nowMs % (WRAP_PERIOD_MS * 256)) / WRAP_PERIOD_MS;
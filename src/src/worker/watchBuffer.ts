@@ -0,0 +1,57 @@
+/**
+ * Main-thread store for watched RAM values streamed from the worker.
+ * Keeps each target's latest value and its last WATCH_HISTORY values for
+ * the sparklines. Batches from an earlier watch list are ignored. Every
+ * batch that changes something produces a new `view` object, and new
+ * samples for the targets it touched, so React can compare by reference.
+ */
+import type { WatchBatch } from './emulatorProtocol';
+import type { WatchTarget } from '../core/ram-watch';
+
+export const WATCH_HISTORY = 64;
+
+export interface WatchSample {
+  value: number;
+  /** Guest time (ns) of the latest value. */
+  timeNS: number;
+  /** Oldest first, ending with `value`. */
+  history: number[];
+  /** Updates received: guest writes in write mode, changes when sampled. */
+  updates: number;
+}
+
+export interface WatchView {
+  targets: WatchTarget[];
+  /** Parallel to targets; null until the first value arrives. */
+  samples: (WatchSample | null)[];
+  /** Log entries the worker overwrote before sending them. */
+  dropped: number;
+}
+
+export class WatchBuffer {
+  id = 0;
+  view: WatchView = { targets: [], samples: [], dropped: 0 };
+
+  /** Start a new watch list. */
+  reset(id: number, targets: WatchTarget[]): void {
+    this.id = id;
+    this.view = { targets, samples: new Array(targets.length).fill(null), dropped: 0 };
+  }
+
+  /** Returns false if the batch belongs to an earlier watch list. */
+  appendBatch(batch: WatchBatch): boolean {
+    if (batch.id !== this.id) return false;
+    const samples = this.view.samples.slice();
+    for (let i = 0; i < batch.indices.length; i++) {
+      const t = batch.indices[i];
+      if (t >= samples.length) continue;
+      const prev = samples[t];
+      const value = batch.values[i];
+      const history = prev ? prev.history.concat(value) : [value];
+      if (history.length > WATCH_HISTORY) history.shift();
+      samples[t] = { value, timeNS: batch.timestamps[i], history, updates: (prev?.updates ?? 0) + 1 };
+    }
+    this.view = { targets: this.view.targets, samples, dropped: this.view.dropped + batch.dropped };
+    return true;
+  }
+}
@@ -1,5 +1,7 @@
 /**
- * Tests for worker-related components: IoWriteBuffer and GA144.getIoWritesDelta.
+ * Tests for worker-related components: IoWriteBuffer, GA144.getIoWritesDelta,
+ * the binary snapshot codec, the shared chip activity buffer and the
+ * main-thread watch buffer.
  *
  * These test the data transfer layer used by the emulator Web Worker.
  * The actual Worker is not instantiated (vitest runs in Node.js).
@@ -11,6 +13,13 @@ import { SerialBits } from '../core/serial';
 import { ROM_DATA } from '../core/rom-data';
 import { compileCube } from '../core/cube';
 import { buildBootStream } from '../core/bootstream';
+import { PORT } from '../core/constants';
+import { encodeSnapshot, decodeSnapshot, encodeDebugBatch, batchTransfer } from './snapshotCodec';
+import { DebugLogBuffer } from './debugLogBuffer';
+import { ChipActivity } from './chipActivity';
+import { WatchBuffer, WATCH_HISTORY } from './watchBuffer';
+import { NODE_STATE_CODES } from '../core/node-pack';
+import { PortIndex } from '../core/types';
 
 import { readFileSync } from 'fs';
 import { fileURLToPath } from 'url';
@@ -23,8 +32,8 @@ describe('IoWriteBuffer', () => {
   it('appends a single batch', () => {
     const buf = new IoWriteBuffer();
     buf.appendBatch({
-      writes: [100, 200, 300],
-      timestamps: [1, 2, 3],
+      writes: Uint32Array.of(100, 200, 300),
+      timestamps: Float64Array.of(1, 2, 3),
       startSeq: 0,
       totalSeq: 3,
     });
@@ -40,8 +49,8 @@ describe('IoWriteBuffer', () => {
 
   it('appends multiple batches sequentially', () => {
     const buf = new IoWriteBuffer();
-    buf.appendBatch({ writes: [10, 20], timestamps: [1, 2], startSeq: 0, totalSeq: 2 });
-    buf.appendBatch({ writes: [30, 40], timestamps: [3, 4], startSeq: 2, totalSeq: 4 });
+    buf.appendBatch({ writes: Uint32Array.of(10, 20), timestamps: Float64Array.of(1, 2), startSeq: 0, totalSeq: 2 });
+    buf.appendBatch({ writes: Uint32Array.of(30, 40), timestamps: Float64Array.of(3, 4), startSeq: 2, totalSeq: 4 });
     expect(buf.count).toBe(4);
     expect(buf.seq).toBe(4);
     expect(buf.writes[0]).toBe(10);
@@ -50,7 +59,7 @@ describe('IoWriteBuffer', () => {
 
   it('reset clears all state', () => {
     const buf = new IoWriteBuffer();
-    buf.appendBatch({ writes: [1, 2, 3], timestamps: [1, 2, 3], startSeq: 0, totalSeq: 3 });
+    buf.appendBatch({ writes: Uint32Array.of(1, 2, 3), timestamps: Float64Array.of(1, 2, 3), startSeq: 0, totalSeq: 3 });
     buf.reset();
     expect(buf.count).toBe(0);
     expect(buf.seq).toBe(0);
@@ -59,7 +68,7 @@ describe('IoWriteBuffer', () => {
 
   it('handles empty batch', () => {
     const buf = new IoWriteBuffer();
-    buf.appendBatch({ writes: [], timestamps: [], startSeq: 0, totalSeq: 0 });
+    buf.appendBatch({ writes: Uint32Array.of(), timestamps: Float64Array.of(), startSeq: 0, totalSeq: 0 });
     expect(buf.count).toBe(0);
     expect(buf.seq).toBe(0);
   });
@@ -157,3 +166,126 @@ describe('GA144.getIoWritesDelta', () => {
     }
   });
 });
+
+describe('snapshotCodec', () => {
+  /** 100 pushes and writes to 101, which never reads; 200 reads from 100. */
+  const loadBlocked = (): GA144 => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    const compiled = compileCube(`#include std
+node 100
+/\\
+std.send{port=${PORT.RIGHT}, value=0x2A}
+node 200
+/\\
+std.recv{port=${PORT.DOWN}, value=x}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    ga.stepProgramN(20_000);
+    return ga;
+  };
+
+  it('round-trips chip state and the selected node', () => {
+    const ga = loadBlocked();
+    for (const coord of [100, 200, 717]) {
+      const expected = ga.getSnapshot(coord);
+      const decoded = decodeSnapshot(encodeSnapshot(ga, coord));
+      expect(decoded.nodeStates).toEqual(expected.nodeStates);
+      expect(decoded.nodeCoords).toEqual(expected.nodeCoords);
+      expect(decoded.selectedNode).toEqual(expected.selectedNode);
+      expect(decoded.activeCount).toBe(expected.activeCount);
+      expect(decoded.totalSteps).toBe(expected.totalSteps);
+      expect(decoded.totalEnergyPJ).toBe(expected.totalEnergyPJ);
+      expect(decoded.chipPowerMW).toBe(expected.chipPowerMW);
+      expect(decoded.totalSimTimeNS).toBe(expected.totalSimTimeNS);
+    }
+    expect(ga.getSnapshot(100).selectedNode?.currentWritingPort).toBe('R');
+    expect(decodeSnapshot(encodeSnapshot(ga, null)).selectedNode).toBeNull();
+  });
+
+  it('rejects buffers from another protocol version', () => {
+    const buffer = encodeSnapshot(loadBlocked(), null);
+    new Uint32Array(buffer, 0, 4)[1] += 1;
+    expect(() => decodeSnapshot(buffer)).toThrow('protocol');
+    expect(() => decodeSnapshot(new ArrayBuffer(64))).toThrow('Not an emulator snapshot');
+  });
+
+  it('sends debug batches as typed arrays with their buffers listed for transfer', () => {
+    const batch = encodeDebugBatch({ coords: [100, 717], values: [1, 0x3FFFF], timestamps: [5, 7.5], startSeq: 3, totalSeq: 5 });
+    expect(batch.values).toBeInstanceOf(Uint32Array);
+    expect(batchTransfer(batch)).toEqual([batch.coords.buffer, batch.values.buffer, batch.timestamps.buffer]);
+
+    const buf = new DebugLogBuffer();
+    buf.appendBatch(batch);
+    expect(buf.entries).toEqual([
+      { coord: 100, value: 1, timeNS: 5 },
+      { coord: 717, value: 0x3FFFF, timeNS: 7.5 },
+    ]);
+    expect(buf.seq).toBe(5);
+  });
+});
+
+describe('ChipActivity', () => {
+  it('publishes node counters and link traffic into a buffer the main thread can view', () => {
+    const ga = new GA144('test');
+    ga.setRomData(ROM_DATA);
+    const compiled = compileCube(`#include std
+node 100
+/\\
+std.send{port=${PORT.RIGHT}, value=1}
+node 101
+/\\
+std.recv{port=${PORT.RIGHT}, value=x}
+`);
+    expect(compiled.errors).toHaveLength(0);
+    ga.load(compiled);
+    ga.stepProgramN(20_000);
+
+    const writer = ChipActivity.create(ga.mesh);
+    const before = writer.generation;
+    writer.publish(ga);
+    const view = new ChipActivity(writer.sab);
+    expect(view.generation).toBe(before + 1);
+    expect(view.mesh.numNodes).toBe(144);
+
+    const snapshot = ga.getSnapshot();
+    const i100 = ga.mesh.coordToIndex(100);
+    expect(Array.from(view.states, c => NODE_STATE_CODES[c])).toEqual(snapshot.nodeStates);
+    expect(view.steps[i100]).toBe(ga.getNodeByIndex(i100).stepCount);
+    expect(view.temperature[i100]).toBe(ga.getNodeByIndex(i100).thermal.temperature);
+    const c = view.links.outChan[i100 * 4 + PortIndex.RIGHT];
+    expect(view.transfers[c]).toBe(1);
+    expect(view.links.chanTo[c]).toBe(ga.mesh.coordToIndex(101));
+  });
+});
+
+describe('WatchBuffer', () => {
+  const batch = (id: number, indices: number[], values: number[]) => ({
+    id,
+    indices: Uint16Array.from(indices),
+    values: Uint32Array.from(values),
+    timestamps: Float64Array.from(values.map((_, i) => i)),
+    dropped: 0,
+  });
+
+  it('tracks latest values and bounded history per target, ignoring stale lists', () => {
+    const buf = new WatchBuffer();
+    buf.reset(2, [{ coord: 404, addr: 0x3F }, { coord: 404, addr: 0x3E }]);
+    expect(buf.view.samples).toEqual([null, null]);
+    expect(batchTransfer(batch(2, [0], [1]))).toHaveLength(3);
+
+    expect(buf.appendBatch(batch(1, [0], [99]))).toBe(false);
+    const before = buf.view;
+    expect(buf.appendBatch(batch(2, [0, 0, 1], [1, 2, 0x3FFFF]))).toBe(true);
+    expect(buf.view).not.toBe(before);
+    expect(buf.view.samples[0]).toEqual({ value: 2, timeNS: 1, history: [1, 2], updates: 2 });
+    expect(buf.view.samples[1]?.value).toBe(0x3FFFF);
+
+    const untouched = buf.view.samples[1];
+    buf.appendBatch(batch(2, new Array(WATCH_HISTORY + 5).fill(0), Array.from({ length: WATCH_HISTORY + 5 }, (_, i) => i)));
+    expect(buf.view.samples[0]?.history).toHaveLength(WATCH_HISTORY);
+    expect(buf.view.samples[0]?.value).toBe(WATCH_HISTORY + 4);
+    expect(buf.view.samples[1]).toBe(untouched);
+  });
+});